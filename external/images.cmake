@@ -4,6 +4,7 @@ FetchContent_Declare(
     GIT_TAG         v0.7.4
 )
 set(BUILD_EXAMPLES OFF)
+set(SPNG_SHARED OFF)
 FetchContent_MakeAvailable(libspng)
 
 # FetchContent_Declare(
@@ -7,6 +7,7 @@
 #include "muon/core/window.hpp"
 #include "muon/event/event.hpp"
 #include "muon/input/key.hpp"
+#include "muon/profile/profiler.hpp"
 
 #include <string_view>
 
@@ -26,8 +27,9 @@ public:
     MuonEditor(
         Extent2D extent,
         bool v_sync,
-        WindowMode mode
-    ) : Application{"Muon Editor", extent, v_sync, mode} {
+        WindowMode mode,
+        const ApplicationOptions &options
+    ) : Application{"Muon Editor", extent, v_sync, mode, options} {
         // override default window close handler if you need to
         auto success = dispatcher_->unsubscribe<event::WindowQuit>(on_window_close_);
         client::expect(success, "failed to unsubscribe from default window close event handler");
@@ -42,6 +44,19 @@ public:
         fullscreen_ = mode == WindowMode::BorderlessFullscreen;
 
         dispatcher_->subscribe<event::Keyboard>([&](const auto &event) {
+            if (event.scancode == input::Scancode::Function9 && event.down) {
+                profile::capture(120, "muon-trace.json");
+            }
+
+            if (event.scancode == input::Scancode::KeyQ && event.mods.is_ctrl_down() && event.down) {
+                running_ = false;
+            }
+
+            // headless runs have no window to act on
+            if (!window_) {
+                return;
+            }
+
             if (event.scancode == input::Scancode::KeyC && event.mods.is_ctrl_down() && event.down) {
                 window_->set_clipboard_text("foobar");
             }
@@ -64,10 +79,6 @@ public:
             if (event.scancode == input::Scancode::Function3 && event.down) {
                 window_->end_text_input();
             }
-
-            if (event.scancode == input::Scancode::KeyQ && event.mods.is_ctrl_down() && event.down) {
-                running_ = false;
-            }
         });
 
         dispatcher_->subscribe<event::DropFile>([](const auto &event) {
@@ -99,7 +110,8 @@ auto create_application(size_t count, char **arguments) -> Application::Pointer
     return new MuonEditor{
         {1920, 1080},
         false,
-        WindowMode::Windowed
+        WindowMode::Windowed,
+        parse_application_options(count, arguments),
     };
 }
 
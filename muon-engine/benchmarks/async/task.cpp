@@ -0,0 +1,120 @@
+#include "muon/async/task.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "muon/async/frame_pool.hpp"
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+namespace muon {
+
+namespace {
+
+// identical to async::Task<uint32_t> except that frames come from the global allocator
+class UnpooledTask {
+public:
+    struct promise_type {
+        uint32_t value{0};
+        std::coroutine_handle<> continuation{nullptr};
+
+        auto get_return_object() -> UnpooledTask {
+            return UnpooledTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        auto initial_suspend() const noexcept -> std::suspend_always { return {}; }
+        auto final_suspend() const noexcept {
+            struct FinalAwaiter {
+                auto await_ready() const noexcept -> bool { return false; }
+                auto await_suspend(std::coroutine_handle<promise_type> handle) const noexcept -> std::coroutine_handle<> {
+                    if (auto continuation = handle.promise().continuation) {
+                        return continuation;
+                    }
+                    return std::noop_coroutine();
+                }
+                void await_resume() const noexcept {}
+            };
+            return FinalAwaiter{};
+        }
+        void unhandled_exception() const noexcept { std::terminate(); }
+        void return_value(uint32_t result) { value = result; }
+    };
+
+    explicit UnpooledTask(std::coroutine_handle<promise_type> handle) : handle_{handle} {}
+    UnpooledTask(UnpooledTask &&other) noexcept : handle_{std::exchange(other.handle_, nullptr)} {}
+    ~UnpooledTask() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    void resume() { handle_.resume(); }
+    auto result() const -> uint32_t { return handle_.promise().value; }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+            auto await_ready() const noexcept -> bool { return false; }
+            auto await_suspend(std::coroutine_handle<> continuation) noexcept -> std::coroutine_handle<> {
+                handle.promise().continuation = continuation;
+                return handle;
+            }
+            auto await_resume() const -> uint32_t { return handle.promise().value; }
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+auto pooled_leaf(uint32_t value) -> async::Task<uint32_t> { co_return value + 1; }
+
+auto pooled_chain(uint32_t depth) -> async::Task<uint32_t> {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < depth; i++) {
+        total += co_await pooled_leaf(i);
+    }
+    co_return total;
+}
+
+auto unpooled_leaf(uint32_t value) -> UnpooledTask { co_return value + 1; }
+
+auto unpooled_chain(uint32_t depth) -> UnpooledTask {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < depth; i++) {
+        total += co_await unpooled_leaf(i);
+    }
+    co_return total;
+}
+
+} // namespace
+
+TEST_CASE("coroutine frame allocation", "[benchmark][task]") {
+    BENCHMARK("pooled frame pool allocate/deallocate") {
+        void *block = async::FramePool::allocate(256);
+        async::FramePool::deallocate(block, 256);
+        return block != nullptr;
+    };
+
+    BENCHMARK("global operator new/delete") {
+        void *block = ::operator new(256);
+        ::operator delete(block);
+        return block != nullptr;
+    };
+
+    BENCHMARK("pooled task, 64 awaited children") {
+        auto task = pooled_chain(64);
+        task.resume();
+        return task.result();
+    };
+
+    BENCHMARK("unpooled task, 64 awaited children") {
+        auto task = unpooled_chain(64);
+        task.resume();
+        return task.result();
+    };
+}
+
+} // namespace muon
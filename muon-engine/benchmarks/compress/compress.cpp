@@ -0,0 +1,123 @@
+#include "muon/compress/compress.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "fmt/format.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace muon::compress {
+
+namespace {
+
+// a mix of repetitive text and noisy floats, roughly what scene and log data looks like
+auto make_payload(size_t size, uint32_t seed = 0x9e3779b9) -> Buffer {
+    std::string text;
+    uint32_t state = seed;
+    for (size_t i = 0; text.size() < size; i++) {
+        state = state * 1664525 + 1013904223;
+        text += fmt::format(
+            R"({{"entity": {}, "mesh": "meshes/prop_{}.mesh", "position": [{:.4f}, {:.4f}, {:.4f}]}})"
+            "\n",
+            i, state % 64, (state >> 8) * 1e-4, (state >> 12) * 1e-3, -static_cast<double>(state >> 16)
+        );
+    }
+    text.resize(size);
+    return Buffer{text};
+}
+
+template <typename Fn>
+auto seconds(Fn &&fn) -> double {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(BufferView source, const Options &options) {
+    constexpr double MEBIBYTE = 1024.0 * 1024.0;
+
+    auto compressed = compress(source, options);
+    REQUIRE(compressed.has_value());
+    Buffer output{source.size()};
+
+    auto compress_time = seconds([&] { (void)compress(source, options); });
+    auto decompress_time = seconds([&] { (void)decompress_into(*compressed, {output.data(), output.size()}, options.codec); });
+
+    fmt::println(
+        "{} level {:>2} workers {}: ratio {:.2f}, compress {:.0f} MiB/s, decompress {:.0f} MiB/s",
+        options.codec == Codec::Zstd ? "zstd" : "zlib", options.level, options.workers,
+        static_cast<double>(source.size()) / static_cast<double>(compressed->size()),
+        static_cast<double>(source.size()) / MEBIBYTE / compress_time,
+        static_cast<double>(source.size()) / MEBIBYTE / decompress_time
+    );
+}
+
+} // namespace
+
+TEST_CASE("compression levels", "[benchmark][compress]") {
+    auto payload = make_payload(16 * 1024 * 1024);
+
+    for (auto level : {1, 3, 9, 19}) {
+        report(payload, {.codec = Codec::Zstd, .level = level});
+    }
+    for (auto level : {3, 9}) {
+        report(payload, {.codec = Codec::Zstd, .level = level, .workers = 4});
+    }
+    for (auto level : {1, 6, 9}) {
+        report(payload, {.codec = Codec::Zlib, .level = level});
+    }
+
+    auto zstd = *compress(payload);
+    auto zlib = *compress(payload, {.codec = Codec::Zlib, .level = DEFAULT_ZLIB_LEVEL});
+    Buffer output{payload.size()};
+
+    BENCHMARK("zstd compress") { return compress(payload); };
+    BENCHMARK("zstd compress 4 workers") { return compress(payload, {.workers = 4}); };
+    BENCHMARK("zlib compress") { return compress(payload, {.codec = Codec::Zlib, .level = DEFAULT_ZLIB_LEVEL}); };
+
+    BENCHMARK("zstd decompress") { return decompress_into(zstd, {output.data(), output.size()}); };
+    BENCHMARK("zlib decompress") { return decompress_into(zlib, {output.data(), output.size()}, Codec::Zlib); };
+}
+
+TEST_CASE("small asset dictionaries", "[benchmark][compress]") {
+    std::vector<Buffer> assets;
+    for (size_t i = 0; i < 2000; i++) {
+        assets.push_back(make_payload(256 + i % 512, static_cast<uint32_t>(i)));
+    }
+    std::vector<BufferView> samples(assets.begin(), assets.end());
+    auto dictionary = Dictionary::train(samples);
+    REQUIRE(dictionary.has_value());
+
+    size_t original = 0;
+    size_t plain = 0;
+    size_t trained = 0;
+    for (const auto &asset : assets) {
+        original += asset.size();
+        plain += compress(asset)->size();
+        trained += compress(asset, *dictionary)->size();
+    }
+    fmt::println(
+        "{} assets: ratio {:.2f} without a dictionary, {:.2f} with one", assets.size(),
+        static_cast<double>(original) / static_cast<double>(plain), static_cast<double>(original) / static_cast<double>(trained)
+    );
+
+    BENCHMARK("compress without dictionary") {
+        size_t total = 0;
+        for (const auto &asset : assets) {
+            total += compress(asset)->size();
+        }
+        return total;
+    };
+    BENCHMARK("compress with dictionary") {
+        size_t total = 0;
+        for (const auto &asset : assets) {
+            total += compress(asset, *dictionary)->size();
+        }
+        return total;
+    };
+}
+
+} // namespace muon::compress
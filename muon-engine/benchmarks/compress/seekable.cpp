@@ -0,0 +1,53 @@
+#include "muon/compress/seekable.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "fmt/format.h"
+
+#include <cstdint>
+#include <string>
+
+namespace muon::compress {
+
+namespace {
+
+auto make_log(size_t size) -> Buffer {
+    std::string text;
+    for (size_t i = 0; text.size() < size; i++) {
+        text += fmt::format("[{:010}] [debug] [Job] finished job {} on worker {} in {} us\n", i, i * 7, i % 12, i % 1000);
+    }
+    text.resize(size);
+    return Buffer{text};
+}
+
+} // namespace
+
+TEST_CASE("seekable reads", "[benchmark][compress]") {
+    auto source = make_log(64 * 1024 * 1024);
+    job::System jobs;
+
+    auto whole = *compress(source);
+    auto archive = *compress_seekable(source, {}, &jobs);
+    auto reader = *SeekableReader::open(archive);
+    fmt::println(
+        "whole file {} bytes, seekable {} bytes in {} frames", whole.size(), archive.size(), reader.frame_count()
+    );
+
+    Buffer record{4096};
+    Buffer output{source.size()};
+    uint64_t offset = 0;
+
+    BENCHMARK("4 KiB record from whole file") {
+        auto decompressed = decompress(whole);
+        return decompressed->data()[source.size() / 2];
+    };
+    BENCHMARK("4 KiB record from seekable") {
+        offset = (offset + 7'919'993) % (source.size() - record.size());
+        return reader.read(offset, {record.data(), record.size()});
+    };
+    BENCHMARK("whole seekable serial") { return reader.read(0, {output.data(), output.size()}); };
+    BENCHMARK("whole seekable parallel") { return reader.read(0, {output.data(), output.size()}, &jobs); };
+    BENCHMARK("compress seekable parallel") { return compress_seekable(source, {}, &jobs); };
+}
+
+} // namespace muon::compress
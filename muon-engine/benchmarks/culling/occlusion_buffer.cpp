@@ -0,0 +1,92 @@
+#include "muon/culling/occlusion_buffer.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace muon::culling {
+
+namespace {
+
+constexpr size_t BUILDINGS_PER_SIDE = 20;
+constexpr float SPACING = 20.0f;
+constexpr size_t OBJECTS = 100'000;
+
+const std::array<glm::vec3, 8> CUBE_VERTICES{
+    glm::vec3{-1.0f, -1.0f, -1.0f}, glm::vec3{1.0f, -1.0f, -1.0f}, glm::vec3{1.0f, 1.0f, -1.0f}, glm::vec3{-1.0f, 1.0f, -1.0f},
+    glm::vec3{-1.0f, -1.0f, 1.0f},  glm::vec3{1.0f, -1.0f, 1.0f},  glm::vec3{1.0f, 1.0f, 1.0f},  glm::vec3{-1.0f, 1.0f, 1.0f},
+};
+
+constexpr std::array<uint32_t, 36> CUBE_INDICES{
+    0, 1, 2, 0, 2, 3, 4, 6, 5, 4, 7, 6, 0, 4, 5, 0, 5, 1, 3, 2, 6, 3, 6, 7, 0, 3, 7, 0, 7, 4, 1, 5, 6, 1, 6, 2,
+};
+
+} // namespace
+
+TEST_CASE("occlusion culling", "[benchmark][culling]") {
+    // a grid of buildings with the camera down one of the streets, small objects scattered between and behind them
+    std::vector<glm::mat4> buildings;
+    std::mt19937 random{3};
+    std::uniform_real_distribution<float> height{4.0f, 12.0f};
+    for (size_t x = 0; x < BUILDINGS_PER_SIDE; x++) {
+        for (size_t z = 0; z < BUILDINGS_PER_SIDE; z++) {
+            glm::vec3 center{(static_cast<float>(x) - BUILDINGS_PER_SIDE / 2.0f) * SPACING, 0.0f, -static_cast<float>(z) * SPACING - 10.0f};
+            auto model = glm::translate(glm::mat4{1.0f}, center);
+            buildings.push_back(glm::scale(model, glm::vec3{7.0f, height(random), 7.0f}));
+        }
+    }
+
+    std::uniform_real_distribution<float> across{-SPACING * BUILDINGS_PER_SIDE / 2.0f, SPACING * BUILDINGS_PER_SIDE / 2.0f};
+    std::uniform_real_distribution<float> along{-SPACING * BUILDINGS_PER_SIDE, 0.0f};
+    std::array<std::vector<float>, 6> columns;
+    for (size_t i = 0; i < OBJECTS; i++) {
+        glm::vec3 center{across(random), 1.0f, along(random)};
+        for (int axis = 0; axis < 3; axis++) {
+            columns[axis].push_back(center[axis] - 0.5f);
+            columns[axis + 3].push_back(center[axis] + 0.5f);
+        }
+    }
+    maths::AabbSoa<const float> boxes{{columns[0], columns[1], columns[2]}, {columns[3], columns[4], columns[5]}};
+
+    auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    auto view = glm::lookAt(glm::vec3{10.0f, 2.0f, 0.0f}, glm::vec3{25.0f, 2.0f, -100.0f}, glm::vec3{0.0f, 1.0f, 0.0f});
+    auto view_projection = projection * view;
+    auto frustum = maths::Frustum::from_matrix(view_projection);
+
+    OcclusionBuffer buffer;
+    auto render = [&] {
+        buffer.clear(view_projection);
+        for (const auto &model : buildings) {
+            buffer.render(model, CUBE_VERTICES, CUBE_INDICES);
+        }
+    };
+
+    BENCHMARK("render 400 occluders") {
+        render();
+        return buffer.width();
+    };
+
+    std::vector<uint32_t> visible;
+    visible.reserve(OBJECTS);
+    BENCHMARK("frustum cull 100k boxes") {
+        visible.clear();
+        maths::frustum_cull(frustum, boxes, visible);
+        return visible.size();
+    };
+
+    render();
+    BENCHMARK("frustum and occlusion cull 100k boxes") {
+        visible.clear();
+        maths::frustum_cull(frustum, boxes, visible);
+        buffer.cull(boxes, visible);
+        return visible.size();
+    };
+}
+
+} // namespace muon::culling
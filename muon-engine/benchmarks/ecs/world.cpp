@@ -0,0 +1,126 @@
+#include "muon/ecs/world.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "muon/ecs/command_buffer.hpp"
+#include "muon/ecs/query.hpp"
+#include "muon/job/system.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace muon::ecs {
+
+namespace {
+
+constexpr size_t ENTITIES = 1'000'000;
+
+struct Position {
+    float x{0.0f};
+    float y{0.0f};
+    float z{0.0f};
+};
+
+struct Velocity {
+    float x{0.0f};
+    float y{0.0f};
+    float z{0.0f};
+};
+
+struct Health {
+    float value{100.0f};
+};
+
+// an object per allocation with every component inline, as a baseline
+struct Object {
+    Position position;
+    Velocity velocity;
+    Health health;
+    bool alive{true};
+};
+
+} // namespace
+
+TEST_CASE("entity component system", "[benchmark][ecs]") {
+    World world;
+    std::vector<std::unique_ptr<Object>> objects;
+    for (size_t i = 0; i < ENTITIES; i++) {
+        auto x = static_cast<float>(i);
+        // a few archetypes so queries span more than one
+        switch (i % 4) {
+            case 0:
+                world.create(Position{x, 0.0f, 0.0f}, Velocity{1.0f, 0.0f, 0.0f});
+                break;
+            case 1:
+                world.create(Position{x, 0.0f, 0.0f}, Velocity{1.0f, 0.0f, 0.0f}, Health{});
+                break;
+            default:
+                world.create(Position{x, 0.0f, 0.0f}, Velocity{1.0f, 0.0f, 0.0f}, Health{}, Object{});
+                break;
+        }
+        objects.push_back(std::make_unique<Object>(Position{x, 0.0f, 0.0f}, Velocity{1.0f, 0.0f, 0.0f}));
+    }
+
+    Query<Position, const Velocity> movement{world};
+    BENCHMARK("query each") {
+        movement.each([](Position &position, const Velocity &velocity) {
+            position.x += velocity.x * 0.016f;
+            position.y += velocity.y * 0.016f;
+            position.z += velocity.z * 0.016f;
+        });
+        return movement.size();
+    };
+
+    BENCHMARK("query each chunk") {
+        movement.each_chunk([](std::span<const Entity>, std::span<Position> positions, std::span<const Velocity> velocities) {
+            for (size_t i = 0; i < positions.size(); i++) {
+                positions[i].x += velocities[i].x * 0.016f;
+                positions[i].y += velocities[i].y * 0.016f;
+                positions[i].z += velocities[i].z * 0.016f;
+            }
+        });
+        return movement.size();
+    };
+
+    job::System jobs;
+    BENCHMARK("query each across workers") {
+        movement.each(jobs, [](Position &position, const Velocity &velocity) {
+            position.x += velocity.x * 0.016f;
+            position.y += velocity.y * 0.016f;
+            position.z += velocity.z * 0.016f;
+        });
+        return movement.size();
+    };
+
+    BENCHMARK("pointer per object") {
+        for (auto &object : objects) {
+            object->position.x += object->velocity.x * 0.016f;
+            object->position.y += object->velocity.y * 0.016f;
+            object->position.z += object->velocity.z * 0.016f;
+        }
+        return objects.size();
+    };
+
+    BENCHMARK("query create fresh") {
+        Query<Position, const Velocity, Health> query{world};
+        return query.size();
+    };
+
+    Query<const Health> health{world};
+    BENCHMARK("deferred add and remove") {
+        CommandBuffer commands;
+        size_t i = 0;
+        health.each([&](Entity entity, const Health &) {
+            if (i++ % 1000 == 0) {
+                commands.remove<Health>(entity);
+                commands.add(entity, Health{});
+            }
+        });
+        commands.apply(world);
+        return world.size();
+    };
+}
+
+} // namespace muon::ecs
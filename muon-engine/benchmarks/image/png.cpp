@@ -0,0 +1,117 @@
+#include "muon/image/png.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "fmt/format.h"
+#include "muon/fs/fs.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace muon::image {
+
+namespace {
+
+auto load(std::string_view name) -> Buffer {
+    auto png = fs::read_file_binary(std::filesystem::path{MUON_TEST_PROJECT_DIR} / "images" / name);
+    REQUIRE(png.has_value());
+    return std::move(*png);
+}
+
+template <typename Fn>
+auto seconds(Fn &&fn) -> double {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void recycle(BufferPool &pool, std::expected<Image, ImageError> image) { pool.release(std::move(*image).release()); }
+
+auto format_name(PixelFormat format) -> std::string_view {
+    switch (format) {
+        case PixelFormat::R8:
+            return "r8";
+        case PixelFormat::Rgb8:
+            return "rgb8";
+        case PixelFormat::Rgba8:
+            return "rgba8";
+        case PixelFormat::Bgra8:
+            return "bgra8";
+        case PixelFormat::Rgba16:
+            break;
+    }
+    return "rgba16";
+}
+
+} // namespace
+
+TEST_CASE("png decoding", "[benchmark][image]") {
+    constexpr double MEBIBYTE = 1024.0 * 1024.0;
+
+    auto png = load("muon-logo.png");
+    BufferPool pool;
+    // nothing is ever kept, so every decode allocates like it would without a pool
+    BufferPool unpooled{BufferPool::DEFAULT_ALIGNMENT, 0};
+
+    for (auto format : {PixelFormat::R8, PixelFormat::Rgb8, PixelFormat::Rgba8, PixelFormat::Bgra8, PixelFormat::Rgba16}) {
+        auto image = decode_png(png, format, pool);
+        REQUIRE(image.has_value());
+        auto pixels = static_cast<double>(image->width()) * image->height();
+        pool.release(std::move(*image).release());
+
+        auto time = seconds([&] { recycle(pool, decode_png(png, format, pool)); });
+        fmt::println(
+            "muon-logo.png to {}: {:.0f} MiB/s of png, {:.0f} megapixels/s", format_name(format),
+            static_cast<double>(png.size()) / MEBIBYTE / time, pixels / 1e6 / time
+        );
+    }
+
+    BENCHMARK("decode rgba8") { recycle(pool, decode_png(png, PixelFormat::Rgba8, pool)); };
+    BENCHMARK("decode rgba8 without a pool") { recycle(unpooled, decode_png(png, PixelFormat::Rgba8, unpooled)); };
+    BENCHMARK("decode bgra8") { recycle(pool, decode_png(png, PixelFormat::Bgra8, pool)); };
+    BENCHMARK("decode r8") { recycle(pool, decode_png(png, PixelFormat::R8, pool)); };
+}
+
+TEST_CASE("png batch decoding", "[benchmark][image]") {
+    constexpr size_t BATCH = 16;
+
+    auto png = load("muon-logo.png");
+    std::vector<BufferView> pngs(BATCH, png);
+    BufferPool pool;
+    job::System jobs;
+
+    auto recycle_all = [&](std::vector<std::expected<Image, ImageError>> &images) {
+        for (auto &image : images) {
+            recycle(pool, std::move(image));
+        }
+    };
+
+    auto serial = [&] {
+        std::vector<std::expected<Image, ImageError>> images;
+        for (auto view : pngs) {
+            images.push_back(decode_png(view, PixelFormat::Rgba8, pool));
+        }
+        recycle_all(images);
+    };
+    auto parallel = [&] {
+        auto images = decode_png(pngs, PixelFormat::Rgba8, pool, jobs);
+        recycle_all(images);
+    };
+
+    // warm the pool so neither side pays for the first allocations
+    parallel();
+    fmt::println(
+        "{} pngs on {} workers: {:.1f} ms serial, {:.1f} ms across jobs", BATCH, jobs.worker_count(), seconds(serial) * 1e3,
+        seconds(parallel) * 1e3
+    );
+
+    BENCHMARK("decode 16 pngs serially") { serial(); };
+    BENCHMARK("decode 16 pngs across jobs") { parallel(); };
+}
+
+} // namespace muon::image
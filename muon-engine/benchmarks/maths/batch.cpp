@@ -0,0 +1,183 @@
+#include "muon/maths/batch.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "fmt/format.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace muon::maths {
+
+namespace {
+
+constexpr size_t COUNT = 4096;
+
+constexpr std::array<std::string_view, 4> LEVEL_NAMES{"scalar", "sse4", "avx2", "avx512"};
+
+struct Columns {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> w;
+
+    explicit Columns(size_t count) : x(count), y(count), z(count), w(count) {
+        for (size_t i = 0; i < count; i++) {
+            auto value = static_cast<float>(i);
+            x[i] = std::sin(value);
+            y[i] = std::cos(value * 0.5f);
+            z[i] = value * 0.01f;
+            w[i] = 1.0f + value * 0.001f;
+        }
+    }
+
+    auto vec3() -> Vec3Soa<float> { return {x, y, z}; }
+    auto vec4() -> Vec4Soa<float> { return {x, y, z, w}; }
+};
+
+auto make_matrix() -> glm::mat4 {
+    glm::mat4 matrix{1.0f};
+    matrix[0] = glm::vec4{0.8f, 0.6f, 0.0f, 0.0f};
+    matrix[1] = glm::vec4{-0.6f, 0.8f, 0.0f, 0.0f};
+    matrix[3] = glm::vec4{5.0f, -2.0f, 1.0f, 1.0f};
+    return matrix;
+}
+
+// benchmarks each kernel at every level the cpu supports
+template <typename Fn>
+void each_level(std::string_view kernel, Fn &&fn) {
+    for (auto level : {SimdLevel::Scalar, SimdLevel::Sse4, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (set_simd_level(level) != level) {
+            continue;
+        }
+        BENCHMARK(fmt::format("{} {}", kernel, LEVEL_NAMES[static_cast<size_t>(level)])) { return fn(); };
+    }
+    set_simd_level(supported_simd_level());
+}
+
+} // namespace
+
+TEST_CASE("batch maths", "[benchmark][maths]") {
+    auto matrix = make_matrix();
+    Columns input{COUNT};
+    Columns other{COUNT};
+    Columns output{COUNT};
+    std::vector<float> t(COUNT, 0.3f);
+    std::vector<glm::mat4> matrices(COUNT, matrix);
+
+    std::vector<glm::vec3> points(COUNT);
+    std::vector<glm::quat> from(COUNT);
+    std::vector<glm::quat> to(COUNT);
+    for (size_t i = 0; i < COUNT; i++) {
+        points[i] = {input.x[i], input.y[i], input.z[i]};
+        from[i] = glm::normalize(glm::quat{input.w[i], input.x[i], input.y[i], input.z[i]});
+        to[i] = glm::normalize(glm::quat{other.z[i], other.w[i], other.x[i], other.y[i]});
+    }
+    normalize(input.vec4(), input.vec4());
+    normalize(other.vec4(), other.vec4());
+
+    BENCHMARK("transform points glm") {
+        for (auto &point : points) {
+            point = glm::vec3{matrix * glm::vec4{point, 1.0f}};
+        }
+        return points[0].x;
+    };
+    each_level("transform points", [&] {
+        transform_points(matrix, input.vec3(), output.vec3());
+        return output.x[0];
+    });
+
+    BENCHMARK("transform points per matrix glm") {
+        for (size_t i = 0; i < COUNT; i++) {
+            points[i] = glm::vec3{matrices[i] * glm::vec4{points[i], 1.0f}};
+        }
+        return points[0].x;
+    };
+    each_level("transform points per matrix", [&] {
+        transform_points(matrices, input.vec3(), output.vec3());
+        return output.x[0];
+    });
+
+    BENCHMARK("normalize quats glm") {
+        for (auto &quat : from) {
+            quat = glm::normalize(quat);
+        }
+        return from[0].x;
+    };
+    each_level("normalize quats", [&] {
+        normalize(input.vec4(), output.vec4());
+        return output.x[0];
+    });
+
+    std::vector<glm::quat> blended(COUNT);
+    BENCHMARK("slerp glm") {
+        for (size_t i = 0; i < COUNT; i++) {
+            blended[i] = glm::slerp(from[i], to[i], t[i]);
+        }
+        return blended[0].x;
+    };
+    each_level("slerp", [&] {
+        slerp(input.vec4(), other.vec4(), t, output.vec4());
+        return output.x[0];
+    });
+
+    Columns max{COUNT};
+    Columns out_max{COUNT};
+    each_level("transform aabbs", [&] {
+        transform_aabbs(matrix, {input.vec3(), max.vec3()}, {output.vec3(), out_max.vec3()});
+        return output.x[0];
+    });
+
+    // a camera looking down the line of points the columns trace out, about half of them in view
+    Columns centres{COUNT};
+    Columns corners{COUNT};
+    for (size_t i = 0; i < COUNT; i++) {
+        corners.x[i] += centres.w[i];
+        corners.y[i] += centres.w[i];
+        corners.z[i] += centres.w[i];
+    }
+    auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 20.0f);
+    auto view = glm::lookAt(glm::vec3{0.0f, 0.0f, -1.0f}, glm::vec3{0.0f, 0.0f, 40.0f}, glm::vec3{0.0f, 1.0f, 0.0f});
+    auto frustum = Frustum::from_matrix(projection * view);
+    std::vector<uint32_t> visible;
+    visible.reserve(COUNT);
+
+    BENCHMARK("frustum cull spheres scalar overlaps") {
+        visible.clear();
+        for (size_t i = 0; i < COUNT; i++) {
+            if (frustum.overlaps(Sphere{{centres.x[i], centres.y[i], centres.z[i]}, centres.w[i]})) {
+                visible.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        return visible.size();
+    };
+    each_level("frustum cull spheres", [&] {
+        visible.clear();
+        frustum_cull(frustum, SphereSoa<const float>{centres.vec3(), centres.w}, visible);
+        return visible.size();
+    });
+
+    BENCHMARK("frustum cull aabbs scalar overlaps") {
+        visible.clear();
+        for (size_t i = 0; i < COUNT; i++) {
+            if (frustum.overlaps(Aabb{{centres.x[i], centres.y[i], centres.z[i]}, {corners.x[i], corners.y[i], corners.z[i]}})) {
+                visible.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        return visible.size();
+    };
+    each_level("frustum cull aabbs", [&] {
+        visible.clear();
+        frustum_cull(frustum, AabbSoa<const float>{centres.vec3(), corners.vec3()}, visible);
+        return visible.size();
+    });
+}
+
+} // namespace muon::maths
@@ -0,0 +1,112 @@
+#include "muon/scene/bvh.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "muon/job/system.hpp"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace muon::scene {
+
+namespace {
+
+constexpr size_t OBJECTS = 100'000;
+constexpr float WORLD = 1000.0f;
+
+auto make_boxes(std::mt19937 &random) -> std::vector<maths::Aabb> {
+    std::uniform_real_distribution<float> position{-WORLD, WORLD};
+    std::uniform_real_distribution<float> size{0.5f, 4.0f};
+    std::vector<maths::Aabb> boxes;
+    for (size_t i = 0; i < OBJECTS; i++) {
+        glm::vec3 center{position(random), position(random) * 0.05f, position(random)};
+        boxes.push_back(maths::Aabb::from_center(center, glm::vec3{size(random), size(random), size(random)}));
+    }
+    return boxes;
+}
+
+} // namespace
+
+TEST_CASE("bounding volume hierarchy", "[benchmark][scene]") {
+    std::mt19937 random{3};
+    auto boxes = make_boxes(random);
+    job::System jobs;
+
+    BENCHMARK("bulk build") {
+        Bvh bvh;
+        std::vector<ProxyId> proxies(boxes.size());
+        bvh.create(boxes, {}, proxies);
+        return bvh.height();
+    };
+
+    BENCHMARK("bulk build across workers") {
+        Bvh bvh;
+        std::vector<ProxyId> proxies(boxes.size());
+        bvh.create(boxes, {}, proxies, &jobs);
+        return bvh.height();
+    };
+
+    Bvh bvh;
+    std::vector<ProxyId> proxies(boxes.size());
+    bvh.create(boxes, {}, proxies, &jobs);
+
+    auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    auto view = glm::lookAt(glm::vec3{0.0f, 20.0f, 0.0f}, glm::vec3{1.0f, 19.8f, -0.3f}, glm::vec3{0.0f, 1.0f, 0.0f});
+    auto frustum = maths::Frustum::from_matrix(projection * view);
+
+    std::vector<ProxyId> visible;
+    BENCHMARK("frustum query") {
+        visible.clear();
+        bvh.query(frustum, visible);
+        return visible.size();
+    };
+
+    BENCHMARK("frustum brute force") {
+        visible.clear();
+        for (auto proxy : proxies) {
+            if (frustum.overlaps(bvh.bounds(proxy))) {
+                visible.push_back(proxy);
+            }
+        }
+        return visible.size();
+    };
+
+    std::vector<ProxyId> nearby;
+    size_t query = 0;
+    BENCHMARK("100 proximity queries") {
+        nearby.clear();
+        for (size_t i = 0; i < 100; i++) {
+            bvh.query(maths::Sphere{boxes[(query++ * 7919) % boxes.size()].center(), 25.0f}, nearby);
+        }
+        return nearby.size();
+    };
+
+    std::uniform_real_distribution<float> direction{-1.0f, 1.0f};
+    std::vector<maths::Ray> rays;
+    for (size_t i = 0; i < 1000; i++) {
+        rays.push_back({glm::vec3{0.0f, 10.0f, 0.0f}, glm::vec3{direction(random), direction(random) * 0.05f, direction(random)}});
+    }
+    BENCHMARK("1000 picking rays") {
+        size_t hits = 0;
+        for (const auto &ray : rays) {
+            hits += bvh.raycast(ray, 2.0f * WORLD) ? 1 : 0;
+        }
+        return hits;
+    };
+
+    // a thousand objects wander every frame, most stay within their margin
+    std::vector<ProxyId> moving{proxies.begin(), proxies.begin() + 1000};
+    std::vector<maths::Aabb> moved{boxes.begin(), boxes.begin() + 1000};
+    std::uniform_real_distribution<float> step{-0.05f, 0.05f};
+    BENCHMARK("move 1000 objects") {
+        for (auto &box : moved) {
+            glm::vec3 offset{step(random), 0.0f, step(random)};
+            box = {box.min + offset, box.max + offset};
+        }
+        return bvh.move(moving, moved);
+    };
+}
+
+} // namespace muon::scene
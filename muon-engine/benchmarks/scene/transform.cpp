@@ -0,0 +1,114 @@
+#include "muon/scene/transform.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "muon/job/system.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace muon::scene {
+
+namespace {
+
+// roughly a level: a few hundred objects with a hundred or so parts each, several levels deep
+constexpr size_t OBJECTS = 1000;
+constexpr size_t PARTS = 25;
+
+struct Scene {
+    TransformHierarchy hierarchy;
+    std::vector<Node> objects;
+    std::vector<Node> leaves;
+
+    Scene() {
+        auto root = hierarchy.create();
+        for (size_t i = 0; i < OBJECTS; i++) {
+            auto object = hierarchy.create(root, {glm::vec3{static_cast<float>(i), 0.0f, 0.0f}});
+            objects.push_back(object);
+            for (size_t j = 0; j < PARTS; j++) {
+                auto part = hierarchy.create(object, {glm::vec3{0.0f, static_cast<float>(j), 0.0f}});
+                auto joint = hierarchy.create(part);
+                auto tip = hierarchy.create(joint);
+                leaves.push_back(hierarchy.create(tip));
+            }
+        }
+        hierarchy.update();
+    }
+};
+
+// a node per allocation recomputing every world matrix every frame, as a baseline
+struct NaiveNode {
+    Transform local;
+    glm::mat4 world{1.0f};
+    std::vector<std::unique_ptr<NaiveNode>> children;
+
+    auto add(const Transform &transform) -> NaiveNode & {
+        children.push_back(std::make_unique<NaiveNode>());
+        children.back()->local = transform;
+        return *children.back();
+    }
+
+    void update(const glm::mat4 &parent) {
+        world = parent * glm::translate(glm::mat4{1.0f}, local.translation) * glm::mat4_cast(local.rotation) *
+                glm::scale(glm::mat4{1.0f}, local.scale);
+        for (auto &child : children) {
+            child->update(world);
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE("transform hierarchy", "[benchmark][scene]") {
+    Scene scene;
+    job::System jobs;
+
+    BENCHMARK("update static scene") { return scene.hierarchy.update(); };
+
+    size_t frame = 0;
+    BENCHMARK("update 100 moving leaves") {
+        for (size_t i = 0; i < 100; i++) {
+            auto leaf = scene.leaves[(frame * 100 + i) * 7 % scene.leaves.size()];
+            scene.hierarchy.set_translation(leaf, glm::vec3{static_cast<float>(frame), 0.0f, 0.0f});
+        }
+        frame++;
+        return scene.hierarchy.update();
+    };
+
+    BENCHMARK("update 100 moving objects") {
+        for (size_t i = 0; i < 100; i++) {
+            auto object = scene.objects[(frame * 100 + i) % scene.objects.size()];
+            scene.hierarchy.set_translation(object, glm::vec3{static_cast<float>(frame), 0.0f, 0.0f});
+        }
+        frame++;
+        return scene.hierarchy.update();
+    };
+
+    BENCHMARK("update everything") {
+        scene.hierarchy.set_translation(scene.objects[0], glm::vec3{static_cast<float>(frame++), 0.0f, 0.0f});
+        scene.hierarchy.set_scale(scene.hierarchy.parent(scene.objects[0]).value(), glm::vec3{1.0f});
+        return scene.hierarchy.update();
+    };
+
+    BENCHMARK("update everything in parallel") {
+        scene.hierarchy.set_scale(scene.hierarchy.parent(scene.objects[0]).value(), glm::vec3{1.0f});
+        return scene.hierarchy.update(&jobs);
+    };
+
+    NaiveNode naive;
+    for (size_t i = 0; i < OBJECTS; i++) {
+        auto &object = naive.add({glm::vec3{static_cast<float>(i), 0.0f, 0.0f}});
+        for (size_t j = 0; j < PARTS; j++) {
+            object.add({glm::vec3{0.0f, static_cast<float>(j), 0.0f}}).add({}).add({}).add({});
+        }
+    }
+    BENCHMARK("update naive tree") {
+        naive.update(glm::mat4{1.0f});
+        return naive.world[3].x;
+    };
+}
+
+} // namespace muon::scene
@@ -0,0 +1,199 @@
+#include "muon/serde/binary.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "nlohmann/json.hpp"
+#include "toml++/toml.hpp"
+
+#include <array>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace muon::serde {
+
+namespace {
+
+enum class Kind : uint8_t {
+    Empty,
+    Mesh,
+    Light,
+    Camera,
+};
+
+struct Entity {
+    Uuid id;
+    std::string name;
+    Kind kind;
+    std::array<float, 3> position;
+    std::array<float, 4> rotation;
+    std::array<float, 3> scale;
+    uint32_t parent;
+    std::vector<uint32_t> children;
+};
+
+struct Scene {
+    std::string name;
+    std::vector<Entity> entities;
+};
+
+constexpr uint32_t ENTITY_COUNT = 1000;
+
+auto make_scene() -> Scene {
+    Scene scene{.name = "benchmark", .entities = {}};
+    for (uint32_t i = 0; i < ENTITY_COUNT; i++) {
+        auto value = static_cast<float>(i);
+        scene.entities.push_back({
+            .id = Uuid::uuid4(),
+            .name = "entity " + std::to_string(i),
+            .kind = static_cast<Kind>(i % 4),
+            .position = {value, value * 0.5f, -value},
+            .rotation = {0.0f, 0.0f, 0.0f, 1.0f},
+            .scale = {1.0f, 1.0f, 1.0f},
+            .parent = i / 8,
+            .children = {i * 8, i * 8 + 1, i * 8 + 2},
+        });
+    }
+    return scene;
+}
+
+auto parse_uuid(std::string_view text) -> Uuid {
+    Uuid uuid;
+    size_t index = 0;
+    for (size_t i = 0; i + 1 < text.size() && index < uuid.size(); i++) {
+        if (text[i] == '-') {
+            continue;
+        }
+        auto digit = [](char c) { return static_cast<uint8_t>(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10); };
+        uuid.data()[index++] = static_cast<uint8_t>(digit(text[i]) << 4 | digit(text[i + 1]));
+        i++;
+    }
+    return uuid;
+}
+
+auto to_json(const Scene &scene) -> std::string {
+    auto entities = nlohmann::json::array();
+    for (const auto &entity : scene.entities) {
+        entities.push_back({
+            {"id", entity.id.to_string()},
+            {"name", entity.name},
+            {"kind", static_cast<uint8_t>(entity.kind)},
+            {"position", entity.position},
+            {"rotation", entity.rotation},
+            {"scale", entity.scale},
+            {"parent", entity.parent},
+            {"children", entity.children},
+        });
+    }
+    return nlohmann::json{{"name", scene.name}, {"entities", std::move(entities)}}.dump();
+}
+
+auto from_json(std::string_view text) -> Scene {
+    auto json = nlohmann::json::parse(text);
+    Scene scene{.name = json.at("name").get<std::string>(), .entities = {}};
+    for (const auto &entity : json.at("entities")) {
+        scene.entities.push_back({
+            .id = parse_uuid(entity.at("id").get<std::string>()),
+            .name = entity.at("name").get<std::string>(),
+            .kind = static_cast<Kind>(entity.at("kind").get<uint8_t>()),
+            .position = entity.at("position").get<std::array<float, 3>>(),
+            .rotation = entity.at("rotation").get<std::array<float, 4>>(),
+            .scale = entity.at("scale").get<std::array<float, 3>>(),
+            .parent = entity.at("parent").get<uint32_t>(),
+            .children = entity.at("children").get<std::vector<uint32_t>>(),
+        });
+    }
+    return scene;
+}
+
+template <typename T>
+auto to_toml_array(const T &values) -> toml::array {
+    toml::array array;
+    for (auto value : values) {
+        array.push_back(value);
+    }
+    return array;
+}
+
+template <typename T>
+void from_toml_array(const toml::node_view<const toml::node> &node, T &values) {
+    const auto *array = node.as_array();
+    for (size_t i = 0; array && i < values.size() && i < array->size(); i++) {
+        values[i] = (*array)[i].value_or(typename T::value_type{});
+    }
+}
+
+auto to_toml(const Scene &scene) -> std::string {
+    toml::array entities;
+    for (const auto &entity : scene.entities) {
+        entities.push_back(toml::table{
+            {"id", entity.id.to_string()},
+            {"name", entity.name},
+            {"kind", static_cast<int64_t>(entity.kind)},
+            {"position", to_toml_array(entity.position)},
+            {"rotation", to_toml_array(entity.rotation)},
+            {"scale", to_toml_array(entity.scale)},
+            {"parent", static_cast<int64_t>(entity.parent)},
+            {"children", to_toml_array(entity.children)},
+        });
+    }
+
+    std::ostringstream stream;
+    stream << toml::table{{"name", scene.name}, {"entities", std::move(entities)}};
+    return stream.str();
+}
+
+auto from_toml(std::string_view text) -> Scene {
+    const toml::table table = toml::parse(text);
+    Scene scene{.name = table["name"].value_or(std::string{}), .entities = {}};
+    const auto *entities = table["entities"].as_array();
+    if (!entities) {
+        return scene;
+    }
+
+    for (const auto &node : *entities) {
+        const auto *entity = node.as_table();
+        if (!entity) {
+            continue;
+        }
+        auto &decoded = scene.entities.emplace_back();
+        decoded.id = parse_uuid((*entity)["id"].value_or(std::string_view{}));
+        decoded.name = (*entity)["name"].value_or(std::string{});
+        decoded.kind = static_cast<Kind>((*entity)["kind"].value_or(int64_t{0}));
+        from_toml_array((*entity)["position"], decoded.position);
+        from_toml_array((*entity)["rotation"], decoded.rotation);
+        from_toml_array((*entity)["scale"], decoded.scale);
+        decoded.parent = static_cast<uint32_t>((*entity)["parent"].value_or(int64_t{0}));
+        if (const auto *children = (*entity)["children"].as_array()) {
+            for (const auto &child : *children) {
+                decoded.children.push_back(static_cast<uint32_t>(child.value_or(int64_t{0})));
+            }
+        }
+    }
+    return scene;
+}
+
+} // namespace
+
+TEST_CASE("scene serialization", "[benchmark][serde]") {
+    auto scene = make_scene();
+    auto binary = to_binary(scene);
+    auto json = to_json(scene);
+    auto toml_text = to_toml(scene);
+
+    REQUIRE(from_binary<Scene>(binary)->entities.size() == ENTITY_COUNT);
+    REQUIRE(from_json(json).entities.size() == ENTITY_COUNT);
+    REQUIRE(from_toml(toml_text).entities.size() == ENTITY_COUNT);
+
+    BENCHMARK("binary serialize") { return to_binary(scene); };
+    BENCHMARK("json serialize") { return to_json(scene); };
+    BENCHMARK("toml serialize") { return to_toml(scene); };
+
+    BENCHMARK("binary deserialize") { return from_binary<Scene>(binary); };
+    BENCHMARK("json deserialize") { return from_json(json); };
+    BENCHMARK("toml deserialize") { return from_toml(toml_text); };
+}
+
+} // namespace muon::serde
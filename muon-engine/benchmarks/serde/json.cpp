@@ -0,0 +1,157 @@
+#include "muon/serde/json.hpp"
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "fmt/format.h"
+#include "nlohmann/json.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace muon::serde {
+
+namespace {
+
+enum class Kind : uint8_t {
+    Empty,
+    Mesh,
+    Light,
+    Camera,
+};
+
+struct Node {
+    static constexpr std::array JSON_FIELDS{"name", "kind", "position", "rotation", "children", "parent"};
+
+    std::string name;
+    Kind kind;
+    std::array<float, 3> position;
+    std::array<float, 4> rotation;
+    std::vector<uint32_t> children;
+    std::optional<uint32_t> parent;
+};
+
+struct Scene {
+    static constexpr std::array JSON_FIELDS{"name", "nodes"};
+
+    std::string name;
+    std::vector<Node> nodes;
+};
+
+constexpr uint32_t NODE_COUNT = 50'000;
+
+auto write_scene(const std::filesystem::path &path) -> uint64_t {
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file << R"({"name": "benchmark", "nodes": [)";
+    for (uint32_t i = 0; i < NODE_COUNT; i++) {
+        file << fmt::format(
+            R"({}{{"name": "node {}", "kind": "{}", "position": [{}, {}, {}], "rotation": [0, 0, 0, 1], )"
+            R"("children": [{}, {}, {}], "parent": {}}})",
+            i == 0 ? "" : ",", i, i % 2 == 0 ? "Mesh" : "Light", i * 0.5, i * 0.25, -static_cast<double>(i), i * 3 + 1,
+            i * 3 + 2, i * 3 + 3, i == 0 ? std::string{"null"} : std::to_string(i / 3)
+        );
+    }
+    file << "]}";
+    file.flush();
+    return static_cast<uint64_t>(file.tellp());
+}
+
+// converts a parsed document the way a hand written loader would
+auto from_document(const nlohmann::json &document) -> Scene {
+    Scene scene{.name = document.at("name").get<std::string>(), .nodes = {}};
+    for (const auto &node : document.at("nodes")) {
+        const auto &parent = node.at("parent");
+        scene.nodes.push_back({
+            .name = node.at("name").get<std::string>(),
+            .kind = node.at("kind").get<std::string>() == "Mesh" ? Kind::Mesh : Kind::Light,
+            .position = node.at("position").get<std::array<float, 3>>(),
+            .rotation = node.at("rotation").get<std::array<float, 4>>(),
+            .children = node.at("children").get<std::vector<uint32_t>>(),
+            .parent = parent.is_null() ? std::nullopt : std::optional{parent.get<uint32_t>()},
+        });
+    }
+    return scene;
+}
+
+#if defined(__linux__)
+// the high water mark is reset first so each measurement only sees its own peak
+void reset_peak_memory() {
+    std::ofstream{"/proc/self/clear_refs"} << "5";
+}
+
+auto peak_memory() -> uint64_t {
+    std::ifstream status{"/proc/self/status"};
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.starts_with("VmHWM:")) {
+            return std::stoull(line.substr(6)) * 1024;
+        }
+    }
+    return 0;
+}
+
+auto current_memory() -> uint64_t {
+    std::ifstream status{"/proc/self/status"};
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.starts_with("VmRSS:")) {
+            return std::stoull(line.substr(6)) * 1024;
+        }
+    }
+    return 0;
+}
+#else
+void reset_peak_memory() {}
+auto peak_memory() -> uint64_t { return 0; }
+auto current_memory() -> uint64_t { return 0; }
+#endif
+
+template <typename Fn>
+void report(const char *name, uint64_t size, Fn &&fn) {
+    reset_peak_memory();
+    auto baseline = current_memory();
+    auto start = std::chrono::steady_clock::now();
+    auto nodes = fn();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto peak = peak_memory();
+
+    constexpr double MEBIBYTE = 1024.0 * 1024.0;
+    fmt::println(
+        "{}: {} nodes, {:.1f} MiB/s, peak rss +{:.1f} MiB for a {:.1f} MiB document", name, nodes,
+        static_cast<double>(size) / MEBIBYTE / elapsed, static_cast<double>(peak - std::min(peak, baseline)) / MEBIBYTE,
+        static_cast<double>(size) / MEBIBYTE
+    );
+}
+
+} // namespace
+
+TEST_CASE("json scene ingestion", "[benchmark][serde]") {
+    auto path = std::filesystem::temp_directory_path() / "muon-benchmark-scene.json";
+    auto size = write_scene(path);
+
+    auto streamed = [&path] {
+        return deserialize<JsonFile, Scene, JsonDeserializeError>(JsonFile{path})->nodes.size();
+    };
+    auto document = [&path] {
+        std::ifstream file{path, std::ios::binary};
+        return from_document(nlohmann::json::parse(file)).nodes.size();
+    };
+
+    REQUIRE(streamed() == NODE_COUNT);
+    REQUIRE(document() == NODE_COUNT);
+
+    report("sax stream", size, streamed);
+    report("json document", size, document);
+
+    BENCHMARK("sax stream") { return streamed(); };
+    BENCHMARK("json document") { return document(); };
+
+    std::filesystem::remove(path);
+}
+
+} // namespace muon::serde
@@ -0,0 +1,81 @@
+#include "muon/async/frame_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace muon::async {
+
+namespace {
+
+constexpr size_t MIN_BLOCK_SHIFT = 6;
+constexpr size_t MAX_BLOCK_SHIFT = 12;
+constexpr size_t CLASS_COUNT = MAX_BLOCK_SHIFT - MIN_BLOCK_SHIFT + 1;
+constexpr size_t MAX_CACHED_BLOCKS = 256;
+
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+struct FreeList {
+    FreeBlock *head{nullptr};
+    size_t count{0};
+};
+
+struct ThreadCache {
+    std::array<FreeList, CLASS_COUNT> lists{};
+
+    ~ThreadCache() {
+        for (auto &list : lists) {
+            while (list.head) {
+                ::operator delete(std::exchange(list.head, list.head->next));
+            }
+        }
+    }
+};
+
+thread_local ThreadCache cache;
+
+auto size_class(size_t size) -> size_t {
+    size_t shift = std::bit_width(std::max(size, size_t{1} << MIN_BLOCK_SHIFT) - 1);
+    return shift - MIN_BLOCK_SHIFT;
+}
+
+} // namespace
+
+auto FramePool::allocate(size_t size) -> void * {
+    size_t index = size_class(size);
+    if (index >= CLASS_COUNT) {
+        return ::operator new(size);
+    }
+
+    FreeList &list = cache.lists[index];
+    if (list.head) {
+        list.count -= 1;
+        return std::exchange(list.head, list.head->next);
+    }
+
+    return ::operator new(size_t{1} << (index + MIN_BLOCK_SHIFT));
+}
+
+void FramePool::deallocate(void *pointer, size_t size) noexcept {
+    size_t index = size_class(size);
+    if (index >= CLASS_COUNT) {
+        ::operator delete(pointer);
+        return;
+    }
+
+    FreeList &list = cache.lists[index];
+    if (list.count >= MAX_CACHED_BLOCKS) {
+        ::operator delete(pointer);
+        return;
+    }
+
+    list.head = new (pointer) FreeBlock{list.head};
+    list.count += 1;
+}
+
+} // namespace muon::async
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+namespace muon::async {
+
+// recycles coroutine frames through per-thread free lists bucketed by size
+class FramePool {
+public:
+    static auto allocate(size_t size) -> void *;
+    static void deallocate(void *pointer, size_t size) noexcept;
+};
+
+} // namespace muon::async
@@ -0,0 +1,49 @@
+#include "muon/async/scheduler.hpp"
+
+#include "muon/core/log.hpp"
+
+#include <algorithm>
+
+namespace muon::async {
+
+Scheduler::Scheduler(job::System &jobs) : jobs_{jobs} {}
+
+Scheduler::~Scheduler() {
+    if (!tasks_.empty()) {
+        MU_LOG_DEBUG(Async, "destroying scheduler with {} unfinished tasks", tasks_.size());
+    }
+}
+
+void Scheduler::spawn(Task<void> task) {
+    if (task.done()) {
+        return;
+    }
+
+    auto &spawned = tasks_.emplace_back(std::move(task));
+    schedule(spawned.handle());
+}
+
+void Scheduler::tick() {
+    {
+        std::lock_guard lock{ready_mutex_};
+        std::swap(ready_, resuming_);
+    }
+
+    for (auto handle : resuming_) {
+        handle.resume();
+    }
+    resuming_.clear();
+
+    std::erase_if(tasks_, [](const Task<void> &task) { return task.done(); });
+}
+
+auto Scheduler::pending() const -> size_t { return tasks_.size(); }
+
+auto Scheduler::next_frame() -> NextFrame { return NextFrame{*this}; }
+
+void Scheduler::schedule(std::coroutine_handle<> handle) {
+    std::lock_guard lock{ready_mutex_};
+    ready_.emplace_back(handle);
+}
+
+} // namespace muon::async
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "muon/async/task.hpp"
+#include "muon/core/buffer.hpp"
+#include "muon/fs/fs.hpp"
+#include "muon/job/system.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <coroutine>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace muon::async {
+
+// resumes coroutines on the thread that calls tick, which is the main loop for the application's scheduler
+class Scheduler : utils::NoCopy, utils::NoMove {
+public:
+    explicit Scheduler(job::System &jobs);
+    ~Scheduler();
+
+    // takes ownership of the task and starts it on the next tick
+    void spawn(Task<void> task);
+
+    // resumes every coroutine that became ready before this call
+    void tick();
+
+    auto pending() const -> size_t;
+
+public: // awaitables
+    struct NextFrame {
+        Scheduler &scheduler;
+
+        auto await_ready() const noexcept -> bool { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const { scheduler.schedule(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    template <typename Fn>
+    struct Job {
+        using Result = std::invoke_result_t<Fn &>;
+        using Storage = std::conditional_t<std::is_void_v<Result>, std::monostate, Result>;
+
+        Scheduler &scheduler;
+        Fn fn;
+        std::optional<Storage> result{std::nullopt};
+
+        auto await_ready() const noexcept -> bool { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            scheduler.jobs_.submit([this, handle] {
+                if constexpr (std::is_void_v<Result>) {
+                    fn();
+                    result.emplace();
+                } else {
+                    result.emplace(fn());
+                }
+                scheduler.schedule(handle);
+            });
+        }
+
+        auto await_resume() -> Result {
+            if constexpr (!std::is_void_v<Result>) {
+                return std::move(*result);
+            }
+        }
+    };
+
+    // resumes the awaiting coroutine on the next tick
+    auto next_frame() -> NextFrame;
+
+    // runs `fn` on the job system and resumes the awaiting coroutine with its result on the next tick
+    template <typename Fn>
+    auto run_job(Fn fn) -> Job<Fn> {
+        return Job<Fn>{*this, std::move(fn)};
+    }
+
+    auto read_file(std::filesystem::path path) {
+        return run_job([path = std::move(path)] { return fs::read_file_binary(path); });
+    }
+
+    auto read_file_text(std::filesystem::path path) {
+        return run_job([path = std::move(path)] { return fs::read_file_text(path); });
+    }
+
+private:
+    // thread safe, the handle is resumed on the next tick
+    void schedule(std::coroutine_handle<> handle);
+
+private:
+    job::System &jobs_;
+
+    mutable std::mutex ready_mutex_;
+    std::vector<std::coroutine_handle<>> ready_{};
+    std::vector<std::coroutine_handle<>> resuming_{};
+
+    std::vector<Task<void>> tasks_{};
+};
+
+} // namespace muon::async
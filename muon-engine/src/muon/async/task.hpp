@@ -0,0 +1,159 @@
+#pragma once
+
+#include "muon/async/frame_pool.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace muon::async {
+
+template <typename T>
+class Task;
+
+class Scheduler;
+
+namespace internal {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation{nullptr};
+
+    struct FinalAwaiter {
+        auto await_ready() const noexcept -> bool { return false; }
+
+        template <typename Promise>
+        auto await_suspend(std::coroutine_handle<Promise> handle) const noexcept -> std::coroutine_handle<> {
+            if (auto continuation = handle.promise().continuation) {
+                return continuation;
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    auto initial_suspend() const noexcept -> std::suspend_always { return {}; }
+    auto final_suspend() const noexcept -> FinalAwaiter { return {}; }
+
+    // the engine does not use exceptions
+    void unhandled_exception() const noexcept { std::terminate(); }
+
+    static auto operator new(size_t size) -> void * { return FramePool::allocate(size); }
+    static void operator delete(void *pointer, size_t size) noexcept { FramePool::deallocate(pointer, size); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value{std::nullopt};
+
+    auto get_return_object() -> Task<T>;
+
+    template <typename U>
+    void return_value(U &&result) {
+        value.emplace(std::forward<U>(result));
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    auto get_return_object() -> Task<void>;
+
+    void return_void() const noexcept {}
+};
+
+} // namespace internal
+
+// lazily started coroutine, runs when awaited or spawned on a scheduler
+template <typename T = void>
+class [[nodiscard]] Task {
+public:
+    using promise_type = internal::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(Handle handle) noexcept : handle_{handle} {}
+
+    Task(const Task &) = delete;
+    auto operator=(const Task &) -> Task & = delete;
+
+    Task(Task &&other) noexcept : handle_{std::exchange(other.handle_, nullptr)} {}
+
+    auto operator=(Task &&other) noexcept -> Task & {
+        if (this != &other) {
+            destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task() { destroy(); }
+
+    auto done() const noexcept -> bool { return !handle_ || handle_.done(); }
+
+    // resumes the coroutine until its next suspension point, used to drive root tasks
+    void resume() {
+        if (!done()) {
+            handle_.resume();
+        }
+    }
+
+    auto result() -> std::add_lvalue_reference_t<T>
+        requires(!std::is_void_v<T>)
+    {
+        return *handle_.promise().value;
+    }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            Handle handle;
+
+            auto await_ready() const noexcept -> bool { return !handle || handle.done(); }
+
+            auto await_suspend(std::coroutine_handle<> continuation) noexcept -> std::coroutine_handle<> {
+                handle.promise().continuation = continuation;
+                return handle;
+            }
+
+            auto await_resume() -> T {
+                if constexpr (!std::is_void_v<T>) {
+                    return std::move(*handle.promise().value);
+                }
+            }
+        };
+
+        return Awaiter{handle_};
+    }
+
+private:
+    friend class Scheduler;
+
+    auto handle() const noexcept -> Handle { return handle_; }
+
+    void destroy() {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+private:
+    Handle handle_{nullptr};
+};
+
+namespace internal {
+
+template <typename T>
+auto Promise<T>::get_return_object() -> Task<T> {
+    return Task<T>{std::coroutine_handle<Promise<T>>::from_promise(*this)};
+}
+
+inline auto Promise<void>::get_return_object() -> Task<void> {
+    return Task<void>{std::coroutine_handle<Promise<void>>::from_promise(*this)};
+}
+
+} // namespace internal
+
+} // namespace muon::async
@@ -0,0 +1,496 @@
+#include "muon/compress/compress.hpp"
+
+#include "muon/core/expect.hpp"
+#include "zdict.h"
+#include "zlib.h"
+
+// needed for the total size of multi frame inputs, the library is always linked statically
+#define ZSTD_STATIC_LINKING_ONLY
+#include "zstd.h"
+#include "zstd_errors.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace muon::compress {
+
+namespace {
+
+// zlib counts in 32 bit integers on some platforms, larger inputs are fed in slices
+constexpr size_t ZLIB_SLICE = std::numeric_limits<uInt>::max();
+constexpr size_t ZLIB_CHUNK = 128 * 1024;
+
+// frame headers are untrusted, anything claiming more than this is streamed so memory only grows with the real output
+constexpr unsigned long long MAX_PREALLOCATED_SIZE = 256 * 1024 * 1024;
+
+// creating a context is far more expensive than compressing a small asset, each thread keeps one of each around
+struct ZstdContexts {
+    ZSTD_CCtx *compress{ZSTD_createCCtx()};
+    ZSTD_DCtx *decompress{ZSTD_createDCtx()};
+
+    ~ZstdContexts() {
+        ZSTD_freeCCtx(compress);
+        ZSTD_freeDCtx(decompress);
+    }
+};
+
+auto contexts() -> ZstdContexts & {
+    thread_local ZstdContexts contexts;
+    return contexts;
+}
+
+auto valid(const Options &options) -> bool {
+    if (options.codec == Codec::Zstd) {
+        return options.level >= ZSTD_minCLevel() && options.level <= ZSTD_maxCLevel();
+    }
+    return options.workers == 0 && options.level >= Z_DEFAULT_COMPRESSION && options.level <= Z_BEST_COMPRESSION;
+}
+
+auto zstd_error(size_t result) -> CompressError {
+    switch (ZSTD_getErrorCode(result)) {
+        case ZSTD_error_dstSize_tooSmall:
+            return CompressError::DestinationTooSmall;
+        case ZSTD_error_dictionary_wrong:
+        case ZSTD_error_dictionary_corrupted:
+            return CompressError::DictionaryMismatch;
+        case ZSTD_error_srcSize_wrong:
+            return CompressError::Truncated;
+        default:
+            return CompressError::CorruptData;
+    }
+}
+
+auto zstd_configure(ZSTD_CCtx *context, const Options &options) -> bool {
+    ZSTD_CCtx_reset(context, ZSTD_reset_session_and_parameters);
+    if (ZSTD_isError(ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, options.level))) {
+        return false;
+    }
+    // fails when the library was built without threading support
+    return options.workers == 0 ||
+           !ZSTD_isError(ZSTD_CCtx_setParameter(context, ZSTD_c_nbWorkers, static_cast<int>(options.workers)));
+}
+
+// frames written by a streaming compressor do not carry their size, those are decoded in chunks instead
+auto decompress_stream(Decompressor &decompressor, BufferView source) -> std::expected<Buffer, CompressError> {
+    std::vector<uint8_t> output;
+    auto result = decompressor.write(source, [&output](BufferView chunk) {
+        output.insert(output.end(), chunk.begin(), chunk.end());
+    });
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+    if (!decompressor.finished()) {
+        return std::unexpected(CompressError::Truncated);
+    }
+    return Buffer{output.data(), output.size()};
+}
+
+// the whole output up front for a frame that declares a believable size, nothing when it has to be streamed instead
+auto preallocate(unsigned long long size) -> std::optional<Buffer> {
+    if (size == ZSTD_CONTENTSIZE_UNKNOWN || size > MAX_PREALLOCATED_SIZE) {
+        return std::nullopt;
+    }
+    Buffer output{static_cast<size_t>(size)};
+    if (output.data() == nullptr && size > 0) {
+        return std::nullopt;
+    }
+    return output;
+}
+
+} // namespace
+
+struct Dictionary::Impl {
+    Buffer content;
+    int32_t level;
+    ZSTD_CDict *compress;
+    ZSTD_DDict *decompress;
+};
+
+Dictionary::Dictionary(BufferView content, int32_t level) : impl_{new Impl{Buffer{content.size()}, level, nullptr, nullptr}} {
+    std::memcpy(impl_->content.data(), content.data(), content.size());
+    impl_->compress = ZSTD_createCDict(content.data(), content.size(), level);
+    impl_->decompress = ZSTD_createDDict(content.data(), content.size());
+    core::expect(impl_->compress && impl_->decompress, "failed to digest compression dictionary");
+}
+
+Dictionary::Dictionary(Dictionary &&other) noexcept : impl_{std::exchange(other.impl_, nullptr)} {}
+
+Dictionary::~Dictionary() {
+    if (impl_) {
+        ZSTD_freeCDict(impl_->compress);
+        ZSTD_freeDDict(impl_->decompress);
+        delete impl_;
+    }
+}
+
+auto Dictionary::operator=(Dictionary &&other) noexcept -> Dictionary & {
+    if (this != &other) {
+        std::swap(impl_, other.impl_);
+    }
+    return *this;
+}
+
+auto Dictionary::content() const -> BufferView { return impl_->content; }
+
+auto Dictionary::id() const -> uint32_t {
+    return ZSTD_getDictID_fromDict(impl_->content.data(), impl_->content.size());
+}
+
+auto Dictionary::level() const -> int32_t { return impl_->level; }
+
+auto Dictionary::train(std::span<const BufferView> samples, size_t capacity, int32_t level)
+    -> std::expected<Dictionary, CompressError> {
+    std::vector<uint8_t> joined;
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto &sample : samples) {
+        joined.insert(joined.end(), sample.begin(), sample.end());
+        sizes.push_back(sample.size());
+    }
+
+    std::vector<uint8_t> content(capacity);
+    auto written = ZDICT_trainFromBuffer(
+        content.data(), content.size(), joined.data(), sizes.data(), static_cast<unsigned>(sizes.size())
+    );
+    if (ZDICT_isError(written)) {
+        return std::unexpected(CompressError::TrainingFailure);
+    }
+    return Dictionary{BufferView{content.data(), written}, level};
+}
+
+auto compress_bound(size_t size, Codec codec) -> size_t {
+    if (codec == Codec::Zstd) {
+        return ZSTD_compressBound(size);
+    }
+    return compressBound(static_cast<uLong>(size));
+}
+
+auto compress(BufferView source, const Options &options) -> std::expected<Buffer, CompressError> {
+    Buffer output{compress_bound(source.size(), options.codec)};
+    auto written = compress_into(source, {output.data(), output.size()}, options);
+    if (!written) {
+        return std::unexpected(written.error());
+    }
+    output.truncate(*written);
+    return output;
+}
+
+auto compress(BufferView source, const Dictionary &dictionary) -> std::expected<Buffer, CompressError> {
+    Buffer output{compress_bound(source.size())};
+    auto *context = contexts().compress;
+    ZSTD_CCtx_reset(context, ZSTD_reset_session_and_parameters);
+    auto written = ZSTD_compress_usingCDict(
+        context, output.data(), output.size(), source.data(), source.size(), dictionary.impl_->compress
+    );
+    if (ZSTD_isError(written)) {
+        return std::unexpected(CompressError::CompressionFailure);
+    }
+    output.truncate(written);
+    return output;
+}
+
+auto compress_into(BufferView source, std::span<uint8_t> destination, const Options &options)
+    -> std::expected<size_t, CompressError> {
+    if (!valid(options)) {
+        return std::unexpected(CompressError::InvalidOptions);
+    }
+
+    if (options.codec == Codec::Zstd) {
+        auto *context = contexts().compress;
+        if (!zstd_configure(context, options)) {
+            return std::unexpected(CompressError::InvalidOptions);
+        }
+        auto written = ZSTD_compress2(context, destination.data(), destination.size(), source.data(), source.size());
+        if (ZSTD_isError(written)) {
+            return std::unexpected(
+                ZSTD_getErrorCode(written) == ZSTD_error_dstSize_tooSmall ? CompressError::DestinationTooSmall
+                                                                          : CompressError::CompressionFailure
+            );
+        }
+        return written;
+    }
+
+    auto length = static_cast<uLongf>(destination.size());
+    auto result = compress2(destination.data(), &length, source.data(), static_cast<uLong>(source.size()), options.level);
+    if (result == Z_BUF_ERROR) {
+        return std::unexpected(CompressError::DestinationTooSmall);
+    }
+    if (result != Z_OK) {
+        return std::unexpected(CompressError::CompressionFailure);
+    }
+    return static_cast<size_t>(length);
+}
+
+auto decompress(BufferView source, Codec codec) -> std::expected<Buffer, CompressError> {
+    if (codec == Codec::Zstd) {
+        auto size = ZSTD_findDecompressedSize(source.data(), source.size());
+        if (size == ZSTD_CONTENTSIZE_ERROR) {
+            return std::unexpected(CompressError::CorruptData);
+        }
+        if (auto output = preallocate(size)) {
+            auto written = decompress_into(source, {output->data(), output->size()}, codec);
+            if (!written) {
+                return std::unexpected(written.error());
+            }
+            return std::move(*output);
+        }
+    }
+
+    Decompressor decompressor{codec};
+    return decompress_stream(decompressor, source);
+}
+
+auto decompress(BufferView source, const Dictionary &dictionary) -> std::expected<Buffer, CompressError> {
+    auto size = ZSTD_findDecompressedSize(source.data(), source.size());
+    if (size == ZSTD_CONTENTSIZE_ERROR) {
+        return std::unexpected(CompressError::CorruptData);
+    }
+    auto output = preallocate(size);
+    if (!output) {
+        Decompressor decompressor{dictionary};
+        return decompress_stream(decompressor, source);
+    }
+
+    auto written = decompress_into(source, {output->data(), output->size()}, dictionary);
+    if (!written) {
+        return std::unexpected(written.error());
+    }
+    return std::move(*output);
+}
+
+auto decompress_into(BufferView source, std::span<uint8_t> destination, Codec codec) -> std::expected<size_t, CompressError> {
+    if (codec == Codec::Zstd) {
+        auto *context = contexts().decompress;
+        ZSTD_DCtx_reset(context, ZSTD_reset_session_and_parameters);
+        auto written = ZSTD_decompressDCtx(context, destination.data(), destination.size(), source.data(), source.size());
+        if (ZSTD_isError(written)) {
+            return std::unexpected(zstd_error(written));
+        }
+        return written;
+    }
+
+    auto length = static_cast<uLongf>(destination.size());
+    auto consumed = static_cast<uLong>(source.size());
+    auto result = uncompress2(destination.data(), &length, source.data(), &consumed);
+    if (result == Z_BUF_ERROR) {
+        return std::unexpected(CompressError::DestinationTooSmall);
+    }
+    if (result != Z_OK) {
+        return std::unexpected(CompressError::CorruptData);
+    }
+    return static_cast<size_t>(length);
+}
+
+auto decompress_into(BufferView source, std::span<uint8_t> destination, const Dictionary &dictionary)
+    -> std::expected<size_t, CompressError> {
+    auto *context = contexts().decompress;
+    ZSTD_DCtx_reset(context, ZSTD_reset_session_and_parameters);
+    auto written = ZSTD_decompress_usingDDict(
+        context, destination.data(), destination.size(), source.data(), source.size(), dictionary.impl_->decompress
+    );
+    if (ZSTD_isError(written)) {
+        return std::unexpected(zstd_error(written));
+    }
+    return written;
+}
+
+struct Compressor::Impl {
+    Codec codec;
+    ZSTD_CCtx *zstd{nullptr};
+    z_stream zlib{};
+    std::vector<uint8_t> output{};
+
+    // runs deflate until it stops filling the whole output chunk, which means it wants more input
+    auto deflate_all(int flush, const Sink &sink) -> std::expected<void, CompressError> {
+        do {
+            zlib.next_out = output.data();
+            zlib.avail_out = static_cast<uInt>(output.size());
+            if (deflate(&zlib, flush) == Z_STREAM_ERROR) {
+                return std::unexpected(CompressError::CompressionFailure);
+            }
+            auto produced = output.size() - zlib.avail_out;
+            if (produced > 0) {
+                sink(BufferView{output.data(), produced});
+            }
+        } while (zlib.avail_out == 0);
+        return {};
+    }
+
+    auto zstd_stream(ZSTD_inBuffer &input, ZSTD_EndDirective directive, const Sink &sink)
+        -> std::expected<size_t, CompressError> {
+        ZSTD_outBuffer out{output.data(), output.size(), 0};
+        auto remaining = ZSTD_compressStream2(zstd, &out, &input, directive);
+        if (ZSTD_isError(remaining)) {
+            return std::unexpected(CompressError::CompressionFailure);
+        }
+        if (out.pos > 0) {
+            sink(BufferView{output.data(), out.pos});
+        }
+        return remaining;
+    }
+};
+
+Compressor::Compressor(const Options &options) : impl_{new Impl{.codec = options.codec}} {
+    core::expect(valid(options), "invalid compression options");
+
+    if (options.codec == Codec::Zstd) {
+        impl_->zstd = ZSTD_createCCtx();
+        impl_->output.resize(ZSTD_CStreamOutSize());
+        core::expect(zstd_configure(impl_->zstd, options), "invalid compression options");
+    } else {
+        impl_->output.resize(ZLIB_CHUNK);
+        core::expect(deflateInit(&impl_->zlib, options.level) == Z_OK, "failed to initialise deflate");
+    }
+}
+
+Compressor::Compressor(const Dictionary &dictionary) : impl_{new Impl{.codec = Codec::Zstd}} {
+    impl_->zstd = ZSTD_createCCtx();
+    impl_->output.resize(ZSTD_CStreamOutSize());
+    ZSTD_CCtx_refCDict(impl_->zstd, dictionary.impl_->compress);
+}
+
+Compressor::~Compressor() {
+    if (impl_->codec == Codec::Zstd) {
+        ZSTD_freeCCtx(impl_->zstd);
+    } else {
+        deflateEnd(&impl_->zlib);
+    }
+    delete impl_;
+}
+
+auto Compressor::write(BufferView input, const Sink &sink) -> std::expected<void, CompressError> {
+    if (impl_->codec == Codec::Zstd) {
+        ZSTD_inBuffer in{input.data(), input.size(), 0};
+        while (in.pos < in.size) {
+            auto result = impl_->zstd_stream(in, ZSTD_e_continue, sink);
+            if (!result) {
+                return std::unexpected(result.error());
+            }
+        }
+        return {};
+    }
+
+    for (size_t offset = 0; offset < input.size(); offset += ZLIB_SLICE) {
+        impl_->zlib.next_in = const_cast<Bytef *>(input.data() + offset);
+        impl_->zlib.avail_in = static_cast<uInt>(std::min(input.size() - offset, ZLIB_SLICE));
+        auto result = impl_->deflate_all(Z_NO_FLUSH, sink);
+        if (!result) {
+            return result;
+        }
+    }
+    return {};
+}
+
+auto Compressor::finish(const Sink &sink) -> std::expected<void, CompressError> {
+    if (impl_->codec == Codec::Zstd) {
+        ZSTD_inBuffer in{nullptr, 0, 0};
+        size_t remaining = 0;
+        do {
+            auto result = impl_->zstd_stream(in, ZSTD_e_end, sink);
+            if (!result) {
+                return std::unexpected(result.error());
+            }
+            remaining = *result;
+        } while (remaining != 0);
+        return {};
+    }
+
+    impl_->zlib.next_in = nullptr;
+    impl_->zlib.avail_in = 0;
+    auto result = impl_->deflate_all(Z_FINISH, sink);
+    deflateReset(&impl_->zlib);
+    return result;
+}
+
+struct Decompressor::Impl {
+    Codec codec;
+    ZSTD_DCtx *zstd{nullptr};
+    z_stream zlib{};
+    std::vector<uint8_t> output{};
+    bool finished{false};
+
+    auto write_zstd(BufferView input, const Sink &sink) -> std::expected<void, CompressError> {
+        ZSTD_inBuffer in{input.data(), input.size(), 0};
+        ZSTD_outBuffer out{};
+        // a full output chunk may leave decoded data behind in the context even once the input is used up
+        do {
+            out = {output.data(), output.size(), 0};
+            auto result = ZSTD_decompressStream(zstd, &out, &in);
+            if (ZSTD_isError(result)) {
+                return std::unexpected(zstd_error(result));
+            }
+            if (out.pos > 0) {
+                sink(BufferView{output.data(), out.pos});
+            }
+            finished = result == 0;
+        } while (in.pos < in.size || out.pos == out.size);
+        return {};
+    }
+
+    auto write_zlib(BufferView input, const Sink &sink) -> std::expected<void, CompressError> {
+        for (size_t offset = 0; offset < input.size(); offset += ZLIB_SLICE) {
+            zlib.next_in = const_cast<Bytef *>(input.data() + offset);
+            zlib.avail_in = static_cast<uInt>(std::min(input.size() - offset, ZLIB_SLICE));
+            do {
+                zlib.next_out = output.data();
+                zlib.avail_out = static_cast<uInt>(output.size());
+                auto result = inflate(&zlib, Z_NO_FLUSH);
+                if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+                    return std::unexpected(CompressError::CorruptData);
+                }
+                auto produced = output.size() - zlib.avail_out;
+                if (produced > 0) {
+                    sink(BufferView{output.data(), produced});
+                }
+                finished = result == Z_STREAM_END;
+                if (finished) {
+                    inflateReset(&zlib);
+                } else if (result == Z_BUF_ERROR) {
+                    break;
+                }
+            } while (zlib.avail_in > 0 || zlib.avail_out == 0);
+        }
+        return {};
+    }
+};
+
+Decompressor::Decompressor(Codec codec) : impl_{new Impl{.codec = codec}} {
+    if (codec == Codec::Zstd) {
+        impl_->zstd = ZSTD_createDCtx();
+        impl_->output.resize(ZSTD_DStreamOutSize());
+    } else {
+        impl_->output.resize(ZLIB_CHUNK);
+        core::expect(inflateInit(&impl_->zlib) == Z_OK, "failed to initialise inflate");
+    }
+}
+
+Decompressor::Decompressor(const Dictionary &dictionary) : Decompressor{Codec::Zstd} {
+    ZSTD_DCtx_refDDict(impl_->zstd, dictionary.impl_->decompress);
+}
+
+Decompressor::~Decompressor() {
+    if (impl_->codec == Codec::Zstd) {
+        ZSTD_freeDCtx(impl_->zstd);
+    } else {
+        inflateEnd(&impl_->zlib);
+    }
+    delete impl_;
+}
+
+auto Decompressor::write(BufferView input, const Sink &sink) -> std::expected<void, CompressError> {
+    if (input.size() == 0) {
+        return {};
+    }
+    if (impl_->codec == Codec::Zstd) {
+        return impl_->write_zstd(input, sink);
+    }
+    return impl_->write_zlib(input, sink);
+}
+
+auto Decompressor::finished() const -> bool { return impl_->finished; }
+
+} // namespace muon::compress
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "muon/core/buffer.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+
+namespace muon::compress {
+
+enum class Codec : uint8_t {
+    Zstd,
+    Zlib,
+};
+
+enum class CompressError {
+    InvalidOptions,
+    CompressionFailure,
+    CorruptData,
+    DestinationTooSmall,
+    DictionaryMismatch,
+    TrainingFailure,
+    Truncated,
+    InvalidSeekTable,
+    OutOfRange,
+};
+
+constexpr int32_t DEFAULT_ZSTD_LEVEL = 3;
+constexpr int32_t DEFAULT_ZLIB_LEVEL = 6;
+
+struct Options {
+    Codec codec{Codec::Zstd};
+    int32_t level{DEFAULT_ZSTD_LEVEL};
+    // zstd only, zero compresses on the calling thread, anything else splits the input across that many workers
+    uint32_t workers{0};
+};
+
+// trained on a set of small samples that share structure, pays off for many small assets where each payload on its
+// own is too short for the compressor to learn anything, zstd only
+class Dictionary : utils::NoCopy {
+public:
+    Dictionary(BufferView content, int32_t level = DEFAULT_ZSTD_LEVEL);
+    Dictionary(Dictionary &&other) noexcept;
+    ~Dictionary();
+
+    auto operator=(Dictionary &&other) noexcept -> Dictionary &;
+
+    auto content() const -> BufferView;
+    auto id() const -> uint32_t;
+    auto level() const -> int32_t;
+
+    static auto train(std::span<const BufferView> samples, size_t capacity = 112 * 1024, int32_t level = DEFAULT_ZSTD_LEVEL)
+        -> std::expected<Dictionary, CompressError>;
+
+private:
+    friend class Compressor;
+    friend class Decompressor;
+    friend auto compress(BufferView source, const Dictionary &dictionary) -> std::expected<Buffer, CompressError>;
+    friend auto decompress_into(BufferView source, std::span<uint8_t> destination, const Dictionary &dictionary)
+        -> std::expected<size_t, CompressError>;
+
+    struct Impl;
+    Impl *impl_;
+};
+
+auto compress_bound(size_t size, Codec codec = Codec::Zstd) -> size_t;
+
+auto compress(BufferView source, const Options &options = {}) -> std::expected<Buffer, CompressError>;
+auto compress(BufferView source, const Dictionary &dictionary) -> std::expected<Buffer, CompressError>;
+
+// writes into memory owned by the caller, returns the number of bytes used
+auto compress_into(BufferView source, std::span<uint8_t> destination, const Options &options = {})
+    -> std::expected<size_t, CompressError>;
+
+// zstd frames carry their decompressed size, zlib streams and zstd frames written by a streaming compressor without a
+// known size are grown as they decode
+auto decompress(BufferView source, Codec codec = Codec::Zstd) -> std::expected<Buffer, CompressError>;
+auto decompress(BufferView source, const Dictionary &dictionary) -> std::expected<Buffer, CompressError>;
+
+// the destination has to hold the whole output, nothing is allocated
+auto decompress_into(BufferView source, std::span<uint8_t> destination, Codec codec = Codec::Zstd)
+    -> std::expected<size_t, CompressError>;
+auto decompress_into(BufferView source, std::span<uint8_t> destination, const Dictionary &dictionary)
+    -> std::expected<size_t, CompressError>;
+
+// receives each chunk of output, the view is only valid for the duration of the call
+using Sink = std::function<void(BufferView)>;
+
+class Compressor : utils::NoCopy, utils::NoMove {
+public:
+    explicit Compressor(const Options &options = {});
+    explicit Compressor(const Dictionary &dictionary);
+    ~Compressor();
+
+    auto write(BufferView input, const Sink &sink) -> std::expected<void, CompressError>;
+
+    // ends the stream, the compressor can be written to again afterwards to start a new one
+    auto finish(const Sink &sink) -> std::expected<void, CompressError>;
+
+private:
+    struct Impl;
+    Impl *impl_;
+};
+
+class Decompressor : utils::NoCopy, utils::NoMove {
+public:
+    explicit Decompressor(Codec codec = Codec::Zstd);
+    explicit Decompressor(const Dictionary &dictionary);
+    ~Decompressor();
+
+    auto write(BufferView input, const Sink &sink) -> std::expected<void, CompressError>;
+
+    // true once the end of the stream has been decoded, more input starts a new one
+    auto finished() const -> bool;
+
+private:
+    struct Impl;
+    Impl *impl_;
+};
+
+} // namespace muon::compress
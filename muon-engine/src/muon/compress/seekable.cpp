@@ -0,0 +1,309 @@
+#include "muon/compress/seekable.hpp"
+
+#include "muon/core/expect.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+namespace muon::compress {
+
+namespace {
+
+constexpr size_t SKIPPABLE_HEADER_SIZE = 8;
+constexpr size_t ENTRY_SIZE = 8;
+constexpr size_t CHECKSUM_ENTRY_SIZE = 12;
+constexpr uint8_t CHECKSUM_FLAG = 0x80;
+constexpr uint8_t RESERVED_BITS = 0x7c;
+constexpr uint32_t MAX_FRAMES = 0x8000000;
+
+void write_u32(std::vector<uint8_t> &output, uint32_t value) {
+    for (size_t i = 0; i < 4; i++) {
+        output.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+auto read_u32(const uint8_t *data) -> uint32_t {
+    return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 | static_cast<uint32_t>(data[2]) << 16 |
+           static_cast<uint32_t>(data[3]) << 24;
+}
+
+} // namespace
+
+namespace internal {
+
+auto valid(const SeekableOptions &options) -> bool {
+    return options.frame_size > 0 && options.frame_size <= MAX_SEEKABLE_FRAME_SIZE;
+}
+
+void append_seek_table(std::vector<uint8_t> &output, std::span<const SeekEntry> entries) {
+    write_u32(output, SEEK_TABLE_FRAME_MAGIC);
+    write_u32(output, static_cast<uint32_t>(entries.size() * ENTRY_SIZE + SEEK_TABLE_FOOTER_SIZE));
+    for (const auto &entry : entries) {
+        write_u32(output, entry.compressed_size);
+        write_u32(output, entry.decompressed_size);
+    }
+    write_u32(output, static_cast<uint32_t>(entries.size()));
+    output.push_back(0);
+    write_u32(output, SEEK_TABLE_MAGIC);
+}
+
+} // namespace internal
+
+auto compress_seekable(BufferView source, const SeekableOptions &options, job::System *jobs)
+    -> std::expected<Buffer, CompressError> {
+    if (!internal::valid(options)) {
+        return std::unexpected(CompressError::InvalidOptions);
+    }
+
+    // every frame gets a worst case slot so they can all be compressed at once, then the slots are packed together
+    size_t count = (source.size() + options.frame_size - 1) / options.frame_size;
+    size_t slot = compress_bound(options.frame_size);
+    std::vector<uint8_t> scratch(count * slot);
+    std::vector<internal::SeekEntry> entries(count);
+    std::atomic<bool> failed{false};
+
+    auto compress_frames = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            size_t offset = i * options.frame_size;
+            size_t size = std::min(options.frame_size, source.size() - offset);
+            auto written = compress_into(
+                {source.data() + offset, size}, {scratch.data() + i * slot, slot}, {.codec = Codec::Zstd, .level = options.level}
+            );
+            if (!written) {
+                failed.store(true, std::memory_order_relaxed);
+                return;
+            }
+            entries[i] = {static_cast<uint32_t>(*written), static_cast<uint32_t>(size)};
+        }
+    };
+    if (jobs) {
+        jobs->parallel_for(count, 1, compress_frames);
+    } else {
+        compress_frames(0, count);
+    }
+    if (failed.load(std::memory_order_relaxed)) {
+        return std::unexpected(CompressError::CompressionFailure);
+    }
+
+    std::vector<uint8_t> output;
+    size_t packed = 0;
+    for (const auto &entry : entries) {
+        packed += entry.compressed_size;
+    }
+    output.reserve(packed + SKIPPABLE_HEADER_SIZE + count * ENTRY_SIZE + SEEK_TABLE_FOOTER_SIZE);
+    for (size_t i = 0; i < count; i++) {
+        output.insert(output.end(), scratch.begin() + i * slot, scratch.begin() + i * slot + entries[i].compressed_size);
+    }
+    internal::append_seek_table(output, entries);
+    return Buffer{output.data(), output.size()};
+}
+
+SeekableWriter::SeekableWriter(const SeekableOptions &options) : options_{options} {
+    core::expect(internal::valid(options), "invalid seekable compression options");
+    pending_.reserve(options_.frame_size);
+    compressed_.resize(compress_bound(options_.frame_size));
+}
+
+auto SeekableWriter::write(BufferView input, const Sink &sink) -> std::expected<void, CompressError> {
+    size_t consumed = 0;
+    while (consumed < input.size()) {
+        size_t take = std::min(options_.frame_size - pending_.size(), input.size() - consumed);
+        pending_.insert(pending_.end(), input.begin() + consumed, input.begin() + consumed + take);
+        consumed += take;
+
+        if (pending_.size() == options_.frame_size) {
+            auto result = flush_frame(sink);
+            if (!result) {
+                return result;
+            }
+        }
+    }
+    return {};
+}
+
+auto SeekableWriter::finish(const Sink &sink) -> std::expected<void, CompressError> {
+    if (!pending_.empty()) {
+        auto result = flush_frame(sink);
+        if (!result) {
+            return result;
+        }
+    }
+
+    std::vector<uint8_t> table;
+    internal::append_seek_table(table, entries_);
+    sink(BufferView{table.data(), table.size()});
+    entries_.clear();
+    return {};
+}
+
+auto SeekableWriter::flush_frame(const Sink &sink) -> std::expected<void, CompressError> {
+    auto written = compress_into(
+        {pending_.data(), pending_.size()}, compressed_, {.codec = Codec::Zstd, .level = options_.level}
+    );
+    if (!written) {
+        return std::unexpected(written.error());
+    }
+
+    sink(BufferView{compressed_.data(), *written});
+    entries_.push_back({static_cast<uint32_t>(*written), static_cast<uint32_t>(pending_.size())});
+    pending_.clear();
+    return {};
+}
+
+SeekableReader::SeekableReader(BufferView archive, std::vector<Frame> frames)
+    : archive_{archive}, frames_{std::move(frames)} {
+    if (!frames_.empty()) {
+        size_ = frames_.back().decompressed_offset + frames_.back().decompressed_size;
+    }
+}
+
+auto SeekableReader::open(BufferView archive) -> std::expected<SeekableReader, CompressError> {
+    if (archive.size() < SKIPPABLE_HEADER_SIZE + SEEK_TABLE_FOOTER_SIZE) {
+        return std::unexpected(CompressError::InvalidSeekTable);
+    }
+
+    const auto *footer = archive.data() + archive.size() - SEEK_TABLE_FOOTER_SIZE;
+    auto count = read_u32(footer);
+    auto descriptor = footer[4];
+    if (read_u32(footer + 5) != SEEK_TABLE_MAGIC || (descriptor & RESERVED_BITS) != 0 || count > MAX_FRAMES) {
+        return std::unexpected(CompressError::InvalidSeekTable);
+    }
+
+    size_t entry_size = (descriptor & CHECKSUM_FLAG) ? CHECKSUM_ENTRY_SIZE : ENTRY_SIZE;
+    size_t table_size = count * entry_size + SEEK_TABLE_FOOTER_SIZE;
+    if (archive.size() < table_size + SKIPPABLE_HEADER_SIZE) {
+        return std::unexpected(CompressError::InvalidSeekTable);
+    }
+
+    size_t frames_size = archive.size() - table_size - SKIPPABLE_HEADER_SIZE;
+    const auto *header = archive.data() + frames_size;
+    if (read_u32(header) != SEEK_TABLE_FRAME_MAGIC || read_u32(header + 4) != table_size) {
+        return std::unexpected(CompressError::InvalidSeekTable);
+    }
+
+    std::vector<Frame> frames;
+    frames.reserve(count);
+    uint64_t compressed_offset = 0;
+    uint64_t decompressed_offset = 0;
+    for (size_t i = 0; i < count; i++) {
+        const auto *entry = header + SKIPPABLE_HEADER_SIZE + i * entry_size;
+        Frame frame{compressed_offset, decompressed_offset, read_u32(entry), read_u32(entry + 4)};
+        compressed_offset += frame.compressed_size;
+        decompressed_offset += frame.decompressed_size;
+        frames.push_back(frame);
+    }
+    if (compressed_offset != frames_size) {
+        return std::unexpected(CompressError::InvalidSeekTable);
+    }
+
+    return SeekableReader{archive, std::move(frames)};
+}
+
+auto SeekableReader::size() const -> uint64_t { return size_; }
+
+auto SeekableReader::frame_count() const -> size_t { return frames_.size(); }
+
+auto SeekableReader::read(uint64_t offset, std::span<uint8_t> destination, job::System *jobs) const
+    -> std::expected<size_t, CompressError> {
+    if (offset > size_) {
+        return std::unexpected(CompressError::OutOfRange);
+    }
+
+    auto length = static_cast<size_t>(std::min<uint64_t>(destination.size(), size_ - offset));
+    if (length == 0) {
+        return 0;
+    }
+    destination = destination.first(length);
+
+    size_t first = frame_at(offset);
+    size_t last = frame_at(offset + length - 1);
+
+    std::atomic<bool> failed{false};
+    std::atomic<CompressError> error{CompressError::CorruptData};
+    auto read_frames = [&](size_t begin, size_t end) {
+        for (size_t i = first + begin; i < first + end; i++) {
+            auto result = read_frame(frames_[i], offset, destination);
+            if (!result && !failed.exchange(true, std::memory_order_relaxed)) {
+                error.store(result.error(), std::memory_order_relaxed);
+            }
+        }
+    };
+
+    size_t count = last - first + 1;
+    if (jobs && count > 1) {
+        jobs->parallel_for(count, 1, read_frames);
+    } else {
+        read_frames(0, count);
+    }
+
+    if (failed.load(std::memory_order_relaxed)) {
+        return std::unexpected(error.load(std::memory_order_relaxed));
+    }
+    return length;
+}
+
+auto SeekableReader::read(uint64_t offset, size_t size, job::System *jobs) const -> std::expected<Buffer, CompressError> {
+    if (offset > size_) {
+        return std::unexpected(CompressError::OutOfRange);
+    }
+
+    Buffer output{static_cast<size_t>(std::min<uint64_t>(size, size_ - offset))};
+    auto result = read(offset, {output.data(), output.size()}, jobs);
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+    return output;
+}
+
+auto SeekableReader::frame_at(uint64_t offset) const -> size_t {
+    auto frame = std::upper_bound(frames_.begin(), frames_.end(), offset, [](uint64_t offset, const Frame &frame) {
+        return offset < frame.decompressed_offset;
+    });
+    return static_cast<size_t>(frame - frames_.begin()) - 1;
+}
+
+// frames entirely inside the range decompress straight into the destination, only the ends need a copy
+auto SeekableReader::read_frame(const Frame &frame, uint64_t offset, std::span<uint8_t> destination) const
+    -> std::expected<void, CompressError> {
+    BufferView source{archive_.data() + frame.compressed_offset, frame.compressed_size};
+
+    uint64_t begin = std::max(offset, frame.decompressed_offset);
+    uint64_t end = std::min(offset + destination.size(), frame.decompressed_offset + frame.decompressed_size);
+    auto target = destination.subspan(static_cast<size_t>(begin - offset), static_cast<size_t>(end - begin));
+
+    if (begin == frame.decompressed_offset && end - begin == frame.decompressed_size) {
+        auto written = decompress_into(source, target);
+        if (!written) {
+            return std::unexpected(written.error());
+        }
+        if (*written != frame.decompressed_size) {
+            return std::unexpected(CompressError::CorruptData);
+        }
+        return {};
+    }
+
+    // the frame size comes from the seek table, so rather than trusting it for a scratch buffer the frame is streamed
+    // and only the requested part is kept
+    uint64_t position = frame.decompressed_offset;
+    Decompressor decompressor;
+    auto result = decompressor.write(source, [&](BufferView chunk) {
+        uint64_t chunk_begin = std::max(position, begin);
+        uint64_t chunk_end = std::min(position + chunk.size(), end);
+        if (chunk_begin < chunk_end) {
+            auto size = static_cast<size_t>(chunk_end - chunk_begin);
+            std::memcpy(target.data() + (chunk_begin - begin), chunk.data() + (chunk_begin - position), size);
+        }
+        position += chunk.size();
+    });
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+    if (!decompressor.finished() || position != frame.decompressed_offset + frame.decompressed_size) {
+        return std::unexpected(CompressError::CorruptData);
+    }
+    return {};
+}
+
+} // namespace muon::compress
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "muon/compress/compress.hpp"
+#include "muon/core/buffer.hpp"
+#include "muon/job/system.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <vector>
+
+namespace muon::compress {
+
+// the layout follows the zstd seekable format, independent frames followed by a skippable frame holding the jump
+// table, so plain zstd tools still decompress the whole archive
+constexpr uint32_t SEEK_TABLE_MAGIC = 0x8f92eab1;
+constexpr uint32_t SEEK_TABLE_FRAME_MAGIC = 0x184d2a5e;
+constexpr size_t SEEK_TABLE_FOOTER_SIZE = 9;
+constexpr size_t MAX_SEEKABLE_FRAME_SIZE = 1024 * 1024 * 1024;
+constexpr size_t DEFAULT_SEEKABLE_FRAME_SIZE = 256 * 1024;
+
+// smaller frames make reads of short ranges cheaper at the cost of ratio
+struct SeekableOptions {
+    int32_t level{DEFAULT_ZSTD_LEVEL};
+    size_t frame_size{DEFAULT_SEEKABLE_FRAME_SIZE};
+};
+
+namespace internal {
+
+struct SeekEntry {
+    uint32_t compressed_size;
+    uint32_t decompressed_size;
+};
+
+auto valid(const SeekableOptions &options) -> bool;
+void append_seek_table(std::vector<uint8_t> &output, std::span<const SeekEntry> entries);
+
+} // namespace internal
+
+// frames are compressed in parallel when a job system is given
+auto compress_seekable(BufferView source, const SeekableOptions &options = {}, job::System *jobs = nullptr)
+    -> std::expected<Buffer, CompressError>;
+
+// cuts the stream into frames as it fills up, suited to logs and replays that are written once and read back in
+// pieces later
+class SeekableWriter : utils::NoCopy, utils::NoMove {
+public:
+    explicit SeekableWriter(const SeekableOptions &options = {});
+
+    auto write(BufferView input, const Sink &sink) -> std::expected<void, CompressError>;
+
+    // compresses whatever is left and appends the jump table, the writer starts a new archive afterwards
+    auto finish(const Sink &sink) -> std::expected<void, CompressError>;
+
+private:
+    auto flush_frame(const Sink &sink) -> std::expected<void, CompressError>;
+
+private:
+    SeekableOptions options_;
+    std::vector<uint8_t> pending_;
+    std::vector<uint8_t> compressed_;
+    std::vector<internal::SeekEntry> entries_;
+};
+
+// reads any byte range of an archive by decompressing only the frames it touches, the archive memory has to outlive
+// the reader, a file mapped through utils::map_file_read works well
+class SeekableReader {
+public:
+    static auto open(BufferView archive) -> std::expected<SeekableReader, CompressError>;
+
+    auto size() const -> uint64_t;
+    auto frame_count() const -> size_t;
+
+    // returns the number of bytes read, which is short only at the end of the archive
+    auto read(uint64_t offset, std::span<uint8_t> destination, job::System *jobs = nullptr) const
+        -> std::expected<size_t, CompressError>;
+    auto read(uint64_t offset, size_t size, job::System *jobs = nullptr) const -> std::expected<Buffer, CompressError>;
+
+private:
+    struct Frame {
+        uint64_t compressed_offset;
+        uint64_t decompressed_offset;
+        uint32_t compressed_size;
+        uint32_t decompressed_size;
+    };
+
+    SeekableReader(BufferView archive, std::vector<Frame> frames);
+
+    auto frame_at(uint64_t offset) const -> size_t;
+    auto read_frame(const Frame &frame, uint64_t offset, std::span<uint8_t> destination) const
+        -> std::expected<void, CompressError>;
+
+private:
+    BufferView archive_;
+    std::vector<Frame> frames_;
+    uint64_t size_{0};
+};
+
+} // namespace muon::compress
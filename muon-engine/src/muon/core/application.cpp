@@ -1,27 +1,81 @@
 #include "muon/core/application.hpp"
 
+#include "argparse/argparse.hpp"
 #include "muon/core/expect.hpp"
+#include "muon/core/flight_recorder.hpp"
 #include "muon/core/log.hpp"
 #include "muon/core/types.hpp"
 #include "muon/core/window.hpp"
 #include "muon/event/dispatcher.hpp"
 #include "muon/event/event.hpp"
+#include "muon/profile/profiler.hpp"
 
+#include <exception>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace muon {
 
+constexpr size_t EVENT_QUEUE_CAPACITY = 4096;
+constexpr std::chrono::milliseconds EVENT_PUMP_TIMEOUT{10};
+
+auto parse_application_options(size_t count, char **arguments) -> ApplicationOptions {
+    argparse::ArgumentParser parser{"muon", "", argparse::default_arguments::none};
+    parser.add_argument("--headless").flag();
+    parser.add_argument("--frames").scan<'u', uint64_t>();
+    parser.add_argument("--event-thread").flag();
+
+    ApplicationOptions options;
+    try {
+        parser.parse_known_args(std::vector<std::string>{arguments, arguments + count});
+    } catch (const std::exception &error) {
+        core::error("failed to parse application options: {}", error.what());
+        return options;
+    }
+
+    options.headless = parser.get<bool>("--headless");
+    if (auto frames = parser.present<uint64_t>("--frames")) {
+        options.frame_limit = *frames;
+    }
+    if (parser.get<bool>("--event-thread")) {
+        options.threading = ThreadingModel::DedicatedEventThread;
+    }
+
+    return options;
+}
+
 Application::Application(
     std::string_view name,
     Extent2D extent,
     bool v_sync,
-    WindowMode mode
+    WindowMode mode,
+    const ApplicationOptions &options
 ) : name_{name} {
     core::expect(!instance_, "application already exists");
     instance_ = this;
 
+    frame_stats_ = std::make_unique<profile::FrameStats>(options.stats_window);
+    stats_log_interval_ = options.stats_log_interval;
+
+    jobs_ = std::make_unique<job::System>();
+    scheduler_ = std::make_unique<async::Scheduler>(*jobs_);
     dispatcher_ = std::make_unique<event::Dispatcher>();
-    window_ = std::make_unique<Window>(name_, extent, mode, *dispatcher_);
+
+    if (options.headless) {
+        synthetic_events_ = std::make_unique<SyntheticEventSource>(*dispatcher_, options.frame_limit);
+        event_source_ = synthetic_events_.get();
+        core::info("running headless");
+    } else {
+        window_ = std::make_unique<Window>(name_, extent, mode, *dispatcher_);
+        event_source_ = window_.get();
+
+        threading_ = options.threading;
+        if (threading_ == ThreadingModel::DedicatedEventThread) {
+            window_->use_event_queue(EVENT_QUEUE_CAPACITY);
+        }
+    }
 
     on_window_close_ = dispatcher_->subscribe<event::WindowQuit>([&](const auto &event) { running_ = false; });
 }
@@ -31,6 +85,7 @@ Application::~Application() {}
 void Application::push_layer(Layer *layer) {
     layer_stack_.push_layer(layer);
     layer->on_attach();
+    layer_graph_.build(layer_stack_);
 }
 
 void Application::run() {
@@ -38,16 +93,101 @@ void Application::run() {
 
     client::info("running {}", name_);
 
+    if (threading_ == ThreadingModel::SingleThreaded) {
+        frame_loop();
+        return;
+    }
+
+    // the OS only delivers window events to the main thread, so the layers move to their own thread instead
+    std::atomic<bool> updating{true};
+    std::jthread update_thread{[&] {
+        frame_loop();
+        updating = false;
+    }};
+
+    // keep pumping until the update thread is done, it may still be waiting on window calls marshalled to this thread
+    while (updating) {
+        window_->pump_events(EVENT_PUMP_TIMEOUT);
+    }
+}
+
+void Application::frame_loop() {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    auto frame_start = start;
+    auto last_stats_log = start;
+
     while (running_) {
-        window_->poll_events();
+        {
+            MU_PROFILE_ZONE("frame");
+
+            const auto poll_start = Clock::now();
+            {
+                MU_PROFILE_ZONE("poll_events");
+                event_source_->poll_events();
+            }
+
+            const auto update_start = Clock::now();
+            frame_stats_->poll_events.record(update_start - poll_start);
 
-        for (auto &layer : layer_stack_) {
-            layer->on_update();
+            {
+                MU_PROFILE_ZONE("tasks");
+                scheduler_->tick();
+            }
+
+            layer_graph_.execute(*jobs_);
+            frame_stats_->update.record(Clock::now() - update_start);
         }
+
+        MU_PROFILE_FRAME();
+
+        const auto frame_end = Clock::now();
+        delta_time_ = std::chrono::duration_cast<Duration>(frame_end - frame_start);
+        frame_stats_->frame.record(delta_time_);
+        frame_start = frame_end;
+        log::record_frame(frame_index_, delta_time_);
+        frame_index_ += 1;
+
+        if (stats_log_interval_.count() > 0 && frame_end - last_stats_log >= stats_log_interval_) {
+            log_frame_stats();
+            last_stats_log = frame_end;
+        }
+    }
+
+    if (is_headless() && frame_index_ > 0) {
+        const auto elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start);
+        core::info(
+            "ran {} frames in {:.2f} ms, {:.4f} ms per frame",
+            frame_index_, elapsed.count(), elapsed.count() / static_cast<double>(frame_index_)
+        );
+        log_frame_stats();
     }
 }
 
+void Application::log_frame_stats() const {
+    auto log = [](std::string_view label, const profile::RollingHistogram &histogram) {
+        const auto stats = histogram.percentiles();
+        auto ms = [](profile::Duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+        core::info(
+            "{} over {} frames: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+            label, stats.count, ms(stats.p50), ms(stats.p95), ms(stats.p99), ms(stats.max)
+        );
+    };
+
+    log("frame", frame_stats_->frame);
+    log("update", frame_stats_->update);
+    log("poll events", frame_stats_->poll_events);
+}
+
 auto Application::name() const -> std::string_view { return name_; }
+auto Application::jobs() -> job::System & { return *jobs_; }
+auto Application::scheduler() -> async::Scheduler & { return *scheduler_; }
+auto Application::is_headless() const -> bool { return synthetic_events_ != nullptr; }
+
+auto Application::frame_index() const -> uint64_t { return frame_index_; }
+auto Application::delta_time() const -> Duration { return delta_time_; }
+auto Application::frame_stats() const -> const profile::FrameStats & { return *frame_stats_; }
+
 auto Application::instance() -> Reference { return *instance_; }
 
 } // namespace muon
@@ -1,31 +1,66 @@
 #pragma once
 
+#include "muon/async/scheduler.hpp"
+#include "muon/core/event_source.hpp"
 #include "muon/core/layer.hpp"
+#include "muon/core/layer_graph.hpp"
 #include "muon/core/layer_stack.hpp"
+#include "muon/core/synthetic_event_source.hpp"
 #include "muon/core/types.hpp"
 #include "muon/utils/no_copy.hpp"
 #include "muon/utils/no_move.hpp"
 #include "muon/core/window.hpp"
 #include "muon/event/dispatcher.hpp"
+#include "muon/job/system.hpp"
+#include "muon/profile/frame_stats.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string_view>
 
 namespace muon {
 
+enum class ThreadingModel {
+    // OS events are polled on the thread that updates the layers
+    SingleThreaded,
+    // the main thread only pumps OS events into a queue, layers update on a dedicated thread
+    DedicatedEventThread,
+};
+
+struct ApplicationOptions {
+    // skips window creation and drives the layer stack from a synthetic event source
+    bool headless{false};
+    // quits after this many frames, only honored in headless mode
+    std::optional<uint64_t> frame_limit{std::nullopt};
+    // ignored in headless mode, there are no OS events to pump
+    ThreadingModel threading{ThreadingModel::SingleThreaded};
+    // number of most recent frames the frame statistics cover
+    size_t stats_window{1024};
+    // how often frame statistics are logged, zero disables logging
+    std::chrono::seconds stats_log_interval{10};
+};
+
+// understands `--headless`, `--frames <count>` and `--event-thread`, leaving other arguments to the client
+auto parse_application_options(size_t count, char **arguments) -> ApplicationOptions;
+
 class Application : utils::NoCopy, utils::NoMove {
 public:
     using Pointer = Application *;
     using ConstPointer = const Application *;
     using Reference = Application &;
     using ConstReference = const Application &;
+    using Duration = std::chrono::nanoseconds;
 
     Application(
         std::string_view name,
         Extent2D extent,
         bool v_sync,
-        WindowMode mode
+        WindowMode mode,
+        const ApplicationOptions &options = {}
     );
     virtual ~Application();
 
@@ -35,20 +70,49 @@ public:
 
 public:
     auto name() const -> std::string_view;
+    auto jobs() -> job::System &;
+    auto scheduler() -> async::Scheduler &;
+    auto is_headless() const -> bool;
+
+    auto frame_index() const -> uint64_t;
+    auto delta_time() const -> Duration;
+    auto frame_stats() const -> const profile::FrameStats &;
+
     static auto instance() -> Reference;
 
+private:
+    void frame_loop();
+    void log_frame_stats() const;
+
 protected:
     std::string name_;
 
     LayerStack layer_stack_;
+    LayerGraph layer_graph_;
+
+    // declared before the job system so that jobs still finishing during shutdown can reach it
+    std::unique_ptr<async::Scheduler> scheduler_{nullptr};
+    std::unique_ptr<job::System> jobs_{nullptr};
 
     std::unique_ptr<event::Dispatcher> dispatcher_{nullptr};
     event::Dispatcher::Handle on_window_close_{};
 
+    // null in headless mode
     std::unique_ptr<Window> window_{nullptr};
+    // null unless in headless mode
+    std::unique_ptr<SyntheticEventSource> synthetic_events_{nullptr};
+    EventSource *event_source_{nullptr};
+
+    ThreadingModel threading_{ThreadingModel::SingleThreaded};
 
     std::mutex run_mutex_;
-    bool running_{true};
+    std::atomic<bool> running_{true};
+
+    uint64_t frame_index_{0};
+    Duration delta_time_{0};
+
+    std::unique_ptr<profile::FrameStats> frame_stats_{nullptr};
+    std::chrono::seconds stats_log_interval_{0};
 
     static inline Pointer instance_{nullptr};
 };
@@ -0,0 +1,329 @@
+#include "muon/core/async_sink.hpp"
+
+#include "fmt/format.h"
+#include "muon/core/expect.hpp"
+#include "muon/utils/platform.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <exception>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace muon::log {
+
+namespace {
+
+constexpr auto WRITER_IDLE = std::chrono::milliseconds{1};
+constexpr size_t DATA_SIZE = AsyncSink::SLOT_SIZE - 16;
+constexpr size_t NAME_SIZE = 15;
+
+// the first slot of a record starts with this, the payload follows it across as many slots as it needs, the strings
+// behind the source location are string literals so only their pointers are kept
+struct RecordHeader {
+    spdlog::log_clock::time_point time;
+    size_t thread_id;
+    const char *file;
+    const char *function;
+    int32_t line;
+    spdlog::level::level_enum level;
+    uint32_t size;
+    uint8_t name_size;
+    std::array<char, NAME_SIZE> name;
+};
+static_assert(std::is_trivially_copyable_v<RecordHeader>);
+
+auto slots_needed(size_t payload_size) -> size_t { return (sizeof(RecordHeader) + payload_size + DATA_SIZE - 1) / DATA_SIZE; }
+
+} // namespace
+
+AsyncSink::AsyncSink(
+    std::vector<spdlog::sink_ptr> sinks,
+    size_t slot_count,
+    OverflowPolicy overflow,
+    std::chrono::milliseconds flush_interval
+)
+    : sinks_{std::move(sinks)}, capacity_{std::bit_ceil(std::max<size_t>(slot_count, 1))}, mask_{capacity_ - 1},
+      overflow_{overflow}, flush_interval_{flush_interval}, slots_{std::make_unique<Slot[]>(capacity_)} {
+    for (size_t i = 0; i < capacity_; i++) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    // the largest record fits the whole ring, the writer never allocates while it holds slots
+    scratch_.reserve(capacity_ * DATA_SIZE);
+}
+
+AsyncSink::~AsyncSink() { stop(); }
+
+void AsyncSink::log(const spdlog::details::log_msg &message) {
+    if (stopped_.load(std::memory_order_acquire)) {
+        write(message);
+        return;
+    }
+
+    auto count = slots_needed(message.payload.size());
+    if (count > capacity_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    while (!try_push(message, static_cast<uint32_t>(count))) {
+        if (overflow_ == OverflowPolicy::Drop) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (overflow_ == OverflowPolicy::Overwrite && try_pop([](uint64_t, uint32_t) {})) {
+            overwritten_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        // nothing will make room once the writer is gone
+        if (stopped_.load(std::memory_order_acquire)) {
+            write(message);
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void AsyncSink::flush() { request_flush(tail_.load(std::memory_order_acquire)); }
+
+void AsyncSink::set_pattern(const std::string &pattern) {
+    for (auto &sink : sinks_) {
+        sink->set_pattern(pattern);
+    }
+}
+
+void AsyncSink::set_formatter(std::unique_ptr<spdlog::formatter> formatter) {
+    for (auto &sink : sinks_) {
+        sink->set_formatter(formatter->clone());
+    }
+}
+
+void AsyncSink::start() {
+    core::expect(!writer_.joinable(), "async log writer already started");
+    writer_ = std::jthread{[this](std::stop_token stop) { run(stop); }};
+}
+
+void AsyncSink::stop() {
+    if (writer_.joinable() && writer_.get_id() != std::this_thread::get_id()) {
+        writer_.request_stop();
+        writer_.join();
+    }
+    stopped_.store(true, std::memory_order_release);
+
+    // records claimed before the producers saw the flag are still in the ring
+    write_pending();
+    report_lost();
+    flush_sinks();
+    flushed_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+auto AsyncSink::drain(std::chrono::nanoseconds timeout) noexcept -> bool {
+    // a crash on the writer thread itself cannot wait for it
+    if (writer_.get_id() == std::this_thread::get_id()) {
+        return false;
+    }
+
+    auto target = tail_.load(std::memory_order_acquire);
+    request_flush(target);
+
+    // steady_clock reads through clock_gettime, which is async signal safe
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (flushed_.load(std::memory_order_acquire) < target) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AsyncSink::request_flush(uint64_t position) noexcept {
+    auto target = flush_target_.load(std::memory_order_relaxed);
+    while (target < position && !flush_target_.compare_exchange_weak(target, position, std::memory_order_release)) {
+    }
+}
+
+auto AsyncSink::try_push(const spdlog::details::log_msg &message, uint32_t count) noexcept -> bool {
+    auto position = tail_.load(std::memory_order_relaxed);
+    while (true) {
+        // every slot the record needs has to be free in this lap, a slot still holding an older lap means it's full
+        int64_t difference = 0;
+        for (uint32_t i = 0; i < count && difference == 0; i++) {
+            auto sequence = slots_[(position + i) & mask_].sequence.load(std::memory_order_acquire);
+            difference = static_cast<int64_t>(sequence - (position + i));
+        }
+
+        if (difference < 0) {
+            return false;
+        }
+        if (difference > 0) {
+            position = tail_.load(std::memory_order_relaxed);
+        } else if (tail_.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    RecordHeader header{
+        .time = message.time,
+        .thread_id = message.thread_id,
+        .file = message.source.filename,
+        .function = message.source.funcname,
+        .line = message.source.line,
+        .level = message.level,
+        .size = static_cast<uint32_t>(message.payload.size()),
+        .name_size = static_cast<uint8_t>(std::min(message.logger_name.size(), NAME_SIZE)),
+        .name = {},
+    };
+    std::memcpy(header.name.data(), message.logger_name.data(), header.name_size);
+
+    copy_in(position, 0, &header, sizeof(header));
+    copy_in(position, sizeof(header), message.payload.data(), message.payload.size());
+
+    // the first slot is published last, the consumer takes the whole record once it sees that one
+    for (uint32_t i = count - 1; i > 0; i--) {
+        slots_[(position + i) & mask_].sequence.store(position + i + 1, std::memory_order_release);
+    }
+    auto &first = slots_[position & mask_];
+    first.count.store(count, std::memory_order_relaxed);
+    first.sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename Fn>
+auto AsyncSink::try_pop(Fn &&fn) noexcept -> bool {
+    auto position = head_.load(std::memory_order_relaxed);
+    while (true) {
+        auto &slot = slots_[position & mask_];
+        auto difference = static_cast<int64_t>(slot.sequence.load(std::memory_order_acquire) - (position + 1));
+        if (difference < 0) {
+            return false;
+        }
+        if (difference > 0) {
+            position = head_.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        auto count = slot.count.load(std::memory_order_relaxed);
+        if (head_.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+            fn(position, count);
+            for (uint32_t i = 0; i < count; i++) {
+                slots_[(position + i) & mask_].sequence.store(position + i + capacity_, std::memory_order_release);
+            }
+            return true;
+        }
+    }
+}
+
+void AsyncSink::copy_in(uint64_t position, size_t offset, const void *data, size_t size) noexcept {
+    auto *in = static_cast<const std::byte *>(data);
+    while (size > 0) {
+        auto &slot = slots_[(position + offset / DATA_SIZE) & mask_];
+        auto start = offset % DATA_SIZE;
+        auto length = std::min(size, DATA_SIZE - start);
+        std::memcpy(slot.data.data() + start, in, length);
+        in += length;
+        offset += length;
+        size -= length;
+    }
+}
+
+void AsyncSink::copy_out(uint64_t position, size_t offset, void *data, size_t size) const noexcept {
+    auto *out = static_cast<std::byte *>(data);
+    while (size > 0) {
+        const auto &slot = slots_[(position + offset / DATA_SIZE) & mask_];
+        auto start = offset % DATA_SIZE;
+        auto length = std::min(size, DATA_SIZE - start);
+        std::memcpy(out, slot.data.data() + start, length);
+        out += length;
+        offset += length;
+        size -= length;
+    }
+}
+
+void AsyncSink::run(std::stop_token stop) {
+    auto last_flush = std::chrono::steady_clock::now();
+    while (!stop.stop_requested()) {
+        auto written = write_pending();
+        // everything below this has been written, the producers may have moved on since
+        auto done = head_.load(std::memory_order_acquire);
+        report_lost();
+
+        auto flushed = flushed_.load(std::memory_order_relaxed);
+        auto requested = flush_target_.load(std::memory_order_acquire) > flushed && done > flushed;
+        auto now = std::chrono::steady_clock::now();
+        if (requested || now - last_flush >= flush_interval_) {
+            flush_sinks();
+            flushed_.store(done, std::memory_order_release);
+            last_flush = now;
+        }
+
+        if (written == 0) {
+            std::this_thread::sleep_for(WRITER_IDLE);
+        }
+    }
+}
+
+auto AsyncSink::write_pending() -> size_t {
+    size_t count = 0;
+    RecordHeader header;
+    auto copy = [&](uint64_t position, uint32_t) {
+        copy_out(position, 0, &header, sizeof(header));
+        scratch_.resize(header.size);
+        copy_out(position, sizeof(header), scratch_.data(), header.size);
+    };
+
+    while (try_pop(copy)) {
+        spdlog::details::log_msg message{
+            header.time,
+            spdlog::source_loc{header.file, header.line, header.function},
+            spdlog::string_view_t{header.name.data(), header.name_size},
+            header.level,
+            spdlog::string_view_t{scratch_.data(), scratch_.size()},
+        };
+        message.thread_id = header.thread_id;
+        write(message);
+        count += 1;
+    }
+    return count;
+}
+
+void AsyncSink::write(const spdlog::details::log_msg &message) {
+    for (auto &sink : sinks_) {
+        if (!sink->should_log(message.level)) {
+            continue;
+        }
+        try {
+            sink->log(message);
+        } catch (const std::exception &error) {
+            utils::write_error_output(fmt::format("async log sink failed: {}\n", error.what()));
+        }
+    }
+}
+
+void AsyncSink::report_lost() {
+    auto dropped = dropped_.exchange(0, std::memory_order_relaxed);
+    auto overwritten = overwritten_.exchange(0, std::memory_order_relaxed);
+
+    auto report = [this](const std::string &text) {
+        write(spdlog::details::log_msg{"MUON", spdlog::level::warn, spdlog::string_view_t{text.data(), text.size()}});
+    };
+    if (dropped > 0) {
+        report(fmt::format("async log dropped {} records, the queue was full", dropped));
+    }
+    if (overwritten > 0) {
+        report(fmt::format("async log overwrote the {} oldest records, the queue was full", overwritten));
+    }
+}
+
+void AsyncSink::flush_sinks() {
+    for (auto &sink : sinks_) {
+        try {
+            sink->flush();
+        } catch (const std::exception &error) {
+            utils::write_error_output(fmt::format("async log sink failed: {}\n", error.what()));
+        }
+    }
+}
+
+} // namespace muon::log
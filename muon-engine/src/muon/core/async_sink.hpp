@@ -0,0 +1,104 @@
+#pragma once
+
+#include "muon/core/log.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+#include "spdlog/sinks/sink.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace muon::log {
+
+// hands records from any thread to one writer thread through a preallocated lock-free ring of fixed size slots, a
+// record takes as many consecutive slots as it needs, every logger in async mode shares one of these as its only sink
+// and the writer passes the records on to the sinks that do the actual writing
+class AsyncSink final : public spdlog::sinks::sink, utils::NoCopy, utils::NoMove {
+public:
+    static constexpr size_t SLOT_SIZE = 128;
+
+    // the writer thread doesn't run until start, records queue up in the meantime
+    AsyncSink(
+        std::vector<spdlog::sink_ptr> sinks,
+        size_t slot_count,
+        OverflowPolicy overflow,
+        std::chrono::milliseconds flush_interval
+    );
+    ~AsyncSink() override;
+
+    void log(const spdlog::details::log_msg &message) override;
+    // asks the writer to flush once it has written everything queued so far, without waiting for it
+    void flush() override;
+    void set_pattern(const std::string &pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override;
+
+    void start();
+    // writes everything still queued, flushes the sinks and joins the writer, later records are written directly
+    void stop();
+
+    // only async signal safe work for the crash handlers, waits at most `timeout` for the writer to write and flush
+    // every record claimed so far, a record the crashing thread was in the middle of writing is never published, so
+    // this can only be bounded, returns whether everything made it out
+    auto drain(std::chrono::nanoseconds timeout) noexcept -> bool;
+
+    auto capacity() const noexcept -> size_t { return capacity_; }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence{0};
+        // how many slots the record starting here spans, only read from the first one
+        std::atomic<uint32_t> count{0};
+        std::array<std::byte, SLOT_SIZE - 16> data{};
+    };
+    static_assert(sizeof(Slot) == SLOT_SIZE);
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<bool>::is_always_lock_free);
+
+    void request_flush(uint64_t position) noexcept;
+    auto try_push(const spdlog::details::log_msg &message, uint32_t count) noexcept -> bool;
+    // claims the oldest record and hands its position and slot count to fn before releasing the slots
+    template <typename Fn>
+    auto try_pop(Fn &&fn) noexcept -> bool;
+
+    void copy_in(uint64_t position, size_t offset, const void *data, size_t size) noexcept;
+    void copy_out(uint64_t position, size_t offset, void *data, size_t size) const noexcept;
+
+    void run(std::stop_token stop);
+    // writes until the ring is empty, returns how many records were written
+    auto write_pending() -> size_t;
+    void write(const spdlog::details::log_msg &message);
+    void report_lost();
+    void flush_sinks();
+
+    std::vector<spdlog::sink_ptr> sinks_;
+    size_t capacity_{0};
+    size_t mask_{0};
+    OverflowPolicy overflow_{OverflowPolicy::Block};
+    std::chrono::milliseconds flush_interval_{0};
+    std::unique_ptr<Slot[]> slots_{nullptr};
+
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    alignas(64) std::atomic<uint64_t> head_{0};
+
+    // everything below this position has been written and flushed
+    alignas(64) std::atomic<uint64_t> flushed_{0};
+    // flush() and the crash handlers ask for everything below this to be flushed
+    std::atomic<uint64_t> flush_target_{0};
+    std::atomic<bool> stopped_{false};
+
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> overwritten_{0};
+
+    // only touched by the writer
+    std::string scratch_;
+    std::jthread writer_;
+};
+
+} // namespace muon::log
@@ -1,12 +1,19 @@
 #include "muon/core/buffer.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <utility>
 
 namespace muon {
 
 Buffer::Buffer(SizeType size) noexcept : size_{size} { allocate(); }
 
+Buffer::Buffer(SizeType size, std::align_val_t alignment) noexcept
+    : size_{size}, alignment_{std::max(alignment, std::align_val_t{alignof(std::max_align_t)})} {
+    allocate();
+}
+
 Buffer::Buffer(Pointer data, SizeType size) noexcept : size_{size} {
     allocate();
     std::memcpy(data_, data, size_);
@@ -17,13 +24,37 @@ Buffer::Buffer(std::string_view text) noexcept : size_{text.size()} {
     std::memcpy(data_, text.data(), size_);
 }
 
-Buffer::Buffer(const Buffer &other) noexcept : size_{other.size()} {
+Buffer::Buffer(const Buffer &other) noexcept : size_{other.size()}, alignment_{other.alignment_} {
     allocate();
     std::memcpy(data_, other.data(), size_);
 }
 
+Buffer::Buffer(Buffer &&other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)}, alignment_{other.alignment_} {}
+
 Buffer::~Buffer() noexcept {
-    free(data_);
+    release();
+}
+
+auto Buffer::operator=(const Buffer &other) noexcept -> Buffer & {
+    if (this != &other) {
+        release();
+        size_ = other.size();
+        alignment_ = other.alignment_;
+        allocate();
+        std::memcpy(data_, other.data(), size_);
+    }
+    return *this;
+}
+
+auto Buffer::operator=(Buffer &&other) noexcept -> Buffer & {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        alignment_ = other.alignment_;
+    }
+    return *this;
 }
 
 auto Buffer::data() noexcept -> Pointer { return data_; }
@@ -37,10 +68,44 @@ auto Buffer::end() const noexcept -> ConstIterator { return data_ + size_; }
 
 auto Buffer::size() const noexcept -> SizeType { return size_; }
 
+auto Buffer::alignment() const noexcept -> SizeType { return static_cast<SizeType>(alignment_); }
+
+void Buffer::truncate(SizeType size) noexcept {
+    if (size >= size_) {
+        return;
+    }
+    if (over_aligned()) {
+        size_ = size;
+        return;
+    }
+    if (auto *data = static_cast<Pointer>(realloc(data_, size == 0 ? 1 : size))) {
+        data_ = data;
+    }
+    size_ = size;
+}
+
 void Buffer::allocate() {
-    data_ = static_cast<Pointer>(calloc(size_, sizeof(ValueType)));
+    if (!over_aligned()) {
+        data_ = static_cast<Pointer>(calloc(size_, sizeof(ValueType)));
+        return;
+    }
+    data_ = static_cast<Pointer>(::operator new(size_, alignment_, std::nothrow));
+    if (data_ != nullptr) {
+        std::memset(data_, 0, size_);
+    }
 }
 
+void Buffer::release() noexcept {
+    if (over_aligned()) {
+        ::operator delete(data_, alignment_);
+    } else {
+        free(data_);
+    }
+    data_ = nullptr;
+}
+
+auto Buffer::over_aligned() const noexcept -> bool { return alignment_ > std::align_val_t{alignof(std::max_align_t)}; }
+
 auto Buffer::operator==(const Buffer &rhs) const noexcept -> bool {
     if (size() != rhs.size()) {
         return false;
@@ -50,6 +115,8 @@ auto Buffer::operator==(const Buffer &rhs) const noexcept -> bool {
 
 BufferView::BufferView(const Buffer &buffer) noexcept : data_{buffer.data()}, size_{buffer.size()} {}
 
+BufferView::BufferView(ConstPointer data, SizeType size) noexcept : data_{data}, size_{size} {}
+
 BufferView::BufferView(const BufferView &other) noexcept : data_{other.data()}, size_{other.size()} {}
 
 auto BufferView::data() const noexcept -> ConstPointer { return data_; }
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <new>
 #include <string_view>
 
 namespace muon {
@@ -17,12 +18,18 @@ public:
 
     Buffer() = delete;
     Buffer(SizeType size) noexcept;
+    // alignments past what malloc guarantees have to be powers of two
+    Buffer(SizeType size, std::align_val_t alignment) noexcept;
     Buffer(Pointer data, SizeType size) noexcept;
     Buffer(std::string_view text) noexcept;
     Buffer(const Buffer &other) noexcept;
+    Buffer(Buffer &&other) noexcept;
 
     ~Buffer() noexcept;
 
+    auto operator=(const Buffer &other) noexcept -> Buffer &;
+    auto operator=(Buffer &&other) noexcept -> Buffer &;
+
     auto data() noexcept -> Pointer;
     auto data() const noexcept -> ConstPointer;
 
@@ -33,6 +40,11 @@ public:
     auto end() const noexcept -> ConstIterator;
 
     auto size() const noexcept -> SizeType;
+    auto alignment() const noexcept -> SizeType;
+
+    // drops everything past size, the allocation is shrunk in place where the allocator allows it, which over-aligned
+    // allocations never do
+    void truncate(SizeType size) noexcept;
 
     template <typename T>
     auto as() -> T * {
@@ -48,10 +60,13 @@ public:
 
 private:
     void allocate();
+    void release() noexcept;
+    auto over_aligned() const noexcept -> bool;
 
 private:
     Pointer data_{nullptr};
     SizeType size_{0};
+    std::align_val_t alignment_{alignof(std::max_align_t)};
 };
 
 
@@ -64,6 +79,7 @@ public:
 
     BufferView() = delete;
     BufferView(const Buffer &buffer) noexcept;
+    BufferView(ConstPointer data, SizeType size) noexcept;
     BufferView(const BufferView &other) noexcept;
 
     auto data() const noexcept -> ConstPointer;
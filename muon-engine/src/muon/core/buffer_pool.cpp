@@ -0,0 +1,74 @@
+#include "muon/core/buffer_pool.hpp"
+
+#include "muon/core/expect.hpp"
+#include "muon/maths/alignment.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace muon {
+
+namespace {
+
+constexpr size_t SMALLEST_CLASS = 64;
+
+} // namespace
+
+BufferPool::BufferPool(size_t alignment, size_t capacity) : alignment_{alignment}, capacity_{capacity} {
+    core::expect(maths::is_pow2(alignment), "buffer pool alignment has to be a power of two: {}", alignment);
+}
+
+auto BufferPool::acquire(size_t size) -> Buffer {
+    auto size_class = BufferPool::size_class(size);
+    {
+        std::scoped_lock lock{mutex_};
+        auto it = free_.find(size_class);
+        if (it != free_.end() && !it->second.empty()) {
+            auto buffer = std::move(it->second.back());
+            it->second.pop_back();
+            cached_ -= size_class;
+            return buffer;
+        }
+    }
+    return Buffer{size_class, std::align_val_t{alignment_}};
+}
+
+void BufferPool::release(Buffer buffer) {
+    if (buffer.data() == nullptr || buffer.size() != size_class(buffer.size()) || buffer.alignment() < alignment_) {
+        return;
+    }
+
+    std::scoped_lock lock{mutex_};
+    if (cached_ + buffer.size() > capacity_) {
+        return;
+    }
+    cached_ += buffer.size();
+    free_[buffer.size()].push_back(std::move(buffer));
+}
+
+void BufferPool::clear() {
+    std::map<size_t, std::vector<Buffer>> freed;
+    {
+        std::scoped_lock lock{mutex_};
+        freed.swap(free_);
+        cached_ = 0;
+    }
+}
+
+auto BufferPool::cached_bytes() const -> size_t {
+    std::scoped_lock lock{mutex_};
+    return cached_;
+}
+
+auto BufferPool::alignment() const -> size_t { return alignment_; }
+
+auto BufferPool::size_class(size_t size) -> size_t {
+    if (size <= SMALLEST_CLASS) {
+        return SMALLEST_CLASS;
+    }
+    auto step = std::max(std::bit_floor(size) / 8, SMALLEST_CLASS);
+    return maths::align(size, step);
+}
+
+} // namespace muon
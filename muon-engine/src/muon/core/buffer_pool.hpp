@@ -0,0 +1,48 @@
+#pragma once
+
+#include "muon/core/buffer.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace muon {
+
+// recycles aligned buffers for work that allocates and frees similar sizes over and over, like decoded images or
+// staging memory, sizes are rounded up to a class so that nearby sizes share buffers, safe to use from any thread
+class BufferPool : utils::NoCopy, utils::NoMove {
+public:
+    static constexpr size_t DEFAULT_ALIGNMENT = 64;
+
+    // at most capacity bytes are kept around, anything released past that is freed
+    explicit BufferPool(size_t alignment = DEFAULT_ALIGNMENT, size_t capacity = 256 * 1024 * 1024);
+
+    // the buffer's size is the class the request falls into, at least size, and recycled buffers keep whatever their
+    // last user left in them
+    auto acquire(size_t size) -> Buffer;
+
+    // buffers that didn't come from the pool are taken as long as their size is a class and they are aligned enough
+    void release(Buffer buffer);
+
+    // frees everything kept around
+    void clear();
+
+    auto cached_bytes() const -> size_t;
+    auto alignment() const -> size_t;
+
+    // eight classes per power of two, so at most an eighth is wasted
+    static auto size_class(size_t size) -> size_t;
+
+private:
+    size_t alignment_;
+    size_t capacity_;
+
+    mutable std::mutex mutex_;
+    std::map<size_t, std::vector<Buffer>> free_;
+    size_t cached_{0};
+};
+
+} // namespace muon
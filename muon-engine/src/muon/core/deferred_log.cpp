@@ -0,0 +1,472 @@
+#include "muon/core/deferred_log.hpp"
+
+#include "fmt/args.h"
+#include "muon/core/expect.hpp"
+#include "spdlog/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace muon::log {
+
+namespace {
+
+using internal::RecordHeader;
+using internal::ThreadBuffer;
+
+constexpr auto WRITER_IDLE = std::chrono::milliseconds{1};
+
+struct DeferredLog {
+    std::atomic<bool> enabled{false};
+    DeferredOutput output{DeferredOutput::Off};
+    std::filesystem::path path;
+    size_t buffer_size{0};
+    std::chrono::seconds flush_interval{1};
+
+    std::mutex threads_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> threads;
+
+    std::mutex formats_mutex;
+    std::deque<Format> formats;
+
+    std::jthread writer;
+};
+
+auto deferred() -> DeferredLog & {
+    static DeferredLog instance;
+    return instance;
+}
+
+auto thread_buffer() -> ThreadBuffer & {
+    thread_local ThreadBuffer *buffer = [] {
+        auto &state = deferred();
+        std::lock_guard lock{state.threads_mutex};
+        auto id = static_cast<uint32_t>(state.threads.size());
+        return state.threads.emplace_back(std::make_unique<ThreadBuffer>(id, state.buffer_size)).get();
+    }();
+    return *buffer;
+}
+
+template <typename T>
+void write_value(std::ofstream &file, const T &value) {
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void write_string(std::ofstream &file, std::string_view text) {
+    write_value(file, static_cast<uint32_t>(text.size()));
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+class Writer {
+public:
+    explicit Writer(DeferredLog &state) : state_{state} {}
+
+    auto open() -> bool {
+        if (state_.output != DeferredOutput::Binary) {
+            return true;
+        }
+
+        file_.open(state_.path, std::ios::binary | std::ios::trunc);
+        if (!file_) {
+            core::error("failed to open deferred log output: {}", state_.path.string());
+            return false;
+        }
+        file_.write(BINARY_MAGIC.data(), BINARY_MAGIC.size());
+        write_value(file_, BINARY_VERSION);
+        return true;
+    }
+
+    void run(std::stop_token stop) {
+        auto last_flush = std::chrono::steady_clock::now();
+        while (!stop.stop_requested()) {
+            if (drain() == 0) {
+                std::this_thread::sleep_for(WRITER_IDLE);
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now - last_flush >= state_.flush_interval) {
+                flush();
+                last_flush = now;
+            }
+        }
+
+        drain();
+        flush();
+    }
+
+private:
+    auto drain() -> size_t {
+        std::vector<ThreadBuffer *> buffers;
+        {
+            std::lock_guard lock{state_.threads_mutex};
+            for (auto &buffer : state_.threads) {
+                buffers.push_back(buffer.get());
+            }
+        }
+
+        size_t count = 0;
+        uint64_t dropped = 0;
+        for (auto *buffer : buffers) {
+            count += buffer->consume([&](const RecordHeader &header, std::span<const std::byte> payload) {
+                write(buffer->id(), header, payload);
+            });
+            dropped += buffer->take_dropped();
+        }
+
+        if (dropped > 0) {
+            if (state_.output == DeferredOutput::Binary) {
+                write_value(file_, BinaryEntry::Dropped);
+                write_value(file_, dropped);
+            } else {
+                core::warn("deferred log dropped {} records, thread buffers were full", dropped);
+            }
+        }
+
+        return count;
+    }
+
+    void write(uint32_t thread, const RecordHeader &header, std::span<const std::byte> payload) {
+        const auto &format = lookup(header.format);
+
+        if (state_.output == DeferredOutput::Text) {
+            auto time = std::chrono::system_clock::time_point{
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds{header.time})
+            };
+            spdlog::source_loc location{format.file.c_str(), static_cast<int>(format.line), ""};
+            internal::core_logger->log(time, location, format.level, format_record(format, payload));
+            return;
+        }
+
+        if (!written_[header.format - 1]) {
+            write_value(file_, BinaryEntry::Format);
+            write_value(file_, format.id);
+            write_value(file_, static_cast<uint8_t>(format.level));
+            write_value(file_, format.line);
+            write_string(file_, format.file);
+            write_string(file_, format.format);
+            write_value(file_, static_cast<uint32_t>(format.args.size()));
+            file_.write(reinterpret_cast<const char *>(format.args.data()), static_cast<std::streamsize>(format.args.size()));
+            written_[header.format - 1] = true;
+        }
+
+        write_value(file_, BinaryEntry::Record);
+        write_value(file_, header.format);
+        write_value(file_, thread);
+        write_value(file_, header.time);
+        write_value(file_, header.size);
+        file_.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    }
+
+    auto lookup(uint32_t id) -> const Format & {
+        if (id > formats_.size()) {
+            std::lock_guard lock{state_.formats_mutex};
+            for (auto i = formats_.size(); i < state_.formats.size(); i++) {
+                formats_.push_back(&state_.formats[i]);
+            }
+            written_.resize(formats_.size(), false);
+        }
+        return *formats_[id - 1];
+    }
+
+    void flush() {
+        if (state_.output == DeferredOutput::Binary) {
+            file_.flush();
+        } else {
+            internal::core_logger->flush();
+        }
+    }
+
+    DeferredLog &state_;
+    std::ofstream file_;
+    std::vector<const Format *> formats_;
+    std::vector<bool> written_;
+};
+
+class Reader {
+public:
+    explicit Reader(std::span<const std::byte> payload) : payload_{payload} {}
+
+    template <typename T>
+    auto read(T &value) -> bool {
+        if (offset_ + sizeof(T) > payload_.size()) {
+            return false;
+        }
+        std::memcpy(&value, payload_.data() + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return true;
+    }
+
+    auto read(std::string &text) -> bool {
+        std::span<const std::byte> bytes;
+        uint32_t size;
+        if (!read(size) || !read(bytes, size)) {
+            return false;
+        }
+        text.assign(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+        return true;
+    }
+
+    auto read(std::span<const std::byte> &bytes, size_t size) -> bool {
+        if (size > payload_.size() - offset_) {
+            return false;
+        }
+        bytes = payload_.subspan(offset_, size);
+        offset_ += size;
+        return true;
+    }
+
+    auto done() const -> bool { return offset_ == payload_.size(); }
+
+private:
+    std::span<const std::byte> payload_;
+    size_t offset_{0};
+};
+
+template <typename T>
+auto push(Reader &reader, fmt::dynamic_format_arg_store<fmt::format_context> &store) -> bool {
+    T value{};
+    if (!reader.read(value)) {
+        return false;
+    }
+    store.push_back(value);
+    return true;
+}
+
+auto read_format(Reader &reader, Format &format) -> bool {
+    uint8_t level;
+    uint32_t arg_count;
+    std::span<const std::byte> args;
+    if (!reader.read(format.id) || !reader.read(level) || !reader.read(format.line) || !reader.read(format.file) ||
+        !reader.read(format.format) || !reader.read(arg_count) || !reader.read(args, arg_count)) {
+        return false;
+    }
+
+    format.level = static_cast<spdlog::level::level_enum>(level);
+    format.args.resize(arg_count);
+    std::memcpy(format.args.data(), args.data(), arg_count);
+    return true;
+}
+
+} // namespace
+
+auto format_record(const Format &format, std::span<const std::byte> payload) -> std::string {
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    Reader reader{payload};
+
+    for (auto type : format.args) {
+        bool ok = false;
+        switch (type) {
+            case ArgType::Bool: {
+                uint8_t value{0};
+                ok = reader.read(value);
+                store.push_back(value != 0);
+                break;
+            }
+            case ArgType::Char: {
+                uint8_t value{0};
+                ok = reader.read(value);
+                store.push_back(static_cast<char>(value));
+                break;
+            }
+            case ArgType::I32:
+                ok = push<int32_t>(reader, store);
+                break;
+            case ArgType::U32:
+                ok = push<uint32_t>(reader, store);
+                break;
+            case ArgType::I64:
+                ok = push<int64_t>(reader, store);
+                break;
+            case ArgType::U64:
+                ok = push<uint64_t>(reader, store);
+                break;
+            case ArgType::F32:
+                ok = push<float>(reader, store);
+                break;
+            case ArgType::F64:
+                ok = push<double>(reader, store);
+                break;
+            case ArgType::Pointer: {
+                uint64_t value{0};
+                ok = reader.read(value);
+                store.push_back(reinterpret_cast<const void *>(static_cast<uintptr_t>(value)));
+                break;
+            }
+            case ArgType::String:
+                ok = push<std::string>(reader, store);
+                break;
+        }
+
+        if (!ok) {
+            return fmt::format("{} [truncated record]", format.format);
+        }
+    }
+
+    try {
+        return fmt::vformat(format.format, store);
+    } catch (const fmt::format_error &error) {
+        return fmt::format("{} [{}]", format.format, error.what());
+    }
+}
+
+auto read_binary_log(const std::filesystem::path &path) -> std::expected<BinaryLog, BinaryLogError> {
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+        return std::unexpected(BinaryLogError::FileOpenFailure);
+    }
+    std::vector<char> contents{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    Reader reader{std::as_bytes(std::span{contents})};
+
+    std::array<char, 8> magic;
+    uint32_t version;
+    if (!reader.read(magic) || magic != BINARY_MAGIC) {
+        return std::unexpected(BinaryLogError::InvalidFormat);
+    }
+    if (!reader.read(version) || version != BINARY_VERSION) {
+        return std::unexpected(BinaryLogError::UnsupportedVersion);
+    }
+
+    BinaryLog log;
+    std::unordered_map<uint32_t, Format> formats;
+    while (!reader.done()) {
+        BinaryEntry entry;
+        if (!reader.read(entry)) {
+            log.truncated = true;
+            break;
+        }
+
+        switch (entry) {
+            case BinaryEntry::Format: {
+                Format format;
+                if (!read_format(reader, format)) {
+                    log.truncated = true;
+                    return log;
+                }
+                formats.insert_or_assign(format.id, std::move(format));
+                break;
+            }
+
+            case BinaryEntry::Record: {
+                uint32_t id;
+                BinaryRecord record;
+                uint32_t size;
+                std::span<const std::byte> payload;
+                if (!reader.read(id) || !reader.read(record.thread) || !reader.read(record.time) || !reader.read(size) ||
+                    !reader.read(payload, size)) {
+                    log.truncated = true;
+                    return log;
+                }
+
+                // the writer always describes a format before its first record
+                auto format = formats.find(id);
+                if (format == formats.end()) {
+                    return std::unexpected(BinaryLogError::InvalidFormat);
+                }
+                record.level = format->second.level;
+                record.file = format->second.file;
+                record.line = format->second.line;
+                record.text = format_record(format->second, payload);
+                log.records.push_back(std::move(record));
+                break;
+            }
+
+            case BinaryEntry::Dropped: {
+                uint64_t dropped;
+                if (!reader.read(dropped)) {
+                    log.truncated = true;
+                    return log;
+                }
+                log.dropped += dropped;
+                break;
+            }
+
+            default:
+                return std::unexpected(BinaryLogError::InvalidFormat);
+        }
+    }
+
+    return log;
+}
+
+namespace internal {
+
+auto register_format(const Site &site, std::span<const ArgType> args) -> uint32_t {
+    auto &state = deferred();
+    std::lock_guard lock{state.formats_mutex};
+    auto id = static_cast<uint32_t>(state.formats.size() + 1);
+    state.formats.push_back(Format{
+        .id = id,
+        .level = site.level,
+        .file = site.file,
+        .line = site.line,
+        .format = site.format,
+        .args = {args.begin(), args.end()},
+    });
+    return id;
+}
+
+auto deferred_enabled() noexcept -> bool { return deferred().enabled.load(std::memory_order_relaxed); }
+
+auto reserve(uint32_t format, size_t payload_size) noexcept -> std::byte * {
+    auto *out = thread_buffer().reserve(record_size(payload_size));
+    if (!out) {
+        return nullptr;
+    }
+
+    auto time = std::chrono::system_clock::now().time_since_epoch();
+    RecordHeader header{
+        .format = format,
+        .size = static_cast<uint32_t>(payload_size),
+        .time = std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(),
+    };
+    std::memcpy(out, &header, sizeof(header));
+    return out + sizeof(header);
+}
+
+void commit() noexcept { thread_buffer().commit(); }
+
+void start_deferred(const Config &config) {
+    auto &state = deferred();
+    if (config.deferred == DeferredOutput::Off) {
+        return;
+    }
+    core::expect(!state.writer.joinable(), "deferred logging already started");
+
+    state.output = config.deferred;
+    state.path = config.binary_path;
+    state.buffer_size = config.thread_buffer_size;
+    state.flush_interval = config.flush_interval;
+
+    auto writer = std::make_shared<Writer>(state);
+    if (!writer->open()) {
+        return;
+    }
+
+    state.writer = std::jthread{[writer](std::stop_token stop) { writer->run(stop); }};
+    state.enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop_deferred() {
+    auto &state = deferred();
+    state.enabled.store(false, std::memory_order_relaxed);
+
+    // a crash on the writer thread itself cannot wait for its own drain
+    if (!state.writer.joinable() || state.writer.get_id() == std::this_thread::get_id()) {
+        return;
+    }
+    state.writer.request_stop();
+    state.writer.join();
+}
+
+} // namespace internal
+
+} // namespace muon::log
@@ -0,0 +1,328 @@
+#pragma once
+
+#include "fmt/format.h"
+#include "muon/core/log.hpp"
+#include "muon/maths/alignment.hpp"
+#include "spdlog/common.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace muon::log {
+
+enum class ArgType : uint8_t {
+    Bool,
+    Char,
+    I32,
+    U32,
+    I64,
+    U64,
+    F32,
+    F64,
+    Pointer,
+    String,
+};
+
+struct Site {
+    spdlog::level::level_enum level;
+    const char *file;
+    uint32_t line;
+    const char *format;
+};
+
+struct Format {
+    uint32_t id{0};
+    spdlog::level::level_enum level{spdlog::level::info};
+    std::string file;
+    uint32_t line{0};
+    std::string format;
+    std::vector<ArgType> args;
+};
+
+// binary log files start with the magic and version, followed by a stream of entries
+constexpr std::array<char, 8> BINARY_MAGIC{'M', 'U', 'O', 'N', 'L', 'O', 'G', '\0'};
+constexpr uint32_t BINARY_VERSION = 1;
+
+enum class BinaryEntry : uint8_t {
+    // u32 id, u8 level, u32 line, u32 + file, u32 + format, u32 + arg types
+    Format = 1,
+    // u32 id, u32 thread, i64 nanoseconds since epoch, u32 + payload
+    Record = 2,
+    // u64 records lost because a thread buffer was full
+    Dropped = 3,
+};
+
+// formats the raw argument bytes of a record the same way the call site would have
+auto format_record(const Format &format, std::span<const std::byte> payload) -> std::string;
+
+struct BinaryRecord {
+    uint32_t thread{0};
+    // nanoseconds since the epoch
+    int64_t time{0};
+    spdlog::level::level_enum level{spdlog::level::info};
+    std::string file;
+    uint32_t line{0};
+    std::string text;
+};
+
+struct BinaryLog {
+    std::vector<BinaryRecord> records;
+    uint64_t dropped{0};
+    // the file ended partway through an entry, usually because the process died while writing it
+    bool truncated{false};
+};
+
+enum class BinaryLogError {
+    FileOpenFailure,
+    InvalidFormat,
+    UnsupportedVersion,
+};
+
+// reads a binary deferred log back and formats every record in the order they were written
+auto read_binary_log(const std::filesystem::path &path) -> std::expected<BinaryLog, BinaryLogError>;
+
+namespace internal {
+
+template <typename T>
+consteval auto arg_type() -> ArgType {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_enum_v<U>) {
+        return arg_type<std::underlying_type_t<U>>();
+    } else if constexpr (std::is_same_v<U, bool>) {
+        return ArgType::Bool;
+    } else if constexpr (std::is_same_v<U, char>) {
+        return ArgType::Char;
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        return sizeof(U) <= 4 ? ArgType::I32 : ArgType::I64;
+    } else if constexpr (std::is_integral_v<U>) {
+        return sizeof(U) <= 4 ? ArgType::U32 : ArgType::U64;
+    } else if constexpr (std::is_same_v<U, float>) {
+        return ArgType::F32;
+    } else if constexpr (std::is_floating_point_v<U>) {
+        return ArgType::F64;
+    } else if constexpr (std::is_convertible_v<U, std::string_view>) {
+        return ArgType::String;
+    } else if constexpr (std::is_pointer_v<U>) {
+        return ArgType::Pointer;
+    } else {
+        static_assert(sizeof(T) == 0, "deferred logging only supports arithmetic, enum, pointer and string arguments");
+    }
+}
+
+template <typename... Args>
+constexpr std::array<ArgType, sizeof...(Args)> ARG_TYPES{arg_type<Args>()...};
+
+template <typename T>
+auto encoded_size(const T &arg) -> size_t {
+    constexpr auto type = arg_type<T>();
+    if constexpr (type == ArgType::String) {
+        return sizeof(uint32_t) + std::string_view{arg}.size();
+    } else if constexpr (type == ArgType::Bool || type == ArgType::Char) {
+        return 1;
+    } else if constexpr (type == ArgType::I32 || type == ArgType::U32 || type == ArgType::F32) {
+        return 4;
+    } else {
+        return 8;
+    }
+}
+
+template <typename T>
+void encode_value(std::byte *&out, const T &value) {
+    std::memcpy(out, &value, sizeof(T));
+    out += sizeof(T);
+}
+
+template <typename T>
+void encode(std::byte *&out, const T &arg) {
+    constexpr auto type = arg_type<T>();
+    using U = std::decay_t<T>;
+    if constexpr (type == ArgType::String) {
+        std::string_view text{arg};
+        encode_value(out, static_cast<uint32_t>(text.size()));
+        std::memcpy(out, text.data(), text.size());
+        out += text.size();
+    } else if constexpr (type == ArgType::Pointer) {
+        encode_value(out, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(arg)));
+    } else if constexpr (std::is_enum_v<U>) {
+        encode(out, static_cast<std::underlying_type_t<U>>(arg));
+    } else if constexpr (type == ArgType::Bool || type == ArgType::Char) {
+        encode_value(out, static_cast<uint8_t>(arg));
+    } else if constexpr (type == ArgType::I32) {
+        encode_value(out, static_cast<int32_t>(arg));
+    } else if constexpr (type == ArgType::U32) {
+        encode_value(out, static_cast<uint32_t>(arg));
+    } else if constexpr (type == ArgType::I64) {
+        encode_value(out, static_cast<int64_t>(arg));
+    } else if constexpr (type == ArgType::U64) {
+        encode_value(out, static_cast<uint64_t>(arg));
+    } else if constexpr (type == ArgType::F32) {
+        encode_value(out, static_cast<float>(arg));
+    } else {
+        encode_value(out, static_cast<double>(arg));
+    }
+}
+
+constexpr size_t RECORD_ALIGNMENT = 8;
+
+// every record starts with a header, the payload follows and the whole record is padded to the alignment
+struct RecordHeader {
+    uint32_t format;
+    uint32_t size;
+    int64_t time;
+};
+
+inline auto record_size(size_t payload_size) -> size_t {
+    return maths::align<RECORD_ALIGNMENT>(sizeof(RecordHeader) + payload_size);
+}
+
+// single producer, single consumer byte ring that each thread records into, records never wrap, the tail end is
+// skipped with a zero format id, and a record that doesn't fit is dropped and counted
+class ThreadBuffer {
+public:
+    ThreadBuffer(uint32_t id, size_t capacity)
+        : id_{id}, capacity_{std::bit_ceil(std::max(capacity, sizeof(RecordHeader)))}, mask_{capacity_ - 1},
+          data_{std::make_unique<std::byte[]>(capacity_)} {}
+
+    auto reserve(size_t size) noexcept -> std::byte * {
+        auto head = head_.load(std::memory_order_relaxed);
+        auto offset = head & mask_;
+        auto contiguous = capacity_ - offset;
+        auto padding = contiguous < size ? contiguous : 0;
+
+        if (size > capacity_ || !has_space(head, padding + size)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        if (padding > 0) {
+            constexpr uint32_t skip = 0;
+            std::memcpy(data_.get() + offset, &skip, sizeof(skip));
+        }
+
+        pending_head_ = head + padding + size;
+        return data_.get() + ((head + padding) & mask_);
+    }
+
+    void commit() noexcept { head_.store(pending_head_, std::memory_order_release); }
+
+    template <typename Fn>
+    auto consume(Fn &&fn) -> size_t {
+        auto head = head_.load(std::memory_order_acquire);
+        auto tail = tail_.load(std::memory_order_relaxed);
+
+        size_t count = 0;
+        while (tail != head) {
+            auto offset = tail & mask_;
+
+            uint32_t format;
+            std::memcpy(&format, data_.get() + offset, sizeof(format));
+            if (format == 0) {
+                tail += capacity_ - offset;
+                continue;
+            }
+
+            RecordHeader header;
+            std::memcpy(&header, data_.get() + offset, sizeof(header));
+            fn(header, std::span<const std::byte>{data_.get() + offset + sizeof(header), header.size});
+
+            tail += record_size(header.size);
+            count += 1;
+        }
+
+        tail_.store(tail, std::memory_order_release);
+        return count;
+    }
+
+    auto id() const -> uint32_t { return id_; }
+    auto take_dropped() -> uint64_t { return dropped_.exchange(0, std::memory_order_relaxed); }
+
+private:
+    auto has_space(uint64_t head, size_t size) noexcept -> bool {
+        if (capacity_ - (head - cached_tail_) >= size) {
+            return true;
+        }
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        return capacity_ - (head - cached_tail_) >= size;
+    }
+
+    uint32_t id_{0};
+    size_t capacity_{0};
+    size_t mask_{0};
+    std::unique_ptr<std::byte[]> data_{nullptr};
+
+    alignas(64) std::atomic<uint64_t> head_{0};
+    uint64_t cached_tail_{0};
+    uint64_t pending_head_{0};
+
+    alignas(64) std::atomic<uint64_t> tail_{0};
+
+    std::atomic<uint64_t> dropped_{0};
+};
+
+auto register_format(const Site &site, std::span<const ArgType> args) -> uint32_t;
+auto deferred_enabled() noexcept -> bool;
+
+// reserves space in the calling thread's buffer, returns null when the record has to be dropped
+auto reserve(uint32_t format, size_t payload_size) noexcept -> std::byte *;
+void commit() noexcept;
+
+void start_deferred(const Config &config);
+void stop_deferred();
+
+template <typename SiteFn, typename... Args>
+void write_deferred(SiteFn site, const Args &...args) {
+    static const uint32_t id = register_format(site(), ARG_TYPES<Args...>);
+
+    if (!deferred_enabled()) {
+        auto fallback = site();
+        spdlog::source_loc location{fallback.file, static_cast<int>(fallback.line), ""};
+        core_logger->log(location, fallback.level, fmt::runtime(fallback.format), args...);
+        return;
+    }
+
+    size_t size = (size_t{0} + ... + encoded_size(args));
+    auto *out = reserve(id, size);
+    if (!out) {
+        return;
+    }
+    (encode(out, args), ...);
+    commit();
+}
+
+} // namespace internal
+
+} // namespace muon::log
+
+// records the format id and raw arguments, formatting happens later on the writer thread or offline, the core
+// category's level gates it so nothing is recorded before log::init
+#define MU_LOG_DEFERRED(level, message, ...)                                                                \
+    do {                                                                                                    \
+        if (::muon::log::should_log(::muon::log::Category::Core, level)) {                                  \
+            if (false) {                                                                                    \
+                static_cast<void>(::fmt::format(message __VA_OPT__(, ) __VA_ARGS__));                       \
+            }                                                                                               \
+            ::muon::log::internal::write_deferred(                                                          \
+                [] { return ::muon::log::Site{level, __FILE__, static_cast<uint32_t>(__LINE__), message}; } \
+                __VA_OPT__(, ) __VA_ARGS__                                                                  \
+            );                                                                                              \
+        }                                                                                                   \
+    } while (false)
+
+#define MU_TRACE_DEFERRED(message, ...) MU_LOG_DEFERRED(::spdlog::level::trace, message __VA_OPT__(, ) __VA_ARGS__)
+#define MU_DEBUG_DEFERRED(message, ...) MU_LOG_DEFERRED(::spdlog::level::debug, message __VA_OPT__(, ) __VA_ARGS__)
+#define MU_INFO_DEFERRED(message, ...) MU_LOG_DEFERRED(::spdlog::level::info, message __VA_OPT__(, ) __VA_ARGS__)
+#define MU_WARN_DEFERRED(message, ...) MU_LOG_DEFERRED(::spdlog::level::warn, message __VA_OPT__(, ) __VA_ARGS__)
+#define MU_ERROR_DEFERRED(message, ...) MU_LOG_DEFERRED(::spdlog::level::err, message __VA_OPT__(, ) __VA_ARGS__)
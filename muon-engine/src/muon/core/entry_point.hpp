@@ -10,7 +10,7 @@
 extern auto muon::create_application(size_t count, char **arguments) -> Application::Pointer;
 
 auto main(int32_t count, char **arguments) -> int32_t {
-    muon::log::init();
+    muon::log::init(muon::log::parse_config(count, arguments));
 
     if (muon::utils::has_elevated_privileges()) {
         muon::core::error("cannot be run with elevated privileges");
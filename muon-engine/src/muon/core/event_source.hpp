@@ -0,0 +1,12 @@
+#pragma once
+
+namespace muon {
+
+class EventSource {
+public:
+    virtual ~EventSource() = default;
+
+    virtual void poll_events() = 0;
+};
+
+} // namespace muon
@@ -0,0 +1,288 @@
+#include "muon/core/flight_recorder.hpp"
+
+#include "fmt/format.h"
+#include "muon/utils/platform.hpp"
+
+#if defined(_M_X64)
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <span>
+#include <thread>
+
+namespace muon::log {
+
+namespace {
+
+struct Recorder {
+    std::atomic<FlightHeader *> header{nullptr};
+    FlightSlot *slots{nullptr};
+    uint64_t mask{0};
+    std::span<std::byte> mapping{};
+    // only written on open and close, so the check every record starts with stays in a shared cache line, the writers
+    // count is only touched once a recorder is open
+    std::atomic<bool> enabled{false};
+    std::atomic<uint32_t> threads{0};
+    // threads between loading the header and finishing their record, a clean close waits for them before unmapping
+    std::atomic<uint32_t> writers{0};
+};
+
+Recorder recorder;
+
+auto thread_index() noexcept -> uint32_t {
+    thread_local uint32_t index = recorder.threads.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+auto now() noexcept -> int64_t {
+    auto time = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+// reading the clock can cost a syscall on some machines, the timestamp counter never does
+auto ticks() noexcept -> uint64_t {
+#if defined(__x86_64__) || defined(_M_X64)
+    return __rdtsc();
+#else
+    auto time = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+#endif
+}
+
+void calibrate(FlightHeader &header) noexcept {
+    auto elapsed = now() - header.origin_time;
+    if (elapsed > 0) {
+        auto rate = static_cast<double>(ticks() - header.origin_ticks) / static_cast<double>(elapsed);
+        header.ticks_per_nanosecond.store(rate, std::memory_order_relaxed);
+    }
+}
+
+template <typename Fn>
+void record(FlightRecordKind kind, Fn &&fill) noexcept {
+    if (!recorder.enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    recorder.writers.fetch_add(1, std::memory_order_seq_cst);
+    auto *header = recorder.header.load(std::memory_order_seq_cst);
+    if (!header) {
+        recorder.writers.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+
+    auto index = header->next.fetch_add(1, std::memory_order_relaxed);
+    auto &slot = recorder.slots[index & recorder.mask];
+
+    slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.ticks = ticks();
+    slot.thread = thread_index();
+    slot.kind = kind;
+    slot.source[0] = '\0';
+    fill(*header, slot);
+
+    slot.sequence.store(index * 2 + 2, std::memory_order_release);
+    recorder.writers.fetch_sub(1, std::memory_order_release);
+}
+
+void copy_text(std::span<char> destination, std::string_view text, uint16_t *length) noexcept {
+    auto size = std::min(text.size(), destination.size());
+    std::memcpy(destination.data(), text.data(), size);
+    if (length) {
+        *length = static_cast<uint16_t>(size);
+    } else if (size < destination.size()) {
+        destination[size] = '\0';
+    }
+}
+
+auto frame_text(const std::array<char, FLIGHT_TEXT_SIZE> &text) -> std::string {
+    uint64_t index;
+    int64_t duration;
+    std::memcpy(&index, text.data(), sizeof(index));
+    std::memcpy(&duration, text.data() + sizeof(index), sizeof(duration));
+    return fmt::format("frame {} took {:.3f} ms", index, static_cast<double>(duration) / 1e6);
+}
+
+auto terminated(const std::array<char, 8> &text) -> std::string_view {
+    std::string_view view{text.data(), text.size()};
+    return view.substr(0, view.find('\0'));
+}
+
+// the file is read field by field, the atomics in the mapped layout are never copied
+template <typename T>
+auto read_field(const char *base, size_t offset) -> T {
+    T value;
+    std::memcpy(&value, base + offset, sizeof(T));
+    return value;
+}
+
+} // namespace
+
+auto open_flight_recorder(const std::filesystem::path &path, size_t slot_count) -> bool {
+    close_flight_recorder();
+
+    std::error_code error;
+    if (std::filesystem::exists(path, error)) {
+        auto previous = path;
+        previous += ".prev";
+        std::filesystem::rename(path, previous, error);
+    }
+
+    auto count = std::bit_ceil(std::max<size_t>(slot_count, 1));
+    auto mapping = utils::map_file(path, sizeof(FlightHeader) + count * sizeof(FlightSlot));
+    if (!mapping) {
+        return false;
+    }
+
+    std::ranges::fill(*mapping, std::byte{0});
+    auto *header = new (mapping->data()) FlightHeader{
+        .magic = FLIGHT_MAGIC,
+        .version = FLIGHT_VERSION,
+        .slot_size = sizeof(FlightSlot),
+        .slot_count = count,
+        .next = 0,
+        .clean_exit = 0,
+        .origin_time = now(),
+        .origin_ticks = ticks(),
+        .ticks_per_nanosecond = 0.0,
+    };
+
+    auto *slots = reinterpret_cast<FlightSlot *>(mapping->data() + sizeof(FlightHeader));
+    for (size_t i = 0; i < count; i++) {
+        new (&slots[i]) FlightSlot{};
+    }
+
+    recorder.slots = slots;
+    recorder.mask = count - 1;
+    recorder.mapping = *mapping;
+    recorder.header.store(header, std::memory_order_seq_cst);
+    recorder.enabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void close_flight_recorder(bool clean_exit) {
+    recorder.enabled.store(false, std::memory_order_relaxed);
+    auto *header = recorder.header.exchange(nullptr, std::memory_order_seq_cst);
+    if (!header) {
+        return;
+    }
+    calibrate(*header);
+    header->clean_exit.store(clean_exit ? 1 : 0, std::memory_order_release);
+    if (!clean_exit) {
+        return;
+    }
+
+    // anyone who saw the header before it was cleared is still writing into the mapping
+    while (recorder.writers.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+    (void)utils::unmap_file(recorder.mapping);
+    recorder.mapping = {};
+    recorder.slots = nullptr;
+}
+
+void record_log(spdlog::level::level_enum level, std::string_view source, std::string_view text) noexcept {
+    record(FlightRecordKind::Log, [&](FlightHeader &, FlightSlot &slot) {
+        slot.level = static_cast<uint8_t>(level);
+        copy_text(slot.source, source, nullptr);
+        copy_text(slot.text, text, &slot.length);
+    });
+}
+
+void record_event(const char *name) noexcept {
+    record(FlightRecordKind::Event, [&](FlightHeader &, FlightSlot &slot) {
+        slot.level = static_cast<uint8_t>(spdlog::level::trace);
+        copy_text(slot.text, name, &slot.length);
+    });
+}
+
+void record_frame(uint64_t index, std::chrono::nanoseconds duration) noexcept {
+    record(FlightRecordKind::Frame, [&](FlightHeader &header, FlightSlot &slot) {
+        calibrate(header);
+        int64_t nanoseconds = duration.count();
+        slot.level = static_cast<uint8_t>(spdlog::level::trace);
+        std::memcpy(slot.text.data(), &index, sizeof(index));
+        std::memcpy(slot.text.data() + sizeof(index), &nanoseconds, sizeof(nanoseconds));
+        slot.length = sizeof(index) + sizeof(nanoseconds);
+    });
+}
+
+auto read_flight_recorder(const std::filesystem::path &path) -> std::expected<FlightDump, FlightRecorderError> {
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+        return std::unexpected(FlightRecorderError::FileOpenFailure);
+    }
+    std::vector<char> contents{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+    if (contents.size() < sizeof(FlightHeader)) {
+        return std::unexpected(FlightRecorderError::InvalidFormat);
+    }
+
+    const char *header = contents.data();
+    auto magic = read_field<std::array<char, 8>>(header, offsetof(FlightHeader, magic));
+    auto version = read_field<uint32_t>(header, offsetof(FlightHeader, version));
+    auto slot_size = read_field<uint32_t>(header, offsetof(FlightHeader, slot_size));
+    auto slot_count = read_field<uint64_t>(header, offsetof(FlightHeader, slot_count));
+    if (magic != FLIGHT_MAGIC || version != FLIGHT_VERSION || slot_size != sizeof(FlightSlot) ||
+        (contents.size() - sizeof(FlightHeader)) / sizeof(FlightSlot) < slot_count) {
+        return std::unexpected(FlightRecorderError::InvalidFormat);
+    }
+
+    FlightDump dump;
+    dump.clean_exit = read_field<uint32_t>(header, offsetof(FlightHeader, clean_exit)) != 0;
+    auto origin_time = read_field<int64_t>(header, offsetof(FlightHeader, origin_time));
+    auto origin_ticks = read_field<uint64_t>(header, offsetof(FlightHeader, origin_ticks));
+    auto rate = read_field<double>(header, offsetof(FlightHeader, ticks_per_nanosecond));
+    if (!(rate > 0.0)) {
+        rate = 1.0;
+    }
+
+    for (size_t i = 0; i < slot_count; i++) {
+        const char *slot = contents.data() + sizeof(FlightHeader) + i * sizeof(FlightSlot);
+        auto sequence = read_field<uint64_t>(slot, offsetof(FlightSlot, sequence));
+        if (sequence == 0 || sequence % 2 != 0) {
+            continue;
+        }
+
+        auto kind = read_field<FlightRecordKind>(slot, offsetof(FlightSlot, kind));
+        auto source = read_field<std::array<char, 8>>(slot, offsetof(FlightSlot, source));
+        auto text = read_field<std::array<char, FLIGHT_TEXT_SIZE>>(slot, offsetof(FlightSlot, text));
+        auto length = std::min<size_t>(read_field<uint16_t>(slot, offsetof(FlightSlot, length)), text.size());
+        auto elapsed = static_cast<int64_t>(read_field<uint64_t>(slot, offsetof(FlightSlot, ticks)) - origin_ticks);
+
+        dump.records.push_back({
+            .index = sequence / 2 - 1,
+            .time = origin_time + static_cast<int64_t>(static_cast<double>(elapsed) / rate),
+            .thread = read_field<uint32_t>(slot, offsetof(FlightSlot, thread)),
+            .kind = kind,
+            .level = static_cast<spdlog::level::level_enum>(read_field<uint8_t>(slot, offsetof(FlightSlot, level))),
+            .source = std::string{terminated(source)},
+            .text = kind == FlightRecordKind::Frame ? frame_text(text) : std::string{text.data(), length},
+        });
+    }
+
+    std::ranges::sort(dump.records, {}, &FlightRecord::index);
+
+    auto written = read_field<uint64_t>(header, offsetof(FlightHeader, next));
+    dump.lost = written - std::min<uint64_t>(written, dump.records.size());
+    return dump;
+}
+
+void FlightRecorderSink::sink_it_(const spdlog::details::log_msg &message) {
+    record_log(
+        message.level, std::string_view{message.logger_name.data(), message.logger_name.size()},
+        std::string_view{message.payload.data(), message.payload.size()}
+    );
+}
+
+} // namespace muon::log
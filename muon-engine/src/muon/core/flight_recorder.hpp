@@ -0,0 +1,106 @@
+#pragma once
+
+#include "spdlog/common.h"
+#include "spdlog/details/null_mutex.h"
+#include "spdlog/sinks/base_sink.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace muon::log {
+
+enum class FlightRecordKind : uint8_t {
+    Log = 1,
+    Event = 2,
+    Frame = 3,
+};
+
+constexpr std::array<char, 8> FLIGHT_MAGIC{'M', 'U', 'O', 'N', 'F', 'L', 'T', '\0'};
+constexpr uint32_t FLIGHT_VERSION = 1;
+constexpr size_t FLIGHT_TEXT_SIZE = 96;
+
+// the layout of the mapped file, a header followed by a power of two number of slots
+struct alignas(64) FlightHeader {
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t slot_size;
+    uint64_t slot_count;
+    std::atomic<uint64_t> next;
+    std::atomic<uint32_t> clean_exit;
+
+    // slots store raw timestamp counter ticks, converted to wall time through these, the rate is zero until the first
+    // frame or the close has measured it against the origin
+    int64_t origin_time;
+    uint64_t origin_ticks;
+    std::atomic<double> ticks_per_nanosecond;
+};
+
+// odd sequences are being written, even sequences hold record (sequence / 2 - 1)
+struct alignas(64) FlightSlot {
+    std::atomic<uint64_t> sequence;
+    uint64_t ticks;
+    uint32_t thread;
+    FlightRecordKind kind;
+    uint8_t level;
+    uint16_t length;
+    std::array<char, 8> source;
+    std::array<char, FLIGHT_TEXT_SIZE> text;
+};
+
+static_assert(sizeof(FlightHeader) == 64);
+static_assert(sizeof(FlightSlot) == 128);
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<double>::is_always_lock_free);
+
+// maps a circular buffer of `slot_count` records into `path`, the previous file is kept with a .prev suffix
+auto open_flight_recorder(const std::filesystem::path &path, size_t slot_count) -> bool;
+// stops recording and marks how the process ended, a clean close waits for threads that are still recording and
+// unmaps the file, otherwise the mapping is left alone so that it is safe to call from a signal handler
+void close_flight_recorder(bool clean_exit = true);
+
+// each record is a handful of plain stores into the mapping, nothing is written when no recorder is open
+void record_log(spdlog::level::level_enum level, std::string_view source, std::string_view text) noexcept;
+void record_event(const char *name) noexcept;
+// also refreshes the tick rate, frames come often enough to keep it accurate without a calibration pause
+void record_frame(uint64_t index, std::chrono::nanoseconds duration) noexcept;
+
+struct FlightRecord {
+    uint64_t index{0};
+    // nanoseconds since the epoch
+    int64_t time{0};
+    uint32_t thread{0};
+    FlightRecordKind kind{FlightRecordKind::Log};
+    spdlog::level::level_enum level{spdlog::level::info};
+    std::string source;
+    std::string text;
+};
+
+struct FlightDump {
+    bool clean_exit{false};
+    uint64_t lost{0};
+    std::vector<FlightRecord> records;
+};
+
+enum class FlightRecorderError {
+    FileOpenFailure,
+    InvalidFormat,
+};
+
+// reads every complete record back in the order they were written
+auto read_flight_recorder(const std::filesystem::path &path) -> std::expected<FlightDump, FlightRecorderError>;
+
+class FlightRecorderSink final : public spdlog::sinks::base_sink<spdlog::details::null_mutex> {
+protected:
+    void sink_it_(const spdlog::details::log_msg &message) override;
+    void flush_() override {}
+};
+
+} // namespace muon::log
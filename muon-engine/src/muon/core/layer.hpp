@@ -1,7 +1,21 @@
 #pragma once
 
+#include <typeindex>
+#include <vector>
+
 namespace muon {
 
+class Layer;
+
+struct LayerAccess {
+    std::vector<std::type_index> reads;
+    std::vector<std::type_index> writes;
+    std::vector<const Layer *> after;
+
+    // layers that declare nothing are treated as touching everything and run alone on the main thread
+    bool declared{false};
+};
+
 class Layer {
 public:
     virtual ~Layer() = default;
@@ -9,6 +23,30 @@ public:
     virtual void on_attach() = 0;
     virtual void on_detach() = 0;
     virtual void on_update() = 0;
+
+public:
+    auto access() const -> const LayerAccess & { return access_; }
+
+protected:
+    template <typename Resource>
+    void reads() {
+        access_.reads.emplace_back(typeid(Resource));
+        access_.declared = true;
+    }
+
+    template <typename Resource>
+    void writes() {
+        access_.writes.emplace_back(typeid(Resource));
+        access_.declared = true;
+    }
+
+    void runs_after(const Layer *layer) {
+        access_.after.emplace_back(layer);
+        access_.declared = true;
+    }
+
+private:
+    LayerAccess access_{};
 };
 
 } // namespace muon
@@ -0,0 +1,136 @@
+#include "muon/core/layer_graph.hpp"
+
+#include "muon/core/log.hpp"
+#include "muon/profile/profiler.hpp"
+#include "muon/utils/platform.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace muon {
+
+namespace {
+
+auto overlaps(const std::vector<std::type_index> &lhs, const std::vector<std::type_index> &rhs) -> bool {
+    return std::ranges::any_of(lhs, [&](const auto &resource) { return std::ranges::find(rhs, resource) != rhs.end(); });
+}
+
+auto conflicts(const Layer *earlier, const Layer *later) -> bool {
+    const auto &first = earlier->access();
+    const auto &second = later->access();
+
+    if (!first.declared || !second.declared) {
+        return true;
+    }
+
+    return overlaps(first.writes, second.writes) || overlaps(first.writes, second.reads) ||
+           overlaps(first.reads, second.writes);
+}
+
+} // namespace
+
+void LayerGraph::build(const LayerStack &stack) {
+    std::vector<Layer *> layers{stack.begin(), stack.end()};
+    const size_t count = layers.size();
+
+    levels_.clear();
+    names_.clear();
+    if (count == 0) {
+        return;
+    }
+
+    for (Layer *layer : layers) {
+        names_.emplace(layer, profile::intern(utils::demangle(typeid(*layer).name())));
+    }
+
+    // conflicting layers keep their stack order, explicit dependencies may point either way
+    std::vector<std::vector<size_t>> successors(count);
+    std::vector<size_t> in_degree(count, 0);
+    auto add_edge = [&](size_t from, size_t to) {
+        if (std::ranges::find(successors[from], to) == successors[from].end()) {
+            successors[from].emplace_back(to);
+            in_degree[to] += 1;
+        }
+    };
+
+    for (size_t later = 0; later < count; later++) {
+        for (size_t earlier = 0; earlier < later; earlier++) {
+            if (conflicts(layers[earlier], layers[later])) {
+                add_edge(earlier, later);
+            }
+        }
+
+        for (const Layer *dependency : layers[later]->access().after) {
+            auto it = std::ranges::find(layers, dependency);
+            if (it == layers.end()) {
+                core::warn("layer {} depends on a layer that is not in the stack, ignoring", later);
+                continue;
+            }
+            add_edge(static_cast<size_t>(it - layers.begin()), later);
+        }
+    }
+
+    std::vector<size_t> depth(count, 0);
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < count; i++) {
+        if (in_degree[i] == 0) {
+            ready.emplace_back(i);
+        }
+    }
+
+    size_t visited = 0;
+    size_t max_depth = 0;
+    while (!ready.empty()) {
+        size_t current = ready.back();
+        ready.pop_back();
+        visited += 1;
+        max_depth = std::max(max_depth, depth[current]);
+
+        for (size_t next : successors[current]) {
+            depth[next] = std::max(depth[next], depth[current] + 1);
+            if (--in_degree[next] == 0) {
+                ready.emplace_back(next);
+            }
+        }
+    }
+
+    if (visited != count) {
+        core::error("layer dependencies form a cycle, falling back to serial updates in stack order");
+        for (Layer *layer : layers) {
+            levels_.push_back({layer});
+        }
+        return;
+    }
+
+    levels_.resize(max_depth + 1);
+    for (size_t i = 0; i < count; i++) {
+        levels_[depth[i]].emplace_back(layers[i]);
+    }
+
+    core::trace("built layer graph with {} layers over {} levels", count, levels_.size());
+}
+
+void LayerGraph::execute(job::System &jobs) {
+    for (auto &level : levels_) {
+        if (level.size() == 1) {
+            update(level.front());
+            continue;
+        }
+
+        job::Counter counter;
+        for (size_t i = 1; i < level.size(); i++) {
+            jobs.submit([this, layer = level[i]] { update(layer); }, counter);
+        }
+
+        jobs.run_and_wait([&] { update(level.front()); }, counter);
+    }
+}
+
+void LayerGraph::update(Layer *layer) {
+    MU_PROFILE_ZONE(names_.at(layer));
+    layer->on_update();
+}
+
+auto LayerGraph::levels() const -> const std::vector<Level> & { return levels_; }
+
+} // namespace muon
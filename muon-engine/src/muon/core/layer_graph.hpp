@@ -0,0 +1,32 @@
+#pragma once
+
+#include "muon/core/layer.hpp"
+#include "muon/core/layer_stack.hpp"
+#include "muon/job/system.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace muon {
+
+class LayerGraph {
+public:
+    using Level = std::vector<Layer *>;
+
+    LayerGraph() = default;
+
+    void build(const LayerStack &stack);
+
+    void execute(job::System &jobs);
+
+    auto levels() const -> const std::vector<Level> &;
+
+private:
+    void update(Layer *layer);
+
+private:
+    std::vector<Level> levels_{};
+    std::unordered_map<const Layer *, const char *> names_{};
+};
+
+} // namespace muon
@@ -1,11 +1,28 @@
 #include "muon/core/log.hpp"
 
+#include "argparse/argparse.hpp"
 #include "fmt/format.h"
-#include "spdlog/sinks/basic_file_sink.h"
+#include "muon/core/async_sink.hpp"
+#include "muon/core/deferred_log.hpp"
+#include "muon/core/flight_recorder.hpp"
+#include "muon/core/rotating_sink.hpp"
+#include "muon/utils/platform.hpp"
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <exception>
 #include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace muon {
@@ -19,37 +36,286 @@ namespace internal {
 std::shared_ptr<spdlog::logger> core_logger{nullptr};
 std::shared_ptr<spdlog::logger> client_logger{nullptr};
 
+std::array<std::shared_ptr<spdlog::logger>, CATEGORY_NAMES.size()> category_loggers{};
+namespace {
+
+template <size_t... Indices>
+auto levels_off(std::index_sequence<Indices...>) -> std::array<std::atomic<spdlog::level::level_enum>, sizeof...(Indices)> {
+    return {((void)Indices, spdlog::level::off)...};
+}
+
+} // namespace
+
+// nothing gets past should_log until init has created the loggers and set the real levels
+std::array<std::atomic<spdlog::level::level_enum>, CATEGORY_NAMES.size()> category_levels =
+    levels_off(std::make_index_sequence<CATEGORY_NAMES.size()>{});
+
 } // namespace internal
 
-void init() {
-    auto init_spdlog = []() {
+namespace {
+
+constexpr std::array CRASH_SIGNALS{SIGABRT, SIGFPE, SIGILL, SIGSEGV};
+constexpr auto CRASH_DRAIN_TIMEOUT = std::chrono::seconds{1};
+
+std::once_flag logger_shutdown;
+std::terminate_handler previous_terminate{nullptr};
+
+// the loggers own it, the crash handlers only need to reach it
+std::atomic<AsyncSink *> async_sink{nullptr};
+
+auto make_logger(
+    const char *name,
+    const std::vector<spdlog::sink_ptr> &sinks,
+    spdlog::level::level_enum flush_level
+) -> std::shared_ptr<spdlog::logger> {
+    auto logger = std::make_shared<spdlog::logger>(name, sinks.begin(), sinks.end());
+    logger->flush_on(flush_level);
+    return logger;
+}
+
+void crash_signal_handler(int32_t signal) {
+    // only async signal safe work, the flight recorder goes first since it is plain stores into a mapping, then the
+    // async writer gets a bounded wait to write and flush what was queued, it may be the thread that crashed or be
+    // stuck behind a record the crashing thread never finished
+    std::array<char, 32> text{"fatal signal "};
+    auto end = std::to_chars(text.data() + 13, text.data() + text.size() - 1, signal).ptr;
+    record_log(spdlog::level::critical, "MUON", std::string_view{text.data(), end});
+    close_flight_recorder(false);
+    if (auto *sink = async_sink.load(std::memory_order_acquire)) {
+        sink->drain(CRASH_DRAIN_TIMEOUT);
+    }
+
+    *end = '\n';
+    utils::write_error_output(std::string_view{text.data(), end + 1});
+
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
+}
+
+void crash_terminate_handler() {
+    record_log(spdlog::level::critical, "MUON", "terminate called");
+    close_flight_recorder(false);
+    shutdown();
+    if (previous_terminate) {
+        previous_terminate();
+    }
+    std::abort();
+}
+
+void install_crash_handlers() {
+    for (auto signal : CRASH_SIGNALS) {
+        std::signal(signal, crash_signal_handler);
+    }
+    previous_terminate = std::set_terminate(crash_terminate_handler);
+    std::atexit(shutdown);
+}
+
+auto parse_level(std::string_view name) -> std::optional<spdlog::level::level_enum> {
+    auto level = spdlog::level::from_str(std::string{name});
+    if (level == spdlog::level::off && name != "off") {
+        return std::nullopt;
+    }
+    return level;
+}
+
+auto parse_category(std::string_view name) -> std::optional<Category> {
+    auto found = std::ranges::find(CATEGORY_NAMES, name);
+    if (found == CATEGORY_NAMES.end()) {
+        return std::nullopt;
+    }
+    return static_cast<Category>(found - CATEGORY_NAMES.begin());
+}
+
+} // namespace
+
+void set_level(Category category, spdlog::level::level_enum level) {
+    auto index = std::to_underlying(category);
+    internal::category_levels[index].store(level, std::memory_order_relaxed);
+    if (internal::category_loggers[index]) {
+        internal::category_loggers[index]->set_level(level);
+    }
+}
+
+auto level(Category category) -> spdlog::level::level_enum {
+    return internal::category_levels[std::to_underlying(category)].load(std::memory_order_relaxed);
+}
+
+auto apply_levels(std::string_view levels) -> bool {
+    bool valid = true;
+    while (!levels.empty()) {
+        auto end = levels.find(',');
+        auto entry = levels.substr(0, end);
+        levels = end == std::string_view::npos ? std::string_view{} : levels.substr(end + 1);
+
+        auto separator = entry.find('=');
+        auto category = parse_category(entry.substr(0, separator));
+        auto level = separator == std::string_view::npos ? std::nullopt : parse_level(entry.substr(separator + 1));
+        if (!category || !level) {
+            core::warn("ignoring invalid log level entry: {}", entry);
+            valid = false;
+            continue;
+        }
+
+        set_level(*category, *level);
+    }
+    return valid;
+}
+
+auto RateLimiter::allow(std::chrono::steady_clock::time_point now) noexcept -> bool {
+    auto second = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count());
+    auto state = state_.load(std::memory_order_relaxed);
+    while (true) {
+        auto window = static_cast<uint32_t>(state >> 32);
+        auto count = static_cast<uint32_t>(state);
+        // a thread that read the clock just before another moved on counts towards the newer second
+        bool same_window = static_cast<int32_t>(second - window) <= 0;
+        if (same_window && count >= per_second_) {
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto next = same_window ? state + 1 : uint64_t{second} << 32 | 1;
+        if (state_.compare_exchange_weak(state, next, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+auto parse_config(size_t count, char **arguments) -> Config {
+    argparse::ArgumentParser parser{"muon", "", argparse::default_arguments::none};
+    parser.add_argument("--log-async").flag();
+    parser.add_argument("--log-queue-size").scan<'u', size_t>();
+    parser.add_argument("--log-overflow").choices("block", "drop", "overwrite");
+    parser.add_argument("--log-deferred").choices("text", "binary");
+    parser.add_argument("--log-level");
+    parser.add_argument("--log-max-size").scan<'u', size_t>();
+    parser.add_argument("--log-budget").scan<'u', uint64_t>();
+    parser.add_argument("--log-no-crash-handlers").flag();
+    parser.add_argument("--log-flight-recorder");
+
+    // the loggers do not exist yet, so malformed options fall back to defaults silently, unlike a default Config the
+    // crash handlers are on here, this is only called from the entry point, which owns the process
+    Config config;
+    config.crash_handlers = true;
+    try {
+        parser.parse_known_args(std::vector<std::string>{arguments, arguments + count});
+    } catch (const std::exception &) {
+        return config;
+    }
+
+    config.async = parser.get<bool>("--log-async");
+    config.crash_handlers = !parser.get<bool>("--log-no-crash-handlers");
+    if (auto queue_size = parser.present<size_t>("--log-queue-size")) {
+        config.queue_size = std::max<size_t>(*queue_size, 1);
+    }
+    if (auto overflow = parser.present("--log-overflow")) {
+        if (*overflow == "drop") {
+            config.overflow = OverflowPolicy::Drop;
+        } else if (*overflow == "overwrite") {
+            config.overflow = OverflowPolicy::Overwrite;
+        }
+    }
+    if (auto deferred = parser.present("--log-deferred")) {
+        config.deferred = *deferred == "binary" ? DeferredOutput::Binary : DeferredOutput::Text;
+    }
+    if (auto levels = parser.present("--log-level")) {
+        config.levels = *levels;
+    }
+    if (auto max_size = parser.present<size_t>("--log-max-size")) {
+        config.rotation.max_size = *max_size;
+    }
+    if (auto budget = parser.present<uint64_t>("--log-budget")) {
+        config.rotation.disk_budget = *budget;
+    }
+    if (auto flight_recorder = parser.present("--log-flight-recorder")) {
+        config.flight_recorder = *flight_recorder;
+    }
+
+    return config;
+}
+
+void init(const Config &config) {
+    auto init_spdlog = [&config]() {
         std::vector<spdlog::sink_ptr> sinks;
         sinks.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
-        sinks.emplace_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>("Muon.log", true));
+        sinks.emplace_back(std::make_shared<RotatingSink>("Muon.log", config.rotation));
 
         sinks[0]->set_pattern("%T%z [%4n] [%^%5l%$]: %v");
         sinks[1]->set_pattern("%T%z [%4n] [%5l]: %v");
 
-        internal::core_logger = std::make_shared<spdlog::logger>("MUON", sinks.begin(), sinks.end());
+        if (!config.flight_recorder.empty() && open_flight_recorder(config.flight_recorder, config.flight_recorder_slots)) {
+            sinks.emplace_back(std::make_shared<FlightRecorderSink>());
+        }
+
+        auto flush_level = spdlog::level::trace;
+        if (config.async) {
+            // every logger shares one ring so records keep the order they were logged in, its writer thread owns the
+            // sinks that do the writing
+            auto sink = std::make_shared<AsyncSink>(std::move(sinks), config.queue_size, config.overflow, config.flush_interval);
+            sink->start();
+            async_sink.store(sink.get(), std::memory_order_release);
+            sinks = {sink};
+            flush_level = spdlog::level::err;
+        }
+
+        internal::core_logger = make_logger("MUON", sinks, flush_level);
         spdlog::register_logger(internal::core_logger);
         internal::core_logger->set_level(spdlog::level::trace);
-        internal::core_logger->flush_on(spdlog::level::trace);
 
-        internal::client_logger = std::make_shared<spdlog::logger>("APP", sinks.begin(), sinks.end());
+        internal::client_logger = make_logger("APP", sinks, flush_level);
         spdlog::register_logger(internal::client_logger);
         internal::client_logger->set_level(spdlog::level::trace);
-        internal::client_logger->flush_on(spdlog::level::trace);
+
+        internal::category_loggers[std::to_underlying(Category::Core)] = internal::core_logger;
+        for (size_t i = 1; i < CATEGORY_NAMES.size(); i++) {
+            std::string name{CATEGORY_NAMES[i]};
+            std::ranges::transform(name, name.begin(), [](unsigned char c) { return std::toupper(c); });
+            internal::category_loggers[i] = make_logger(name.c_str(), sinks, flush_level);
+            spdlog::register_logger(internal::category_loggers[i]);
+        }
 
         if constexpr (DEBUG_ENABLED) {
             spdlog::set_level(spdlog::level::trace);
         } else {
             spdlog::set_level(spdlog::level::info);
         }
+
+        for (size_t i = 0; i < CATEGORY_NAMES.size(); i++) {
+            set_level(static_cast<Category>(i), spdlog::get_level());
+        }
+        apply_levels(config.levels);
+
+        internal::start_deferred(config);
+        if (config.crash_handlers) {
+            install_crash_handlers();
+        }
     };
 
     std::call_once(logger_init, init_spdlog);
 }
 
+void shutdown() {
+    std::call_once(logger_shutdown, []() {
+        internal::stop_deferred();
+        if (internal::core_logger) {
+            internal::core_logger->flush();
+        }
+        if (internal::client_logger) {
+            internal::client_logger->flush();
+        }
+        for (auto &logger : internal::category_loggers) {
+            if (logger) {
+                logger->flush();
+            }
+        }
+        if (auto *sink = async_sink.exchange(nullptr, std::memory_order_acq_rel)) {
+            sink->stop();
+        }
+        spdlog::shutdown();
+        close_flight_recorder();
+    });
+}
+
 } // namespace log
 
 namespace core {
@@ -4,20 +4,133 @@
 #include "muon/core/debug.hpp"
 #include "spdlog/logger.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
 
 namespace muon {
 
 namespace log {
 
+// engine subsystems that can be made more or less verbose at runtime, core shares the MUON logger
+enum class Category : uint8_t {
+    Core,
+    Async,
+    Crypto,
+    Event,
+    Fs,
+    Job,
+    Profile,
+    Window,
+};
+
+constexpr std::array<std::string_view, 8> CATEGORY_NAMES{
+    "core", "async", "crypto", "event", "fs", "job", "profile", "window",
+};
+
 namespace internal {
 
 extern std::shared_ptr<spdlog::logger> core_logger;
 extern std::shared_ptr<spdlog::logger> client_logger;
 
+extern std::array<std::shared_ptr<spdlog::logger>, CATEGORY_NAMES.size()> category_loggers;
+extern std::array<std::atomic<spdlog::level::level_enum>, CATEGORY_NAMES.size()> category_levels;
+
+inline auto logger(Category category) -> spdlog::logger * { return category_loggers[std::to_underlying(category)].get(); }
+
 } // namespace internal
 
-void init();
+inline auto should_log(Category category, spdlog::level::level_enum level) noexcept -> bool {
+    return level >= internal::category_levels[std::to_underlying(category)].load(std::memory_order_relaxed);
+}
+
+void set_level(Category category, spdlog::level::level_enum level);
+auto level(Category category) -> spdlog::level::level_enum;
+
+// applies a comma separated list of category=level pairs, e.g. "fs=debug,window=trace"
+auto apply_levels(std::string_view levels) -> bool;
+
+// lets up to `per_second` messages through in each second of the clock, shared by every thread
+class RateLimiter {
+public:
+    explicit RateLimiter(uint32_t per_second) : per_second_{per_second} {}
+
+    auto allow(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) noexcept -> bool;
+    auto suppressed() const noexcept -> uint64_t { return suppressed_.load(std::memory_order_relaxed); }
+
+private:
+    uint32_t per_second_{0};
+    // the second in the high half and the messages let through in it in the low half, so moving to a new second and
+    // counting the message are one compare and swap
+    std::atomic<uint64_t> state_{0};
+    std::atomic<uint64_t> suppressed_{0};
+};
+
+enum class OverflowPolicy {
+    Block,
+    Drop,
+    Overwrite,
+};
+
+enum class DeferredOutput {
+    Off,
+    Text,
+    Binary,
+};
+
+// the Muon.log file rotates into the archive directory, old segments are compressed and pruned to the budget
+struct RotationOptions {
+    // zero disables the limit
+    size_t max_size{16 << 20};
+    std::chrono::seconds max_age{0};
+    uint64_t disk_budget{256ull << 20};
+
+    std::filesystem::path archive_directory{"logs"};
+    int32_t compression_level{3};
+};
+
+struct Config {
+    // async logging formats and writes on a background thread through a preallocated lock-free ring, the size is in
+    // slots of AsyncSink::SLOT_SIZE bytes and a record with long text takes more than one
+    bool async{false};
+    size_t queue_size{8192};
+    OverflowPolicy overflow{OverflowPolicy::Block};
+    std::chrono::seconds flush_interval{1};
+
+    // where deferred records are formatted, text goes through the loggers, binary is decoded offline
+    DeferredOutput deferred{DeferredOutput::Off};
+    std::filesystem::path binary_path{"Muon.mulog"};
+    size_t thread_buffer_size{1 << 20};
+
+    // category levels applied after the defaults, see apply_levels
+    std::string levels;
+
+    RotationOptions rotation{};
+
+    // replaces the crash signal handlers, the terminate handler and registers shutdown at exit, off so that test
+    // runners and tools keep their own handlers, parse_config turns it on for the entry point
+    bool crash_handlers{false};
+
+    // recent records are mirrored into a memory mapped ring that survives a crash, off unless given a path
+    std::filesystem::path flight_recorder{};
+    size_t flight_recorder_slots{1 << 14};
+};
+
+// reads the --log-* options for the entry point, unlike a default Config the crash handlers are on unless
+// --log-no-crash-handlers is given
+auto parse_config(size_t count, char **arguments) -> Config;
+
+void init(const Config &config = {});
+
+// drains queued messages and flushes every sink, safe to call more than once
+void shutdown();
 
 } // namespace log
 
@@ -110,3 +223,37 @@ void critical(const char *message);
 } // namespace client
 
 } // namespace muon
+
+// the level is checked before any argument is evaluated, `category` names a log::Category enumerator
+#define MU_LOG(category, level, ...)                                                                 \
+    do {                                                                                             \
+        if (::muon::log::should_log(::muon::log::Category::category, level)) {                       \
+            ::muon::log::internal::logger(::muon::log::Category::category)->log(level, __VA_ARGS__); \
+        }                                                                                            \
+    } while (false)
+
+#define MU_LOG_EVERY_N(category, level, n, ...)                                                          \
+    do {                                                                                                 \
+        if (::muon::log::should_log(::muon::log::Category::category, level)) {                           \
+            static ::std::atomic<uint64_t> mu_log_count{0};                                              \
+            if (mu_log_count.fetch_add(1, ::std::memory_order_relaxed) % (n) == 0) {                     \
+                ::muon::log::internal::logger(::muon::log::Category::category)->log(level, __VA_ARGS__); \
+            }                                                                                            \
+        }                                                                                                \
+    } while (false)
+
+#define MU_LOG_AT_MOST_PER_SEC(category, level, per_second, ...)                                         \
+    do {                                                                                                 \
+        if (::muon::log::should_log(::muon::log::Category::category, level)) {                           \
+            static ::muon::log::RateLimiter mu_log_limiter{per_second};                                  \
+            if (mu_log_limiter.allow()) {                                                                \
+                ::muon::log::internal::logger(::muon::log::Category::category)->log(level, __VA_ARGS__); \
+            }                                                                                            \
+        }                                                                                                \
+    } while (false)
+
+#define MU_LOG_TRACE(category, ...) MU_LOG(category, ::spdlog::level::trace, __VA_ARGS__)
+#define MU_LOG_DEBUG(category, ...) MU_LOG(category, ::spdlog::level::debug, __VA_ARGS__)
+#define MU_LOG_INFO(category, ...) MU_LOG(category, ::spdlog::level::info, __VA_ARGS__)
+#define MU_LOG_WARN(category, ...) MU_LOG(category, ::spdlog::level::warn, __VA_ARGS__)
+#define MU_LOG_ERROR(category, ...) MU_LOG(category, ::spdlog::level::err, __VA_ARGS__)
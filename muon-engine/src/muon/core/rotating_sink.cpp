@@ -0,0 +1,212 @@
+#include "muon/core/rotating_sink.hpp"
+
+#include "fmt/chrono.h"
+#include "fmt/format.h"
+#include "zstd.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace muon::log {
+
+namespace {
+
+constexpr std::string_view ARCHIVE_EXTENSION = ".zst";
+
+auto read_file(const std::filesystem::path &path) -> std::vector<char> {
+    std::ifstream file{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+} // namespace
+
+RotatingSink::RotatingSink(std::filesystem::path path, const RotationOptions &options)
+    : path_{std::move(path)}, options_{options} {
+    std::error_code error;
+    std::filesystem::create_directories(options_.archive_directory, error);
+
+    compressor_ = std::jthread{[this](std::stop_token stop) { compress_segments(stop); }};
+
+    // keep the previous run instead of truncating it
+    if (std::filesystem::file_size(path_, error) > 0 && !error) {
+        archive_current();
+    }
+    open();
+}
+
+RotatingSink::~RotatingSink() {
+    {
+        std::lock_guard lock{mutex_};
+        file_.close();
+    }
+    compressor_.request_stop();
+}
+
+void RotatingSink::sink_it_(const spdlog::details::log_msg &message) {
+    spdlog::memory_buf_t formatted;
+    formatter_->format(message, formatted);
+
+    bool too_large = options_.max_size > 0 && size_ > 0 && size_ + formatted.size() > options_.max_size;
+    bool too_old = options_.max_age.count() > 0 && std::chrono::steady_clock::now() - opened_at_ >= options_.max_age;
+    if (too_large || too_old) {
+        rotate();
+    }
+
+    file_.write(formatted);
+    size_ += formatted.size();
+}
+
+void RotatingSink::flush_() { file_.flush(); }
+
+void RotatingSink::open() {
+    file_.open(path_.string(), true);
+    size_ = 0;
+    opened_at_ = std::chrono::steady_clock::now();
+}
+
+void RotatingSink::rotate() {
+    file_.close();
+    archive_current();
+    open();
+}
+
+void RotatingSink::archive_current() {
+    auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+    auto stem = path_.stem().string();
+    auto extension = path_.extension().string();
+
+    // a previous run may have rotated within the same second
+    std::error_code error;
+    std::filesystem::path segment;
+    do {
+        segment = options_.archive_directory / fmt::format("{}-{:%Y%m%d-%H%M%S}-{:04}{}", stem, now, sequence_++, extension);
+    } while (std::filesystem::exists(segment, error) ||
+             std::filesystem::exists(std::filesystem::path{segment} += ARCHIVE_EXTENSION, error));
+
+    {
+        // the segment is queued as it appears, so the budget never sees it in the directory without it being pending
+        std::lock_guard lock{pending_mutex_};
+        std::filesystem::rename(path_, segment, error);
+        if (error) {
+            // the archive directory may be on another filesystem
+            std::filesystem::copy_file(path_, segment, std::filesystem::copy_options::overwrite_existing, error);
+            if (error) {
+                return;
+            }
+        }
+        pending_.push_back(segment);
+    }
+    pending_condition_.notify_one();
+}
+
+void RotatingSink::compress_segments(std::stop_token stop) {
+    while (true) {
+        std::filesystem::path segment;
+        {
+            std::unique_lock lock{pending_mutex_};
+            pending_condition_.wait(lock, stop, [this] { return !pending_.empty(); });
+            if (pending_.empty()) {
+                return;
+            }
+            segment = std::move(pending_.front());
+            pending_.pop_front();
+        }
+
+        compress(segment);
+        enforce_budget();
+    }
+}
+
+void RotatingSink::compress(const std::filesystem::path &segment) {
+    auto contents = read_file(segment);
+    if (contents.empty()) {
+        return;
+    }
+
+    std::vector<char> compressed(ZSTD_compressBound(contents.size()));
+    auto size = ZSTD_compress(compressed.data(), compressed.size(), contents.data(), contents.size(), options_.compression_level);
+    if (ZSTD_isError(size)) {
+        return;
+    }
+
+    auto archive = segment;
+    archive += ARCHIVE_EXTENSION;
+    auto temporary = archive;
+    temporary += ".tmp";
+
+    {
+        std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+        file.write(compressed.data(), static_cast<std::streamsize>(size));
+        if (!file) {
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, archive, error);
+    if (!error) {
+        std::filesystem::remove(segment, error);
+    }
+}
+
+void RotatingSink::enforce_budget() {
+    if (options_.disk_budget == 0) {
+        return;
+    }
+
+    struct Archive {
+        std::filesystem::path path;
+        uint64_t size;
+    };
+
+    std::error_code error;
+    uint64_t total = std::filesystem::file_size(path_, error);
+    if (error) {
+        total = 0;
+    }
+
+    auto prefix = path_.stem().string() + "-";
+    std::vector<std::filesystem::path> listed;
+    for (const auto &entry : std::filesystem::directory_iterator{options_.archive_directory, error}) {
+        auto name = entry.path().filename().string();
+        if (entry.is_regular_file() && name.starts_with(prefix)) {
+            listed.push_back(entry.path());
+        }
+    }
+
+    // segments still waiting to be compressed, and the compressor's temporary output, are neither counted nor deleted
+    std::vector<std::filesystem::path> waiting;
+    {
+        std::lock_guard lock{pending_mutex_};
+        for (const auto &segment : pending_) {
+            waiting.push_back(segment.filename());
+        }
+    }
+
+    std::vector<Archive> archives;
+    for (const auto &path : listed) {
+        if (path.extension() == ".tmp" || std::ranges::find(waiting, path.filename()) != waiting.end()) {
+            continue;
+        }
+        auto size = std::filesystem::file_size(path, error);
+        archives.push_back({path, error ? 0 : size});
+        total += error ? 0 : size;
+    }
+
+    // names start with the rotation time, so lexical order is oldest first
+    std::ranges::sort(archives, {}, &Archive::path);
+    for (const auto &archive : archives) {
+        if (total <= options_.disk_budget) {
+            break;
+        }
+        if (std::filesystem::remove(archive.path, error)) {
+            total -= archive.size;
+        }
+    }
+}
+
+} // namespace muon::log
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "muon/core/log.hpp"
+#include "spdlog/details/file_helper.h"
+#include "spdlog/sinks/base_sink.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace muon::log {
+
+// writes to a single file, rotated segments are moved into the archive directory and compressed with zstd on a
+// background thread, the oldest archives are deleted once the directory exceeds the disk budget
+class RotatingSink final : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    RotatingSink(std::filesystem::path path, const RotationOptions &options);
+    ~RotatingSink() override;
+
+protected:
+    void sink_it_(const spdlog::details::log_msg &message) override;
+    void flush_() override;
+
+private:
+    void open();
+    void rotate();
+    void archive_current();
+
+    void compress_segments(std::stop_token stop);
+    void compress(const std::filesystem::path &segment);
+    void enforce_budget();
+
+    std::filesystem::path path_;
+    RotationOptions options_;
+
+    spdlog::details::file_helper file_;
+    size_t size_{0};
+    std::chrono::steady_clock::time_point opened_at_{};
+    uint32_t sequence_{0};
+
+    std::mutex pending_mutex_;
+    std::condition_variable_any pending_condition_;
+    std::deque<std::filesystem::path> pending_;
+    std::jthread compressor_;
+};
+
+} // namespace muon::log
@@ -0,0 +1,35 @@
+#include "muon/core/synthetic_event_source.hpp"
+
+#include "muon/core/log.hpp"
+#include "muon/event/event.hpp"
+
+namespace muon {
+
+SyntheticEventSource::SyntheticEventSource(
+    const event::Dispatcher &dispatcher,
+    std::optional<uint64_t> frame_limit
+) : dispatcher_{dispatcher}, frame_limit_{frame_limit} {
+    if (frame_limit_) {
+        MU_LOG_DEBUG(Event, "created synthetic event source, quitting after {} frames", *frame_limit_);
+    } else {
+        MU_LOG_DEBUG(Event, "created synthetic event source");
+    }
+}
+
+void SyntheticEventSource::poll_events() {
+    auto [begin, end] = emitters_.equal_range(frame_);
+    for (auto it = begin; it != end; it++) {
+        it->second(dispatcher_);
+    }
+    emitters_.erase(begin, end);
+
+    if (frame_limit_ && frame_ + 1 >= *frame_limit_) {
+        dispatcher_.dispatch<event::WindowQuit>({});
+    }
+
+    frame_ += 1;
+}
+
+auto SyntheticEventSource::frame() const -> uint64_t { return frame_; }
+
+} // namespace muon
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "muon/core/event_source.hpp"
+#include "muon/event/dispatcher.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+
+namespace muon {
+
+// drives the dispatcher without an OS window, e.g. for servers, simulations and benchmark runs
+class SyntheticEventSource final : public EventSource {
+public:
+    using Emitter = std::function<void(const event::Dispatcher &)>;
+
+    SyntheticEventSource(const event::Dispatcher &dispatcher, std::optional<uint64_t> frame_limit);
+
+    void poll_events() override;
+
+    template <typename Event>
+    void schedule(uint64_t frame, Event event) {
+        emitters_.emplace(frame, [event](const event::Dispatcher &dispatcher) { dispatcher.dispatch(event); });
+    }
+
+    auto frame() const -> uint64_t;
+
+private:
+    const event::Dispatcher &dispatcher_;
+    std::optional<uint64_t> frame_limit_;
+
+    std::multimap<uint64_t, Emitter> emitters_{};
+    uint64_t frame_{0};
+};
+
+} // namespace muon
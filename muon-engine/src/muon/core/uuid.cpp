@@ -87,11 +87,11 @@ auto Uuid::begin() const noexcept -> ConstIterator { return data_.begin(); }
 auto Uuid::end() noexcept -> Iterator { return data_.end(); }
 auto Uuid::end() const noexcept -> ConstIterator { return data_.end(); }
 
-auto Uuid::operator==(const Uuid &rhs) noexcept -> bool {
+auto Uuid::operator==(const Uuid &rhs) const noexcept -> bool {
     return data_ == rhs.data_;
 }
 
-auto Uuid::operator<=>(const Uuid &rhs) noexcept -> std::strong_ordering {
+auto Uuid::operator<=>(const Uuid &rhs) const noexcept -> std::strong_ordering {
     return data_ <=> rhs.data_;
 }
 
@@ -44,8 +44,8 @@ public:
     auto end() noexcept -> Iterator;
     auto end() const noexcept -> ConstPointer;
 
-    auto operator==(const Uuid &rhs) noexcept -> bool;
-    auto operator<=>(const Uuid &rhs) noexcept -> std::strong_ordering;
+    auto operator==(const Uuid &rhs) const noexcept -> bool;
+    auto operator<=>(const Uuid &rhs) const noexcept -> std::strong_ordering;
 
 private:
     ValueType data_{};
@@ -6,6 +6,7 @@
 #include "SDL3/SDL_init.h"
 #include "SDL3/SDL_keyboard.h"
 #include "SDL3/SDL_stdinc.h"
+#include "SDL3/SDL_timer.h"
 #include "SDL3/SDL_video.h"
 #include "SDL3/SDL_vulkan.h"
 #include "fmt/base.h"
@@ -22,6 +23,10 @@
 #include "vulkan/vulkan_raii.hpp"
 
 #include <cstring>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace muon {
@@ -49,7 +54,7 @@ Window::Window(
     core::expect(displayMode, "failed to get desktop display mode: {}", SDL_GetError());
     refresh_rate_ = static_cast<uint16_t>(displayMode->refresh_rate);
 
-    core::trace("selected display: {}", SDL_GetDisplayName(impl_->current_display));
+    MU_LOG_TRACE(Window, "selected display: {}", SDL_GetDisplayName(impl_->current_display));
 
     impl_->window = SDL_CreateWindow(title_.c_str(), extent_.width, extent_.height, SDL_WINDOW_VULKAN);
     core::expect(impl_->window, "failed to create window: {}", SDL_GetError());
@@ -59,82 +64,175 @@ Window::Window(
 
     set_mode(mode_);
 
-    core::debug("created window with dimensions: {}x{}", extent_.width, extent_.height);
+    MU_LOG_DEBUG(Window, "created window with dimensions: {}x{}", extent_.width, extent_.height);
 }
 
 Window::~Window() {
     SDL_DestroyWindow(impl_->window);
     SDL_Quit();
-    core::debug("destroyed window");
+    MU_LOG_DEBUG(Window, "destroyed window");
 }
 
-void Window::poll_events() {
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        if (event.type == SDL_EVENT_QUIT) {
-            dispatcher_.dispatch<event::WindowQuit>({});
-        }
+namespace {
+
+auto translate(const SDL_Event &event) -> std::optional<event::Queued> {
+    event::Queued queued{.timestamp = event.common.timestamp};
 
-        if (event.type == SDL_EVENT_WINDOW_RESIZED) {
-            extent_ = Extent2D{
+    switch (event.type) {
+        case SDL_EVENT_QUIT:
+            queued.event = event::WindowQuit{};
+            break;
+
+        case SDL_EVENT_WINDOW_RESIZED:
+            queued.event = event::WindowResize{Extent2D{
                 static_cast<uint32_t>(event.window.data1),
                 static_cast<uint32_t>(event.window.data2),
-            };
-            dispatcher_.dispatch<event::WindowResize>({extent_});
-        }
+            }};
+            break;
 
-        if (event.type == SDL_EVENT_WINDOW_FOCUS_GAINED || event.type == SDL_EVENT_WINDOW_FOCUS_LOST) {
-            dispatcher_.dispatch<event::WindowFocus>({event.type == SDL_EVENT_WINDOW_FOCUS_GAINED});
-        }
+        case SDL_EVENT_WINDOW_FOCUS_GAINED:
+        case SDL_EVENT_WINDOW_FOCUS_LOST:
+            queued.event = event::WindowFocus{event.type == SDL_EVENT_WINDOW_FOCUS_GAINED};
+            break;
 
-        if (event.type == SDL_EVENT_KEY_DOWN || event.type == SDL_EVENT_KEY_UP) {
-            dispatcher_.dispatch<event::Keyboard>({
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+            queued.event = event::Keyboard{
                 static_cast<input::Scancode>(event.key.scancode),
                 event.key.down,
                 event.key.repeat,
                 input::Modifier{event.key.mod},
-            });
-        }
+            };
+            break;
 
-        if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN || event.type == SDL_EVENT_MOUSE_BUTTON_UP) {
-            dispatcher_.dispatch<event::MouseButton>({
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            queued.event = event::MouseButton{
                 static_cast<input::MouseButton>(event.button.button),
                 event.button.down,
                 event.button.clicks,
-            });
-        }
+            };
+            break;
 
-        if (event.type == SDL_EVENT_MOUSE_MOTION) {
-            dispatcher_.dispatch<event::MouseMotion>({
+        case SDL_EVENT_MOUSE_MOTION:
+            queued.event = event::MouseMotion{
                 event.motion.xrel,
                 event.motion.yrel,
-            });
-        }
+            };
+            break;
 
-        if (event.type == SDL_EVENT_TEXT_INPUT) {
-            dispatcher_.dispatch<event::TextInput>({
-                event.text.text,
-            });
-        }
+        case SDL_EVENT_TEXT_INPUT:
+            queued.event = event::TextInput{};
+            queued.text = event.text.text;
+            break;
+
+        case SDL_EVENT_DROP_FILE:
+            queued.event = event::DropFile{};
+            queued.text = event.drop.data;
+            break;
+
+        case SDL_EVENT_DROP_TEXT:
+            queued.event = event::DropText{};
+            queued.text = event.drop.data;
+            break;
+
+        default:
+            return std::nullopt;
+    }
+
+    return queued;
+}
+
+} // namespace
 
-        if (event.type == SDL_EVENT_DROP_FILE) {
-            dispatcher_.dispatch<event::DropFile>({
-                event.drop.data,
-            });
+void Window::poll_events() {
+    if (queue_) {
+        while (auto queued = queue_->pop()) {
+            dispatch(*queued);
         }
+        return;
+    }
 
-        if (event.type == SDL_EVENT_DROP_TEXT) {
-            dispatcher_.dispatch<event::DropText>({
-                event.drop.data,
-            });
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        if (auto queued = translate(event)) {
+            dispatch(*queued);
         }
     }
 }
 
+void Window::use_event_queue(size_t capacity) {
+    core::expect(!queue_, "window is already using an event queue");
+    queue_ = std::make_unique<event::Queue>(capacity);
+    MU_LOG_DEBUG(Window, "window events are queued for a separate update thread");
+}
+
+void Window::pump_events(std::chrono::milliseconds timeout) {
+    core::expect(queue_, "window must use an event queue to pump events");
+
+    SDL_Event event;
+    if (SDL_WaitEventTimeout(&event, static_cast<int32_t>(timeout.count()))) {
+        do {
+            auto queued = translate(event);
+            if (!queued) {
+                continue;
+            }
+
+            if (!queue_->push(std::move(*queued))) {
+                dropped_events_ += 1;
+                MU_LOG_AT_MOST_PER_SEC(
+                    Window, spdlog::level::warn, 1, "window event queue is full, dropped {} events so far", dropped_events_
+                );
+            }
+        } while (SDL_PollEvent(&event));
+    }
+
+    // motion merged while the update thread was behind goes out even when nothing else comes in
+    queue_->flush();
+}
+
+auto Window::input_latency() const -> std::chrono::nanoseconds {
+    return std::chrono::nanoseconds{input_latency_.load(std::memory_order_relaxed)};
+}
+
+void Window::dispatch(event::Queued &queued) {
+    std::visit(
+        [&]<typename Event>(Event &event) {
+            if constexpr (std::is_same_v<Event, event::WindowResize>) {
+                extent_ = event.extent;
+            } else if constexpr (std::is_same_v<Event, event::TextInput> || std::is_same_v<Event, event::DropText>) {
+                event.text = queued.text.c_str();
+            } else if constexpr (std::is_same_v<Event, event::DropFile>) {
+                event.path = queued.text.c_str();
+            }
+
+            dispatcher_.dispatch<Event>(event);
+        },
+        queued.event
+    );
+
+    const uint64_t now = SDL_GetTicksNS();
+    input_latency_.store(now > queued.timestamp ? now - queued.timestamp : 0, std::memory_order_relaxed);
+}
+
+template <typename Fn>
+void Window::run_on_main_thread(Fn &&fn) const {
+    if (SDL_IsMainThread()) {
+        fn();
+        return;
+    }
+
+    // SDL only allows window management from the main thread, which keeps pumping events while this waits
+    auto callback = [](void *data) { (*static_cast<std::remove_reference_t<Fn> *>(data))(); };
+    if (!SDL_RunOnMainThread(callback, &fn, true)) {
+        handle_error();
+    }
+}
+
 auto Window::get_title() const -> std::string_view { return title_; }
 void Window::set_title(std::string_view title) {
     title_ = title;
-    SDL_SetWindowTitle(impl_->window, title_.c_str());
+    run_on_main_thread([&] { SDL_SetWindowTitle(impl_->window, title_.c_str()); });
 }
 
 auto Window::extent() const -> Extent2D { return extent_; }
@@ -156,54 +254,64 @@ void Window::set_mode(WindowMode mode) {
             break;
     }
 
-    bool success = SDL_SetWindowFullscreen(impl_->window, fullscreen);
-    core::expect(success, "failed to set window mode to: {}, {}", mode_, SDL_GetError());
+    run_on_main_thread([&] {
+        bool success = SDL_SetWindowFullscreen(impl_->window, fullscreen);
+        core::expect(success, "failed to set window mode to: {}, {}", mode_, SDL_GetError());
+    });
 }
 
 void Window::request_attention() const {
-    if (!SDL_FlashWindow(impl_->window, SDL_FLASH_UNTIL_FOCUSED)) {
-        handle_error();
-    }
+    run_on_main_thread([&] {
+        if (!SDL_FlashWindow(impl_->window, SDL_FLASH_UNTIL_FOCUSED)) {
+            handle_error();
+        }
+    });
 }
 
 auto Window::get_clipboard_text() const -> std::optional<std::string> {
-    if (!SDL_HasClipboardText()) {
-        return std::nullopt;
-    }
+    std::optional<std::string> text;
+
+    run_on_main_thread([&] {
+        if (!SDL_HasClipboardText()) {
+            return;
+        }
 
-    char *raw_text =  SDL_GetClipboardText();
-    if (std::strcmp(raw_text, "") == 0) {
+        char *raw_text =  SDL_GetClipboardText();
+        if (std::strcmp(raw_text, "") != 0) {
+            text = raw_text;
+        }
         SDL_free(raw_text);
-        return std::nullopt;
-    }
+    });
 
-    std::string text = raw_text;
-    SDL_free(raw_text);
     return text;
 }
 
 void Window::set_clipboard_text(const std::string_view text) {
-    SDL_SetClipboardText(text.data());
+    run_on_main_thread([&] { SDL_SetClipboardText(text.data()); });
 }
 
 void Window::begin_text_input() {
     core::expect(!text_input_, "cannot begin text input while already accepting text input");
 
-    if (SDL_StartTextInput(impl_->window)) {
-        text_input_ = true;
-    } else {
-        handle_error();
-    }
+    run_on_main_thread([&] {
+        if (SDL_StartTextInput(impl_->window)) {
+            text_input_ = true;
+        } else {
+            handle_error();
+        }
+    });
 }
 
 void Window::end_text_input() {
     core::expect(text_input_, "cannot end text input while not accepting text input");
 
-    if (SDL_StopTextInput(impl_->window)) {
-        text_input_ = false;
-    } else {
-        handle_error();
-    }
+    run_on_main_thread([&] {
+        if (SDL_StopTextInput(impl_->window)) {
+            text_input_ = false;
+        } else {
+            handle_error();
+        }
+    });
 }
 
 auto Window::displays() const -> std::optional<const std::vector<DisplayInfo>> {
@@ -255,7 +363,7 @@ auto Window::get_required_extensions() const -> std::vector<const char *> {
 
 void Window::handle_error() const {
     if (const char *error = SDL_GetError(); error) {
-        core::error(error);
+        MU_LOG_ERROR(Window, error);
     }
 }
 
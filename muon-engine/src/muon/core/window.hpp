@@ -1,10 +1,15 @@
 #pragma once
 
 #include "fmt/base.h"
+#include "muon/core/event_source.hpp"
 #include "muon/core/types.hpp"
 #include "muon/event/dispatcher.hpp"
+#include "muon/event/queue.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -23,7 +28,7 @@ enum class WindowMode {
     BorderlessFullscreen,
 };
 
-class Window {
+class Window final : public EventSource {
 public:
     Window(
         std::string_view title,
@@ -31,9 +36,18 @@ public:
         WindowMode mode,
         const event::Dispatcher &dispatcher
     );
-    ~Window();
+    ~Window() override;
 
-    void poll_events();
+    // dispatches OS events directly, or the events queued by pump_events once an event queue is in use
+    void poll_events() override;
+
+public: // dedicated event thread
+    void use_event_queue(size_t capacity);
+    // waits up to `timeout` for OS events and queues them, must be called from the main thread
+    void pump_events(std::chrono::milliseconds timeout);
+
+    // time between the OS timestamping the most recent event and its dispatch
+    auto input_latency() const -> std::chrono::nanoseconds;
 
 public: // class getters/setters
     auto get_title() const -> std::string_view;
@@ -62,8 +76,12 @@ public: // Vulkan
     auto get_required_extensions() const -> std::vector<const char *>;
 
 private:
+    void dispatch(event::Queued &queued);
     void handle_error() const;
 
+    template <typename Fn>
+    void run_on_main_thread(Fn &&fn) const;
+
 private:
     std::string title_;
     Extent2D extent_;
@@ -75,6 +93,10 @@ private:
     Impl *impl_;
 
     bool text_input_{false};
+
+    std::unique_ptr<event::Queue> queue_{nullptr};
+    uint64_t dropped_events_{0};
+    std::atomic<uint64_t> input_latency_{0};
 };
 
 } // namespace muon
@@ -0,0 +1,318 @@
+#include "muon/culling/occlusion_buffer.hpp"
+
+#include "muon/core/expect.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+namespace muon::culling {
+
+namespace {
+
+constexpr uint64_t FULL = ~uint64_t{0};
+
+// how far in front of the near plane a clip space position is
+auto near_distance(const glm::vec4 &clip) -> float {
+#if defined(GLM_FORCE_DEPTH_ZERO_TO_ONE)
+    return clip.z;
+#else
+    return clip.w + clip.z;
+#endif
+}
+
+// the bits of the columns first to last of one row of a tile, both relative to the tile
+auto row_bits(int first, int last) -> uint64_t {
+    if (first > last) {
+        return 0;
+    }
+    return ((uint64_t{1} << (last + 1)) - 1) & ~((uint64_t{1} << first) - 1);
+}
+
+} // namespace
+
+OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height)
+    : tiles_x_{(width + TILE_SIZE - 1) / TILE_SIZE}, tiles_y_{(height + TILE_SIZE - 1) / TILE_SIZE} {
+    core::expect(width > 0 && height > 0, "occlusion buffer must not be empty: {}x{}", width, height);
+    tiles_.resize(static_cast<size_t>(tiles_x_) * tiles_y_);
+}
+
+void OcclusionBuffer::clear(const glm::mat4 &view_projection) {
+    view_projection_ = view_projection;
+    std::ranges::fill(tiles_, Tile{});
+}
+
+void OcclusionBuffer::render(const glm::mat4 &model, std::span<const glm::vec3> vertices, std::span<const uint32_t> indices) {
+    core::expect(indices.size() % 3 == 0, "occluder indices must form triangles: {}", indices.size());
+    core::expect(
+        std::ranges::all_of(indices, [&](uint32_t index) { return index < vertices.size(); }), "occluder index out of range"
+    );
+
+    auto matrix = view_projection_ * model;
+    clip_.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        clip_[i] = matrix * glm::vec4{vertices[i], 1.0f};
+    }
+
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        clip_and_rasterise(clip_[indices[i]], clip_[indices[i + 1]], clip_[indices[i + 2]]);
+    }
+}
+
+auto OcclusionBuffer::is_visible(const maths::Aabb &box) const -> bool {
+    auto inf = std::numeric_limits<float>::infinity();
+    float min_x = inf;
+    float min_y = inf;
+    float max_x = -inf;
+    float max_y = -inf;
+    float min_depth = inf;
+    // the corners are the transformed centre plus or minus the transformed half extent along each axis
+    auto center = view_projection_ * glm::vec4{box.center(), 1.0f};
+    auto extent = box.extent();
+    std::array<glm::vec4, 3> axes{view_projection_[0] * extent.x, view_projection_[1] * extent.y, view_projection_[2] * extent.z};
+    for (uint32_t corner = 0; corner < 8; corner++) {
+        auto clip = center + (corner & 1 ? axes[0] : -axes[0]) + (corner & 2 ? axes[1] : -axes[1]) +
+                    (corner & 4 ? axes[2] : -axes[2]);
+        if (near_distance(clip) <= 0.0f) {
+            return true;
+        }
+        auto screen = to_screen(clip);
+        min_x = std::min(min_x, screen.x);
+        min_y = std::min(min_y, screen.y);
+        max_x = std::max(max_x, screen.x);
+        max_y = std::max(max_y, screen.y);
+        min_depth = std::min(min_depth, screen.depth);
+    }
+
+    auto width = static_cast<float>(this->width());
+    auto height = static_cast<float>(this->height());
+    if (max_x < 0.0f || max_y < 0.0f || min_x >= width || min_y >= height) {
+        return false;
+    }
+
+    // every pixel the rectangle touches
+    auto first_x = static_cast<int>(std::max(std::floor(min_x), 0.0f));
+    auto first_y = static_cast<int>(std::max(std::floor(min_y), 0.0f));
+    auto last_x = static_cast<int>(std::min(std::floor(max_x), width - 1.0f));
+    auto last_y = static_cast<int>(std::min(std::floor(max_y), height - 1.0f));
+
+    constexpr int SIZE = TILE_SIZE;
+    for (int ty = first_y / SIZE; ty <= last_y / SIZE; ty++) {
+        auto row_first = std::max(first_y - ty * SIZE, 0);
+        auto row_last = std::min(last_y - ty * SIZE, SIZE - 1);
+        for (int tx = first_x / SIZE; tx <= last_x / SIZE; tx++) {
+            auto columns = row_bits(std::max(first_x - tx * SIZE, 0), std::min(last_x - tx * SIZE, SIZE - 1));
+            uint64_t rect = 0;
+            for (int row = row_first; row <= row_last; row++) {
+                rect |= columns << (row * SIZE);
+            }
+
+            const auto &tile = tiles_[static_cast<size_t>(ty) * tiles_x_ + static_cast<size_t>(tx)];
+            if ((rect & ~tile.mask) != 0 && min_depth <= tile.reference) {
+                return true;
+            }
+            if ((rect & tile.mask) != 0 && min_depth <= tile.working) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void OcclusionBuffer::cull(maths::AabbSoa<const float> boxes, std::vector<uint32_t> &visible) const {
+    core::expect(
+        boxes.min.y.size() == boxes.size() && boxes.min.z.size() == boxes.size() && boxes.max.x.size() == boxes.size() &&
+            boxes.max.y.size() == boxes.size() && boxes.max.z.size() == boxes.size(),
+        "mismatched batch sizes"
+    );
+    auto occluded = std::ranges::remove_if(visible, [&](uint32_t index) {
+        maths::Aabb box{
+            {boxes.min.x[index], boxes.min.y[index], boxes.min.z[index]},
+            {boxes.max.x[index], boxes.max.y[index], boxes.max.z[index]},
+        };
+        return !is_visible(box);
+    });
+    visible.erase(occluded.begin(), occluded.end());
+}
+
+auto OcclusionBuffer::resolve() const -> std::vector<float> {
+    std::vector<float> depth(static_cast<size_t>(width()) * height());
+    for (uint32_t ty = 0; ty < tiles_y_; ty++) {
+        for (uint32_t tx = 0; tx < tiles_x_; tx++) {
+            const auto &tile = tiles_[ty * tiles_x_ + tx];
+            for (uint32_t bit = 0; bit < TILE_SIZE * TILE_SIZE; bit++) {
+                auto x = tx * TILE_SIZE + bit % TILE_SIZE;
+                auto y = ty * TILE_SIZE + bit / TILE_SIZE;
+                depth[static_cast<size_t>(y) * width() + x] = (tile.mask >> bit) & 1 ? tile.working : tile.reference;
+            }
+        }
+    }
+    return depth;
+}
+
+auto OcclusionBuffer::width() const -> uint32_t { return tiles_x_ * TILE_SIZE; }
+
+auto OcclusionBuffer::height() const -> uint32_t { return tiles_y_ * TILE_SIZE; }
+
+auto OcclusionBuffer::to_screen(const glm::vec4 &clip) const -> ScreenVertex {
+    auto inverse = 1.0f / clip.w;
+#if defined(GLM_FORCE_DEPTH_ZERO_TO_ONE)
+    auto depth = clip.z * inverse;
+#else
+    auto depth = clip.z * inverse * 0.5f + 0.5f;
+#endif
+    return {
+        (clip.x * inverse * 0.5f + 0.5f) * static_cast<float>(width()),
+        (clip.y * inverse * 0.5f + 0.5f) * static_cast<float>(height()),
+        depth,
+    };
+}
+
+void OcclusionBuffer::clip_and_rasterise(const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c) {
+    std::array<glm::vec4, 3> vertices{a, b, c};
+    std::array<float, 3> distances{near_distance(a), near_distance(b), near_distance(c)};
+    if (distances[0] >= 0.0f && distances[1] >= 0.0f && distances[2] >= 0.0f) {
+        rasterise(to_screen(a), to_screen(b), to_screen(c));
+        return;
+    }
+    if (distances[0] < 0.0f && distances[1] < 0.0f && distances[2] < 0.0f) {
+        return;
+    }
+
+    // cutting a corner off leaves a quad, cutting two leaves a smaller triangle
+    std::array<glm::vec4, 4> polygon;
+    size_t count = 0;
+    for (size_t i = 0; i < 3; i++) {
+        size_t next = (i + 1) % 3;
+        if (distances[i] >= 0.0f) {
+            polygon[count++] = vertices[i];
+        }
+        if ((distances[i] >= 0.0f) != (distances[next] >= 0.0f)) {
+            auto t = distances[i] / (distances[i] - distances[next]);
+            polygon[count++] = vertices[i] + (vertices[next] - vertices[i]) * t;
+        }
+    }
+
+    rasterise(to_screen(polygon[0]), to_screen(polygon[1]), to_screen(polygon[2]));
+    if (count == 4) {
+        rasterise(to_screen(polygon[0]), to_screen(polygon[2]), to_screen(polygon[3]));
+    }
+}
+
+void OcclusionBuffer::rasterise(ScreenVertex a, ScreenVertex b, ScreenVertex c) {
+    auto area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (!(std::abs(area) > 0.0f)) {
+        return;
+    }
+    // counter clockwise from here on so the inside is to the left of every edge
+    if (area < 0.0f) {
+        std::swap(b, c);
+        area = -area;
+    }
+
+    auto min_x = std::min({a.x, b.x, c.x});
+    auto min_y = std::min({a.y, b.y, c.y});
+    auto max_x = std::max({a.x, b.x, c.x});
+    auto max_y = std::max({a.y, b.y, c.y});
+
+    // every pixel whose centre could be inside
+    auto first_x = std::max(std::ceil(min_x - 0.5f), 0.0f);
+    auto first_y = std::max(std::ceil(min_y - 0.5f), 0.0f);
+    auto last_x = std::min(std::floor(max_x - 0.5f), static_cast<float>(width() - 1));
+    auto last_y = std::min(std::floor(max_y - 0.5f), static_cast<float>(height() - 1));
+    if (first_x > last_x || first_y > last_y) {
+        return;
+    }
+
+    // depth is affine in screen space, so over any part of the triangle it is farthest at a corner of that part
+    auto dzdx = ((b.depth - a.depth) * (c.y - a.y) - (c.depth - a.depth) * (b.y - a.y)) / area;
+    auto dzdy = ((c.depth - a.depth) * (b.x - a.x) - (b.depth - a.depth) * (c.x - a.x)) / area;
+    auto max_depth = std::max({a.depth, b.depth, c.depth});
+
+    struct Edge {
+        ScreenVertex from;
+        float dx;
+        float dy;
+    };
+    std::array<Edge, 3> edges{{{a, b.x - a.x, b.y - a.y}, {b, c.x - b.x, c.y - b.y}, {c, a.x - c.x, a.y - c.y}}};
+
+    constexpr int SIZE = TILE_SIZE;
+    auto pixel_first_x = static_cast<int>(first_x);
+    auto pixel_last_x = static_cast<int>(last_x);
+    auto pixel_first_y = static_cast<int>(first_y);
+    auto pixel_last_y = static_cast<int>(last_y);
+    for (int ty = pixel_first_y / SIZE; ty <= pixel_last_y / SIZE; ty++) {
+        // the triangle crosses each scanline in a single span, found once per row and shared by the row's tiles
+        std::array<int, TILE_SIZE> span_first;
+        std::array<int, TILE_SIZE> span_last;
+        for (int row = 0; row < SIZE; row++) {
+            auto y = ty * SIZE + row;
+            span_first[row] = pixel_first_x;
+            span_last[row] = y < pixel_first_y || y > pixel_last_y ? -1 : pixel_last_x;
+
+            auto center_y = static_cast<float>(y) + 0.5f;
+            for (const auto &edge : edges) {
+                // left of the edge where dx * (y - from.y) - dy * (x - from.x) >= 0
+                auto along = edge.dx * (center_y - edge.from.y);
+                if (edge.dy == 0.0f) {
+                    if (along < 0.0f) {
+                        span_last[row] = -1;
+                    }
+                    continue;
+                }
+                auto crossing = edge.from.x + along / edge.dy - 0.5f;
+                if (edge.dy < 0.0f) {
+                    auto first = std::clamp(std::ceil(crossing), first_x, last_x + 1.0f);
+                    span_first[row] = std::max(span_first[row], static_cast<int>(first));
+                } else {
+                    auto last = std::clamp(std::floor(crossing), first_x - 1.0f, last_x);
+                    span_last[row] = std::min(span_last[row], static_cast<int>(last));
+                }
+            }
+        }
+
+        auto tile_min_y = std::max(static_cast<float>(ty * SIZE), min_y);
+        auto tile_max_y = std::min(static_cast<float>((ty + 1) * SIZE), max_y);
+        for (int tx = pixel_first_x / SIZE; tx <= pixel_last_x / SIZE; tx++) {
+            uint64_t coverage = 0;
+            for (int row = 0; row < SIZE; row++) {
+                auto first = std::max(span_first[row] - tx * SIZE, 0);
+                auto last = std::min(span_last[row] - tx * SIZE, SIZE - 1);
+                coverage |= row_bits(first, last) << (row * SIZE);
+            }
+            if (coverage == 0) {
+                continue;
+            }
+
+            auto tile_min_x = std::max(static_cast<float>(tx * SIZE), min_x);
+            auto tile_max_x = std::min(static_cast<float>((tx + 1) * SIZE), max_x);
+            auto x = dzdx > 0.0f ? tile_max_x : tile_min_x;
+            auto y = dzdy > 0.0f ? tile_max_y : tile_min_y;
+            auto depth = std::min(a.depth + dzdx * (x - a.x) + dzdy * (y - a.y), max_depth);
+            update(tiles_[static_cast<size_t>(ty) * tiles_x_ + static_cast<size_t>(tx)], coverage, depth);
+        }
+    }
+}
+
+// the quick merge of masked occlusion culling, pixels in the mask are only known to be in front of the working depth,
+// the rest in front of the reference depth, and once the mask covers the tile the working layer becomes the reference
+void OcclusionBuffer::update(Tile &tile, uint64_t coverage, float depth) {
+    if (depth >= tile.reference) {
+        return;
+    }
+
+    // a triangle much closer than the working layer starts a new one rather than being merged into it and lost
+    if (tile.mask != 0 && tile.working - depth > tile.reference - tile.working) {
+        tile.mask = 0;
+    }
+    tile.working = tile.mask == 0 ? depth : std::max(tile.working, depth);
+    tile.mask |= coverage;
+
+    if (tile.mask == FULL) {
+        tile.reference = tile.working;
+        tile.mask = 0;
+    }
+}
+
+} // namespace muon::culling
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "muon/maths/batch.hpp"
+#include "muon/maths/bounds.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace muon::culling {
+
+// a low resolution software depth buffer in the style of masked occlusion culling, instead of a depth per pixel every
+// 8x8 tile keeps a coverage mask and two conservative depths, occluders are rasterised into it a scanline mask at a
+// time and the screen bounds of occludees are tested against it, all on the cpu
+//
+// depth is the normalised device depth mapped to [0, 1] and increases away from the camera, so reversed depth
+// projections aren't supported
+class OcclusionBuffer : utils::NoCopy, utils::NoMove {
+public:
+    static constexpr uint32_t TILE_SIZE = 8;
+
+    // rounded up to whole tiles
+    OcclusionBuffer(uint32_t width = 256, uint32_t height = 144);
+
+    // empties the buffer and sets the camera for the renders and tests that follow
+    void clear(const glm::mat4 &view_projection);
+
+    // rasterises indexed triangles with both windings, clipped against the near plane, pixels count as covered when
+    // their centre is
+    void render(const glm::mat4 &model, std::span<const glm::vec3> vertices, std::span<const uint32_t> indices);
+
+    // whether the box could be visible, boxes reaching behind the near plane always are and off screen ones never are
+    auto is_visible(const maths::Aabb &box) const -> bool;
+
+    // drops the indices of occluded boxes from visible and keeps the order, meant to run on what maths::frustum_cull
+    // left over
+    void cull(maths::AabbSoa<const float> boxes, std::vector<uint32_t> &visible) const;
+
+    // the depth every pixel is known to be in front of, rows from the bottom of the screen up, infinite where nothing
+    // was rendered
+    auto resolve() const -> std::vector<float>;
+
+    auto width() const -> uint32_t;
+    auto height() const -> uint32_t;
+
+private:
+    struct Tile {
+        // pixels of the working layer, cleared as soon as it covers the whole tile
+        uint64_t mask{0};
+        // the farthest depth of the pixels outside the mask
+        float reference{std::numeric_limits<float>::infinity()};
+        // the farthest depth of the pixels in the mask
+        float working{0.0f};
+    };
+
+    struct ScreenVertex {
+        float x;
+        float y;
+        float depth;
+    };
+
+    auto to_screen(const glm::vec4 &clip) const -> ScreenVertex;
+    void clip_and_rasterise(const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c);
+    void rasterise(ScreenVertex a, ScreenVertex b, ScreenVertex c);
+    static void update(Tile &tile, uint64_t coverage, float depth);
+
+private:
+    uint32_t tiles_x_;
+    uint32_t tiles_y_;
+    std::vector<Tile> tiles_;
+
+    glm::mat4 view_projection_{1.0f};
+    std::vector<glm::vec4> clip_;
+};
+
+} // namespace muon::culling
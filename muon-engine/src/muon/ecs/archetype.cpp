@@ -0,0 +1,149 @@
+#include "muon/ecs/archetype.hpp"
+
+#include "muon/core/expect.hpp"
+#include "muon/maths/alignment.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace muon::ecs {
+
+namespace {
+
+auto allocate_chunk() -> std::byte * {
+    return static_cast<std::byte *>(::operator new(CHUNK_SIZE, std::align_val_t{CHUNK_ALIGNMENT}));
+}
+
+void free_chunk(std::byte *chunk) { ::operator delete(chunk, std::align_val_t{CHUNK_ALIGNMENT}); }
+
+} // namespace
+
+Archetype::Archetype(std::vector<ComponentId> components) : components_{std::move(components)} {
+    core::expect(std::ranges::is_sorted(components_), "archetype components have to be sorted");
+    core::expect(std::ranges::adjacent_find(components_) == components_.end(), "archetype components have to be unique");
+
+    size_t row_size = sizeof(Entity);
+    for (auto component : components_) {
+        infos_.push_back(component_info(component));
+        row_size += infos_.back().size;
+    }
+
+    // every column starts on a cache line, shrinking the capacity until the padding fits
+    offsets_.resize(components_.size());
+    for (capacity_ = CHUNK_SIZE / row_size; capacity_ > 0; capacity_--) {
+        size_t offset = capacity_ * sizeof(Entity);
+        for (size_t i = 0; i < infos_.size(); i++) {
+            offset = maths::align<CHUNK_ALIGNMENT>(offset);
+            offsets_[i] = static_cast<uint32_t>(offset);
+            offset += capacity_ * infos_[i].size;
+        }
+        if (offset <= CHUNK_SIZE) {
+            break;
+        }
+    }
+    core::expect(capacity_ > 0, "archetype components don't fit in a chunk");
+}
+
+Archetype::~Archetype() {
+    for (size_t row = 0; row < size_; row++) {
+        for (uint32_t column = 0; column < infos_.size(); column++) {
+            infos_[column].destroy(component(row, column));
+        }
+    }
+    for (auto *chunk : chunks_) {
+        free_chunk(chunk);
+    }
+}
+
+auto Archetype::components() const -> std::span<const ComponentId> { return components_; }
+
+auto Archetype::column(ComponentId component) const -> uint32_t {
+    auto found = std::ranges::lower_bound(components_, component);
+    if (found == components_.end() || *found != component) {
+        return NO_COLUMN;
+    }
+    return static_cast<uint32_t>(found - components_.begin());
+}
+
+auto Archetype::info(uint32_t column) const -> const ComponentInfo & { return infos_[column]; }
+
+auto Archetype::size() const -> size_t { return size_; }
+
+auto Archetype::chunk_capacity() const -> size_t { return capacity_; }
+
+// trailing chunks may be empty spares
+auto Archetype::chunk_count() const -> size_t { return (size_ + capacity_ - 1) / capacity_; }
+
+auto Archetype::chunk_size(size_t chunk) const -> size_t { return std::min(capacity_, size_ - chunk * capacity_); }
+
+auto Archetype::entities(size_t chunk) const -> Entity * {
+    return std::launder(reinterpret_cast<Entity *>(chunks_[chunk]));
+}
+
+auto Archetype::column_data(size_t chunk, uint32_t column) const -> void * { return chunks_[chunk] + offsets_[column]; }
+
+auto Archetype::component(size_t row, uint32_t column) const -> void * {
+    return chunks_[row / capacity_] + offsets_[column] + (row % capacity_) * infos_[column].size;
+}
+
+auto Archetype::entity(size_t row) const -> Entity { return entities(row / capacity_)[row % capacity_]; }
+
+auto Archetype::push(Entity entity) -> size_t {
+    if (size_ == chunks_.size() * capacity_) {
+        chunks_.push_back(allocate_chunk());
+    }
+
+    auto row = size_++;
+    new (chunks_[row / capacity_] + (row % capacity_) * sizeof(Entity)) Entity{entity};
+    return row;
+}
+
+auto Archetype::erase(size_t row) -> std::optional<Entity> {
+    for (uint32_t column = 0; column < infos_.size(); column++) {
+        infos_[column].destroy(component(row, column));
+    }
+    return vacate(row);
+}
+
+auto Archetype::vacate(size_t row) -> std::optional<Entity> {
+    core::expect(row < size_, "archetype row out of range");
+
+    std::optional<Entity> moved;
+    auto last = size_ - 1;
+    if (row != last) {
+        for (uint32_t column = 0; column < infos_.size(); column++) {
+            infos_[column].relocate(component(row, column), component(last, column));
+        }
+        moved = entity(last);
+        entities(row / capacity_)[row % capacity_] = *moved;
+    }
+    size_--;
+
+    // one spare chunk is kept so an entity moving back and forth doesn't allocate every time
+    while (chunks_.size() > chunk_count() + 1) {
+        free_chunk(chunks_.back());
+        chunks_.pop_back();
+    }
+    return moved;
+}
+
+auto Archetype::edge(ComponentId component, bool add) const -> Archetype * {
+    for (const auto &edge : edges_) {
+        if (edge.component == component) {
+            return add ? edge.add : edge.remove;
+        }
+    }
+    return nullptr;
+}
+
+void Archetype::set_edge(ComponentId component, bool add, Archetype *archetype) {
+    for (auto &edge : edges_) {
+        if (edge.component == component) {
+            (add ? edge.add : edge.remove) = archetype;
+            return;
+        }
+    }
+    edges_.push_back({component, add ? archetype : nullptr, add ? nullptr : archetype});
+}
+
+} // namespace muon::ecs
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "muon/ecs/component.hpp"
+#include "muon/ecs/entity.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace muon::ecs {
+
+constexpr size_t CHUNK_SIZE = 16 * 1024;
+
+// every entity with exactly the same set of components, stored in fixed size chunks that each hold one column per
+// component plus one for the entities, all chunks but the last are full so rows are numbered contiguously
+class Archetype : utils::NoCopy, utils::NoMove {
+public:
+    static constexpr uint32_t NO_COLUMN = std::numeric_limits<uint32_t>::max();
+
+    // components have to be sorted and unique
+    explicit Archetype(std::vector<ComponentId> components);
+    ~Archetype();
+
+    auto components() const -> std::span<const ComponentId>;
+    auto column(ComponentId component) const -> uint32_t;
+    auto info(uint32_t column) const -> const ComponentInfo &;
+
+    auto size() const -> size_t;
+    auto chunk_capacity() const -> size_t;
+    auto chunk_count() const -> size_t;
+    auto chunk_size(size_t chunk) const -> size_t;
+
+    auto entities(size_t chunk) const -> Entity *;
+    auto column_data(size_t chunk, uint32_t column) const -> void *;
+    auto component(size_t row, uint32_t column) const -> void *;
+    auto entity(size_t row) const -> Entity;
+
+    // appends a row for the entity, its components are left for the caller to construct
+    auto push(Entity entity) -> size_t;
+
+    // destroys the row's components and fills the hole with the last row, returns the entity that moved into it
+    auto erase(size_t row) -> std::optional<Entity>;
+
+    // fills the hole of a row whose components were already moved out or destroyed
+    auto vacate(size_t row) -> std::optional<Entity>;
+
+    // cached transitions to the archetype with one component more or less
+    auto edge(ComponentId component, bool add) const -> Archetype *;
+    void set_edge(ComponentId component, bool add, Archetype *archetype);
+
+private:
+    std::vector<ComponentId> components_;
+    std::vector<ComponentInfo> infos_;
+    std::vector<uint32_t> offsets_;
+    size_t capacity_{0};
+
+    std::vector<std::byte *> chunks_;
+    size_t size_{0};
+
+    struct Edge {
+        ComponentId component;
+        Archetype *add;
+        Archetype *remove;
+    };
+    std::vector<Edge> edges_;
+};
+
+} // namespace muon::ecs
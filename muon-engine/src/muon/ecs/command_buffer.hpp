@@ -0,0 +1,69 @@
+#pragma once
+
+#include "muon/core/uuid.hpp"
+#include "muon/ecs/component.hpp"
+#include "muon/ecs/entity.hpp"
+#include "muon/ecs/world.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace muon::ecs {
+
+// records structural changes while queries are iterating and applies them in order afterwards, changes to entities
+// destroyed earlier in the same buffer are skipped
+class CommandBuffer {
+public:
+    // the uuid is assigned up front, so the entity can be looked up once the buffer is applied
+    template <ComponentValue... Ts>
+    auto create(Ts &&...components) -> Uuid {
+        auto uuid = Uuid::uuid7();
+        commands_.emplace_back([uuid, ... values = std::remove_cvref_t<Ts>{std::forward<Ts>(components)}](World &world
+                               ) mutable { world.restore(uuid, std::move(values)...); });
+        return uuid;
+    }
+
+    void destroy(Entity entity) {
+        commands_.emplace_back([entity](World &world) {
+            if (world.alive(entity)) {
+                world.destroy(entity);
+            }
+        });
+    }
+
+    template <ComponentValue T>
+    void add(Entity entity, T &&component) {
+        commands_.emplace_back([entity, value = std::remove_cvref_t<T>{std::forward<T>(component)}](World &world) mutable {
+            if (world.alive(entity)) {
+                world.add<std::remove_cvref_t<T>>(entity, std::move(value));
+            }
+        });
+    }
+
+    template <Component T>
+    void remove(Entity entity) {
+        commands_.emplace_back([entity](World &world) {
+            if (world.alive(entity)) {
+                world.remove<T>(entity);
+            }
+        });
+    }
+
+    void apply(World &world) {
+        for (auto &command : commands_) {
+            command(world);
+        }
+        commands_.clear();
+    }
+
+    auto size() const -> size_t { return commands_.size(); }
+    auto empty() const -> bool { return commands_.empty(); }
+
+private:
+    std::vector<std::move_only_function<void(World &)>> commands_;
+};
+
+} // namespace muon::ecs
@@ -0,0 +1,44 @@
+#include "muon/ecs/component.hpp"
+
+#include "muon/core/expect.hpp"
+
+#include <deque>
+#include <mutex>
+
+namespace muon::ecs {
+
+namespace {
+
+struct Registry {
+    std::mutex mutex;
+
+    // a deque so that references handed out stay valid as components are registered
+    std::deque<ComponentInfo> infos;
+};
+
+auto registry() -> Registry & {
+    static Registry registry;
+    return registry;
+}
+
+} // namespace
+
+namespace internal {
+
+auto register_component(const ComponentInfo &info) -> ComponentId {
+    auto &components = registry();
+    std::scoped_lock lock{components.mutex};
+    components.infos.push_back(info);
+    return static_cast<ComponentId>(components.infos.size() - 1);
+}
+
+} // namespace internal
+
+auto component_info(ComponentId id) -> const ComponentInfo & {
+    auto &components = registry();
+    std::scoped_lock lock{components.mutex};
+    core::expect(id < components.infos.size(), "unknown component id {}", id);
+    return components.infos[id];
+}
+
+} // namespace muon::ecs
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace muon::ecs {
+
+// the alignment chunks are allocated at, and so the largest a component can ask for
+constexpr size_t CHUNK_ALIGNMENT = 64;
+
+template <typename T>
+concept Component = std::is_object_v<T> && !std::is_const_v<T> && std::is_nothrow_move_constructible_v<T> &&
+                    std::is_nothrow_destructible_v<T> && alignof(T) <= CHUNK_ALIGNMENT;
+
+using ComponentId = uint32_t;
+
+// how a column of a component is moved and destroyed without knowing its type
+struct ComponentInfo {
+    size_t size;
+    size_t alignment;
+
+    // move constructs into destination and destroys the source
+    void (*relocate)(void *destination, void *source) noexcept;
+    void (*destroy)(void *value) noexcept;
+};
+
+namespace internal {
+
+auto register_component(const ComponentInfo &info) -> ComponentId;
+
+template <Component T>
+auto make_component_info() -> ComponentInfo {
+    return {
+        .size = sizeof(T),
+        .alignment = alignof(T),
+        .relocate =
+            [](void *destination, void *source) noexcept {
+                auto *value = std::launder(static_cast<T *>(source));
+                new (destination) T{std::move(*value)};
+                value->~T();
+            },
+        .destroy = [](void *value) noexcept { std::launder(static_cast<T *>(value))->~T(); },
+    };
+}
+
+} // namespace internal
+
+// ids are handed out on first use, so they are only stable within one run of the program
+template <Component T>
+auto component_id() -> ComponentId {
+    static const ComponentId id = internal::register_component(internal::make_component_info<T>());
+    return id;
+}
+
+auto component_info(ComponentId id) -> const ComponentInfo &;
+
+} // namespace muon::ecs
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace muon::ecs {
+
+// a dense index into the world's records, the generation changes whenever the index is reused
+struct Entity {
+    uint32_t index{0};
+    uint32_t generation{0};
+
+    auto operator==(const Entity &) const -> bool = default;
+};
+
+} // namespace muon::ecs
+
+template <>
+struct std::hash<muon::ecs::Entity> {
+    auto operator()(const muon::ecs::Entity &entity) const -> size_t {
+        return std::hash<uint64_t>{}((static_cast<uint64_t>(entity.generation) << 32) | entity.index);
+    }
+};
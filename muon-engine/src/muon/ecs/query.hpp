@@ -0,0 +1,133 @@
+#pragma once
+
+#include "muon/ecs/archetype.hpp"
+#include "muon/ecs/component.hpp"
+#include "muon/ecs/entity.hpp"
+#include "muon/ecs/world.hpp"
+#include "muon/job/system.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace muon::ecs {
+
+// every entity with at least the given components, const components are only read, keep the query around between
+// frames since the archetypes that match are cached and only new archetypes are checked when it runs
+template <typename... Ts>
+    requires(Component<std::remove_const_t<Ts>> && ...)
+class Query {
+public:
+    explicit Query(World &world) : world_{&world} {}
+
+    // fn(Ts &...) or fn(Entity, Ts &...) for every match
+    template <typename Fn>
+    void each(Fn &&fn) {
+        each_chunk(per_entity(fn));
+    }
+
+    // fn(std::span<const Entity>, std::span<Ts>...) once per chunk, the columns are contiguous so loops over them
+    // vectorise
+    template <typename Fn>
+    void each_chunk(Fn &&fn) {
+        refresh();
+        for (const auto &match : matches_) {
+            for (size_t chunk = 0; chunk < match.archetype->chunk_count(); chunk++) {
+                run_chunk(match, chunk, fn, std::index_sequence_for<Ts...>{});
+            }
+        }
+    }
+
+    // same as above but chunks are spread across the job system's workers, fn is called concurrently and must only
+    // touch the components it's given
+    template <typename Fn>
+    void each(job::System &jobs, Fn &&fn) {
+        each_chunk(jobs, per_entity(fn));
+    }
+
+    template <typename Fn>
+    void each_chunk(job::System &jobs, Fn &&fn) {
+        refresh();
+        chunks_.clear();
+        for (uint32_t match = 0; match < matches_.size(); match++) {
+            for (size_t chunk = 0; chunk < matches_[match].archetype->chunk_count(); chunk++) {
+                chunks_.push_back({match, static_cast<uint32_t>(chunk)});
+            }
+        }
+
+        // a few ranges per worker so one slow range doesn't hold up the rest
+        auto grain = std::max<size_t>(chunks_.size() / ((jobs.worker_count() + 1) * RANGES_PER_WORKER), 1);
+        jobs.parallel_for(chunks_.size(), grain, [this, &fn](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                run_chunk(matches_[chunks_[i].match], chunks_[i].chunk, fn, std::index_sequence_for<Ts...>{});
+            }
+        });
+    }
+
+    auto size() -> size_t {
+        refresh();
+        size_t count = 0;
+        for (const auto &match : matches_) {
+            count += match.archetype->size();
+        }
+        return count;
+    }
+
+private:
+    static constexpr size_t RANGES_PER_WORKER = 4;
+
+    struct Match {
+        Archetype *archetype;
+        std::array<uint32_t, sizeof...(Ts)> columns;
+    };
+
+    struct ChunkRef {
+        uint32_t match;
+        uint32_t chunk;
+    };
+
+    void refresh() {
+        const auto &archetypes = world_->archetypes_;
+        for (; seen_ < archetypes.size(); seen_++) {
+            auto *archetype = archetypes[seen_].get();
+            Match match{archetype, {archetype->column(component_id<std::remove_const_t<Ts>>())...}};
+            if (std::ranges::find(match.columns, Archetype::NO_COLUMN) == match.columns.end()) {
+                matches_.push_back(match);
+            }
+        }
+    }
+
+    template <typename Fn>
+    static auto per_entity(Fn &fn) {
+        return [&fn](std::span<const Entity> entities, std::span<Ts>... columns) {
+            for (size_t i = 0; i < entities.size(); i++) {
+                if constexpr (std::is_invocable_v<Fn &, Entity, Ts &...>) {
+                    fn(entities[i], columns[i]...);
+                } else {
+                    fn(columns[i]...);
+                }
+            }
+        };
+    }
+
+    template <typename Fn, size_t... I>
+    static void run_chunk(const Match &match, size_t chunk, Fn &fn, std::index_sequence<I...>) {
+        auto count = match.archetype->chunk_size(chunk);
+        fn(std::span<const Entity>{match.archetype->entities(chunk), count},
+           std::span<Ts>{std::launder(static_cast<Ts *>(match.archetype->column_data(chunk, match.columns[I]))), count}...);
+    }
+
+private:
+    World *world_;
+    std::vector<Match> matches_;
+    size_t seen_{0};
+    std::vector<ChunkRef> chunks_;
+};
+
+} // namespace muon::ecs
@@ -0,0 +1,192 @@
+#include "muon/ecs/scheduler.hpp"
+
+#include "muon/core/expect.hpp"
+#include "muon/core/log.hpp"
+#include "muon/profile/profiler.hpp"
+#include "muon/utils/platform.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <typeinfo>
+
+namespace muon::ecs {
+
+namespace {
+
+auto overlaps(const std::vector<ComponentId> &lhs, const std::vector<ComponentId> &rhs) -> bool {
+    return std::ranges::any_of(lhs, [&](auto component) { return std::ranges::find(rhs, component) != rhs.end(); });
+}
+
+auto conflicts(const System *earlier, const System *later) -> bool {
+    const auto &first = earlier->access();
+    const auto &second = later->access();
+
+    if (!first.declared || !second.declared) {
+        return true;
+    }
+
+    return overlaps(first.writes, second.writes) || overlaps(first.writes, second.reads) ||
+           overlaps(first.reads, second.writes);
+}
+
+} // namespace
+
+Scheduler::Scheduler(World &world, size_t stats_window) : world_{&world}, stats_window_{stats_window} {}
+
+void Scheduler::add(std::unique_ptr<System> system) {
+    core::expect(system != nullptr, "can't schedule a null system");
+
+    auto entry = std::make_unique<Entry>();
+    entry->name = profile::intern(utils::demangle(typeid(*system).name()));
+    entry->system = std::move(system);
+    entry->timings = std::make_unique<profile::RollingHistogram>(stats_window_);
+    entries_.push_back(std::move(entry));
+    dirty_ = true;
+}
+
+void Scheduler::run(job::System &jobs) {
+    if (dirty_) {
+        build();
+    }
+
+    for (auto &level : entry_levels_) {
+        if (level.size() == 1) {
+            update(*level.front(), jobs);
+            continue;
+        }
+
+        job::Counter counter;
+        for (size_t i = 1; i < level.size(); i++) {
+            jobs.submit([this, &jobs, entry = level[i]] { update(*entry, jobs); }, counter);
+        }
+
+        jobs.run_and_wait([&] { update(*level.front(), jobs); }, counter);
+    }
+
+    MU_PROFILE_ZONE("apply_commands");
+    for (auto &entry : entries_) {
+        entry->commands.apply(*world_);
+    }
+}
+
+auto Scheduler::levels() -> const std::vector<Level> & {
+    if (dirty_) {
+        build();
+    }
+    return levels_;
+}
+
+auto Scheduler::name(const System &system) const -> std::string_view { return entry(system).name; }
+
+auto Scheduler::timings(const System &system) const -> const profile::RollingHistogram & {
+    return *entry(system).timings;
+}
+
+void Scheduler::log_timings() const {
+    auto ms = [](profile::Duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+    for (const auto &entry : entries_) {
+        const auto stats = entry->timings->percentiles();
+        core::info(
+            "{} over {} runs: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+            entry->name, stats.count, ms(stats.p50), ms(stats.p95), ms(stats.p99), ms(stats.max)
+        );
+    }
+}
+
+void Scheduler::build() {
+    dirty_ = false;
+    levels_.clear();
+    entry_levels_.clear();
+
+    const size_t count = entries_.size();
+    if (count == 0) {
+        return;
+    }
+
+    // conflicting systems keep the order they were added in, explicit dependencies may point either way
+    std::vector<std::vector<size_t>> successors(count);
+    std::vector<size_t> in_degree(count, 0);
+    auto add_edge = [&](size_t from, size_t to) {
+        if (std::ranges::find(successors[from], to) == successors[from].end()) {
+            successors[from].emplace_back(to);
+            in_degree[to] += 1;
+        }
+    };
+
+    for (size_t later = 0; later < count; later++) {
+        const auto *system = entries_[later]->system.get();
+        for (size_t earlier = 0; earlier < later; earlier++) {
+            if (conflicts(entries_[earlier]->system.get(), system)) {
+                add_edge(earlier, later);
+            }
+        }
+
+        for (const System *dependency : system->access().after) {
+            auto it = std::ranges::find_if(entries_, [&](const auto &entry) { return entry->system.get() == dependency; });
+            if (it == entries_.end()) {
+                core::warn("system {} depends on a system that is not scheduled, ignoring", entries_[later]->name);
+                continue;
+            }
+            add_edge(static_cast<size_t>(it - entries_.begin()), later);
+        }
+    }
+
+    std::vector<size_t> depth(count, 0);
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < count; i++) {
+        if (in_degree[i] == 0) {
+            ready.emplace_back(i);
+        }
+    }
+
+    size_t visited = 0;
+    size_t max_depth = 0;
+    while (!ready.empty()) {
+        size_t current = ready.back();
+        ready.pop_back();
+        visited += 1;
+        max_depth = std::max(max_depth, depth[current]);
+
+        for (size_t next : successors[current]) {
+            depth[next] = std::max(depth[next], depth[current] + 1);
+            if (--in_degree[next] == 0) {
+                ready.emplace_back(next);
+            }
+        }
+    }
+
+    if (visited != count) {
+        core::error("system dependencies form a cycle, falling back to running systems in the order they were added");
+        for (size_t i = 0; i < count; i++) {
+            depth[i] = i;
+        }
+        max_depth = count - 1;
+    }
+
+    levels_.resize(max_depth + 1);
+    entry_levels_.resize(max_depth + 1);
+    for (size_t i = 0; i < count; i++) {
+        levels_[depth[i]].emplace_back(entries_[i]->system.get());
+        entry_levels_[depth[i]].emplace_back(entries_[i].get());
+    }
+
+    core::trace("built system graph with {} systems over {} levels", count, levels_.size());
+}
+
+void Scheduler::update(Entry &entry, job::System &jobs) {
+    MU_PROFILE_ZONE(entry.name);
+    const auto start = std::chrono::steady_clock::now();
+
+    SystemContext context{*world_, jobs, entry.commands};
+    entry.system->on_update(context);
+
+    entry.timings->record(std::chrono::steady_clock::now() - start);
+}
+
+auto Scheduler::entry(const System &system) const -> const Entry & {
+    auto it = std::ranges::find_if(entries_, [&](const auto &entry) { return entry->system.get() == &system; });
+    core::expect(it != entries_.end(), "system is not scheduled");
+    return **it;
+}
+
+} // namespace muon::ecs
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "muon/ecs/command_buffer.hpp"
+#include "muon/ecs/system.hpp"
+#include "muon/ecs/world.hpp"
+#include "muon/job/system.hpp"
+#include "muon/profile/frame_stats.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace muon::ecs {
+
+// runs systems over a world, systems whose component access doesn't conflict share a level and update concurrently,
+// conflicting ones keep the order they were added in
+class Scheduler : utils::NoCopy, utils::NoMove {
+public:
+    using Level = std::vector<System *>;
+
+    explicit Scheduler(World &world, size_t stats_window = 1024);
+
+    template <typename T, typename... Args>
+    auto emplace(Args &&...args) -> T & {
+        auto system = std::make_unique<T>(std::forward<Args>(args)...);
+        auto &reference = *system;
+        add(std::move(system));
+        return reference;
+    }
+
+    void add(std::unique_ptr<System> system);
+
+    void run(job::System &jobs);
+
+    auto levels() -> const std::vector<Level> &;
+
+    auto name(const System &system) const -> std::string_view;
+    auto timings(const System &system) const -> const profile::RollingHistogram &;
+    void log_timings() const;
+
+private:
+    struct Entry {
+        std::unique_ptr<System> system;
+        const char *name;
+        CommandBuffer commands;
+        std::unique_ptr<profile::RollingHistogram> timings;
+    };
+
+    void build();
+    void update(Entry &entry, job::System &jobs);
+    auto entry(const System &system) const -> const Entry &;
+
+private:
+    World *world_;
+    size_t stats_window_;
+
+    std::vector<std::unique_ptr<Entry>> entries_;
+    std::vector<Level> levels_;
+    std::vector<std::vector<Entry *>> entry_levels_;
+
+    // the graph is only rebuilt when systems are added, access is fixed once a system is constructed
+    bool dirty_{false};
+};
+
+} // namespace muon::ecs
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "muon/ecs/command_buffer.hpp"
+#include "muon/ecs/component.hpp"
+#include "muon/ecs/world.hpp"
+#include "muon/job/system.hpp"
+
+#include <type_traits>
+#include <vector>
+
+namespace muon::ecs {
+
+class System;
+
+struct SystemAccess {
+    std::vector<ComponentId> reads;
+    std::vector<ComponentId> writes;
+    std::vector<const System *> after;
+
+    // systems that declare nothing are treated as touching everything, they run alone and may change the world's
+    // structure directly
+    bool declared{false};
+};
+
+struct SystemContext {
+    World &world;
+    job::System &jobs;
+
+    // applied once every system has run, in the order the systems were added
+    CommandBuffer &commands;
+};
+
+class System {
+public:
+    virtual ~System() = default;
+
+    virtual void on_update(SystemContext &context) = 0;
+
+public:
+    auto access() const -> const SystemAccess & { return access_; }
+
+protected:
+    template <Component T>
+    void reads() {
+        access_.reads.emplace_back(component_id<T>());
+        access_.declared = true;
+    }
+
+    template <Component T>
+    void writes() {
+        access_.writes.emplace_back(component_id<T>());
+        access_.declared = true;
+    }
+
+    // declares the access of a Query<Ts...>, const components are read and the rest written
+    template <typename... Ts>
+        requires(Component<std::remove_const_t<Ts>> && ...)
+    void queries() {
+        (declare<Ts>(), ...);
+    }
+
+    void runs_after(const System *system) {
+        access_.after.emplace_back(system);
+        access_.declared = true;
+    }
+
+private:
+    template <typename T>
+    void declare() {
+        if constexpr (std::is_const_v<T>) {
+            reads<std::remove_const_t<T>>();
+        } else {
+            writes<T>();
+        }
+    }
+
+private:
+    SystemAccess access_{};
+};
+
+} // namespace muon::ecs
@@ -0,0 +1,16 @@
+#include "muon/ecs/system_layer.hpp"
+
+namespace muon::ecs {
+
+SystemLayer::SystemLayer(job::System &jobs) : jobs_{&jobs} { writes<World>(); }
+
+void SystemLayer::on_attach() {}
+
+void SystemLayer::on_detach() { scheduler_.log_timings(); }
+
+void SystemLayer::on_update() { scheduler_.run(*jobs_); }
+
+auto SystemLayer::world() -> World & { return world_; }
+auto SystemLayer::scheduler() -> Scheduler & { return scheduler_; }
+
+} // namespace muon::ecs
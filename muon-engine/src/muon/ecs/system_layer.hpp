@@ -0,0 +1,30 @@
+#pragma once
+
+#include "muon/core/layer.hpp"
+#include "muon/ecs/scheduler.hpp"
+#include "muon/ecs/world.hpp"
+#include "muon/job/system.hpp"
+
+namespace muon::ecs {
+
+// runs a world's systems as one layer of the application, the layer writes the World resource so layers that read
+// or write it themselves are ordered around it and the rest update alongside
+class SystemLayer : public Layer {
+public:
+    explicit SystemLayer(job::System &jobs);
+
+    void on_attach() override;
+    void on_detach() override;
+    void on_update() override;
+
+public:
+    auto world() -> World &;
+    auto scheduler() -> Scheduler &;
+
+private:
+    job::System *jobs_;
+    World world_;
+    Scheduler scheduler_{world_};
+};
+
+} // namespace muon::ecs
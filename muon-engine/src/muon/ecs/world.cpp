@@ -0,0 +1,123 @@
+#include "muon/ecs/world.hpp"
+
+#include <algorithm>
+
+namespace muon::ecs {
+
+void World::destroy(Entity entity) {
+    const auto &entry = record(entity);
+    if (auto moved = entry.archetype->erase(entry.row)) {
+        records_[moved->index].row = entry.row;
+    }
+
+    uuids_.erase(entry.uuid);
+    auto &freed = records_[entity.index];
+    freed = Record{.generation = freed.generation + 1};
+    free_records_.push_back(entity.index);
+}
+
+auto World::alive(Entity entity) const -> bool {
+    return entity.index < records_.size() && records_[entity.index].generation == entity.generation &&
+           records_[entity.index].archetype != nullptr;
+}
+
+auto World::size() const -> size_t { return uuids_.size(); }
+
+auto World::uuid(Entity entity) const -> const Uuid & { return record(entity).uuid; }
+
+auto World::find(const Uuid &uuid) const -> std::optional<Entity> {
+    auto found = uuids_.find(uuid);
+    if (found == uuids_.end()) {
+        return std::nullopt;
+    }
+    return found->second;
+}
+
+auto World::record(Entity entity) const -> const Record & {
+    core::expect(alive(entity), "stale entity {}:{}", entity.index, entity.generation);
+    return records_[entity.index];
+}
+
+auto World::allocate(const Uuid &uuid, Archetype *archetype) -> Entity {
+    core::expect(!uuid.is_nil() && !uuids_.contains(uuid), "entity uuid {} is nil or already taken", uuid);
+
+    uint32_t index;
+    if (!free_records_.empty()) {
+        index = free_records_.back();
+        free_records_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(records_.size());
+        records_.emplace_back();
+    }
+
+    auto &entry = records_[index];
+    Entity entity{index, entry.generation};
+    entry.archetype = archetype;
+    entry.row = archetype->push(entity);
+    entry.uuid = uuid;
+    uuids_.emplace(uuid, entity);
+    return entity;
+}
+
+auto World::find_archetype(std::vector<ComponentId> components) -> Archetype * {
+    std::ranges::sort(components);
+    core::expect(std::ranges::adjacent_find(components) == components.end(), "an entity can't hold a component twice");
+
+    auto found = by_components_.find(components);
+    if (found != by_components_.end()) {
+        return found->second;
+    }
+
+    auto *archetype = archetypes_.emplace_back(std::make_unique<Archetype>(components)).get();
+    by_components_.emplace(std::move(components), archetype);
+    return archetype;
+}
+
+auto World::find_component(Entity entity, ComponentId component) const -> void * {
+    const auto &entry = record(entity);
+    auto column = entry.archetype->column(component);
+    if (column == Archetype::NO_COLUMN) {
+        return nullptr;
+    }
+    return entry.archetype->component(entry.row, column);
+}
+
+auto World::move_entity(Entity entity, ComponentId component, bool add) -> void * {
+    auto &entry = records_[entity.index];
+    auto *from = entry.archetype;
+
+    auto *to = from->edge(component, add);
+    if (to == nullptr) {
+        std::vector<ComponentId> components{from->components().begin(), from->components().end()};
+        if (add) {
+            components.push_back(component);
+        } else {
+            std::erase(components, component);
+        }
+        to = find_archetype(std::move(components));
+        from->set_edge(component, add, to);
+        to->set_edge(component, !add, from);
+    }
+
+    // shared components are relocated, the one being removed is destroyed
+    auto row = to->push(entity);
+    for (uint32_t column = 0; column < from->components().size(); column++) {
+        auto *source = from->component(entry.row, column);
+        auto target = to->column(from->components()[column]);
+        if (target != Archetype::NO_COLUMN) {
+            from->info(column).relocate(to->component(row, target), source);
+        } else {
+            from->info(column).destroy(source);
+        }
+    }
+
+    if (auto moved = from->vacate(entry.row)) {
+        records_[moved->index].row = entry.row;
+    }
+    entry.archetype = to;
+    entry.row = row;
+
+    return add ? to->component(row, to->column(component)) : nullptr;
+}
+
+} // namespace muon::ecs
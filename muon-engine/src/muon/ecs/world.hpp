@@ -0,0 +1,149 @@
+#pragma once
+
+#include "muon/core/expect.hpp"
+#include "muon/core/uuid.hpp"
+#include "muon/ecs/archetype.hpp"
+#include "muon/ecs/component.hpp"
+#include "muon/ecs/entity.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace muon::ecs {
+
+template <typename T>
+concept ComponentValue = Component<std::remove_cvref_t<T>>;
+
+template <typename... Ts>
+    requires(Component<std::remove_const_t<Ts>> && ...)
+class Query;
+
+// owns every entity and its components, structural changes (creating, destroying, adding and removing components)
+// invalidate component references and must not happen while a query is iterating, a CommandBuffer defers them
+class World : utils::NoCopy, utils::NoMove {
+public:
+    template <ComponentValue... Ts>
+    auto create(Ts &&...components) -> Entity {
+        return restore(Uuid::uuid7(), std::forward<Ts>(components)...);
+    }
+
+    // creates an entity under a uuid that was persisted earlier
+    template <ComponentValue... Ts>
+    auto restore(const Uuid &uuid, Ts &&...components) -> Entity {
+        auto *archetype = find_archetype({component_id<std::remove_cvref_t<Ts>>()...});
+        auto entity = allocate(uuid, archetype);
+        auto row = records_[entity.index].row;
+        (new (archetype->component(row, archetype->column(component_id<std::remove_cvref_t<Ts>>())))
+             std::remove_cvref_t<Ts>{std::forward<Ts>(components)},
+         ...);
+        return entity;
+    }
+
+    void destroy(Entity entity);
+
+    auto alive(Entity entity) const -> bool;
+    auto size() const -> size_t;
+
+    auto uuid(Entity entity) const -> const Uuid &;
+    auto find(const Uuid &uuid) const -> std::optional<Entity>;
+
+    // replaces the component if the entity already has one
+    template <Component T, typename... Args>
+    auto add(Entity entity, Args &&...args) -> T & {
+        // built before anything moves so a throwing constructor leaves the entity as it was
+        T value(std::forward<Args>(args)...);
+
+        auto id = component_id<T>();
+        const auto &entry = record(entity);
+        if (auto column = entry.archetype->column(id); column != Archetype::NO_COLUMN) {
+            auto *existing = std::launder(static_cast<T *>(entry.archetype->component(entry.row, column)));
+            existing->~T();
+            return *new (existing) T{std::move(value)};
+        }
+        return *new (move_entity(entity, id, true)) T{std::move(value)};
+    }
+
+    // returns whether the entity had the component
+    template <Component T>
+    auto remove(Entity entity) -> bool {
+        auto id = component_id<T>();
+        if (record(entity).archetype->column(id) == Archetype::NO_COLUMN) {
+            return false;
+        }
+        move_entity(entity, id, false);
+        return true;
+    }
+
+    template <Component T>
+    auto has(Entity entity) const -> bool {
+        return record(entity).archetype->column(component_id<T>()) != Archetype::NO_COLUMN;
+    }
+
+    template <Component T>
+    auto try_get(Entity entity) -> T * {
+        auto *component = find_component(entity, component_id<T>());
+        return component != nullptr ? std::launder(static_cast<T *>(component)) : nullptr;
+    }
+
+    template <Component T>
+    auto try_get(Entity entity) const -> const T * {
+        const auto *component = find_component(entity, component_id<T>());
+        return component != nullptr ? std::launder(static_cast<const T *>(component)) : nullptr;
+    }
+
+    template <Component T>
+    auto get(Entity entity) -> T & {
+        auto *component = try_get<T>(entity);
+        core::expect(component != nullptr, "entity has no such component");
+        return *component;
+    }
+
+    template <Component T>
+    auto get(Entity entity) const -> const T & {
+        const auto *component = try_get<T>(entity);
+        core::expect(component != nullptr, "entity has no such component");
+        return *component;
+    }
+
+private:
+    template <typename... Ts>
+        requires(Component<std::remove_const_t<Ts>> && ...)
+    friend class Query;
+
+    struct Record {
+        uint32_t generation{0};
+        Archetype *archetype{nullptr};
+        size_t row{0};
+        Uuid uuid{};
+    };
+
+    auto record(Entity entity) const -> const Record &;
+    auto allocate(const Uuid &uuid, Archetype *archetype) -> Entity;
+    auto find_archetype(std::vector<ComponentId> components) -> Archetype *;
+    auto find_component(Entity entity, ComponentId component) const -> void *;
+
+    // moves the entity to the archetype with the component added or removed, returns the uninitialised slot of an
+    // added component
+    auto move_entity(Entity entity, ComponentId component, bool add) -> void *;
+
+private:
+    std::vector<Record> records_;
+    std::vector<uint32_t> free_records_;
+    std::unordered_map<Uuid, Entity> uuids_;
+
+    // in creation order, queries only look at the ones added since they last ran
+    std::vector<std::unique_ptr<Archetype>> archetypes_;
+    std::map<std::vector<ComponentId>, Archetype *> by_components_;
+};
+
+} // namespace muon::ecs
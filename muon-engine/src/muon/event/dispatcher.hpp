@@ -1,11 +1,20 @@
 #pragma once
 
+#include "muon/profile/profiler.hpp"
 #include "muon/utils/no_copy.hpp"
 #include "muon/utils/no_move.hpp"
+#include "muon/utils/platform.hpp"
 
 #include <eventpp/eventdispatcher.h>
 #include <typeindex>
 
+namespace muon::log {
+
+// declared here rather than through the flight recorder header, which pulls in spdlog's sinks
+void record_event(const char *name) noexcept;
+
+} // namespace muon::log
+
 namespace muon::event {
 
 class Dispatcher : utils::NoCopy, utils::NoMove {
@@ -27,6 +36,10 @@ public:
 
     template <typename Event>
     void dispatch(const Event &event) const {
+        static const char *name = profile::intern(utils::demangle(typeid(Event).name()));
+        MU_PROFILE_ZONE(name);
+        log::record_event(name);
+
         dispatcher_.dispatch(typeid(Event), &event);
     }
 
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "muon/event/event.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+#include "muon/utils/ring_buffer.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+
+namespace muon::event {
+
+using Any = std::variant<WindowQuit, WindowResize, WindowFocus, Keyboard, MouseButton, MouseMotion, DropFile, DropText, TextInput>;
+
+// an event captured on one thread to be dispatched on another
+struct Queued {
+    // nanoseconds since the window system was initialized
+    uint64_t timestamp{0};
+    Any event{};
+    // owns the text of events that carry a string, their pointers are patched on dispatch
+    std::string text{};
+};
+
+// hands events from the thread that pumps them to the thread that dispatches them, one thread on each side, while the
+// consumer falls behind mouse motion is merged instead of taking more slots and a quit is never dropped
+class Queue : utils::NoCopy, utils::NoMove {
+public:
+    using SizeType = size_t;
+
+    explicit Queue(SizeType capacity) : ring_{capacity} {}
+
+    // returns false when the event was dropped because the queue is full, which never happens to motion or a quit
+    auto push(Queued queued) -> bool {
+        if (auto *motion = std::get_if<MouseMotion>(&queued.event)) {
+            // relative motion adds up, so it is merged into one pending event until there is room for it
+            if (pending_motion_) {
+                auto &pending = std::get<MouseMotion>(pending_motion_->event);
+                pending.x += motion->x;
+                pending.y += motion->y;
+                pending_motion_->timestamp = queued.timestamp;
+            } else {
+                pending_motion_ = std::move(queued);
+            }
+            flush();
+            return true;
+        }
+
+        // motion that came first is sent first whenever there is room for it
+        flush();
+
+        bool quit = std::holds_alternative<WindowQuit>(queued.event);
+        auto timestamp = queued.timestamp;
+        if (ring_.push(std::move(queued))) {
+            return true;
+        }
+
+        // a stalled consumer must still be able to close the app, so a quit that doesn't fit is kept on the side
+        if (quit) {
+            quit_timestamp_.store(timestamp, std::memory_order_relaxed);
+            quit_requested_.store(true, std::memory_order_release);
+            return true;
+        }
+        return false;
+    }
+
+    // moves merged motion into the queue if there is room, the producer calls it when it runs out of events
+    void flush() {
+        // the last part of the queue is kept for events that can't be merged
+        auto reserved = ring_.capacity() / 8;
+        if (pending_motion_ && ring_.size() + reserved < ring_.capacity() && ring_.push(std::move(*pending_motion_))) {
+            pending_motion_.reset();
+        }
+    }
+
+    // a quit that didn't fit comes out once everything queued before it has
+    auto pop() -> std::optional<Queued> {
+        if (auto queued = ring_.pop()) {
+            return queued;
+        }
+        if (quit_requested_.exchange(false, std::memory_order_acquire)) {
+            return Queued{.timestamp = quit_timestamp_.load(std::memory_order_relaxed), .event = WindowQuit{}};
+        }
+        return std::nullopt;
+    }
+
+    auto size() const noexcept -> SizeType { return ring_.size(); }
+    auto capacity() const noexcept -> SizeType { return ring_.capacity(); }
+
+private:
+    utils::RingBuffer<Queued> ring_;
+
+    // only touched by the producer
+    std::optional<Queued> pending_motion_{};
+
+    std::atomic<bool> quit_requested_{false};
+    std::atomic<uint64_t> quit_timestamp_{0};
+};
+
+} // namespace muon::event
@@ -0,0 +1,50 @@
+#include "muon/image/image.hpp"
+
+#include "muon/core/expect.hpp"
+
+#include <utility>
+
+namespace muon::image {
+
+auto bytes_per_pixel(PixelFormat format) -> uint32_t {
+    switch (format) {
+        case PixelFormat::R8:
+            return 1;
+        case PixelFormat::Rgb8:
+            return 3;
+        case PixelFormat::Rgba8:
+        case PixelFormat::Bgra8:
+            return 4;
+        case PixelFormat::Rgba16:
+            return 8;
+    }
+    return 0;
+}
+
+Image::Image(uint32_t width, uint32_t height, PixelFormat format, Buffer buffer)
+    : width_{width}, height_{height}, format_{format}, buffer_{std::move(buffer)} {
+    core::expect(
+        buffer_.size() >= stride() * height_, "image buffer of {} bytes is too small for {}x{} pixels", buffer_.size(), width_,
+        height_
+    );
+}
+
+auto Image::width() const -> uint32_t { return width_; }
+
+auto Image::height() const -> uint32_t { return height_; }
+
+auto Image::format() const -> PixelFormat { return format_; }
+
+auto Image::stride() const -> size_t { return static_cast<size_t>(width_) * bytes_per_pixel(format_); }
+
+auto Image::pixels() -> std::span<uint8_t> { return {buffer_.data(), stride() * height_}; }
+
+auto Image::pixels() const -> std::span<const uint8_t> { return {buffer_.data(), stride() * height_}; }
+
+auto Image::row(uint32_t y) -> std::span<uint8_t> { return pixels().subspan(y * stride(), stride()); }
+
+auto Image::row(uint32_t y) const -> std::span<const uint8_t> { return pixels().subspan(y * stride(), stride()); }
+
+auto Image::release() && -> Buffer { return std::move(buffer_); }
+
+} // namespace muon::image
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "muon/core/buffer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace muon::image {
+
+// channels in memory order, 16 bit channels are in the host's byte order
+enum class PixelFormat : uint8_t {
+    R8,
+    Rgb8,
+    Rgba8,
+    Bgra8,
+    Rgba16,
+};
+
+auto bytes_per_pixel(PixelFormat format) -> uint32_t;
+
+// tightly packed rows from the top of the image down, the buffer may be larger than the pixels when it came from a
+// pool
+class Image {
+public:
+    Image(uint32_t width, uint32_t height, PixelFormat format, Buffer buffer);
+
+    auto width() const -> uint32_t;
+    auto height() const -> uint32_t;
+    auto format() const -> PixelFormat;
+    auto stride() const -> size_t;
+
+    auto pixels() -> std::span<uint8_t>;
+    auto pixels() const -> std::span<const uint8_t>;
+    auto row(uint32_t y) -> std::span<uint8_t>;
+    auto row(uint32_t y) const -> std::span<const uint8_t>;
+
+    // hands the storage back, usually to the pool it came from
+    auto release() && -> Buffer;
+
+private:
+    uint32_t width_;
+    uint32_t height_;
+    PixelFormat format_;
+    Buffer buffer_;
+};
+
+} // namespace muon::image
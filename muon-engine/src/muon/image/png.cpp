@@ -0,0 +1,158 @@
+#include "muon/image/png.hpp"
+
+#include "muon/core/expect.hpp"
+#include "spng.h"
+
+#include <optional>
+#include <utility>
+
+namespace muon::image {
+
+namespace {
+
+struct Context {
+    spng_ctx *context{spng_ctx_new(0)};
+
+    ~Context() { spng_ctx_free(context); }
+};
+
+// what libspng writes for each format, the ones it can't produce itself are decoded to rgba8 and converted
+auto decoded_format(PixelFormat format) -> spng_format {
+    switch (format) {
+        case PixelFormat::Rgb8:
+            return SPNG_FMT_RGB8;
+        case PixelFormat::Rgba16:
+            return SPNG_FMT_RGBA16;
+        case PixelFormat::R8:
+        case PixelFormat::Rgba8:
+        case PixelFormat::Bgra8:
+            break;
+    }
+    return SPNG_FMT_RGBA8;
+}
+
+auto decoded_bytes_per_pixel(spng_format format) -> uint32_t {
+    switch (format) {
+        case SPNG_FMT_RGB8:
+            return 3;
+        case SPNG_FMT_RGBA16:
+            return 8;
+        default:
+            return 4;
+    }
+}
+
+auto needs_conversion(PixelFormat format) -> bool { return format == PixelFormat::R8 || format == PixelFormat::Bgra8; }
+
+void convert_row(const uint8_t *rgba, std::span<uint8_t> out, uint32_t width, PixelFormat format) {
+    if (format == PixelFormat::R8) {
+        // greyscale images come out of libspng with the grey level in every colour channel
+        for (uint32_t x = 0; x < width; x++) {
+            out[x] = rgba[x * 4];
+        }
+        return;
+    }
+    for (uint32_t x = 0; x < width; x++) {
+        out[x * 4] = rgba[x * 4 + 2];
+        out[x * 4 + 1] = rgba[x * 4 + 1];
+        out[x * 4 + 2] = rgba[x * 4];
+        out[x * 4 + 3] = rgba[x * 4 + 3];
+    }
+}
+
+} // namespace
+
+auto decode_png(BufferView png, PixelFormat format, BufferPool &pool) -> std::expected<Image, ImageError> {
+    Context context;
+    core::expect(context.context != nullptr, "failed to create a png decoder");
+
+    spng_ihdr header{};
+    if (spng_set_png_buffer(context.context, png.data(), png.size()) != 0 || spng_get_ihdr(context.context, &header) != 0) {
+        return std::unexpected(ImageError::InvalidPng);
+    }
+    if (header.width > MAX_PNG_DIMENSION || header.height > MAX_PNG_DIMENSION) {
+        return std::unexpected(ImageError::TooLarge);
+    }
+
+    auto decoded = decoded_format(format);
+    int flags = SPNG_DECODE_PROGRESSIVE | (decoded == SPNG_FMT_RGB8 ? 0 : SPNG_DECODE_TRNS);
+    if (spng_decode_image(context.context, nullptr, 0, decoded, flags) != 0) {
+        return std::unexpected(ImageError::CorruptData);
+    }
+
+    // the largest images allowed run to gigabytes, so running out of memory is an error rather than a crash
+    size_t pixels = static_cast<size_t>(header.width) * header.height;
+    auto pixel_buffer = pool.acquire(pixels * bytes_per_pixel(format));
+    if (pixel_buffer.data() == nullptr) {
+        return std::unexpected(ImageError::OutOfMemory);
+    }
+    Image image{header.width, header.height, format, std::move(pixel_buffer)};
+    size_t decoded_stride = static_cast<size_t>(header.width) * decoded_bytes_per_pixel(decoded);
+
+    // conversions happen on a row that is still in cache, except that the passes of an interlaced image each fill in
+    // part of every row, so those are converted once the whole image is in
+    bool convert = needs_conversion(format);
+    bool interlaced = header.interlace_method != SPNG_INTERLACE_NONE;
+    std::vector<uint8_t> scratch_row;
+    std::optional<Buffer> scratch_image;
+    if (convert && interlaced) {
+        scratch_image = pool.acquire(decoded_stride * header.height);
+        if (scratch_image->data() == nullptr) {
+            pool.release(std::move(image).release());
+            return std::unexpected(ImageError::OutOfMemory);
+        }
+    } else if (convert) {
+        scratch_row.resize(decoded_stride);
+    }
+
+    int result = 0;
+    do {
+        spng_row_info info{};
+        result = spng_get_row_info(context.context, &info);
+        if (result != 0) {
+            break;
+        }
+
+        uint8_t *destination = image.row(info.row_num).data();
+        if (scratch_image) {
+            destination = scratch_image->data() + info.row_num * decoded_stride;
+        } else if (convert) {
+            destination = scratch_row.data();
+        }
+
+        // the last row comes back with the end of the image
+        result = spng_decode_row(context.context, destination, decoded_stride);
+        if (convert && !interlaced && (result == 0 || result == SPNG_EOI)) {
+            convert_row(destination, image.row(info.row_num), header.width, format);
+        }
+    } while (result == 0);
+
+    if (result != SPNG_EOI) {
+        if (scratch_image) {
+            pool.release(std::move(*scratch_image));
+        }
+        pool.release(std::move(image).release());
+        return std::unexpected(ImageError::CorruptData);
+    }
+
+    if (scratch_image) {
+        for (uint32_t y = 0; y < header.height; y++) {
+            convert_row(scratch_image->data() + y * decoded_stride, image.row(y), header.width, format);
+        }
+        pool.release(std::move(*scratch_image));
+    }
+    return image;
+}
+
+auto decode_png(std::span<const BufferView> pngs, PixelFormat format, BufferPool &pool, job::System &jobs)
+    -> std::vector<std::expected<Image, ImageError>> {
+    std::vector<std::expected<Image, ImageError>> images(pngs.size(), std::unexpected(ImageError::InvalidPng));
+    jobs.parallel_for(pngs.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            images[i] = decode_png(pngs[i], format, pool);
+        }
+    });
+    return images;
+}
+
+} // namespace muon::image
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "muon/core/buffer.hpp"
+#include "muon/core/buffer_pool.hpp"
+#include "muon/image/image.hpp"
+#include "muon/job/system.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <vector>
+
+namespace muon::image {
+
+enum class ImageError {
+    InvalidPng,
+    TooLarge,
+    CorruptData,
+    OutOfMemory,
+};
+
+// anything wider or taller is far more likely a corrupt or hostile header than a real image
+constexpr uint32_t MAX_PNG_DIMENSION = 16384;
+
+// decodes a row at a time straight into a buffer from the pool, converting to the format in the same pass, formats
+// with alpha take transparency from a trns chunk
+auto decode_png(BufferView png, PixelFormat format, BufferPool &pool) -> std::expected<Image, ImageError>;
+
+// decodes each png on its own job, results are in the same order as the inputs
+auto decode_png(std::span<const BufferView> pngs, PixelFormat format, BufferPool &pool, job::System &jobs)
+    -> std::vector<std::expected<Image, ImageError>>;
+
+} // namespace muon::image
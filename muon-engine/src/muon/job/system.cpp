@@ -0,0 +1,145 @@
+#include "muon/job/system.hpp"
+
+#include "muon/core/log.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace muon::job {
+
+auto Counter::done() const noexcept -> bool { return pending_.load(std::memory_order_acquire) == 0; }
+
+void Counter::fail(std::exception_ptr error) noexcept {
+    // published by the release in the decrement that follows
+    if (!failed_.exchange(true, std::memory_order_relaxed)) {
+        error_ = std::move(error);
+    }
+}
+
+System::System(size_t worker_count) {
+    worker_count = std::max<size_t>(worker_count, 1);
+
+    workers_.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; i++) {
+        workers_.emplace_back([this](std::stop_token token) { worker_loop(token); });
+    }
+
+    MU_LOG_DEBUG(Job, "created job system with {} workers", worker_count);
+}
+
+System::~System() {
+    for (auto &worker : workers_) {
+        worker.request_stop();
+    }
+    queue_condition_.notify_all();
+    workers_.clear();
+
+    MU_LOG_DEBUG(Job, "destroyed job system");
+}
+
+void System::submit(Job job) {
+    {
+        std::lock_guard lock{queue_mutex_};
+        queue_.emplace_back(std::move(job), nullptr);
+    }
+    queue_condition_.notify_one();
+}
+
+void System::submit(Job job, Counter &counter) {
+    counter.pending_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard lock{queue_mutex_};
+        queue_.emplace_back(std::move(job), &counter);
+    }
+    queue_condition_.notify_one();
+}
+
+void System::wait(Counter &counter) {
+    while (!counter.done()) {
+        if (try_run_one()) {
+            continue;
+        }
+
+        std::unique_lock lock{queue_mutex_};
+        queue_condition_.wait(lock, [&] { return !queue_.empty() || counter.done(); });
+    }
+
+    if (counter.failed_.load(std::memory_order_relaxed)) {
+        auto error = std::exchange(counter.error_, nullptr);
+        counter.failed_.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(error);
+    }
+}
+
+void System::parallel_for(size_t count, size_t grain, const RangeJob &job) {
+    if (count == 0) {
+        return;
+    }
+
+    grain = std::max<size_t>(grain, 1);
+    if (count <= grain) {
+        job(0, count);
+        return;
+    }
+
+    Counter counter;
+    for (size_t begin = grain; begin < count; begin += grain) {
+        size_t end = std::min(begin + grain, count);
+        submit([&job, begin, end] { job(begin, end); }, counter);
+    }
+
+    run_and_wait([&] { job(0, grain); }, counter);
+}
+
+auto System::worker_count() const noexcept -> size_t { return workers_.size(); }
+
+auto System::default_worker_count() noexcept -> size_t {
+    size_t hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 1;
+}
+
+void System::worker_loop(std::stop_token token) {
+    while (!token.stop_requested()) {
+        if (try_run_one()) {
+            continue;
+        }
+
+        std::unique_lock lock{queue_mutex_};
+        queue_condition_.wait(lock, token, [&] { return !queue_.empty(); });
+    }
+}
+
+auto System::try_run_one() -> bool {
+    Entry entry;
+    {
+        std::lock_guard lock{queue_mutex_};
+        if (queue_.empty()) {
+            return false;
+        }
+
+        entry = std::move(queue_.front());
+        queue_.pop_front();
+    }
+
+    // the counter is always decremented, a throwing job must not leave its waiter hanging
+    try {
+        entry.job();
+    } catch (...) {
+        if (entry.counter == nullptr) {
+            MU_LOG_ERROR(Job, "a job nobody waits on threw an exception");
+            std::terminate();
+        }
+        entry.counter->fail(std::current_exception());
+    }
+
+    if (entry.counter && entry.counter->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // take the lock so a waiter between its predicate check and sleeping cannot miss the wake up
+        std::lock_guard lock{queue_mutex_};
+        queue_condition_.notify_all();
+    }
+
+    return true;
+}
+
+} // namespace muon::job
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace muon::job {
+
+class Counter : utils::NoCopy, utils::NoMove {
+public:
+    Counter() = default;
+
+    auto done() const noexcept -> bool;
+
+private:
+    friend class System;
+
+    void fail(std::exception_ptr error) noexcept;
+
+    std::atomic<uint32_t> pending_{0};
+
+    // the first exception thrown by a tracked job, handed to whoever waits on the counter
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_{};
+};
+
+class System : utils::NoCopy, utils::NoMove {
+public:
+    using Job = std::function<void()>;
+    using RangeJob = std::function<void(size_t begin, size_t end)>;
+
+    explicit System(size_t worker_count = default_worker_count());
+    ~System();
+
+    void submit(Job job);
+    void submit(Job job, Counter &counter);
+
+    // blocks until all jobs tracked by the counter finish, running queued jobs in the meantime, then rethrows the first
+    // exception any of them threw
+    void wait(Counter &counter);
+
+    // runs the job on this thread alongside the ones tracked by the counter, if it throws the exception only leaves
+    // once the others are done, since they usually refer to the caller's stack
+    template <typename Fn>
+    void run_and_wait(Fn &&job, Counter &counter) {
+        try {
+            std::forward<Fn>(job)();
+        } catch (...) {
+            wait(counter);
+            throw;
+        }
+        wait(counter);
+    }
+
+    // splits [0, count) into ranges of at most `grain` elements and runs them across the workers
+    void parallel_for(size_t count, size_t grain, const RangeJob &job);
+
+    auto worker_count() const noexcept -> size_t;
+
+    static auto default_worker_count() noexcept -> size_t;
+
+private:
+    void worker_loop(std::stop_token token);
+    auto try_run_one() -> bool;
+
+private:
+    struct Entry {
+        Job job;
+        Counter *counter;
+    };
+
+    std::deque<Entry> queue_;
+    std::mutex queue_mutex_;
+    std::condition_variable_any queue_condition_;
+
+    std::vector<std::jthread> workers_;
+};
+
+} // namespace muon::job
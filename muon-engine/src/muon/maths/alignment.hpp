@@ -1,9 +1,77 @@
 #pragma once
 
+#include <bit>
 #include <cstdint>
 
 namespace muon::maths {
 
-auto align(uint64_t integer, uint64_t alignment) -> uint64_t;
+constexpr auto is_pow2(uint64_t value) -> bool { return std::has_single_bit(value); }
+
+// rounds up to the next multiple of alignment, which has to be non zero, powers of two skip the divide
+constexpr auto align(uint64_t integer, uint64_t alignment) -> uint64_t {
+    if (is_pow2(alignment)) {
+        return (integer + alignment - 1) & ~(alignment - 1);
+    }
+    return ((integer + alignment - 1) / alignment) * alignment;
+}
+
+constexpr auto align_down(uint64_t integer, uint64_t alignment) -> uint64_t {
+    if (is_pow2(alignment)) {
+        return integer & ~(alignment - 1);
+    }
+    return integer - integer % alignment;
+}
+
+constexpr auto is_aligned(uint64_t integer, uint64_t alignment) -> bool {
+    if (is_pow2(alignment)) {
+        return (integer & (alignment - 1)) == 0;
+    }
+    return integer % alignment == 0;
+}
+
+// alignment known at compile time, restricted to powers of two so it is always a mask
+template <uint64_t Alignment>
+    requires(is_pow2(Alignment))
+constexpr auto align(uint64_t integer) -> uint64_t {
+    return (integer + Alignment - 1) & ~(Alignment - 1);
+}
+
+template <uint64_t Alignment>
+    requires(is_pow2(Alignment))
+constexpr auto align_down(uint64_t integer) -> uint64_t {
+    return integer & ~(Alignment - 1);
+}
+
+template <uint64_t Alignment>
+    requires(is_pow2(Alignment))
+constexpr auto is_aligned(uint64_t integer) -> bool {
+    return (integer & (Alignment - 1)) == 0;
+}
+
+template <typename T>
+auto align(T *pointer, uint64_t alignment) -> T * {
+    return reinterpret_cast<T *>(align(reinterpret_cast<uintptr_t>(pointer), alignment));
+}
+
+template <typename T>
+auto align_down(T *pointer, uint64_t alignment) -> T * {
+    return reinterpret_cast<T *>(align_down(reinterpret_cast<uintptr_t>(pointer), alignment));
+}
+
+template <typename T>
+auto is_aligned(const T *pointer, uint64_t alignment) -> bool {
+    return is_aligned(reinterpret_cast<uintptr_t>(pointer), alignment);
+}
+
+// the smallest power of two not below value, 1 for 0, value must not exceed 2^63
+constexpr auto next_pow2(uint64_t value) -> uint64_t { return std::bit_ceil(value); }
+
+// floor of log2, value has to be non zero
+constexpr auto log2(uint64_t value) -> uint32_t { return static_cast<uint32_t>(std::bit_width(value)) - 1; }
+
+// ceiling of log2, 0 for 0 and 1
+constexpr auto log2_ceil(uint64_t value) -> uint32_t {
+    return value <= 1 ? 0 : static_cast<uint32_t>(std::bit_width(value - 1));
+}
 
 } // namespace muon::maths
@@ -0,0 +1,296 @@
+#include "muon/maths/batch.hpp"
+
+#include "glm/gtc/type_ptr.hpp"
+#include "muon/core/expect.hpp"
+#include "muon/maths/batch_kernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#if defined(_MSC_VER) && (defined(__x86_64__) || defined(_M_X64))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace muon::maths {
+
+namespace internal {
+
+namespace {
+
+struct ScalarLanes {
+    using Type = float;
+    static constexpr size_t WIDTH = 1;
+
+    static auto load(const float *p) -> Type { return *p; }
+    static void store(float *p, Type v) { *p = v; }
+    static auto set1(float value) -> Type { return value; }
+    static void load_matrices(const float *matrices, Type *m) {
+        for (size_t i = 0; i < 16; i++) {
+            m[i] = matrices[i];
+        }
+    }
+
+    static auto add(Type a, Type b) -> Type { return a + b; }
+    static auto sub(Type a, Type b) -> Type { return a - b; }
+    static auto mul(Type a, Type b) -> Type { return a * b; }
+    static auto fmadd(Type a, Type b, Type c) -> Type { return a * b + c; }
+    static auto div(Type a, Type b) -> Type { return a / b; }
+    static auto sqrt(Type v) -> Type { return std::sqrt(v); }
+    static auto abs(Type v) -> Type { return std::fabs(v); }
+    static auto flip_sign(Type v, Type sign) -> Type { return std::signbit(sign) ? -v : v; }
+    static auto min(Type a, Type b) -> Type { return a < b ? a : b; }
+    static auto non_negative(Type v) -> uint32_t { return v >= 0.0f ? 1 : 0; }
+};
+
+} // namespace
+
+auto scalar_kernels() -> const BatchKernels & { return Kernels<ScalarLanes>::TABLE; }
+
+} // namespace internal
+
+namespace {
+
+using internal::BatchKernels;
+
+auto detect() -> SimdLevel {
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int leaves = info[0];
+
+    __cpuid(info, 1);
+    bool sse41 = info[2] & (1 << 19);
+    bool fma = info[2] & (1 << 12);
+    bool avx = info[2] & (1 << 28);
+    bool osxsave = info[2] & (1 << 27);
+
+    // the os has to save the wider registers on context switches as well
+    uint64_t xcr0 = osxsave ? _xgetbv(0) : 0;
+    bool ymm = (xcr0 & 0x6) == 0x6;
+    bool zmm = (xcr0 & 0xe6) == 0xe6;
+
+    bool avx2 = false;
+    bool avx512 = false;
+    if (leaves >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = info[1] & (1 << 5);
+        avx512 = info[1] & (1 << 16);
+    }
+
+    if (avx512 && zmm) {
+        return SimdLevel::Avx512;
+    }
+    if (avx2 && fma && avx && ymm) {
+        return SimdLevel::Avx2;
+    }
+    if (sse41) {
+        return SimdLevel::Sse4;
+    }
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SimdLevel::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return SimdLevel::Sse4;
+    }
+#endif
+#endif
+    return SimdLevel::Scalar;
+}
+
+auto kernels_for(SimdLevel level) -> const BatchKernels & {
+#if defined(__x86_64__) || defined(_M_X64)
+    switch (level) {
+        case SimdLevel::Avx512:
+            return internal::avx512_kernels();
+        case SimdLevel::Avx2:
+            return internal::avx2_kernels();
+        case SimdLevel::Sse4:
+            return internal::sse4_kernels();
+        case SimdLevel::Scalar:
+            break;
+    }
+#endif
+    return internal::scalar_kernels();
+}
+
+auto active_level() -> std::atomic<SimdLevel> & {
+    static std::atomic<SimdLevel> level{supported_simd_level()};
+    return level;
+}
+
+// full vectors go to the selected kernels and whatever is left over to the scalar ones
+template <typename Fn>
+void dispatch(size_t count, Fn &&fn, SimdLevel limit = SimdLevel::Avx512) {
+    const auto &kernels = kernels_for(std::min(simd_level(), limit));
+    size_t wide = count - count % kernels.width;
+    if (wide > 0) {
+        fn(kernels, 0, wide);
+    }
+    if (wide < count) {
+        fn(internal::scalar_kernels(), wide, count - wide);
+    }
+}
+
+template <typename T>
+auto consistent(const Vec3Soa<T> &v, size_t size) -> bool {
+    return v.x.size() == size && v.y.size() == size && v.z.size() == size;
+}
+
+template <typename T>
+auto consistent(const Vec4Soa<T> &v, size_t size) -> bool {
+    return v.x.size() == size && v.y.size() == size && v.z.size() == size && v.w.size() == size;
+}
+
+auto input(Vec3Soa<const float> v, size_t offset) -> internal::Vec3In {
+    return {v.x.data() + offset, v.y.data() + offset, v.z.data() + offset};
+}
+
+auto output(Vec3Soa<float> v, size_t offset) -> internal::Vec3Out {
+    return {v.x.data() + offset, v.y.data() + offset, v.z.data() + offset};
+}
+
+auto input(Vec4Soa<const float> v, size_t offset) -> internal::Vec4In {
+    return {v.x.data() + offset, v.y.data() + offset, v.z.data() + offset, v.w.data() + offset};
+}
+
+auto output(Vec4Soa<float> v, size_t offset) -> internal::Vec4Out {
+    return {v.x.data() + offset, v.y.data() + offset, v.z.data() + offset, v.w.data() + offset};
+}
+
+auto plane_array(const Frustum &frustum) -> std::array<float, 24> {
+    std::array<float, 24> planes{};
+    for (size_t i = 0; i < frustum.planes.size(); i++) {
+        planes[i * 4] = frustum.planes[i].normal.x;
+        planes[i * 4 + 1] = frustum.planes[i].normal.y;
+        planes[i * 4 + 2] = frustum.planes[i].normal.z;
+        planes[i * 4 + 3] = frustum.planes[i].distance;
+    }
+    return planes;
+}
+
+// the kernels write every index they test, so the list grows by the whole batch up front and shrinks to what was kept
+template <typename Fn>
+void cull(size_t count, std::vector<uint32_t> &visible, Fn &&fn) {
+    core::expect(count <= std::numeric_limits<uint32_t>::max(), "too many bounds to index: {}", count);
+    auto end = visible.size();
+    visible.resize(end + count);
+    dispatch(count, [&](const BatchKernels &kernels, size_t offset, size_t remaining) {
+        end += fn(kernels, offset, visible.data() + end, remaining);
+    });
+    visible.resize(end);
+}
+
+} // namespace
+
+auto supported_simd_level() -> SimdLevel {
+    static const SimdLevel level = detect();
+    return level;
+}
+
+auto simd_level() -> SimdLevel { return active_level().load(std::memory_order_relaxed); }
+
+auto set_simd_level(SimdLevel level) -> SimdLevel {
+    level = std::min(level, supported_simd_level());
+    active_level().store(level, std::memory_order_relaxed);
+    return level;
+}
+
+void transform_points(const glm::mat4 &matrix, Vec3Soa<const float> points, Vec3Soa<float> out) {
+    core::expect(consistent(points, points.size()) && consistent(out, points.size()), "mismatched batch sizes");
+    dispatch(points.size(), [&](const BatchKernels &kernels, size_t offset, size_t count) {
+        kernels.transform_points(glm::value_ptr(matrix), input(points, offset), output(out, offset), count);
+    });
+}
+
+void transform_points(std::span<const glm::mat4> matrices, Vec3Soa<const float> points, Vec3Soa<float> out) {
+    core::expect(
+        matrices.size() == points.size() && consistent(points, points.size()) && consistent(out, points.size()),
+        "mismatched batch sizes"
+    );
+    // the loads of a matrix per point dominate and transposing sixteen of them at a time loses to eight
+    dispatch(
+        points.size(),
+        [&](const BatchKernels &kernels, size_t offset, size_t count) {
+            kernels.transform_points_each(glm::value_ptr(matrices[offset]), input(points, offset), output(out, offset), count);
+        },
+        SimdLevel::Avx2
+    );
+}
+
+void transform_vectors(const glm::mat4 &matrix, Vec3Soa<const float> vectors, Vec3Soa<float> out) {
+    core::expect(consistent(vectors, vectors.size()) && consistent(out, vectors.size()), "mismatched batch sizes");
+    dispatch(vectors.size(), [&](const BatchKernels &kernels, size_t offset, size_t count) {
+        kernels.transform_vectors(glm::value_ptr(matrix), input(vectors, offset), output(out, offset), count);
+    });
+}
+
+void transform(const glm::mat4 &matrix, Vec4Soa<const float> vectors, Vec4Soa<float> out) {
+    core::expect(consistent(vectors, vectors.size()) && consistent(out, vectors.size()), "mismatched batch sizes");
+    dispatch(vectors.size(), [&](const BatchKernels &kernels, size_t offset, size_t count) {
+        kernels.transform(glm::value_ptr(matrix), input(vectors, offset), output(out, offset), count);
+    });
+}
+
+void normalize(QuatSoa<const float> quats, QuatSoa<float> out) {
+    core::expect(consistent(quats, quats.size()) && consistent(out, quats.size()), "mismatched batch sizes");
+    dispatch(quats.size(), [&](const BatchKernels &kernels, size_t offset, size_t count) {
+        kernels.normalize(input(quats, offset), output(out, offset), count);
+    });
+}
+
+void slerp(QuatSoa<const float> from, QuatSoa<const float> to, std::span<const float> t, QuatSoa<float> out) {
+    core::expect(
+        consistent(from, from.size()) && consistent(to, from.size()) && t.size() == from.size() && consistent(out, from.size()),
+        "mismatched batch sizes"
+    );
+    dispatch(from.size(), [&](const BatchKernels &kernels, size_t offset, size_t count) {
+        kernels.slerp(input(from, offset), input(to, offset), t.data() + offset, output(out, offset), count);
+    });
+}
+
+void transform_aabbs(const glm::mat4 &matrix, AabbSoa<const float> boxes, AabbSoa<float> out) {
+    core::expect(
+        consistent(boxes.min, boxes.size()) && consistent(boxes.max, boxes.size()) && consistent(out.min, boxes.size()) &&
+            consistent(out.max, boxes.size()),
+        "mismatched batch sizes"
+    );
+    dispatch(boxes.size(), [&](const BatchKernels &kernels, size_t offset, size_t count) {
+        kernels.transform_aabbs(
+            glm::value_ptr(matrix), input(boxes.min, offset), input(boxes.max, offset), output(out.min, offset),
+            output(out.max, offset), count
+        );
+    });
+}
+
+void frustum_cull(const Frustum &frustum, SphereSoa<const float> spheres, std::vector<uint32_t> &visible) {
+    core::expect(consistent(spheres.center, spheres.size()), "mismatched batch sizes");
+    auto planes = plane_array(frustum);
+    cull(spheres.size(), visible, [&](const BatchKernels &kernels, size_t offset, uint32_t *out, size_t count) {
+        return kernels.frustum_cull_spheres(
+            planes.data(), input(spheres.center, offset), spheres.radius.data() + offset, static_cast<uint32_t>(offset), out,
+            count
+        );
+    });
+}
+
+void frustum_cull(const Frustum &frustum, AabbSoa<const float> boxes, std::vector<uint32_t> &visible) {
+    core::expect(consistent(boxes.min, boxes.size()) && consistent(boxes.max, boxes.size()), "mismatched batch sizes");
+    auto planes = plane_array(frustum);
+    cull(boxes.size(), visible, [&](const BatchKernels &kernels, size_t offset, uint32_t *out, size_t count) {
+        return kernels.frustum_cull_aabbs(
+            planes.data(), input(boxes.min, offset), input(boxes.max, offset), static_cast<uint32_t>(offset), out, count
+        );
+    });
+}
+
+} // namespace muon::maths
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "glm/mat4x4.hpp"
+#include "muon/maths/bounds.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace muon::maths {
+
+// one column per component, every column of an array has the same length, const T for inputs and T for outputs
+template <typename T>
+struct Vec3Soa {
+    std::span<T> x;
+    std::span<T> y;
+    std::span<T> z;
+
+    auto size() const -> size_t { return x.size(); }
+
+    operator Vec3Soa<const T>() const
+        requires(!std::is_const_v<T>)
+    {
+        return {x, y, z};
+    }
+};
+
+template <typename T>
+struct Vec4Soa {
+    std::span<T> x;
+    std::span<T> y;
+    std::span<T> z;
+    std::span<T> w;
+
+    auto size() const -> size_t { return x.size(); }
+
+    operator Vec4Soa<const T>() const
+        requires(!std::is_const_v<T>)
+    {
+        return {x, y, z, w};
+    }
+};
+
+// components in the same order as glm::quat
+template <typename T>
+using QuatSoa = Vec4Soa<T>;
+
+template <typename T>
+struct AabbSoa {
+    Vec3Soa<T> min;
+    Vec3Soa<T> max;
+
+    auto size() const -> size_t { return min.size(); }
+
+    operator AabbSoa<const T>() const
+        requires(!std::is_const_v<T>)
+    {
+        return {min, max};
+    }
+};
+
+template <typename T>
+struct SphereSoa {
+    Vec3Soa<T> center;
+    std::span<T> radius;
+
+    auto size() const -> size_t { return radius.size(); }
+
+    operator SphereSoa<const T>() const
+        requires(!std::is_const_v<T>)
+    {
+        return {center, radius};
+    }
+};
+
+enum class SimdLevel : uint8_t {
+    Scalar,
+    Sse4,
+    Avx2,
+    Avx512,
+};
+
+// the widest instruction set the cpu supports, detected once
+auto supported_simd_level() -> SimdLevel;
+
+// the level the kernels currently run at, anything above what the cpu supports is clamped
+auto simd_level() -> SimdLevel;
+auto set_simd_level(SimdLevel level) -> SimdLevel;
+
+// outputs may alias their inputs, every kernel matches glm applied per element to within rounding
+
+// out = matrix * vec4(point, 1), without a perspective divide
+void transform_points(const glm::mat4 &matrix, Vec3Soa<const float> points, Vec3Soa<float> out);
+
+// every point with its own matrix
+void transform_points(std::span<const glm::mat4> matrices, Vec3Soa<const float> points, Vec3Soa<float> out);
+
+// out = matrix * vec4(vector, 0)
+void transform_vectors(const glm::mat4 &matrix, Vec3Soa<const float> vectors, Vec3Soa<float> out);
+
+void transform(const glm::mat4 &matrix, Vec4Soa<const float> vectors, Vec4Soa<float> out);
+
+// quaternions have to be non zero
+void normalize(QuatSoa<const float> quats, QuatSoa<float> out);
+
+// takes the shorter arc, uses a polynomial fit of the slerp weights instead of trigonometry so that lanes never
+// diverge, the weights are within 2e-5 of the exact ones
+void slerp(QuatSoa<const float> from, QuatSoa<const float> to, std::span<const float> t, QuatSoa<float> out);
+
+// the bounds of each box after the transform, which is not a tight fit under rotation
+void transform_aabbs(const glm::mat4 &matrix, AabbSoa<const float> boxes, AabbSoa<float> out);
+
+// appends the index of every sphere or box that overlaps the frustum to visible in ascending order, the tests are as
+// conservative as Frustum::overlaps
+void frustum_cull(const Frustum &frustum, SphereSoa<const float> spheres, std::vector<uint32_t> &visible);
+void frustum_cull(const Frustum &frustum, AabbSoa<const float> boxes, std::vector<uint32_t> &visible);
+
+} // namespace muon::maths
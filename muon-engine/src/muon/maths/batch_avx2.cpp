@@ -0,0 +1,66 @@
+#include "muon/maths/batch_kernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+namespace muon::maths::internal {
+
+namespace {
+
+// transposes four column major matrices so that each register holds one element of all four
+void load_quad(const float *matrices, __m128 *m) {
+    for (size_t column = 0; column < 4; column++) {
+        __m128 a = _mm_loadu_ps(matrices + column * 4);
+        __m128 b = _mm_loadu_ps(matrices + 16 + column * 4);
+        __m128 c = _mm_loadu_ps(matrices + 32 + column * 4);
+        __m128 d = _mm_loadu_ps(matrices + 48 + column * 4);
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        m[column * 4] = a;
+        m[column * 4 + 1] = b;
+        m[column * 4 + 2] = c;
+        m[column * 4 + 3] = d;
+    }
+}
+
+struct Avx2Lanes {
+    using Type = __m256;
+    static constexpr size_t WIDTH = 8;
+
+    static auto load(const float *p) -> Type { return _mm256_loadu_ps(p); }
+    static void store(float *p, Type v) { _mm256_storeu_ps(p, v); }
+    static auto set1(float value) -> Type { return _mm256_set1_ps(value); }
+    // gathers are slower than transposing in 128 bit halves
+    static void load_matrices(const float *matrices, Type *m) {
+        __m128 low[16];
+        __m128 high[16];
+        load_quad(matrices, low);
+        load_quad(matrices + 64, high);
+        for (size_t i = 0; i < 16; i++) {
+            m[i] = _mm256_set_m128(high[i], low[i]);
+        }
+    }
+
+    static auto add(Type a, Type b) -> Type { return _mm256_add_ps(a, b); }
+    static auto sub(Type a, Type b) -> Type { return _mm256_sub_ps(a, b); }
+    static auto mul(Type a, Type b) -> Type { return _mm256_mul_ps(a, b); }
+    static auto fmadd(Type a, Type b, Type c) -> Type { return _mm256_fmadd_ps(a, b, c); }
+    static auto div(Type a, Type b) -> Type { return _mm256_div_ps(a, b); }
+    static auto sqrt(Type v) -> Type { return _mm256_sqrt_ps(v); }
+    static auto abs(Type v) -> Type { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+    static auto flip_sign(Type v, Type sign) -> Type {
+        return _mm256_xor_ps(v, _mm256_and_ps(sign, _mm256_set1_ps(-0.0f)));
+    }
+    static auto min(Type a, Type b) -> Type { return _mm256_min_ps(a, b); }
+    static auto non_negative(Type v) -> uint32_t {
+        return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_GE_OQ)));
+    }
+};
+
+} // namespace
+
+auto avx2_kernels() -> const BatchKernels & { return Kernels<Avx2Lanes>::TABLE; }
+
+} // namespace muon::maths::internal
+
+#endif
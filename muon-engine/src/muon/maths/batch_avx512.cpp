@@ -0,0 +1,68 @@
+#include "muon/maths/batch_kernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+namespace muon::maths::internal {
+
+namespace {
+
+// transposes four column major matrices so that each register holds one element of all four
+void load_quad(const float *matrices, __m128 *m) {
+    for (size_t column = 0; column < 4; column++) {
+        __m128 a = _mm_loadu_ps(matrices + column * 4);
+        __m128 b = _mm_loadu_ps(matrices + 16 + column * 4);
+        __m128 c = _mm_loadu_ps(matrices + 32 + column * 4);
+        __m128 d = _mm_loadu_ps(matrices + 48 + column * 4);
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        m[column * 4] = a;
+        m[column * 4 + 1] = b;
+        m[column * 4 + 2] = c;
+        m[column * 4 + 3] = d;
+    }
+}
+
+// only avx512f is assumed, the float bitwise operations go through the integer unit since they need avx512dq
+struct Avx512Lanes {
+    using Type = __m512;
+    static constexpr size_t WIDTH = 16;
+
+    static auto load(const float *p) -> Type { return _mm512_loadu_ps(p); }
+    static void store(float *p, Type v) { _mm512_storeu_ps(p, v); }
+    static auto set1(float value) -> Type { return _mm512_set1_ps(value); }
+    static void load_matrices(const float *matrices, Type *m) {
+        __m128 quads[4][16];
+        for (size_t quad = 0; quad < 4; quad++) {
+            load_quad(matrices + quad * 64, quads[quad]);
+        }
+        for (size_t i = 0; i < 16; i++) {
+            auto value = _mm512_castps128_ps512(quads[0][i]);
+            value = _mm512_insertf32x4(value, quads[1][i], 1);
+            value = _mm512_insertf32x4(value, quads[2][i], 2);
+            m[i] = _mm512_insertf32x4(value, quads[3][i], 3);
+        }
+    }
+
+    static auto add(Type a, Type b) -> Type { return _mm512_add_ps(a, b); }
+    static auto sub(Type a, Type b) -> Type { return _mm512_sub_ps(a, b); }
+    static auto mul(Type a, Type b) -> Type { return _mm512_mul_ps(a, b); }
+    static auto fmadd(Type a, Type b, Type c) -> Type { return _mm512_fmadd_ps(a, b, c); }
+    static auto div(Type a, Type b) -> Type { return _mm512_div_ps(a, b); }
+    static auto sqrt(Type v) -> Type { return _mm512_sqrt_ps(v); }
+    static auto abs(Type v) -> Type { return _mm512_abs_ps(v); }
+    static auto flip_sign(Type v, Type sign) -> Type {
+        auto mask = _mm512_and_si512(_mm512_castps_si512(sign), _mm512_set1_epi32(static_cast<int>(0x80000000u)));
+        return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(v), mask));
+    }
+    static auto min(Type a, Type b) -> Type { return _mm512_min_ps(a, b); }
+    static auto non_negative(Type v) -> uint32_t { return _mm512_cmp_ps_mask(v, _mm512_setzero_ps(), _CMP_GE_OQ); }
+};
+
+} // namespace
+
+auto avx512_kernels() -> const BatchKernels & { return Kernels<Avx512Lanes>::TABLE; }
+
+} // namespace muon::maths::internal
+
+#endif
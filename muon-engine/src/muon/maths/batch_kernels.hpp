@@ -0,0 +1,345 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// shared by the scalar kernels and every instruction set specific translation unit, each of which instantiates the
+// kernels with its own lane type, kept free of library calls so nothing compiled for a wider instruction set can be
+// picked by the linker for code running on a cpu without it
+namespace muon::maths::internal {
+
+struct Vec3In {
+    const float *x;
+    const float *y;
+    const float *z;
+};
+
+struct Vec3Out {
+    float *x;
+    float *y;
+    float *z;
+};
+
+struct Vec4In {
+    const float *x;
+    const float *y;
+    const float *z;
+    const float *w;
+};
+
+struct Vec4Out {
+    float *x;
+    float *y;
+    float *z;
+    float *w;
+};
+
+// matrices are column major like glm, counts are always a multiple of the width, the remainder goes to the scalar
+// kernels
+struct BatchKernels {
+    size_t width;
+    void (*transform_points)(const float *matrix, Vec3In in, Vec3Out out, size_t count);
+    void (*transform_points_each)(const float *matrices, Vec3In in, Vec3Out out, size_t count);
+    void (*transform_vectors)(const float *matrix, Vec3In in, Vec3Out out, size_t count);
+    void (*transform)(const float *matrix, Vec4In in, Vec4Out out, size_t count);
+    void (*normalize)(Vec4In in, Vec4Out out, size_t count);
+    void (*slerp)(Vec4In from, Vec4In to, const float *t, Vec4Out out, size_t count);
+    void (*transform_aabbs)(const float *matrix, Vec3In min, Vec3In max, Vec3Out out_min, Vec3Out out_max, size_t count);
+
+    // planes are six (normal, distance) quadruples, writes first + i for every visible i and returns how many, out needs
+    // room for count indices
+    auto (*frustum_cull_spheres)(
+        const float *planes, Vec3In center, const float *radius, uint32_t first, uint32_t *out, size_t count
+    ) -> size_t;
+    auto (*frustum_cull_aabbs)(const float *planes, Vec3In min, Vec3In max, uint32_t first, uint32_t *out, size_t count)
+        -> size_t;
+};
+
+auto scalar_kernels() -> const BatchKernels &;
+auto sse4_kernels() -> const BatchKernels &;
+auto avx2_kernels() -> const BatchKernels &;
+auto avx512_kernels() -> const BatchKernels &;
+
+// eberly's polynomial approximation of the slerp weights, the last term is scaled to absorb the truncation error
+constexpr size_t SLERP_TERMS = 8;
+constexpr float SLERP_MU = 1.85298109240830f;
+constexpr float SLERP_U[SLERP_TERMS] = {
+    1.0f / (1 * 3), 1.0f / (2 * 5), 1.0f / (3 * 7), 1.0f / (4 * 9),
+    1.0f / (5 * 11), 1.0f / (6 * 13), 1.0f / (7 * 15), SLERP_MU / (8 * 17),
+};
+constexpr float SLERP_V[SLERP_TERMS] = {
+    1.0f / 3, 2.0f / 5, 3.0f / 7, 4.0f / 9, 5.0f / 11, 6.0f / 13, 7.0f / 15, SLERP_MU * 8 / 17,
+};
+
+// L supplies a lane type and the handful of operations below, WIDTH elements at a time
+template <typename L>
+struct Kernels {
+    using V = typename L::Type;
+
+    // dot(row, (x, y, z, w)) for one row of a broadcast matrix
+    static auto row(const V *m, size_t r, V x, V y, V z, V w) -> V {
+        return L::fmadd(m[r], x, L::fmadd(m[4 + r], y, L::fmadd(m[8 + r], z, L::mul(m[12 + r], w))));
+    }
+
+    static auto row_affine(const V *m, size_t r, V x, V y, V z) -> V {
+        return L::fmadd(m[r], x, L::fmadd(m[4 + r], y, L::fmadd(m[8 + r], z, m[12 + r])));
+    }
+
+    static void broadcast(const float *matrix, V *m) {
+        for (size_t i = 0; i < 16; i++) {
+            m[i] = L::set1(matrix[i]);
+        }
+    }
+
+    static void transform_points(const float *matrix, Vec3In in, Vec3Out out, size_t count) {
+        V m[16];
+        broadcast(matrix, m);
+        for (size_t i = 0; i < count; i += L::WIDTH) {
+            V x = L::load(in.x + i);
+            V y = L::load(in.y + i);
+            V z = L::load(in.z + i);
+            L::store(out.x + i, row_affine(m, 0, x, y, z));
+            L::store(out.y + i, row_affine(m, 1, x, y, z));
+            L::store(out.z + i, row_affine(m, 2, x, y, z));
+        }
+    }
+
+    static void transform_points_each(const float *matrices, Vec3In in, Vec3Out out, size_t count) {
+        V m[16];
+        for (size_t i = 0; i < count; i += L::WIDTH) {
+            L::load_matrices(matrices + i * 16, m);
+            V x = L::load(in.x + i);
+            V y = L::load(in.y + i);
+            V z = L::load(in.z + i);
+            L::store(out.x + i, row_affine(m, 0, x, y, z));
+            L::store(out.y + i, row_affine(m, 1, x, y, z));
+            L::store(out.z + i, row_affine(m, 2, x, y, z));
+        }
+    }
+
+    static void transform_vectors(const float *matrix, Vec3In in, Vec3Out out, size_t count) {
+        V m[16];
+        broadcast(matrix, m);
+        V zero = L::set1(0.0f);
+        for (size_t i = 0; i < count; i += L::WIDTH) {
+            V x = L::load(in.x + i);
+            V y = L::load(in.y + i);
+            V z = L::load(in.z + i);
+            L::store(out.x + i, row(m, 0, x, y, z, zero));
+            L::store(out.y + i, row(m, 1, x, y, z, zero));
+            L::store(out.z + i, row(m, 2, x, y, z, zero));
+        }
+    }
+
+    static void transform(const float *matrix, Vec4In in, Vec4Out out, size_t count) {
+        V m[16];
+        broadcast(matrix, m);
+        for (size_t i = 0; i < count; i += L::WIDTH) {
+            V x = L::load(in.x + i);
+            V y = L::load(in.y + i);
+            V z = L::load(in.z + i);
+            V w = L::load(in.w + i);
+            L::store(out.x + i, row(m, 0, x, y, z, w));
+            L::store(out.y + i, row(m, 1, x, y, z, w));
+            L::store(out.z + i, row(m, 2, x, y, z, w));
+            L::store(out.w + i, row(m, 3, x, y, z, w));
+        }
+    }
+
+    static void normalize(Vec4In in, Vec4Out out, size_t count) {
+        V one = L::set1(1.0f);
+        for (size_t i = 0; i < count; i += L::WIDTH) {
+            V x = L::load(in.x + i);
+            V y = L::load(in.y + i);
+            V z = L::load(in.z + i);
+            V w = L::load(in.w + i);
+            V inverse = L::div(one, L::sqrt(L::fmadd(x, x, L::fmadd(y, y, L::fmadd(z, z, L::mul(w, w))))));
+            L::store(out.x + i, L::mul(x, inverse));
+            L::store(out.y + i, L::mul(y, inverse));
+            L::store(out.z + i, L::mul(z, inverse));
+            L::store(out.w + i, L::mul(w, inverse));
+        }
+    }
+
+    // 1 + b0 * (1 + b1 * (... (1 + b7))) scaled by t, with bi = (ui * t^2 - vi) * (cos - 1)
+    static auto slerp_weight(V t, V cos_minus_one, V one) -> V {
+        V squared = L::mul(t, t);
+        V weight = one;
+        for (size_t i = SLERP_TERMS; i-- > 0;) {
+            V term = L::mul(L::fmadd(L::set1(SLERP_U[i]), squared, L::set1(-SLERP_V[i])), cos_minus_one);
+            weight = L::fmadd(term, weight, one);
+        }
+        return L::mul(t, weight);
+    }
+
+    static void slerp(Vec4In from, Vec4In to, const float *t, Vec4Out out, size_t count) {
+        V one = L::set1(1.0f);
+        for (size_t i = 0; i < count; i += L::WIDTH) {
+            V ax = L::load(from.x + i);
+            V ay = L::load(from.y + i);
+            V az = L::load(from.z + i);
+            V aw = L::load(from.w + i);
+            V bx = L::load(to.x + i);
+            V by = L::load(to.y + i);
+            V bz = L::load(to.z + i);
+            V bw = L::load(to.w + i);
+
+            // flipping the target onto the same hemisphere takes the shorter arc
+            V cos = L::fmadd(ax, bx, L::fmadd(ay, by, L::fmadd(az, bz, L::mul(aw, bw))));
+            bx = L::flip_sign(bx, cos);
+            by = L::flip_sign(by, cos);
+            bz = L::flip_sign(bz, cos);
+            bw = L::flip_sign(bw, cos);
+            V cos_minus_one = L::sub(L::abs(cos), one);
+
+            V weight_to = L::load(t + i);
+            V weight_from = slerp_weight(L::sub(one, weight_to), cos_minus_one, one);
+            weight_to = slerp_weight(weight_to, cos_minus_one, one);
+
+            L::store(out.x + i, L::fmadd(ax, weight_from, L::mul(bx, weight_to)));
+            L::store(out.y + i, L::fmadd(ay, weight_from, L::mul(by, weight_to)));
+            L::store(out.z + i, L::fmadd(az, weight_from, L::mul(bz, weight_to)));
+            L::store(out.w + i, L::fmadd(aw, weight_from, L::mul(bw, weight_to)));
+        }
+    }
+
+    // arvo's method on centre and half extent, the extent goes through the absolute upper 3x3
+    static void transform_aabbs(
+        const float *matrix, Vec3In min, Vec3In max, Vec3Out out_min, Vec3Out out_max, size_t count
+    ) {
+        V m[16];
+        V a[16];
+        broadcast(matrix, m);
+        for (size_t i = 0; i < 16; i++) {
+            a[i] = L::abs(m[i]);
+        }
+
+        V half = L::set1(0.5f);
+        for (size_t i = 0; i < count; i += L::WIDTH) {
+            V min_x = L::load(min.x + i);
+            V min_y = L::load(min.y + i);
+            V min_z = L::load(min.z + i);
+            V max_x = L::load(max.x + i);
+            V max_y = L::load(max.y + i);
+            V max_z = L::load(max.z + i);
+
+            V cx = L::mul(L::add(min_x, max_x), half);
+            V cy = L::mul(L::add(min_y, max_y), half);
+            V cz = L::mul(L::add(min_z, max_z), half);
+            V ex = L::mul(L::sub(max_x, min_x), half);
+            V ey = L::mul(L::sub(max_y, min_y), half);
+            V ez = L::mul(L::sub(max_z, min_z), half);
+
+            V centre_x = row_affine(m, 0, cx, cy, cz);
+            V centre_y = row_affine(m, 1, cx, cy, cz);
+            V centre_z = row_affine(m, 2, cx, cy, cz);
+            V extent_x = L::fmadd(a[0], ex, L::fmadd(a[4], ey, L::mul(a[8], ez)));
+            V extent_y = L::fmadd(a[1], ex, L::fmadd(a[5], ey, L::mul(a[9], ez)));
+            V extent_z = L::fmadd(a[2], ex, L::fmadd(a[6], ey, L::mul(a[10], ez)));
+
+            L::store(out_min.x + i, L::sub(centre_x, extent_x));
+            L::store(out_min.y + i, L::sub(centre_y, extent_y));
+            L::store(out_min.z + i, L::sub(centre_z, extent_z));
+            L::store(out_max.x + i, L::add(centre_x, extent_x));
+            L::store(out_max.y + i, L::add(centre_y, extent_y));
+            L::store(out_max.z + i, L::add(centre_z, extent_z));
+        }
+    }
+
+    // every lane is written and only the visible ones advance, which never branches on the mask
+    static auto compact(uint32_t mask, size_t index, uint32_t *out) -> size_t {
+        if (mask == 0) {
+            return 0;
+        }
+        size_t written = 0;
+        for (size_t lane = 0; lane < L::WIDTH; lane++) {
+            out[written] = static_cast<uint32_t>(index + lane);
+            written += (mask >> lane) & 1;
+        }
+        return written;
+    }
+
+    static auto plane_distance(const V *p, size_t plane, V x, V y, V z) -> V {
+        return L::fmadd(p[plane * 4], x, L::fmadd(p[plane * 4 + 1], y, L::fmadd(p[plane * 4 + 2], z, p[plane * 4 + 3])));
+    }
+
+    static auto frustum_cull_spheres(
+        const float *planes, Vec3In center, const float *radius, uint32_t first, uint32_t *out, size_t count
+    ) -> size_t {
+        V p[24];
+        for (size_t i = 0; i < 24; i++) {
+            p[i] = L::set1(planes[i]);
+        }
+
+        size_t visible = 0;
+        for (size_t i = 0; i < count; i += L::WIDTH) {
+            V x = L::load(center.x + i);
+            V y = L::load(center.y + i);
+            V z = L::load(center.z + i);
+
+            // the sphere is outside once its centre is further than its radius behind any plane
+            V distance = plane_distance(p, 0, x, y, z);
+            for (size_t plane = 1; plane < 6; plane++) {
+                distance = L::min(distance, plane_distance(p, plane, x, y, z));
+            }
+            distance = L::add(distance, L::load(radius + i));
+            visible += compact(L::non_negative(distance), first + i, out + visible);
+        }
+        return visible;
+    }
+
+    static auto frustum_cull_aabbs(const float *planes, Vec3In min, Vec3In max, uint32_t first, uint32_t *out, size_t count)
+        -> size_t {
+        V p[24];
+        V a[24];
+        for (size_t i = 0; i < 24; i++) {
+            p[i] = L::set1(planes[i]);
+            a[i] = L::abs(p[i]);
+        }
+
+        V half = L::set1(0.5f);
+        size_t visible = 0;
+        for (size_t i = 0; i < count; i += L::WIDTH) {
+            V min_x = L::load(min.x + i);
+            V min_y = L::load(min.y + i);
+            V min_z = L::load(min.z + i);
+            V max_x = L::load(max.x + i);
+            V max_y = L::load(max.y + i);
+            V max_z = L::load(max.z + i);
+
+            V cx = L::mul(L::add(min_x, max_x), half);
+            V cy = L::mul(L::add(min_y, max_y), half);
+            V cz = L::mul(L::add(min_z, max_z), half);
+            V ex = L::mul(L::sub(max_x, min_x), half);
+            V ey = L::mul(L::sub(max_y, min_y), half);
+            V ez = L::mul(L::sub(max_z, min_z), half);
+
+            // the centre's distance plus the extent projected onto the plane's normal, same as Frustum::overlaps
+            auto reach = [&](size_t plane) {
+                V radius = L::fmadd(a[plane * 4], ex, L::fmadd(a[plane * 4 + 1], ey, L::mul(a[plane * 4 + 2], ez)));
+                return L::add(plane_distance(p, plane, cx, cy, cz), radius);
+            };
+            V distance = reach(0);
+            for (size_t plane = 1; plane < 6; plane++) {
+                distance = L::min(distance, reach(plane));
+            }
+            visible += compact(L::non_negative(distance), first + i, out + visible);
+        }
+        return visible;
+    }
+
+    static constexpr BatchKernels TABLE{
+        .width = L::WIDTH,
+        .transform_points = transform_points,
+        .transform_points_each = transform_points_each,
+        .transform_vectors = transform_vectors,
+        .transform = transform,
+        .normalize = normalize,
+        .slerp = slerp,
+        .transform_aabbs = transform_aabbs,
+        .frustum_cull_spheres = frustum_cull_spheres,
+        .frustum_cull_aabbs = frustum_cull_aabbs,
+    };
+};
+
+} // namespace muon::maths::internal
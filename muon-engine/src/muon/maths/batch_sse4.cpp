@@ -0,0 +1,56 @@
+#include "muon/maths/batch_kernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+namespace muon::maths::internal {
+
+namespace {
+
+// transposes four column major matrices so that each register holds one element of all four
+void load_quad(const float *matrices, __m128 *m) {
+    for (size_t column = 0; column < 4; column++) {
+        __m128 a = _mm_loadu_ps(matrices + column * 4);
+        __m128 b = _mm_loadu_ps(matrices + 16 + column * 4);
+        __m128 c = _mm_loadu_ps(matrices + 32 + column * 4);
+        __m128 d = _mm_loadu_ps(matrices + 48 + column * 4);
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        m[column * 4] = a;
+        m[column * 4 + 1] = b;
+        m[column * 4 + 2] = c;
+        m[column * 4 + 3] = d;
+    }
+}
+
+// the kernels only need plain packed arithmetic, the level is named after the oldest cpus the engine runs on
+struct Sse4Lanes {
+    using Type = __m128;
+    static constexpr size_t WIDTH = 4;
+
+    static auto load(const float *p) -> Type { return _mm_loadu_ps(p); }
+    static void store(float *p, Type v) { _mm_storeu_ps(p, v); }
+    static auto set1(float value) -> Type { return _mm_set1_ps(value); }
+    static void load_matrices(const float *matrices, Type *m) { load_quad(matrices, m); }
+
+    static auto add(Type a, Type b) -> Type { return _mm_add_ps(a, b); }
+    static auto sub(Type a, Type b) -> Type { return _mm_sub_ps(a, b); }
+    static auto mul(Type a, Type b) -> Type { return _mm_mul_ps(a, b); }
+    static auto fmadd(Type a, Type b, Type c) -> Type { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static auto div(Type a, Type b) -> Type { return _mm_div_ps(a, b); }
+    static auto sqrt(Type v) -> Type { return _mm_sqrt_ps(v); }
+    static auto abs(Type v) -> Type { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+    static auto flip_sign(Type v, Type sign) -> Type { return _mm_xor_ps(v, _mm_and_ps(sign, _mm_set1_ps(-0.0f))); }
+    static auto min(Type a, Type b) -> Type { return _mm_min_ps(a, b); }
+    static auto non_negative(Type v) -> uint32_t {
+        return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(v, _mm_setzero_ps())));
+    }
+};
+
+} // namespace
+
+auto sse4_kernels() -> const BatchKernels & { return Kernels<Sse4Lanes>::TABLE; }
+
+} // namespace muon::maths::internal
+
+#endif
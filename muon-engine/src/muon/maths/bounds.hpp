@@ -0,0 +1,143 @@
+#pragma once
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace muon::maths {
+
+struct Aabb {
+    glm::vec3 min{std::numeric_limits<float>::max()};
+    glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+    static auto from_center(const glm::vec3 &center, const glm::vec3 &extent) -> Aabb {
+        return {center - extent, center + extent};
+    }
+
+    auto center() const -> glm::vec3 { return (min + max) * 0.5f; }
+    auto extent() const -> glm::vec3 { return (max - min) * 0.5f; }
+
+    // the default constructed box is empty and merges into anything without changing it
+    auto is_empty() const -> bool { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+    auto surface_area() const -> float {
+        auto size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    auto merge(const Aabb &other) const -> Aabb { return {glm::min(min, other.min), glm::max(max, other.max)}; }
+
+    auto contains(const Aabb &other) const -> bool {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z && other.max.x <= max.x &&
+               other.max.y <= max.y && other.max.z <= max.z;
+    }
+
+    auto overlaps(const Aabb &other) const -> bool {
+        return min.x <= other.max.x && other.min.x <= max.x && min.y <= other.max.y && other.min.y <= max.y &&
+               min.z <= other.max.z && other.min.z <= max.z;
+    }
+
+    auto operator==(const Aabb &) const -> bool = default;
+};
+
+struct Sphere {
+    glm::vec3 center{0.0f};
+    float radius{0.0f};
+};
+
+struct Ray {
+    glm::vec3 origin{0.0f};
+    // doesn't have to be normalised, distances along the ray are in multiples of it
+    glm::vec3 direction{0.0f, 0.0f, -1.0f};
+};
+
+// points with dot(normal, point) + distance >= 0 are in front of the plane
+struct Plane {
+    glm::vec3 normal{0.0f, 1.0f, 0.0f};
+    float distance{0.0f};
+
+    auto signed_distance(const glm::vec3 &point) const -> float { return glm::dot(normal, point) + distance; }
+};
+
+// the planes face inwards, in the order left, right, bottom, top, near, far
+struct Frustum {
+    std::array<Plane, 6> planes;
+
+    // extracts the planes of a view projection matrix, clip space depth follows glm's configuration
+    static auto from_matrix(const glm::mat4 &view_projection) -> Frustum {
+        auto row = [&](int r) {
+            return glm::vec4{view_projection[0][r], view_projection[1][r], view_projection[2][r], view_projection[3][r]};
+        };
+        auto plane = [](const glm::vec4 &p) {
+            auto length = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+            return Plane{glm::vec3{p.x, p.y, p.z} / length, p.w / length};
+        };
+
+        auto x = row(0);
+        auto y = row(1);
+        auto z = row(2);
+        auto w = row(3);
+#if defined(GLM_FORCE_DEPTH_ZERO_TO_ONE)
+        auto near_plane = z;
+#else
+        auto near_plane = w + z;
+#endif
+        return {{plane(w + x), plane(w - x), plane(w + y), plane(w - y), plane(near_plane), plane(w - z)}};
+    }
+
+    auto contains(const glm::vec3 &point) const -> bool {
+        for (const auto &plane : planes) {
+            if (plane.signed_distance(point) < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // conservative, boxes outside the frustum but across the corner of two planes still count
+    auto overlaps(const Aabb &box) const -> bool {
+        auto center = box.center();
+        auto extent = box.extent();
+        for (const auto &plane : planes) {
+            auto radius = glm::dot(glm::abs(plane.normal), extent);
+            if (plane.signed_distance(center) + radius < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto overlaps(const Sphere &sphere) const -> bool {
+        for (const auto &plane : planes) {
+            if (plane.signed_distance(sphere.center) + sphere.radius < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// the distance along the ray at which it enters the box, or infinity if it misses within [0, max_distance]
+inline auto intersect(const Ray &ray, const Aabb &box, float max_distance = std::numeric_limits<float>::infinity())
+    -> float {
+    auto inverse = 1.0f / ray.direction;
+    auto lower = (box.min - ray.origin) * inverse;
+    auto upper = (box.max - ray.origin) * inverse;
+    auto entry = glm::min(lower, upper);
+    auto exit = glm::max(lower, upper);
+
+    // a zero direction component gives infinite slab distances, which only misbehaves if the origin lies exactly on the
+    // slab's boundary
+    auto t_min = std::max(std::max(entry.x, entry.y), std::max(entry.z, 0.0f));
+    auto t_max = std::min(std::min(exit.x, exit.y), std::min(exit.z, max_distance));
+    return t_min <= t_max ? t_min : std::numeric_limits<float>::infinity();
+}
+
+} // namespace muon::maths
@@ -0,0 +1,95 @@
+#include "muon/profile/frame_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace muon::profile {
+
+RollingHistogram::RollingHistogram(size_t window)
+    : window_{std::max<size_t>(window, 1)}, samples_{std::make_unique<std::atomic<uint64_t>[]>(window_)} {}
+
+void RollingHistogram::record(Duration sample) noexcept {
+    const uint64_t value = static_cast<uint64_t>(std::max<int64_t>(sample.count(), 0));
+    const uint64_t written = written_.load(std::memory_order_relaxed);
+    auto &slot = samples_[written % window_];
+
+    if (written >= window_) {
+        const uint64_t evicted = slot.load(std::memory_order_relaxed);
+        buckets_[bucket_index(evicted)].fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    slot.store(value, std::memory_order_relaxed);
+    buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    written_.store(written + 1, std::memory_order_release);
+}
+
+auto RollingHistogram::percentiles() const noexcept -> Percentiles {
+    const size_t count = std::min<uint64_t>(written_.load(std::memory_order_acquire), window_);
+
+    uint64_t max = 0;
+    for (size_t i = 0; i < count; i++) {
+        max = std::max(max, samples_[i].load(std::memory_order_relaxed));
+    }
+
+    return Percentiles{
+        .p50 = std::min(percentile(0.50), Duration{max}),
+        .p95 = std::min(percentile(0.95), Duration{max}),
+        .p99 = std::min(percentile(0.99), Duration{max}),
+        .max = Duration{max},
+        .count = count,
+    };
+}
+
+auto RollingHistogram::percentile(double fraction) const noexcept -> Duration {
+    std::array<uint32_t, BUCKET_COUNT> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    if (total == 0) {
+        return Duration{0};
+    }
+
+    const auto rank = static_cast<uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen >= std::max<uint64_t>(rank, 1)) {
+            return Duration{bucket_upper_bound(i)};
+        }
+    }
+
+    return Duration{bucket_upper_bound(BUCKET_COUNT - 1)};
+}
+
+auto RollingHistogram::window() const noexcept -> size_t { return window_; }
+
+auto RollingHistogram::bucket_index(uint64_t value) noexcept -> size_t {
+    if (value < SUB_BUCKETS) {
+        return value;
+    }
+
+    const uint32_t exponent = std::min<uint32_t>(std::bit_width(value) - 1, MAX_EXPONENT);
+    if (exponent == MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+
+    const uint64_t mantissa = value >> (exponent - PRECISION_BITS);
+    return (exponent - PRECISION_BITS + 1) * SUB_BUCKETS + (mantissa - SUB_BUCKETS);
+}
+
+auto RollingHistogram::bucket_upper_bound(size_t index) noexcept -> uint64_t {
+    const size_t group = index / SUB_BUCKETS;
+    if (group == 0) {
+        return index;
+    }
+
+    const uint32_t shift = static_cast<uint32_t>(group) - 1;
+    const uint64_t mantissa = (index % SUB_BUCKETS) + SUB_BUCKETS;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+} // namespace muon::profile
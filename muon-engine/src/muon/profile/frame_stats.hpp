@@ -0,0 +1,64 @@
+#pragma once
+
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace muon::profile {
+
+using Duration = std::chrono::nanoseconds;
+
+struct Percentiles {
+    Duration p50{0};
+    Duration p95{0};
+    Duration p99{0};
+    Duration max{0};
+    size_t count{0};
+};
+
+// log-linear histogram over the most recent `window` samples, written by one thread and readable from any
+class RollingHistogram : utils::NoCopy, utils::NoMove {
+public:
+    explicit RollingHistogram(size_t window);
+
+    void record(Duration sample) noexcept;
+
+    auto percentiles() const noexcept -> Percentiles;
+    auto percentile(double fraction) const noexcept -> Duration;
+
+    auto window() const noexcept -> size_t;
+
+private:
+    // 32 sub-buckets per power of two keeps every bucket within ~3% of its values
+    static constexpr uint32_t PRECISION_BITS = 5;
+    static constexpr uint32_t SUB_BUCKETS = 1 << PRECISION_BITS;
+    // covers samples up to 2^40 ns, around 18 minutes
+    static constexpr uint32_t MAX_EXPONENT = 40;
+    static constexpr size_t BUCKET_COUNT = (MAX_EXPONENT - PRECISION_BITS + 1) * SUB_BUCKETS;
+
+    static auto bucket_index(uint64_t value) noexcept -> size_t;
+    static auto bucket_upper_bound(size_t index) noexcept -> uint64_t;
+
+private:
+    std::array<std::atomic<uint32_t>, BUCKET_COUNT> buckets_{};
+
+    size_t window_;
+    std::unique_ptr<std::atomic<uint64_t>[]> samples_;
+    std::atomic<uint64_t> written_{0};
+};
+
+struct FrameStats {
+    explicit FrameStats(size_t window) : frame{window}, update{window}, poll_events{window} {}
+
+    RollingHistogram frame;
+    RollingHistogram update;
+    RollingHistogram poll_events;
+};
+
+} // namespace muon::profile
@@ -0,0 +1,179 @@
+#include "muon/profile/profiler.hpp"
+
+#include "muon/core/log.hpp"
+#include "muon/utils/ring_buffer.hpp"
+#include "nlohmann/json.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace muon::profile {
+
+namespace {
+
+constexpr size_t ZONES_PER_THREAD = 1 << 16;
+
+struct ThreadBuffer {
+    uint32_t thread_id;
+    utils::RingBuffer<Zone> zones{ZONES_PER_THREAD};
+    std::atomic<uint64_t> dropped{0};
+};
+
+struct Profiler {
+    std::atomic<bool> capturing{false};
+
+    std::mutex threads_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> threads;
+
+    std::mutex names_mutex;
+    std::unordered_set<std::string> names;
+
+    // only touched by the main loop thread
+    uint32_t frames_left{0};
+    std::filesystem::path path;
+    std::vector<std::pair<uint32_t, Zone>> collected;
+};
+
+auto profiler() -> Profiler & {
+    static Profiler instance;
+    return instance;
+}
+
+auto now() noexcept -> uint64_t {
+    auto time = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+auto thread_buffer() -> ThreadBuffer & {
+    thread_local ThreadBuffer *buffer = [] {
+        auto &state = profiler();
+        std::lock_guard lock{state.threads_mutex};
+        auto id = static_cast<uint32_t>(state.threads.size());
+        return state.threads.emplace_back(std::make_unique<ThreadBuffer>(id)).get();
+    }();
+    return *buffer;
+}
+
+void drain(Profiler &state) {
+    std::lock_guard lock{state.threads_mutex};
+    for (auto &buffer : state.threads) {
+        while (auto zone = buffer->zones.pop()) {
+            state.collected.emplace_back(buffer->thread_id, *zone);
+        }
+    }
+}
+
+void write_trace(Profiler &state) {
+    nlohmann::json events = nlohmann::json::array();
+
+    uint64_t origin = UINT64_MAX;
+    for (const auto &[thread, zone] : state.collected) {
+        origin = std::min(origin, zone.begin);
+    }
+
+    for (const auto &[thread, zone] : state.collected) {
+        events.push_back({
+            {"name", zone.name},
+            {"cat", "muon"},
+            {"ph", "X"},
+            {"ts", static_cast<double>(zone.begin - origin) / 1000.0},
+            {"dur", static_cast<double>(zone.end - zone.begin) / 1000.0},
+            {"pid", 0},
+            {"tid", thread},
+        });
+    }
+
+    uint64_t dropped = 0;
+    {
+        std::lock_guard lock{state.threads_mutex};
+        for (auto &buffer : state.threads) {
+            dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::ofstream file{state.path};
+    if (!file) {
+        MU_LOG_ERROR(Profile, "failed to open profiler capture output: {}", state.path.string());
+        return;
+    }
+    file << nlohmann::json{{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+
+    MU_LOG_INFO(Profile, "wrote {} profiler zones to {}", state.collected.size(), state.path.string());
+    if (dropped > 0) {
+        MU_LOG_WARN(Profile, "profiler dropped {} zones, thread buffers were full", dropped);
+    }
+}
+
+} // namespace
+
+ScopedZone::ScopedZone(const char *name) noexcept {
+    if (profiler().capturing.load(std::memory_order_relaxed)) {
+        name_ = name;
+        begin_ = now();
+    }
+}
+
+ScopedZone::~ScopedZone() noexcept {
+    if (!name_) {
+        return;
+    }
+
+    auto &buffer = thread_buffer();
+    if (!buffer.zones.push(Zone{name_, begin_, now()})) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void capture(uint32_t frames, const std::filesystem::path &path) {
+    auto &state = profiler();
+    if (state.capturing.load(std::memory_order_relaxed) || frames == 0) {
+        return;
+    }
+
+    // discard zones that finished after the previous capture ended
+    drain(state);
+    state.collected.clear();
+
+    state.frames_left = frames;
+    state.path = path;
+    state.capturing.store(true, std::memory_order_relaxed);
+
+    MU_LOG_INFO(Profile, "capturing {} frames", frames);
+}
+
+auto is_capturing() noexcept -> bool { return profiler().capturing.load(std::memory_order_relaxed); }
+
+void mark_frame() {
+    auto &state = profiler();
+    if (!state.capturing.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    drain(state);
+
+    state.frames_left -= 1;
+    if (state.frames_left > 0) {
+        return;
+    }
+
+    state.capturing.store(false, std::memory_order_relaxed);
+    drain(state);
+    write_trace(state);
+    state.collected.clear();
+    state.collected.shrink_to_fit();
+}
+
+auto intern(std::string_view name) -> const char * {
+    auto &state = profiler();
+    std::lock_guard lock{state.names_mutex};
+    return state.names.emplace(name).first->c_str();
+}
+
+} // namespace muon::profile
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace muon::profile {
+
+struct Zone {
+    const char *name{nullptr};
+    uint64_t begin{0};
+    uint64_t end{0};
+};
+
+class ScopedZone {
+public:
+    explicit ScopedZone(const char *name) noexcept;
+    ~ScopedZone() noexcept;
+
+    ScopedZone(const ScopedZone &) = delete;
+    auto operator=(const ScopedZone &) -> ScopedZone & = delete;
+
+private:
+    const char *name_{nullptr};
+    uint64_t begin_{0};
+};
+
+// records every zone on every thread for the next `frames` frames, then writes a chrome trace to `path`
+void capture(uint32_t frames, const std::filesystem::path &path);
+auto is_capturing() noexcept -> bool;
+
+// closes the current frame, must be called from the thread that runs the main loop
+void mark_frame();
+
+// returns a pointer to a copy of the name that lives for the rest of the program
+auto intern(std::string_view name) -> const char *;
+
+} // namespace muon::profile
+
+#define MU_PROFILE_CONCAT_INNER(a, b) a##b
+#define MU_PROFILE_CONCAT(a, b) MU_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef MU_PROFILE
+#define MU_PROFILE_ZONE(name) const ::muon::profile::ScopedZone MU_PROFILE_CONCAT(mu_profile_zone_, __LINE__){name}
+#define MU_PROFILE_FUNCTION() MU_PROFILE_ZONE(__func__)
+#define MU_PROFILE_FRAME() ::muon::profile::mark_frame()
+#else
+#define MU_PROFILE_ZONE(name) static_cast<void>(0)
+#define MU_PROFILE_FUNCTION() static_cast<void>(0)
+#define MU_PROFILE_FRAME() static_cast<void>(0)
+#endif
@@ -0,0 +1,843 @@
+#include "muon/scene/bvh.hpp"
+
+#include "muon/core/expect.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define MU_BVH_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace muon::scene {
+
+namespace {
+
+// wider ranges are built on another worker while this one carries on with the other half
+constexpr size_t PARALLEL_BUILD_THRESHOLD = 4096;
+constexpr size_t SAH_BINS = 16;
+
+// below this many leaves binning costs more than it saves, ranges are split at the median instead
+constexpr size_t SAH_MIN_LEAVES = 16;
+
+// the subtree below a node flagged inside a frustum is reported without testing
+constexpr uint32_t INSIDE_BIT = 1u << 31;
+
+// a traversal stack that only allocates for unusually deep trees
+template <typename T>
+class Stack {
+public:
+    Stack() = default;
+    Stack(const Stack &) = delete;
+    auto operator=(const Stack &) -> Stack & = delete;
+
+    void push(const T &value) {
+        if (size_ == capacity_) {
+            std::vector<T> grown(capacity_ * 2);
+            std::copy(data_, data_ + size_, grown.begin());
+            heap_ = std::move(grown);
+            data_ = heap_.data();
+            capacity_ = heap_.size();
+        }
+        data_[size_++] = value;
+    }
+
+    auto pop() -> T { return data_[--size_]; }
+    auto empty() const -> bool { return size_ == 0; }
+
+private:
+    std::array<T, 64> inline_{};
+    std::vector<T> heap_;
+    T *data_{inline_.data()};
+    size_t size_{0};
+    size_t capacity_{64};
+};
+
+struct RayEntry {
+    uint32_t node;
+    float distance;
+};
+
+#ifdef MU_BVH_SSE
+
+// only the xyz lanes take part, the fourth lane of a node's max is whatever follows it in memory
+constexpr int XYZ = 0b0111;
+
+auto load(const glm::vec3 &v) -> __m128 { return _mm_loadu_ps(&v.x); }
+auto set(const glm::vec3 &v, float w = 0.0f) -> __m128 { return _mm_setr_ps(v.x, v.y, v.z, w); }
+
+auto horizontal_max(__m128 v) -> float {
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1)));
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 0, 2)));
+    return _mm_cvtss_f32(v);
+}
+
+auto horizontal_min(__m128 v) -> float {
+    v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1)));
+    v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 0, 2)));
+    return _mm_cvtss_f32(v);
+}
+
+#endif
+
+struct BoxQuery {
+#ifdef MU_BVH_SSE
+    explicit BoxQuery(const maths::Aabb &box) : min{set(box.min)}, max{set(box.max)} {}
+
+    auto overlaps(const maths::Aabb &box) const -> bool {
+        auto separated = _mm_or_ps(_mm_cmplt_ps(load(box.max), min), _mm_cmplt_ps(max, load(box.min)));
+        return (_mm_movemask_ps(separated) & XYZ) == 0;
+    }
+
+    __m128 min;
+    __m128 max;
+#else
+    explicit BoxQuery(const maths::Aabb &box) : box{box} {}
+
+    auto overlaps(const maths::Aabb &other) const -> bool { return box.overlaps(other); }
+
+    maths::Aabb box;
+#endif
+};
+
+struct SphereQuery {
+#ifdef MU_BVH_SSE
+    explicit SphereQuery(const maths::Sphere &sphere)
+        : center{set(sphere.center)}, radius_squared{sphere.radius * sphere.radius} {}
+
+    auto overlaps(const maths::Aabb &box) const -> bool {
+        auto zero = _mm_setzero_ps();
+        auto below = _mm_max_ps(_mm_sub_ps(load(box.min), center), zero);
+        auto above = _mm_max_ps(_mm_sub_ps(center, load(box.max)), zero);
+        auto delta = _mm_add_ps(below, above);
+        auto squared = _mm_mul_ps(delta, delta);
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, squared);
+        return lanes[0] + lanes[1] + lanes[2] <= radius_squared;
+    }
+
+    __m128 center;
+    float radius_squared;
+#else
+    explicit SphereQuery(const maths::Sphere &sphere) : sphere{sphere} {}
+
+    auto overlaps(const maths::Aabb &box) const -> bool {
+        auto delta = glm::max(box.min - sphere.center, glm::vec3{0.0f}) + glm::max(sphere.center - box.max, glm::vec3{0.0f});
+        return glm::dot(delta, delta) <= sphere.radius * sphere.radius;
+    }
+
+    maths::Sphere sphere;
+#endif
+};
+
+enum class Containment {
+    Outside,
+    Intersecting,
+    Inside,
+};
+
+// the planes are tested together, four at a time, two padding planes that everything is inside make eight
+struct FrustumQuery {
+    explicit FrustumQuery(const maths::Frustum &frustum) {
+        for (size_t i = 0; i < 8; i++) {
+            auto plane = i < frustum.planes.size() ? frustum.planes[i] : maths::Plane{glm::vec3{0.0f}, 1.0f};
+            normal_x[i] = plane.normal.x;
+            normal_y[i] = plane.normal.y;
+            normal_z[i] = plane.normal.z;
+            distance[i] = plane.distance;
+        }
+    }
+
+    auto classify(const maths::Aabb &box) const -> Containment {
+        auto center = box.center();
+        auto extent = box.extent();
+#ifdef MU_BVH_SSE
+        auto cx = _mm_set1_ps(center.x);
+        auto cy = _mm_set1_ps(center.y);
+        auto cz = _mm_set1_ps(center.z);
+        auto ex = _mm_set1_ps(extent.x);
+        auto ey = _mm_set1_ps(extent.y);
+        auto ez = _mm_set1_ps(extent.z);
+        auto sign = _mm_set1_ps(-0.0f);
+        auto zero = _mm_setzero_ps();
+
+        int outside = 0;
+        int inside = 0;
+        for (size_t i = 0; i < 8; i += 4) {
+            auto nx = _mm_load_ps(&normal_x[i]);
+            auto ny = _mm_load_ps(&normal_y[i]);
+            auto nz = _mm_load_ps(&normal_z[i]);
+            auto d = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_add_ps(_mm_mul_ps(nz, cz), _mm_load_ps(&distance[i]))
+            );
+            auto r = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign, nx), ex), _mm_mul_ps(_mm_andnot_ps(sign, ny), ey)),
+                _mm_mul_ps(_mm_andnot_ps(sign, nz), ez)
+            );
+            outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(d, r), zero));
+            inside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(d, r), zero));
+        }
+        if (outside != 0) {
+            return Containment::Outside;
+        }
+        return inside == 0 ? Containment::Inside : Containment::Intersecting;
+#else
+        bool intersecting = false;
+        for (size_t i = 0; i < 8; i++) {
+            auto d = normal_x[i] * center.x + normal_y[i] * center.y + normal_z[i] * center.z + distance[i];
+            auto r = std::fabs(normal_x[i]) * extent.x + std::fabs(normal_y[i]) * extent.y + std::fabs(normal_z[i]) * extent.z;
+            if (d + r < 0.0f) {
+                return Containment::Outside;
+            }
+            intersecting = intersecting || d - r < 0.0f;
+        }
+        return intersecting ? Containment::Intersecting : Containment::Inside;
+#endif
+    }
+
+    alignas(16) float normal_x[8];
+    alignas(16) float normal_y[8];
+    alignas(16) float normal_z[8];
+    alignas(16) float distance[8];
+};
+
+struct RayQuery {
+    RayQuery(const maths::Ray &ray, float max_distance) {
+        auto inverse = 1.0f / ray.direction;
+#ifdef MU_BVH_SSE
+        origin = set(ray.origin);
+        inverse_direction = set(inverse);
+#else
+        origin = ray.origin;
+        inverse_direction = inverse;
+#endif
+        limit = max_distance;
+    }
+
+    // the distance at which the ray enters the box, infinity if it misses before the limit
+    auto enter(const maths::Aabb &box) const -> float {
+#ifdef MU_BVH_SSE
+        auto lower = _mm_mul_ps(_mm_sub_ps(load(box.min), origin), inverse_direction);
+        auto upper = _mm_mul_ps(_mm_sub_ps(load(box.max), origin), inverse_direction);
+
+        // the fourth lane is replaced with a copy of the first so it drops out of both reductions
+        auto entry = _mm_min_ps(lower, upper);
+        auto exit = _mm_max_ps(lower, upper);
+        auto t_min = std::max(horizontal_max(_mm_shuffle_ps(entry, entry, _MM_SHUFFLE(0, 2, 1, 0))), 0.0f);
+        auto t_max = std::min(horizontal_min(_mm_shuffle_ps(exit, exit, _MM_SHUFFLE(0, 2, 1, 0))), limit);
+#else
+        auto lower = (box.min - origin) * inverse_direction;
+        auto upper = (box.max - origin) * inverse_direction;
+        auto entry = glm::min(lower, upper);
+        auto exit = glm::max(lower, upper);
+        auto t_min = std::max(std::max(entry.x, entry.y), std::max(entry.z, 0.0f));
+        auto t_max = std::min(std::min(exit.x, exit.y), std::min(exit.z, limit));
+#endif
+        return t_min <= t_max ? t_min : std::numeric_limits<float>::infinity();
+    }
+
+#ifdef MU_BVH_SSE
+    __m128 origin;
+    __m128 inverse_direction;
+#else
+    glm::vec3 origin;
+    glm::vec3 inverse_direction;
+#endif
+    float limit;
+};
+
+} // namespace
+
+Bvh::Bvh(float margin) : margin_{margin} {}
+
+auto Bvh::create(const maths::Aabb &box, uint64_t user_data) -> ProxyId {
+    auto leaf = allocate_leaf(enlarge(box), user_data);
+    insert_leaf(leaf);
+    return leaf;
+}
+
+void Bvh::create(
+    std::span<const maths::Aabb> boxes,
+    std::span<const uint64_t> user_data,
+    std::span<ProxyId> out,
+    job::System *jobs
+) {
+    core::expect(out.size() == boxes.size(), "every box needs an output proxy");
+    core::expect(user_data.empty() || user_data.size() == boxes.size(), "user data has to match the boxes");
+
+    bool bulk = boxes.size() >= leaf_count_;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        out[i] = allocate_leaf(enlarge(boxes[i]), user_data.empty() ? 0 : user_data[i]);
+        if (!bulk) {
+            insert_leaf(out[i]);
+        }
+    }
+
+    if (bulk) {
+        rebuild(jobs);
+    }
+}
+
+void Bvh::destroy(ProxyId proxy) {
+    core::expect(contains(proxy), "proxy {} doesn't exist", proxy);
+    remove_leaf(proxy);
+    free_node(proxy);
+    leaf_count_ -= 1;
+}
+
+void Bvh::destroy(std::span<const ProxyId> proxies, job::System *jobs) {
+    if (proxies.size() * 2 < leaf_count_) {
+        for (auto proxy : proxies) {
+            destroy(proxy);
+        }
+        return;
+    }
+
+    for (auto proxy : proxies) {
+        core::expect(contains(proxy), "proxy {} doesn't exist", proxy);
+        free_node(proxy);
+        leaf_count_ -= 1;
+    }
+    rebuild(jobs);
+}
+
+auto Bvh::move(ProxyId proxy, const maths::Aabb &box) -> bool {
+    core::expect(contains(proxy), "proxy {} doesn't exist", proxy);
+    if (nodes_[proxy].box.contains(box)) {
+        return false;
+    }
+
+    remove_leaf(proxy);
+    nodes_[proxy].box = enlarge(box);
+    insert_leaf(proxy);
+    return true;
+}
+
+auto Bvh::move(std::span<const ProxyId> proxies, std::span<const maths::Aabb> boxes) -> size_t {
+    core::expect(proxies.size() == boxes.size(), "every proxy needs a box");
+
+    size_t moved = 0;
+    for (size_t i = 0; i < proxies.size(); i++) {
+        moved += move(proxies[i], boxes[i]) ? 1 : 0;
+    }
+    return moved;
+}
+
+void Bvh::set_bounds(ProxyId proxy, const maths::Aabb &box) {
+    core::expect(contains(proxy), "proxy {} doesn't exist", proxy);
+    auto &node = nodes_[proxy];
+    node.box = enlarge(box);
+    if (!node.changed) {
+        node.changed = true;
+        changed_.push_back(proxy);
+    }
+}
+
+void Bvh::refit() {
+    for (auto leaf : changed_) {
+        if (!nodes_[leaf].allocated || !nodes_[leaf].changed) {
+            continue;
+        }
+        nodes_[leaf].changed = false;
+
+        // an ancestor that doesn't change means the rest of the path was already refit for another leaf
+        for (auto index = nodes_[leaf].parent; index != NONE; index = nodes_[index].parent) {
+            auto before = nodes_[index].box;
+            fit(index);
+            rotate(index);
+            if (nodes_[index].box == before) {
+                break;
+            }
+        }
+    }
+    changed_.clear();
+}
+
+void Bvh::rebuild(job::System *jobs) {
+    std::vector<BuildItem> leaves;
+    leaves.reserve(leaf_count_);
+    for (uint32_t i = 0; i < nodes_.size(); i++) {
+        if (!nodes_[i].allocated) {
+            continue;
+        }
+        if (is_leaf(i)) {
+            nodes_[i].changed = false;
+            leaves.push_back({nodes_[i].box, i});
+        } else {
+            free_node(i);
+        }
+    }
+    changed_.clear();
+
+    root_ = NONE;
+    if (leaves.empty()) {
+        return;
+    }
+
+    reserved_.clear();
+    reserved_.reserve(leaves.size());
+    nodes_.reserve(leaves.size() * 2);
+    for (size_t i = 1; i < leaves.size(); i++) {
+        reserved_.push_back(allocate_node());
+    }
+    next_reserved_ = 0;
+
+    root_ = build(leaves, NONE, jobs);
+}
+
+auto Bvh::contains(ProxyId proxy) const -> bool {
+    return proxy < nodes_.size() && nodes_[proxy].allocated && is_leaf(proxy);
+}
+
+auto Bvh::size() const -> size_t { return leaf_count_; }
+
+auto Bvh::bounds(ProxyId proxy) const -> const maths::Aabb & {
+    core::expect(contains(proxy), "proxy {} doesn't exist", proxy);
+    return nodes_[proxy].box;
+}
+
+auto Bvh::user_data(ProxyId proxy) const -> uint64_t {
+    core::expect(contains(proxy), "proxy {} doesn't exist", proxy);
+    return nodes_[proxy].user_data;
+}
+
+auto Bvh::height() const -> uint32_t { return root_ == NONE ? 0 : nodes_[root_].height; }
+
+auto Bvh::cost() const -> float {
+    if (root_ == NONE || is_leaf(root_)) {
+        return 0.0f;
+    }
+
+    float area = 0.0f;
+    for (uint32_t i = 0; i < nodes_.size(); i++) {
+        if (nodes_[i].allocated && !is_leaf(i)) {
+            area += nodes_[i].box.surface_area();
+        }
+    }
+    return area / nodes_[root_].box.surface_area();
+}
+
+void Bvh::query(const maths::Aabb &box, std::vector<ProxyId> &out) const {
+    if (root_ == NONE) {
+        return;
+    }
+
+    BoxQuery query{box};
+    Stack<uint32_t> stack;
+    stack.push(root_);
+    while (!stack.empty()) {
+        auto index = stack.pop();
+        const auto &node = nodes_[index];
+        if (!query.overlaps(node.box)) {
+            continue;
+        }
+        if (node.height == 0) {
+            out.push_back(index);
+        } else {
+            stack.push(node.child2);
+            stack.push(node.child1);
+        }
+    }
+}
+
+void Bvh::query(const maths::Sphere &sphere, std::vector<ProxyId> &out) const {
+    if (root_ == NONE) {
+        return;
+    }
+
+    SphereQuery query{sphere};
+    Stack<uint32_t> stack;
+    stack.push(root_);
+    while (!stack.empty()) {
+        auto index = stack.pop();
+        const auto &node = nodes_[index];
+        if (!query.overlaps(node.box)) {
+            continue;
+        }
+        if (node.height == 0) {
+            out.push_back(index);
+        } else {
+            stack.push(node.child2);
+            stack.push(node.child1);
+        }
+    }
+}
+
+void Bvh::query(const maths::Frustum &frustum, std::vector<ProxyId> &out) const {
+    if (root_ == NONE) {
+        return;
+    }
+
+    FrustumQuery query{frustum};
+    Stack<uint32_t> stack;
+    stack.push(root_);
+    while (!stack.empty()) {
+        auto entry = stack.pop();
+        auto index = entry & ~INSIDE_BIT;
+        auto inside = (entry & INSIDE_BIT) != 0;
+        const auto &node = nodes_[index];
+
+        if (!inside) {
+            auto containment = query.classify(node.box);
+            if (containment == Containment::Outside) {
+                continue;
+            }
+            inside = containment == Containment::Inside;
+        }
+
+        if (node.height == 0) {
+            out.push_back(index);
+        } else {
+            auto flag = inside ? INSIDE_BIT : 0;
+            stack.push(node.child2 | flag);
+            stack.push(node.child1 | flag);
+        }
+    }
+}
+
+auto Bvh::raycast(const maths::Ray &ray, float max_distance, const RayFilter &filter) const -> std::optional<RayHit> {
+    if (root_ == NONE) {
+        return std::nullopt;
+    }
+
+    RayQuery query{ray, max_distance};
+    std::optional<RayHit> hit;
+    Stack<RayEntry> stack;
+
+    auto root_distance = query.enter(nodes_[root_].box);
+    if (root_distance == std::numeric_limits<float>::infinity()) {
+        return std::nullopt;
+    }
+    stack.push({root_, root_distance});
+
+    while (!stack.empty()) {
+        auto [index, distance] = stack.pop();
+        // something closer was hit since the node was pushed
+        if (distance > query.limit) {
+            continue;
+        }
+
+        const auto &node = nodes_[index];
+        if (node.height == 0) {
+            auto exact = filter ? filter(index, distance) : distance;
+            if (exact < std::numeric_limits<float>::infinity() && exact <= query.limit) {
+                query.limit = exact;
+                hit = RayHit{index, exact};
+            }
+            continue;
+        }
+
+        // the nearer child goes on top so it's visited first and tightens the limit for the other
+        auto distance1 = query.enter(nodes_[node.child1].box);
+        auto distance2 = query.enter(nodes_[node.child2].box);
+        auto first = RayEntry{node.child1, distance1};
+        auto second = RayEntry{node.child2, distance2};
+        if (distance2 < distance1) {
+            std::swap(first, second);
+        }
+        if (second.distance <= query.limit) {
+            stack.push(second);
+        }
+        if (first.distance <= query.limit) {
+            stack.push(first);
+        }
+    }
+    return hit;
+}
+
+auto Bvh::allocate_node() -> uint32_t {
+    uint32_t index;
+    if (free_list_ != NONE) {
+        index = free_list_;
+        free_list_ = nodes_[index].parent;
+    } else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    nodes_[index] = Node{};
+    nodes_[index].allocated = true;
+    return index;
+}
+
+void Bvh::free_node(uint32_t index) {
+    nodes_[index] = Node{};
+    nodes_[index].parent = free_list_;
+    free_list_ = index;
+}
+
+auto Bvh::allocate_leaf(const maths::Aabb &box, uint64_t user_data) -> uint32_t {
+    auto leaf = allocate_node();
+    nodes_[leaf].box = box;
+    nodes_[leaf].user_data = user_data;
+    leaf_count_ += 1;
+    return leaf;
+}
+
+auto Bvh::enlarge(const maths::Aabb &box) const -> maths::Aabb {
+    return {box.min - glm::vec3{margin_}, box.max + glm::vec3{margin_}};
+}
+
+auto Bvh::find_sibling(const maths::Aabb &box) const -> uint32_t {
+    auto index = root_;
+    while (!is_leaf(index)) {
+        const auto &node = nodes_[index];
+        auto area = node.box.surface_area();
+        auto combined = node.box.merge(box).surface_area();
+
+        // pairing with this node costs a new parent, going further down grows this node by the same amount anyway
+        auto cost = 2.0f * combined;
+        auto inherited = 2.0f * (combined - area);
+
+        auto descend = [&](uint32_t child) {
+            auto merged = nodes_[child].box.merge(box).surface_area();
+            return (is_leaf(child) ? merged : merged - nodes_[child].box.surface_area()) + inherited;
+        };
+        auto cost1 = descend(node.child1);
+        auto cost2 = descend(node.child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+    return index;
+}
+
+void Bvh::insert_leaf(uint32_t leaf) {
+    if (root_ == NONE) {
+        root_ = leaf;
+        nodes_[leaf].parent = NONE;
+        return;
+    }
+
+    auto sibling = find_sibling(nodes_[leaf].box);
+    auto old_parent = nodes_[sibling].parent;
+
+    auto parent = allocate_node();
+    nodes_[parent].parent = old_parent;
+    nodes_[parent].child1 = sibling;
+    nodes_[parent].child2 = leaf;
+    nodes_[sibling].parent = parent;
+    nodes_[leaf].parent = parent;
+
+    if (old_parent != NONE) {
+        replace_child(old_parent, sibling, parent);
+    } else {
+        root_ = parent;
+    }
+
+    refit_from(parent);
+}
+
+void Bvh::remove_leaf(uint32_t leaf) {
+    if (leaf == root_) {
+        root_ = NONE;
+        return;
+    }
+
+    auto parent = nodes_[leaf].parent;
+    auto grandparent = nodes_[parent].parent;
+    auto sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+    free_node(parent);
+    nodes_[leaf].parent = NONE;
+
+    nodes_[sibling].parent = grandparent;
+    if (grandparent == NONE) {
+        root_ = sibling;
+        return;
+    }
+
+    replace_child(grandparent, parent, sibling);
+    refit_from(grandparent);
+}
+
+void Bvh::replace_child(uint32_t parent, uint32_t from, uint32_t to) {
+    auto &node = nodes_[parent];
+    if (node.child1 == from) {
+        node.child1 = to;
+    } else {
+        node.child2 = to;
+    }
+    nodes_[to].parent = parent;
+}
+
+void Bvh::fit(uint32_t index) {
+    auto &node = nodes_[index];
+    const auto &child1 = nodes_[node.child1];
+    const auto &child2 = nodes_[node.child2];
+    node.box = child1.box.merge(child2.box);
+    node.height = 1 + std::max(child1.height, child2.height);
+}
+
+void Bvh::refit_from(uint32_t index) {
+    for (; index != NONE; index = nodes_[index].parent) {
+        fit(index);
+        rotate(index);
+    }
+}
+
+void Bvh::rotate(uint32_t index) {
+    const auto &node = nodes_[index];
+    if (node.height < 2) {
+        return;
+    }
+
+    auto b = node.child1;
+    auto c = node.child2;
+    auto area = [&](uint32_t i) { return nodes_[i].box.surface_area(); };
+    auto merged = [&](uint32_t i, uint32_t j) { return nodes_[i].box.merge(nodes_[j].box).surface_area(); };
+    auto other = [&](uint32_t parent, uint32_t child) {
+        return nodes_[parent].child1 == child ? nodes_[parent].child2 : nodes_[parent].child1;
+    };
+
+    // swapping a child of this node with a grandchild on the other side, or two grandchildren across, only changes
+    // the boxes of this node's children, the best swap is taken if it shrinks them
+    uint32_t best_u = NONE;
+    uint32_t best_v = NONE;
+    float best = 0.0f;
+    auto consider = [&](uint32_t u, uint32_t v, float delta) {
+        if (delta < best) {
+            best = delta;
+            best_u = u;
+            best_v = v;
+        }
+    };
+
+    if (!is_leaf(c)) {
+        for (auto v : {nodes_[c].child1, nodes_[c].child2}) {
+            consider(b, v, merged(b, other(c, v)) - area(c));
+        }
+    }
+    if (!is_leaf(b)) {
+        for (auto u : {nodes_[b].child1, nodes_[b].child2}) {
+            consider(u, c, merged(c, other(b, u)) - area(b));
+        }
+    }
+    if (!is_leaf(b) && !is_leaf(c)) {
+        auto d = nodes_[b].child1;
+        auto e = nodes_[b].child2;
+        for (auto v : {nodes_[c].child1, nodes_[c].child2}) {
+            consider(d, v, merged(e, v) + merged(d, other(c, v)) - area(b) - area(c));
+        }
+    }
+
+    if (best_u == NONE) {
+        return;
+    }
+
+    auto parent_u = nodes_[best_u].parent;
+    auto parent_v = nodes_[best_v].parent;
+    replace_child(parent_u, best_u, best_v);
+    replace_child(parent_v, best_v, best_u);
+
+    for (auto child : {nodes_[index].child1, nodes_[index].child2}) {
+        if (!is_leaf(child)) {
+            fit(child);
+        }
+    }
+    fit(index);
+}
+
+auto Bvh::build(std::span<BuildItem> items, uint32_t parent, job::System *jobs) -> uint32_t {
+    if (items.size() == 1) {
+        nodes_[items.front().leaf].parent = parent;
+        return items.front().leaf;
+    }
+
+    maths::Aabb centroids;
+    for (const auto &item : items) {
+        auto center = item.box.center();
+        centroids.min = glm::min(centroids.min, center);
+        centroids.max = glm::max(centroids.max, center);
+    }
+
+    auto size = centroids.max - centroids.min;
+    int axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+    auto low = centroids.min[axis];
+    auto extent = size[axis];
+
+    size_t split = items.size() / 2;
+    if (extent > 0.0f && items.size() < SAH_MIN_LEAVES) {
+        std::nth_element(items.begin(), items.begin() + split, items.end(), [&](const BuildItem &a, const BuildItem &b) {
+            return a.box.min[axis] + a.box.max[axis] < b.box.min[axis] + b.box.max[axis];
+        });
+    } else if (extent > 0.0f) {
+        // bin the centroids along the widest axis and split where the surface area heuristic is lowest
+        struct Bin {
+            maths::Aabb box;
+            size_t count{0};
+        };
+        std::array<Bin, SAH_BINS> bins{};
+        auto scale = static_cast<float>(SAH_BINS) / extent;
+        auto bin_of = [&](const BuildItem &item) {
+            auto position = ((item.box.min[axis] + item.box.max[axis]) * 0.5f - low) * scale;
+            return std::min(static_cast<size_t>(position), SAH_BINS - 1);
+        };
+        for (const auto &item : items) {
+            auto &bin = bins[bin_of(item)];
+            bin.box = bin.box.merge(item.box);
+            bin.count += 1;
+        }
+
+        std::array<float, SAH_BINS> right_cost{};
+        maths::Aabb right;
+        size_t right_count = 0;
+        for (size_t i = SAH_BINS - 1; i > 0; i--) {
+            right = right.merge(bins[i].box);
+            right_count += bins[i].count;
+            right_cost[i] = right_count > 0 ? right.surface_area() * static_cast<float>(right_count) : 0.0f;
+        }
+
+        auto best_cost = std::numeric_limits<float>::max();
+        size_t best_bin = 0;
+        maths::Aabb left;
+        size_t left_count = 0;
+        for (size_t i = 1; i < SAH_BINS; i++) {
+            left = left.merge(bins[i - 1].box);
+            left_count += bins[i - 1].count;
+            if (left_count == 0 || left_count == items.size()) {
+                continue;
+            }
+            auto cost = left.surface_area() * static_cast<float>(left_count) + right_cost[i];
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_bin = i;
+            }
+        }
+
+        if (best_bin > 0) {
+            auto middle = std::partition(items.begin(), items.end(), [&](const BuildItem &item) { return bin_of(item) < best_bin; });
+            split = static_cast<size_t>(middle - items.begin());
+        }
+    }
+
+    // every centroid in one place, any split is as good as another
+    if (split == 0 || split == items.size()) {
+        split = items.size() / 2;
+    }
+
+    auto index = reserved_[next_reserved_++];
+    auto &node = nodes_[index];
+    node.parent = parent;
+
+    auto left_items = items.first(split);
+    auto right_items = items.subspan(split);
+    if (jobs != nullptr && items.size() >= PARALLEL_BUILD_THRESHOLD) {
+        job::Counter counter;
+        jobs->submit([&] { node.child1 = build(left_items, index, jobs); }, counter);
+        node.child2 = build(right_items, index, jobs);
+        jobs->wait(counter);
+    } else {
+        node.child1 = build(left_items, index, jobs);
+        node.child2 = build(right_items, index, jobs);
+    }
+
+    fit(index);
+    return index;
+}
+
+} // namespace muon::scene
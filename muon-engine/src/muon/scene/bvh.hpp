@@ -0,0 +1,147 @@
+#pragma once
+
+#include "muon/job/system.hpp"
+#include "muon/maths/bounds.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace muon::scene {
+
+using ProxyId = uint32_t;
+
+struct RayHit {
+    ProxyId proxy;
+    float distance;
+};
+
+// a dynamic aabb tree, leaves hold boxes enlarged by a margin so that objects moving a little don't touch the tree,
+// inserts pick the sibling that adds the least surface area and every change rotates nodes on its way back up to
+// keep the tree close to what a full rebuild would give
+class Bvh : utils::NoCopy, utils::NoMove {
+public:
+    static constexpr ProxyId NONE = std::numeric_limits<uint32_t>::max();
+
+    // given the exact box of the proxy and how far along the ray its box was entered, the exact distance or infinity
+    // for a miss
+    using RayFilter = std::function<float(ProxyId proxy, float distance)>;
+
+    explicit Bvh(float margin = 0.1f);
+
+    auto create(const maths::Aabb &box, uint64_t user_data = 0) -> ProxyId;
+
+    // creating at least as many proxies as the tree already holds rebuilds it with binned sah instead of inserting
+    // them one by one, user data may be empty
+    void create(
+        std::span<const maths::Aabb> boxes,
+        std::span<const uint64_t> user_data,
+        std::span<ProxyId> out,
+        job::System *jobs = nullptr
+    );
+
+    void destroy(ProxyId proxy);
+
+    // destroying at least half of the tree rebuilds what's left instead
+    void destroy(std::span<const ProxyId> proxies, job::System *jobs = nullptr);
+
+    // reinserts the proxy once its box leaves the enlarged one, returns whether it did
+    auto move(ProxyId proxy, const maths::Aabb &box) -> bool;
+    auto move(std::span<const ProxyId> proxies, std::span<const maths::Aabb> boxes) -> size_t;
+
+    // replaces the box without restructuring the tree, which is out of date until the next refit, suits objects that
+    // deform or animate in place
+    void set_bounds(ProxyId proxy, const maths::Aabb &box);
+
+    // refits the ancestors of proxies changed by set_bounds, rotating nodes on the way up
+    void refit();
+
+    // rebuilds the whole tree top down with binned sah, wide ranges split across the job system, proxies stay valid
+    void rebuild(job::System *jobs = nullptr);
+
+    auto contains(ProxyId proxy) const -> bool;
+    auto size() const -> size_t;
+
+    // the enlarged box
+    auto bounds(ProxyId proxy) const -> const maths::Aabb &;
+    auto user_data(ProxyId proxy) const -> uint64_t;
+
+    auto height() const -> uint32_t;
+
+    // the surface area of every internal node relative to the root's, lower means faster queries
+    auto cost() const -> float;
+
+    // append every proxy whose enlarged box overlaps the shape
+    void query(const maths::Aabb &box, std::vector<ProxyId> &out) const;
+    void query(const maths::Sphere &sphere, std::vector<ProxyId> &out) const;
+    void query(const maths::Frustum &frustum, std::vector<ProxyId> &out) const;
+
+    // the closest hit within max_distance, the filter narrows box hits down to the proxy's actual shape
+    auto raycast(
+        const maths::Ray &ray,
+        float max_distance = std::numeric_limits<float>::infinity(),
+        const RayFilter &filter = {}
+    ) const -> std::optional<RayHit>;
+
+private:
+    struct Node {
+        maths::Aabb box;
+        // doubles as the next free node while unallocated
+        uint32_t parent{NONE};
+        uint32_t child1{NONE};
+        uint32_t child2{NONE};
+        // zero for leaves
+        uint32_t height{0};
+        uint64_t user_data{0};
+        bool allocated{false};
+        bool changed{false};
+    };
+
+    auto is_leaf(uint32_t index) const -> bool { return nodes_[index].height == 0; }
+
+    auto allocate_node() -> uint32_t;
+    void free_node(uint32_t index);
+    auto allocate_leaf(const maths::Aabb &box, uint64_t user_data) -> uint32_t;
+    auto enlarge(const maths::Aabb &box) const -> maths::Aabb;
+
+    auto find_sibling(const maths::Aabb &box) const -> uint32_t;
+    void insert_leaf(uint32_t leaf);
+    void remove_leaf(uint32_t leaf);
+    void replace_child(uint32_t parent, uint32_t from, uint32_t to);
+
+    // recomputes a node from its children
+    void fit(uint32_t index);
+    void refit_from(uint32_t index);
+    void rotate(uint32_t index);
+
+    // leaves are partitioned as copies so the build streams through memory instead of chasing node indices
+    struct BuildItem {
+        maths::Aabb box;
+        uint32_t leaf;
+    };
+
+    auto build(std::span<BuildItem> items, uint32_t parent, job::System *jobs) -> uint32_t;
+
+private:
+    float margin_;
+
+    std::vector<Node> nodes_;
+    uint32_t root_{NONE};
+    uint32_t free_list_{NONE};
+    size_t leaf_count_{0};
+
+    std::vector<uint32_t> changed_;
+
+    // internal nodes handed out by a rebuild, reserved up front so parallel builds never grow the node array
+    std::vector<uint32_t> reserved_;
+    std::atomic<size_t> next_reserved_{0};
+};
+
+} // namespace muon::scene
@@ -0,0 +1,344 @@
+#include "muon/scene/transform.hpp"
+
+#include "muon/core/expect.hpp"
+
+#include <algorithm>
+
+namespace muon::scene {
+
+namespace {
+
+constexpr size_t PARALLEL_GRAIN = 4096;
+
+// same as translate * mat4_cast * scale without the full matrix products
+auto compose(const glm::vec3 &t, const glm::quat &r, const glm::vec3 &s) -> glm::mat4 {
+    float xx = r.x * r.x;
+    float yy = r.y * r.y;
+    float zz = r.z * r.z;
+    float xy = r.x * r.y;
+    float xz = r.x * r.z;
+    float yz = r.y * r.z;
+    float wx = r.w * r.x;
+    float wy = r.w * r.y;
+    float wz = r.w * r.z;
+
+    glm::mat4 matrix{1.0f};
+    matrix[0] = glm::vec4{(1.0f - 2.0f * (yy + zz)) * s.x, 2.0f * (xy + wz) * s.x, 2.0f * (xz - wy) * s.x, 0.0f};
+    matrix[1] = glm::vec4{2.0f * (xy - wz) * s.y, (1.0f - 2.0f * (xx + zz)) * s.y, 2.0f * (yz + wx) * s.y, 0.0f};
+    matrix[2] = glm::vec4{2.0f * (xz + wy) * s.z, 2.0f * (yz - wx) * s.z, (1.0f - 2.0f * (xx + yy)) * s.z, 0.0f};
+    matrix[3] = glm::vec4{t, 1.0f};
+    return matrix;
+}
+
+// parent * local for affine matrices, the bottom row is known so a quarter of the products are skipped
+auto multiply_affine(const glm::mat4 &parent, const glm::mat4 &local) -> glm::mat4 {
+    glm::mat4 matrix{1.0f};
+    for (int column = 0; column < 3; column++) {
+        matrix[column] = parent[0] * local[column].x + parent[1] * local[column].y + parent[2] * local[column].z;
+    }
+    matrix[3] = parent[0] * local[3].x + parent[1] * local[3].y + parent[2] * local[3].z + parent[3];
+    return matrix;
+}
+
+} // namespace
+
+auto TransformHierarchy::create(const Transform &local) -> Node { return insert(NONE, local); }
+
+auto TransformHierarchy::create(Node parent, const Transform &local) -> Node {
+    slot(parent);
+    return insert(parent.index, local);
+}
+
+void TransformHierarchy::destroy(Node node) {
+    slot(node);
+    unlink(node.index);
+
+    std::vector<uint32_t> pending{node.index};
+    while (!pending.empty()) {
+        auto index = pending.back();
+        pending.pop_back();
+
+        auto &entry = slots_[index];
+        for (auto child = entry.first_child; child != NONE; child = slots_[child].next_sibling) {
+            pending.push_back(child);
+        }
+        entry = Slot{.generation = entry.generation + 1};
+        free_slots_.push_back(index);
+        size_--;
+    }
+
+    // the positions left behind are unreachable from the roots and dropped by the rebuild
+    reorder_ = true;
+}
+
+auto TransformHierarchy::contains(Node node) const -> bool {
+    return node.index < slots_.size() && slots_[node.index].generation == node.generation &&
+           slots_[node.index].position != NONE;
+}
+
+auto TransformHierarchy::size() const -> size_t { return size_; }
+
+auto TransformHierarchy::parent(Node node) const -> std::optional<Node> {
+    auto index = slot(node).parent;
+    if (index == NONE) {
+        return std::nullopt;
+    }
+    return Node{index, slots_[index].generation};
+}
+
+void TransformHierarchy::set_parent(Node node, std::optional<Node> parent) {
+    slot(node);
+
+    uint32_t target = NONE;
+    if (parent) {
+        slot(*parent);
+        for (auto ancestor = parent->index; ancestor != NONE; ancestor = slots_[ancestor].parent) {
+            core::expect(ancestor != node.index, "a transform can't be parented below itself");
+        }
+        target = parent->index;
+    }
+
+    if (slots_[node.index].parent == target) {
+        return;
+    }
+
+    unlink(node.index);
+    link(node.index, target);
+    marked_.push_back(slots_[node.index].position);
+    reorder_ = true;
+}
+
+auto TransformHierarchy::local(Node node) const -> Transform {
+    auto position = slot(node).position;
+    return {translations_[position], rotations_[position], scales_[position]};
+}
+
+void TransformHierarchy::set_local(Node node, const Transform &local) {
+    auto position = slot(node).position;
+    translations_[position] = local.translation;
+    rotations_[position] = local.rotation;
+    scales_[position] = local.scale;
+    mark(position);
+}
+
+void TransformHierarchy::set_translation(Node node, const glm::vec3 &translation) {
+    auto position = slot(node).position;
+    translations_[position] = translation;
+    mark(position);
+}
+
+void TransformHierarchy::set_rotation(Node node, const glm::quat &rotation) {
+    auto position = slot(node).position;
+    rotations_[position] = rotation;
+    mark(position);
+}
+
+void TransformHierarchy::set_scale(Node node, const glm::vec3 &scale) {
+    auto position = slot(node).position;
+    scales_[position] = scale;
+    mark(position);
+}
+
+auto TransformHierarchy::world(Node node) const -> const glm::mat4 & { return worlds_[slot(node).position]; }
+
+auto TransformHierarchy::update(job::System *jobs) -> size_t {
+    if (reorder_) {
+        rebuild();
+    }
+    if (marked_.empty()) {
+        return 0;
+    }
+
+    std::sort(marked_.begin(), marked_.end());
+    ranges_.clear();
+
+    // each depth updates the children of whatever changed one depth up merged with what was marked at this depth,
+    // both already sorted, overlapping and touching runs are joined
+    size_t updated = 0;
+    size_t marked = 0;
+    for (size_t depth = 0; depth + 1 < depths_.size(); depth++) {
+        next_ranges_.clear();
+        auto add = [this](uint32_t begin, uint32_t end) {
+            if (begin == end) {
+                return;
+            }
+            if (!next_ranges_.empty() && begin <= next_ranges_.back().end) {
+                next_ranges_.back().end = std::max(next_ranges_.back().end, end);
+            } else {
+                next_ranges_.push_back({begin, end});
+            }
+        };
+
+        size_t range = 0;
+        while (range < ranges_.size() || (marked < marked_.size() && marked_[marked] < depths_[depth + 1])) {
+            bool take_marked = marked < marked_.size() && marked_[marked] < depths_[depth + 1] &&
+                               (range == ranges_.size() || marked_[marked] < children_[ranges_[range].begin]);
+            if (take_marked) {
+                add(marked_[marked], marked_[marked] + 1);
+                marked++;
+            } else {
+                add(children_[ranges_[range].begin], children_[ranges_[range].end]);
+                range++;
+            }
+        }
+
+        for (auto next : next_ranges_) {
+            update_range(next, jobs);
+            updated += next.end - next.begin;
+        }
+
+        std::swap(ranges_, next_ranges_);
+        if (ranges_.empty() && marked == marked_.size()) {
+            break;
+        }
+    }
+
+    marked_.clear();
+    return updated;
+}
+
+auto TransformHierarchy::slot(Node node) const -> const Slot & {
+    core::expect(contains(node), "stale transform node");
+    return slots_[node.index];
+}
+
+auto TransformHierarchy::insert(uint32_t parent, const Transform &local) -> Node {
+    uint32_t index;
+    if (!free_slots_.empty()) {
+        index = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    slots_[index].position = static_cast<uint32_t>(translations_.size());
+    translations_.push_back(local.translation);
+    rotations_.push_back(local.rotation);
+    scales_.push_back(local.scale);
+    worlds_.emplace_back(1.0f);
+    parents_.push_back(NONE);
+    marked_.push_back(slots_[index].position);
+
+    link(index, parent);
+    reorder_ = true;
+    size_++;
+    return {index, slots_[index].generation};
+}
+
+void TransformHierarchy::link(uint32_t index, uint32_t parent) {
+    auto &head = parent == NONE ? first_root_ : slots_[parent].first_child;
+    auto &entry = slots_[index];
+    entry.parent = parent;
+    entry.previous_sibling = NONE;
+    entry.next_sibling = head;
+    if (head != NONE) {
+        slots_[head].previous_sibling = index;
+    }
+    head = index;
+}
+
+void TransformHierarchy::unlink(uint32_t index) {
+    auto &entry = slots_[index];
+    if (entry.previous_sibling != NONE) {
+        slots_[entry.previous_sibling].next_sibling = entry.next_sibling;
+    } else if (entry.parent != NONE) {
+        slots_[entry.parent].first_child = entry.next_sibling;
+    } else {
+        first_root_ = entry.next_sibling;
+    }
+    if (entry.next_sibling != NONE) {
+        slots_[entry.next_sibling].previous_sibling = entry.previous_sibling;
+    }
+    entry.parent = NONE;
+    entry.previous_sibling = NONE;
+    entry.next_sibling = NONE;
+}
+
+void TransformHierarchy::mark(uint32_t position) { marked_.push_back(position); }
+
+void TransformHierarchy::rebuild() {
+    // breadth first from the roots, each depth starts once the one before it has been walked
+    std::vector<uint32_t> order;
+    order.reserve(size_);
+    for (auto root = first_root_; root != NONE; root = slots_[root].next_sibling) {
+        order.push_back(root);
+    }
+
+    std::vector<uint32_t> children;
+    children.reserve(size_ + 1);
+    depths_.assign(1, 0);
+    size_t depth_end = order.size();
+    for (size_t i = 0; i < order.size(); i++) {
+        if (i == depth_end) {
+            depths_.push_back(static_cast<uint32_t>(i));
+            depth_end = order.size();
+        }
+        children.push_back(static_cast<uint32_t>(order.size()));
+        for (auto child = slots_[order[i]].first_child; child != NONE; child = slots_[child].next_sibling) {
+            order.push_back(child);
+        }
+    }
+    children.push_back(static_cast<uint32_t>(order.size()));
+    if (!order.empty()) {
+        depths_.push_back(static_cast<uint32_t>(order.size()));
+    }
+
+    std::vector<glm::vec3> translations(order.size());
+    std::vector<glm::quat> rotations(order.size());
+    std::vector<glm::vec3> scales(order.size());
+    std::vector<glm::mat4> worlds(order.size());
+    std::vector<uint32_t> parents(order.size());
+    std::vector<uint32_t> moved(translations_.size(), NONE);
+
+    for (size_t i = 0; i < order.size(); i++) {
+        // parents come first, so their slots already hold the new position
+        auto &entry = slots_[order[i]];
+        auto old = entry.position;
+        translations[i] = translations_[old];
+        rotations[i] = rotations_[old];
+        scales[i] = scales_[old];
+        worlds[i] = worlds_[old];
+        parents[i] = entry.parent == NONE ? NONE : slots_[entry.parent].position;
+        moved[old] = static_cast<uint32_t>(i);
+        entry.position = static_cast<uint32_t>(i);
+    }
+
+    // marks on destroyed nodes are dropped
+    size_t kept = 0;
+    for (auto position : marked_) {
+        if (moved[position] != NONE) {
+            marked_[kept++] = moved[position];
+        }
+    }
+    marked_.resize(kept);
+
+    translations_ = std::move(translations);
+    rotations_ = std::move(rotations);
+    scales_ = std::move(scales);
+    worlds_ = std::move(worlds);
+    parents_ = std::move(parents);
+    children_ = std::move(children);
+    reorder_ = false;
+}
+
+void TransformHierarchy::update_range(Range range, job::System *jobs) {
+    auto update = [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            auto local = compose(translations_[i], rotations_[i], scales_[i]);
+            auto parent = parents_[i];
+            worlds_[i] = parent == NONE ? local : multiply_affine(worlds_[parent], local);
+        }
+    };
+
+    size_t count = range.end - range.begin;
+    if (jobs != nullptr && count > PARALLEL_GRAIN) {
+        jobs->parallel_for(count, PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+            update(range.begin + begin, range.begin + end);
+        });
+    } else {
+        update(range.begin, range.end);
+    }
+}
+
+} // namespace muon::scene
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "glm/gtc/quaternion.hpp"
+#include "glm/mat4x4.hpp"
+#include "glm/vec3.hpp"
+#include "muon/job/system.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace muon::scene {
+
+struct Transform {
+    glm::vec3 translation{0.0f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 scale{1.0f};
+};
+
+// the generation changes whenever a slot is reused, so handles to destroyed nodes stay invalid
+struct Node {
+    uint32_t index{0};
+    uint32_t generation{0};
+
+    auto operator==(const Node &) const -> bool = default;
+};
+
+// nodes are stored breadth first, so every depth is one contiguous run, parents come before their children and the
+// children of any run of nodes are themselves one run, updates follow those runs down from the changed nodes and
+// never touch anything else
+class TransformHierarchy : utils::NoCopy, utils::NoMove {
+public:
+    TransformHierarchy() = default;
+
+    auto create(const Transform &local = {}) -> Node;
+    auto create(Node parent, const Transform &local = {}) -> Node;
+
+    // destroys everything below the node as well
+    void destroy(Node node);
+
+    auto contains(Node node) const -> bool;
+    auto size() const -> size_t;
+
+    auto parent(Node node) const -> std::optional<Node>;
+
+    // keeps the local transform, a node can't be moved below one of its own descendants
+    void set_parent(Node node, std::optional<Node> parent);
+
+    auto local(Node node) const -> Transform;
+    void set_local(Node node, const Transform &local);
+    void set_translation(Node node, const glm::vec3 &translation);
+    void set_rotation(Node node, const glm::quat &rotation);
+    void set_scale(Node node, const glm::vec3 &scale);
+
+    // as of the last update
+    auto world(Node node) const -> const glm::mat4 &;
+
+    // recomputes the world matrices of changed nodes and their descendants, wide depths are split across the job
+    // system, returns how many matrices were recomputed
+    auto update(job::System *jobs = nullptr) -> size_t;
+
+private:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    // links between slots, which unlike positions don't move when the order is rebuilt
+    struct Slot {
+        uint32_t generation{0};
+        uint32_t position{NONE};
+        uint32_t parent{NONE};
+        uint32_t first_child{NONE};
+        uint32_t next_sibling{NONE};
+        uint32_t previous_sibling{NONE};
+    };
+
+    auto slot(Node node) const -> const Slot &;
+    auto insert(uint32_t parent, const Transform &local) -> Node;
+    void link(uint32_t index, uint32_t parent);
+    void unlink(uint32_t index);
+    void mark(uint32_t position);
+
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    void rebuild();
+    void update_range(Range range, job::System *jobs);
+
+private:
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_slots_;
+    uint32_t first_root_{NONE};
+    size_t size_{0};
+
+    // indexed by position, nodes created since the last rebuild are appended at the end
+    std::vector<glm::vec3> translations_;
+    std::vector<glm::quat> rotations_;
+    std::vector<glm::vec3> scales_;
+    std::vector<glm::mat4> worlds_;
+    std::vector<uint32_t> parents_;
+
+    // the children of position i are [children_[i], children_[i + 1]), with the end as the last entry
+    std::vector<uint32_t> children_;
+
+    // the first position of every depth followed by the end
+    std::vector<uint32_t> depths_;
+
+    // positions changed since the last update, possibly more than once
+    std::vector<uint32_t> marked_;
+    std::vector<Range> ranges_;
+    std::vector<Range> next_ranges_;
+    bool reorder_{false};
+};
+
+} // namespace muon::scene
@@ -1,16 +1,414 @@
 #pragma once
 
 #include "muon/core/buffer.hpp"
+#include "muon/core/uuid.hpp"
+#include "muon/crypto/hash.hpp"
+#include "muon/serde/reflect.hpp"
 #include "muon/serde/serde.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace muon::serde {
 
 template <typename From>
 concept BinarySerializable = Serializable<From, Buffer>;
 
-enum class BinaryDeserializeError {};
+enum class BinaryDeserializeError {
+    UnexpectedEnd,
+    InvalidVarint,
+    InvalidValue,
+    TrailingData,
+};
 
 template <typename To>
 concept Binarydeserializable = Deserializable<BufferView, To, BinaryDeserializeError>;
 
+namespace internal {
+
+static_assert(std::endian::native == std::endian::little, "the binary format is written in host order");
+
+constexpr size_t MAX_VARINT_SIZE = 10;
+
+template <typename T>
+concept ByteSized = std::integral<T> && !std::same_as<T, bool> && sizeof(T) == 1;
+
+template <typename T>
+concept VarintEncoded = std::integral<T> && !std::same_as<T, bool> && sizeof(T) > 1;
+
+template <typename T>
+consteval auto is_blittable() -> bool;
+
+template <typename... Fields>
+consteval auto fields_blittable(TypeList<Fields...>) -> bool {
+    return (is_blittable<Fields>() && ...);
+}
+
+template <typename... Fields>
+consteval auto packed_size(TypeList<Fields...>) -> size_t {
+    return (sizeof(Fields) + ... + 0);
+}
+
+// types whose bytes are the encoding, these are copied in bulk
+template <typename T>
+consteval auto is_blittable() -> bool {
+    if constexpr (std::same_as<T, float> || std::same_as<T, double> || ByteSized<T> || std::same_as<T, Uuid>) {
+        return true;
+    } else if constexpr (std::is_enum_v<T>) {
+        return ByteSized<std::underlying_type_t<T>>;
+    } else if constexpr (IsArray<T>::value) {
+        return is_blittable<typename T::value_type>();
+    } else if constexpr (Reflected<T>) {
+        return fields_blittable(FieldTypes<T>{}) && sizeof(T) == packed_size(FieldTypes<T>{});
+    } else {
+        return false;
+    }
+}
+
+template <typename T>
+consteval auto is_supported() -> bool;
+
+template <typename... Fields>
+consteval auto fields_supported(TypeList<Fields...>) -> bool {
+    return (is_supported<Fields>() && ...);
+}
+
+template <typename T>
+consteval auto is_supported() -> bool {
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+        return !std::same_as<T, long double>;
+    } else if constexpr (std::same_as<T, Uuid> || std::same_as<T, crypto::Hash>) {
+        return true;
+    } else if constexpr (std::same_as<T, std::string> || std::same_as<T, std::string_view>) {
+        return true;
+    } else if constexpr (IsVector<T>::value) {
+        return !std::same_as<typename T::value_type, bool> && is_supported<typename T::value_type>();
+    } else if constexpr (IsArray<T>::value || IsOptional<T>::value) {
+        return is_supported<typename T::value_type>();
+    } else if constexpr (Reflected<T>) {
+        return fields_supported(FieldTypes<T>{});
+    } else {
+        return false;
+    }
+}
+
+// signed integers are zigzag encoded so that small negative values stay short
+template <std::integral T>
+constexpr auto to_varint(T value) -> uint64_t {
+    if constexpr (std::is_signed_v<T>) {
+        auto extended = static_cast<int64_t>(value);
+        return (static_cast<uint64_t>(extended) << 1) ^ static_cast<uint64_t>(extended >> 63);
+    } else {
+        return static_cast<uint64_t>(value);
+    }
+}
+
+template <std::integral T>
+constexpr auto from_varint(uint64_t value) -> T {
+    if constexpr (std::is_signed_v<T>) {
+        return static_cast<T>(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+    } else {
+        return static_cast<T>(value);
+    }
 }
+
+template <std::integral T>
+constexpr auto fits_varint(uint64_t value) -> bool {
+    return std::is_signed_v<T> ? value >> 1 <= static_cast<uint64_t>(std::numeric_limits<T>::max())
+                               : value <= static_cast<uint64_t>(std::numeric_limits<T>::max());
+}
+
+constexpr auto varint_size(uint64_t value) -> size_t {
+    return static_cast<size_t>(std::max(1, (70 - std::countl_zero(value)) / 7));
+}
+
+// the writer is handed a buffer of exactly the encoded size, so it never checks bounds
+struct Writer {
+    uint8_t *cursor;
+
+    void bytes(const void *data, size_t size) {
+        if (size > 0) {
+            std::memcpy(cursor, data, size);
+            cursor += size;
+        }
+    }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            *cursor++ = static_cast<uint8_t>(value) | 0x80;
+            value >>= 7;
+        }
+        *cursor++ = static_cast<uint8_t>(value);
+    }
+};
+
+struct Reader {
+    const uint8_t *cursor;
+    const uint8_t *end;
+
+    auto remaining() const -> size_t { return static_cast<size_t>(end - cursor); }
+
+    auto bytes(void *data, size_t size) -> std::expected<void, BinaryDeserializeError> {
+        if (size > remaining()) {
+            return std::unexpected(BinaryDeserializeError::UnexpectedEnd);
+        }
+        if (size > 0) {
+            std::memcpy(data, cursor, size);
+            cursor += size;
+        }
+        return {};
+    }
+
+    auto varint() -> std::expected<uint64_t, BinaryDeserializeError> {
+        uint64_t value = 0;
+        for (size_t i = 0; i < MAX_VARINT_SIZE; i++) {
+            if (cursor == end) {
+                return std::unexpected(BinaryDeserializeError::UnexpectedEnd);
+            }
+            uint8_t byte = *cursor++;
+            if (i == MAX_VARINT_SIZE - 1 && byte > 1) {
+                return std::unexpected(BinaryDeserializeError::InvalidVarint);
+            }
+            value |= static_cast<uint64_t>(byte & 0x7f) << (i * 7);
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        return std::unexpected(BinaryDeserializeError::InvalidVarint);
+    }
+
+    auto length() -> std::expected<size_t, BinaryDeserializeError> {
+        auto value = varint();
+        if (!value) {
+            return std::unexpected(value.error());
+        }
+        if (*value > remaining()) {
+            return std::unexpected(BinaryDeserializeError::UnexpectedEnd);
+        }
+        return static_cast<size_t>(*value);
+    }
+};
+
+template <typename T>
+auto encoded_size(const T &value) -> size_t {
+    if constexpr (is_blittable<T>()) {
+        return sizeof(T);
+    } else if constexpr (std::same_as<T, bool>) {
+        return 1;
+    } else if constexpr (std::integral<T>) {
+        return varint_size(to_varint(value));
+    } else if constexpr (std::is_enum_v<T>) {
+        return encoded_size(std::to_underlying(value));
+    } else if constexpr (std::same_as<T, crypto::Hash>) {
+        return value.size();
+    } else if constexpr (std::same_as<T, std::string> || std::same_as<T, std::string_view>) {
+        return varint_size(value.size()) + value.size();
+    } else if constexpr (IsVector<T>::value) {
+        size_t size = varint_size(value.size());
+        if constexpr (is_blittable<typename T::value_type>()) {
+            return size + value.size() * sizeof(typename T::value_type);
+        } else {
+            for (const auto &element : value) {
+                size += encoded_size(element);
+            }
+            return size;
+        }
+    } else if constexpr (IsArray<T>::value) {
+        size_t size = 0;
+        for (const auto &element : value) {
+            size += encoded_size(element);
+        }
+        return size;
+    } else if constexpr (IsOptional<T>::value) {
+        return 1 + (value ? encoded_size(*value) : 0);
+    } else {
+        return visit_fields(value, [](const auto &...fields) { return (size_t{0} + ... + encoded_size(fields)); });
+    }
+}
+
+template <typename T>
+void write(Writer &writer, const T &value) {
+    if constexpr (is_blittable<T>()) {
+        writer.bytes(&value, sizeof(T));
+    } else if constexpr (std::same_as<T, bool>) {
+        writer.varint(value ? 1 : 0);
+    } else if constexpr (std::integral<T>) {
+        writer.varint(to_varint(value));
+    } else if constexpr (std::is_enum_v<T>) {
+        write(writer, std::to_underlying(value));
+    } else if constexpr (std::same_as<T, crypto::Hash>) {
+        writer.bytes(value.data(), value.size());
+    } else if constexpr (std::same_as<T, std::string> || std::same_as<T, std::string_view>) {
+        writer.varint(value.size());
+        writer.bytes(value.data(), value.size());
+    } else if constexpr (IsVector<T>::value) {
+        writer.varint(value.size());
+        if constexpr (is_blittable<typename T::value_type>()) {
+            writer.bytes(value.data(), value.size() * sizeof(typename T::value_type));
+        } else {
+            for (const auto &element : value) {
+                write(writer, element);
+            }
+        }
+    } else if constexpr (IsArray<T>::value) {
+        for (const auto &element : value) {
+            write(writer, element);
+        }
+    } else if constexpr (IsOptional<T>::value) {
+        writer.varint(value ? 1 : 0);
+        if (value) {
+            write(writer, *value);
+        }
+    } else {
+        visit_fields(value, [&writer](const auto &...fields) { (write(writer, fields), ...); });
+    }
+}
+
+template <typename T>
+auto read(Reader &reader, T &value) -> std::expected<void, BinaryDeserializeError> {
+    if constexpr (is_blittable<T>()) {
+        return reader.bytes(&value, sizeof(T));
+    } else if constexpr (std::same_as<T, bool> || IsOptional<T>::value) {
+        if (reader.cursor == reader.end) {
+            return std::unexpected(BinaryDeserializeError::UnexpectedEnd);
+        }
+        auto flag = *reader.cursor++;
+        if (flag > 1) {
+            return std::unexpected(BinaryDeserializeError::InvalidValue);
+        }
+        if constexpr (std::same_as<T, bool>) {
+            value = flag == 1;
+            return {};
+        } else {
+            if (flag == 0) {
+                value.reset();
+                return {};
+            }
+            return read(reader, value.emplace());
+        }
+    } else if constexpr (std::integral<T>) {
+        auto varint = reader.varint();
+        if (!varint) {
+            return std::unexpected(varint.error());
+        }
+        if (!fits_varint<T>(*varint)) {
+            return std::unexpected(BinaryDeserializeError::InvalidVarint);
+        }
+        value = from_varint<T>(*varint);
+        return {};
+    } else if constexpr (std::is_enum_v<T>) {
+        std::underlying_type_t<T> underlying{};
+        auto result = read(reader, underlying);
+        value = static_cast<T>(underlying);
+        return result;
+    } else if constexpr (std::same_as<T, crypto::Hash>) {
+        return reader.bytes(value.data(), value.size());
+    } else if constexpr (std::same_as<T, std::string> || std::same_as<T, std::string_view>) {
+        auto length = reader.length();
+        if (!length) {
+            return std::unexpected(length.error());
+        }
+        // views borrow from the buffer being read
+        value = std::string_view{reinterpret_cast<const char *>(reader.cursor), *length};
+        reader.cursor += *length;
+        return {};
+    } else if constexpr (IsVector<T>::value) {
+        using Element = typename T::value_type;
+        auto count = reader.varint();
+        if (!count) {
+            return std::unexpected(count.error());
+        }
+        if constexpr (is_blittable<Element>()) {
+            if (*count > reader.remaining() / sizeof(Element)) {
+                return std::unexpected(BinaryDeserializeError::UnexpectedEnd);
+            }
+            value.resize(*count);
+            return reader.bytes(value.data(), *count * sizeof(Element));
+        } else {
+            // a corrupt count must not turn into a huge allocation
+            value.clear();
+            value.reserve(std::min<uint64_t>(*count, reader.remaining()));
+            for (uint64_t i = 0; i < *count; i++) {
+                if (auto result = read(reader, value.emplace_back()); !result) {
+                    return result;
+                }
+            }
+            return {};
+        }
+    } else if constexpr (IsArray<T>::value) {
+        for (auto &element : value) {
+            if (auto result = read(reader, element); !result) {
+                return result;
+            }
+        }
+        return {};
+    } else {
+        return visit_fields(value, [&reader](auto &...fields) {
+            std::expected<void, BinaryDeserializeError> result{};
+            ((result = read(reader, fields)).has_value() && ...);
+            return result;
+        });
+    }
+}
+
+} // namespace internal
+
+// aggregates are reflected field by field, along with integers, floats, enums, strings, uuids, hashes and arrays,
+// vectors and optionals of these
+template <typename T>
+concept BinaryReflectable = internal::is_supported<T>();
+
+template <BinaryReflectable T>
+auto binary_size(const T &value) -> size_t {
+    return internal::encoded_size(value);
+}
+
+template <BinaryReflectable T>
+auto to_binary(const T &value) -> Buffer {
+    Buffer buffer{internal::encoded_size(value)};
+    internal::Writer writer{buffer.data()};
+    internal::write(writer, value);
+    return buffer;
+}
+
+// string views in the result point into `view`, which must outlive them
+template <BinaryReflectable T>
+    requires std::default_initializable<T>
+auto from_binary(BufferView view) -> std::expected<T, BinaryDeserializeError> {
+    internal::Reader reader{view.data(), view.data() + view.size()};
+    T value{};
+    if (auto result = internal::read(reader, value); !result) {
+        return std::unexpected(result.error());
+    }
+    if (reader.cursor != reader.end) {
+        return std::unexpected(BinaryDeserializeError::TrailingData);
+    }
+    return value;
+}
+
+template <typename From, typename To>
+    requires std::same_as<To, Buffer> && BinaryReflectable<From>
+auto serialize(const From &from) -> To {
+    return to_binary(from);
+}
+
+template <typename From, typename To, typename Error>
+    requires std::same_as<From, BufferView> && std::same_as<Error, BinaryDeserializeError> && BinaryReflectable<To>
+auto deserialize(const From &from) -> std::expected<To, Error> {
+    return from_binary<To>(from);
+}
+
+} // namespace muon::serde
@@ -0,0 +1,103 @@
+#include "muon/serde/blob.hpp"
+
+#include "muon/core/expect.hpp"
+#include "muon/utils/platform.hpp"
+
+#include <new>
+#include <utility>
+
+namespace muon::serde {
+
+BlobBuilder::BlobBuilder(uint32_t schema) : schema_{schema}, bytes_(sizeof(BlobHeader)) {}
+
+auto BlobBuilder::add_string(std::string_view text) -> BlobSpan<char> {
+    // the terminator is already zeroed by the resize
+    auto position = allocate(text.size() + 1, 1);
+    std::memcpy(bytes_.data() + position, text.data(), text.size());
+    return {position, static_cast<uint32_t>(text.size())};
+}
+
+auto BlobBuilder::allocate(size_t size, size_t alignment) -> uint32_t {
+    auto position = maths::align(bytes_.size(), alignment);
+    core::expect(position + size <= std::numeric_limits<int32_t>::max(), "blobs are limited to 2 GiB of relative offsets");
+    bytes_.resize(position + size);
+    return static_cast<uint32_t>(position);
+}
+
+auto BlobBuilder::relative(const void *field, uint32_t target) const -> int32_t {
+    auto position = static_cast<const std::byte *>(field) - bytes_.data();
+    return static_cast<int32_t>(static_cast<int64_t>(target) - position);
+}
+
+auto BlobBuilder::finish(uint32_t root) -> Buffer {
+    BlobHeader header{
+        .magic = BLOB_MAGIC,
+        .version = BLOB_VERSION,
+        .reserved = 0,
+        .schema = schema_,
+        .root = root,
+        .size = bytes_.size(),
+    };
+    std::memcpy(bytes_.data(), &header, sizeof(header));
+
+    // the plain constructor only promises malloc's alignment, which is less than a blob needs on some platforms
+    Buffer buffer{bytes_.size(), std::align_val_t{BLOB_ALIGNMENT}};
+    core::expect(buffer.data() != nullptr, "failed to allocate a blob of {} bytes", bytes_.size());
+    std::memcpy(buffer.data(), bytes_.data(), bytes_.size());
+    return buffer;
+}
+
+namespace internal {
+
+auto validate_header(BufferView view, uint32_t schema) -> std::expected<const BlobHeader *, BlobError> {
+    if (view.size() < sizeof(BlobHeader)) {
+        return std::unexpected(BlobError::InvalidHeader);
+    }
+    if (!maths::is_aligned<BLOB_ALIGNMENT>(reinterpret_cast<uintptr_t>(view.data()))) {
+        return std::unexpected(BlobError::Misaligned);
+    }
+
+    const auto *header = view.as<BlobHeader>();
+    if (header->magic != BLOB_MAGIC || header->version != BLOB_VERSION || header->size < sizeof(BlobHeader) ||
+        header->size > view.size()) {
+        return std::unexpected(BlobError::InvalidHeader);
+    }
+    if (header->schema != schema) {
+        return std::unexpected(BlobError::SchemaMismatch);
+    }
+    return header;
+}
+
+} // namespace internal
+
+auto MappedBlob::open(const std::filesystem::path &path) -> std::expected<MappedBlob, BlobError> {
+    auto mapping = utils::map_file_read(path);
+    if (!mapping) {
+        return std::unexpected(BlobError::FileOpenFailure);
+    }
+    return MappedBlob{*mapping};
+}
+
+MappedBlob::MappedBlob(MappedBlob &&other) noexcept : mapping_{std::exchange(other.mapping_, {})} {}
+
+auto MappedBlob::operator=(MappedBlob &&other) noexcept -> MappedBlob & {
+    if (this != &other) {
+        if (!mapping_.empty()) {
+            utils::unmap_file(mapping_);
+        }
+        mapping_ = std::exchange(other.mapping_, {});
+    }
+    return *this;
+}
+
+MappedBlob::~MappedBlob() {
+    if (!mapping_.empty()) {
+        utils::unmap_file(mapping_);
+    }
+}
+
+auto MappedBlob::view() const -> BufferView {
+    return BufferView{reinterpret_cast<BufferView::ConstPointer>(mapping_.data()), mapping_.size()};
+}
+
+} // namespace muon::serde
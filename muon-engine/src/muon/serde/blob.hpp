@@ -0,0 +1,364 @@
+#pragma once
+
+#include "muon/core/buffer.hpp"
+#include "muon/maths/alignment.hpp"
+#include "muon/serde/reflect.hpp"
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace muon::serde {
+
+constexpr std::array<char, 4> BLOB_MAGIC{'M', 'U', 'B', 'L'};
+constexpr uint16_t BLOB_VERSION = 1;
+// the largest alignment of anything stored in a blob, and the alignment the blob itself must be loaded at
+constexpr size_t BLOB_ALIGNMENT = 16;
+constexpr uint32_t MAX_BLOB_DEPTH = 64;
+
+struct BlobHeader {
+    std::array<char, 4> magic;
+    uint16_t version;
+    uint16_t reserved;
+    // versions the layout of the root type, chosen by whoever defines it
+    uint32_t schema;
+    uint32_t root;
+    uint64_t size;
+};
+
+static_assert(sizeof(BlobHeader) == 24);
+
+enum class BlobError {
+    InvalidHeader,
+    SchemaMismatch,
+    Misaligned,
+    OutOfBounds,
+    Unterminated,
+    LimitExceeded,
+    FileOpenFailure,
+};
+
+class BlobBuilder;
+
+// offsets are relative to the field that holds them so a blob reads the same wherever it is mapped, zero is null
+template <typename T>
+class RelPtr {
+public:
+    auto get() const -> const T * {
+        return offset_ == 0 ? nullptr : reinterpret_cast<const T *>(reinterpret_cast<const std::byte *>(this) + offset_);
+    }
+
+    auto operator->() const -> const T * { return get(); }
+    auto operator*() const -> const T & { return *get(); }
+    explicit operator bool() const { return offset_ != 0; }
+
+    auto offset() const -> int32_t { return offset_; }
+
+private:
+    friend class BlobBuilder;
+
+    int32_t offset_{0};
+};
+
+template <typename T>
+class RelVector {
+public:
+    auto data() const -> const T * {
+        return size_ == 0 ? nullptr : reinterpret_cast<const T *>(reinterpret_cast<const std::byte *>(this) + offset_);
+    }
+
+    auto size() const -> uint32_t { return size_; }
+    auto empty() const -> bool { return size_ == 0; }
+
+    auto begin() const -> const T * { return data(); }
+    auto end() const -> const T * { return data() + size_; }
+
+    auto operator[](uint32_t index) const -> const T & { return data()[index]; }
+    auto span() const -> std::span<const T> { return {data(), size_}; }
+
+    auto offset() const -> int32_t { return offset_; }
+
+private:
+    friend class BlobBuilder;
+
+    int32_t offset_{0};
+    uint32_t size_{0};
+};
+
+// stored with a terminator so that c_str() needs no copy
+class RelString {
+public:
+    auto c_str() const -> const char * {
+        return offset_ == 0 ? "" : reinterpret_cast<const char *>(reinterpret_cast<const std::byte *>(this) + offset_);
+    }
+
+    auto view() const -> std::string_view { return {c_str(), size_}; }
+    auto size() const -> uint32_t { return size_; }
+    auto empty() const -> bool { return size_ == 0; }
+
+    auto offset() const -> int32_t { return offset_; }
+
+private:
+    friend class BlobBuilder;
+
+    int32_t offset_{0};
+    uint32_t size_{0};
+};
+
+template <typename T>
+concept BlobLayout = std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T> && alignof(T) <= BLOB_ALIGNMENT;
+
+// a position within a blob that is still being built
+template <typename T>
+struct BlobRef {
+    uint32_t position{0};
+};
+
+template <typename T>
+struct BlobSpan {
+    uint32_t position{0};
+    uint32_t size{0};
+
+    auto at(uint32_t index) const -> BlobRef<T> { return {position + index * static_cast<uint32_t>(sizeof(T))}; }
+};
+
+// objects are appended in any order and linked afterwards, references returned by get() are only valid until the next
+// object is added
+class BlobBuilder : utils::NoCopy, utils::NoMove {
+public:
+    explicit BlobBuilder(uint32_t schema);
+
+    template <BlobLayout T>
+    auto add(const T &value = {}) -> BlobRef<T> {
+        auto position = allocate(sizeof(T), alignof(T));
+        std::memcpy(bytes_.data() + position, &value, sizeof(T));
+        return {position};
+    }
+
+    template <BlobLayout T>
+    auto add_vector(std::span<const T> values) -> BlobSpan<T> {
+        auto position = allocate(values.size_bytes(), alignof(T));
+        if (!values.empty()) {
+            std::memcpy(bytes_.data() + position, values.data(), values.size_bytes());
+        }
+        return {position, static_cast<uint32_t>(values.size())};
+    }
+
+    auto add_string(std::string_view text) -> BlobSpan<char>;
+
+    template <typename T>
+    auto get(BlobRef<T> ref) -> T & {
+        return *reinterpret_cast<T *>(bytes_.data() + ref.position);
+    }
+
+    template <typename T, typename U>
+    void link(BlobRef<T> object, RelPtr<U> T::*field, BlobRef<U> target) {
+        auto &pointer = get(object).*field;
+        pointer.offset_ = relative(&pointer, target.position);
+    }
+
+    template <typename T, typename U>
+    void link(BlobRef<T> object, RelVector<U> T::*field, BlobSpan<U> target) {
+        auto &vector = get(object).*field;
+        vector.offset_ = target.size == 0 ? 0 : relative(&vector, target.position);
+        vector.size_ = target.size;
+    }
+
+    template <typename T>
+    void link(BlobRef<T> object, RelString T::*field, BlobSpan<char> target) {
+        auto &string = get(object).*field;
+        string.offset_ = relative(&string, target.position);
+        string.size_ = target.size;
+    }
+
+    template <BlobLayout T>
+    auto finish(BlobRef<T> root) -> Buffer {
+        return finish(root.position);
+    }
+
+private:
+    auto allocate(size_t size, size_t alignment) -> uint32_t;
+    auto relative(const void *field, uint32_t target) const -> int32_t;
+    auto finish(uint32_t root) -> Buffer;
+
+    uint32_t schema_;
+    std::vector<std::byte> bytes_;
+};
+
+namespace internal {
+
+template <typename T>
+struct IsRelPtr : std::false_type {};
+template <typename T>
+struct IsRelPtr<RelPtr<T>> : std::true_type {};
+
+template <typename T>
+struct IsRelVector : std::false_type {};
+template <typename T>
+struct IsRelVector<RelVector<T>> : std::true_type {};
+
+template <typename T>
+consteval auto has_references() -> bool;
+
+template <typename... Fields>
+consteval auto fields_have_references(TypeList<Fields...>) -> bool {
+    return (has_references<Fields>() || ...);
+}
+
+// only types that can point elsewhere in the blob need to be walked
+template <typename T>
+consteval auto has_references() -> bool {
+    if constexpr (IsRelPtr<T>::value || IsRelVector<T>::value || std::same_as<T, RelString>) {
+        return true;
+    } else if constexpr (IsArray<T>::value) {
+        return has_references<typename T::value_type>();
+    } else if constexpr (Reflected<T>) {
+        return fields_have_references(FieldTypes<T>{});
+    } else {
+        return false;
+    }
+}
+
+class BlobValidator {
+public:
+    BlobValidator(const std::byte *base, size_t size) : base_{base}, size_{size}, budget_{size} {}
+
+    template <typename T>
+    auto target(const void *field, int32_t offset, size_t count) const -> std::expected<const T *, BlobError> {
+        auto position = static_cast<int64_t>(static_cast<const std::byte *>(field) - base_) + offset;
+        if (position < static_cast<int64_t>(sizeof(BlobHeader)) ||
+            count > (size_ - static_cast<size_t>(std::min<int64_t>(position, size_))) / sizeof(T)) {
+            return std::unexpected(BlobError::OutOfBounds);
+        }
+        if (!maths::is_aligned<alignof(T)>(static_cast<uint64_t>(position))) {
+            return std::unexpected(BlobError::Misaligned);
+        }
+        return reinterpret_cast<const T *>(base_ + position);
+    }
+
+    template <typename T>
+    auto validate(const T &value, uint32_t depth) -> std::expected<void, BlobError> {
+        if constexpr (!has_references<T>()) {
+            return {};
+        } else {
+            // shared or cyclic references could otherwise make validation arbitrarily slow
+            if (depth > MAX_BLOB_DEPTH || budget_ == 0) {
+                return std::unexpected(BlobError::LimitExceeded);
+            }
+            budget_--;
+
+            if constexpr (IsRelPtr<T>::value) {
+                if (!value) {
+                    return {};
+                }
+                auto pointee = target<std::remove_cvref_t<decltype(*value)>>(&value, value.offset(), 1);
+                if (!pointee) {
+                    return std::unexpected(pointee.error());
+                }
+                return validate(**pointee, depth + 1);
+            } else if constexpr (IsRelVector<T>::value) {
+                if (value.empty()) {
+                    return {};
+                }
+                using Element = std::remove_cvref_t<decltype(value[0])>;
+                auto elements = target<Element>(&value, value.offset(), value.size());
+                if (!elements) {
+                    return std::unexpected(elements.error());
+                }
+                for (uint32_t i = 0; i < value.size(); i++) {
+                    if (auto result = validate((*elements)[i], depth + 1); !result) {
+                        return result;
+                    }
+                }
+                return {};
+            } else if constexpr (std::same_as<T, RelString>) {
+                if (value.offset() == 0) {
+                    return value.empty() ? std::expected<void, BlobError>{} : std::unexpected(BlobError::OutOfBounds);
+                }
+                auto characters = target<char>(&value, value.offset(), size_t{value.size()} + 1);
+                if (!characters) {
+                    return std::unexpected(characters.error());
+                }
+                if ((*characters)[value.size()] != '\0') {
+                    return std::unexpected(BlobError::Unterminated);
+                }
+                return {};
+            } else if constexpr (IsArray<T>::value) {
+                for (const auto &element : value) {
+                    if (auto result = validate(element, depth); !result) {
+                        return result;
+                    }
+                }
+                return {};
+            } else {
+                return visit_fields(value, [this, depth](const auto &...fields) {
+                    std::expected<void, BlobError> result{};
+                    ((result = validate(fields, depth)).has_value() && ...);
+                    return result;
+                });
+            }
+        }
+    }
+
+private:
+    const std::byte *base_;
+    size_t size_;
+    size_t budget_;
+};
+
+auto validate_header(BufferView view, uint32_t schema) -> std::expected<const BlobHeader *, BlobError>;
+
+} // namespace internal
+
+// checks the header and every reference reachable from the root, after which the blob is read in place
+template <BlobLayout T>
+auto blob_root(BufferView view, uint32_t schema) -> std::expected<const T *, BlobError> {
+    auto header = internal::validate_header(view, schema);
+    if (!header) {
+        return std::unexpected(header.error());
+    }
+
+    internal::BlobValidator validator{reinterpret_cast<const std::byte *>(view.data()), (*header)->size};
+    auto root = validator.target<T>(view.data(), static_cast<int32_t>((*header)->root), 1);
+    if (!root) {
+        return std::unexpected(root.error());
+    }
+    if (auto result = validator.validate(**root, 0); !result) {
+        return std::unexpected(result.error());
+    }
+    return *root;
+}
+
+// keeps a blob file mapped read only for as long as it lives
+class MappedBlob : utils::NoCopy {
+public:
+    static auto open(const std::filesystem::path &path) -> std::expected<MappedBlob, BlobError>;
+
+    MappedBlob(MappedBlob &&other) noexcept;
+    auto operator=(MappedBlob &&other) noexcept -> MappedBlob &;
+    ~MappedBlob();
+
+    auto view() const -> BufferView;
+
+    template <BlobLayout T>
+    auto root(uint32_t schema) const -> std::expected<const T *, BlobError> {
+        return blob_root<T>(view(), schema);
+    }
+
+private:
+    explicit MappedBlob(std::span<const std::byte> mapping) : mapping_{mapping} {}
+
+    std::span<const std::byte> mapping_;
+};
+
+} // namespace muon::serde
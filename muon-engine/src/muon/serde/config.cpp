@@ -0,0 +1,107 @@
+#include "muon/serde/config.hpp"
+
+#include "muon/core/log.hpp"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace muon::serde::internal {
+
+namespace {
+
+constexpr std::array<char, 8> SNAPSHOT_MAGIC{'M', 'U', 'O', 'N', 'C', 'F', 'G', '\0'};
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+// the magic and version, followed by the key and then the payload
+constexpr size_t SNAPSHOT_PREFIX_SIZE = SNAPSHOT_MAGIC.size() + sizeof(SNAPSHOT_VERSION);
+
+} // namespace
+
+auto snapshot_path(const std::filesystem::path &path) -> std::filesystem::path {
+    auto snapshot = path;
+    snapshot += ".snapshot";
+    return snapshot;
+}
+
+auto snapshot_key(BufferView source, std::string_view layout) -> std::optional<SnapshotKey> {
+    auto source_hash = crypto::Hash::from_buffer(source);
+    auto layout_hash = crypto::Hash::from_text(layout);
+    if (!source_hash || !layout_hash) {
+        return std::nullopt;
+    }
+    return SnapshotKey{.source = std::move(*source_hash), .layout = std::move(*layout_hash)};
+}
+
+auto read_snapshot(const std::filesystem::path &path, const SnapshotKey &key) -> std::optional<Snapshot> {
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) {
+        return std::nullopt;
+    }
+
+    auto file = fs::read_file_binary(path);
+    auto key_size = binary_size(key);
+    if (!file || file->size() < SNAPSHOT_PREFIX_SIZE + key_size) {
+        return std::nullopt;
+    }
+
+    uint32_t version = 0;
+    std::memcpy(&version, file->data() + SNAPSHOT_MAGIC.size(), sizeof(version));
+    if (std::memcmp(file->data(), SNAPSHOT_MAGIC.data(), SNAPSHOT_MAGIC.size()) != 0 || version != SNAPSHOT_VERSION) {
+        return std::nullopt;
+    }
+
+    auto stored = from_binary<SnapshotKey>(BufferView{file->data() + SNAPSHOT_PREFIX_SIZE, key_size});
+    if (!stored || !(stored->source == key.source) || !(stored->layout == key.layout)) {
+        return std::nullopt;
+    }
+
+    return Snapshot{std::move(*file), SNAPSHOT_PREFIX_SIZE + key_size};
+}
+
+void write_snapshot(const std::filesystem::path &path, const SnapshotKey &key, BufferView payload) {
+    auto encoded_key = to_binary(key);
+
+    // readers only ever see a complete snapshot
+    auto temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+        file.write(SNAPSHOT_MAGIC.data(), SNAPSHOT_MAGIC.size());
+        file.write(reinterpret_cast<const char *>(&SNAPSHOT_VERSION), sizeof(SNAPSHOT_VERSION));
+        file.write(reinterpret_cast<const char *>(encoded_key.data()), static_cast<std::streamsize>(encoded_key.size()));
+        file.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        if (!file) {
+            MU_LOG_DEBUG(Fs, "failed to write config snapshot {}", temporary.string());
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        MU_LOG_DEBUG(Fs, "failed to replace config snapshot {}: {}", path.string(), error.message());
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+auto parse_toml(BufferView source, const std::filesystem::path &path) -> std::expected<toml::table, ConfigError> {
+    std::string_view text{reinterpret_cast<const char *>(source.data()), source.size()};
+#if TOML_EXCEPTIONS
+    try {
+        return toml::parse(text, path.string());
+    } catch (const toml::parse_error &error) {
+        MU_LOG_WARN(Fs, "failed to parse {}: {}", path.string(), error.description());
+        return std::unexpected(ConfigError::ParseFailure);
+    }
+#else
+    auto result = toml::parse(text, path.string());
+    if (!result) {
+        MU_LOG_WARN(Fs, "failed to parse {}: {}", path.string(), result.error().description());
+        return std::unexpected(ConfigError::ParseFailure);
+    }
+    return std::move(result).table();
+#endif
+}
+
+} // namespace muon::serde::internal
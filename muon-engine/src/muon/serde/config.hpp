@@ -0,0 +1,123 @@
+#pragma once
+
+#include "muon/core/buffer.hpp"
+#include "muon/crypto/hash.hpp"
+#include "muon/fs/fs.hpp"
+#include "muon/serde/binary.hpp"
+#include "muon/serde/reflect.hpp"
+#include "muon/serde/toml.hpp"
+#include "toml++/toml.hpp"
+
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
+
+namespace muon::serde {
+
+enum class ConfigError {
+    FileReadFailure,
+    ParseFailure,
+    DeserializeFailure,
+};
+
+namespace internal {
+
+struct SnapshotKey {
+    crypto::Hash source;
+    crypto::Hash layout;
+};
+
+class Snapshot {
+public:
+    Snapshot(Buffer file, size_t payload_offset) : file_{std::move(file)}, payload_offset_{payload_offset} {}
+
+    auto payload() const -> BufferView { return {file_.data() + payload_offset_, file_.size() - payload_offset_}; }
+
+private:
+    Buffer file_;
+    size_t payload_offset_;
+};
+
+template <typename T>
+void append_layout(std::string &signature);
+
+template <typename... Fields>
+void append_fields(TypeList<Fields...>, std::string &signature) {
+    (append_layout<Fields>(signature), ...);
+}
+
+// type names alone miss changes to the fields of nested structs, so reflected types are expanded
+template <typename T>
+void append_layout(std::string &signature) {
+    signature += typeid(T).name();
+    if constexpr (IsVector<T>::value || IsArray<T>::value || IsOptional<T>::value) {
+        signature += '<';
+        append_layout<typename T::value_type>(signature);
+        signature += '>';
+    } else if constexpr (Reflected<T>) {
+        signature += '{';
+        append_fields(FieldTypes<T>{}, signature);
+        signature += '}';
+    }
+}
+
+template <typename T>
+auto layout_signature() -> std::string {
+    std::string signature;
+    append_layout<T>(signature);
+    return signature;
+}
+
+auto snapshot_path(const std::filesystem::path &path) -> std::filesystem::path;
+auto snapshot_key(BufferView source, std::string_view layout) -> std::optional<SnapshotKey>;
+auto read_snapshot(const std::filesystem::path &path, const SnapshotKey &key) -> std::optional<Snapshot>;
+void write_snapshot(const std::filesystem::path &path, const SnapshotKey &key, BufferView payload);
+auto parse_toml(BufferView source, const std::filesystem::path &path) -> std::expected<toml::table, ConfigError>;
+
+} // namespace internal
+
+// parses the toml file at `path` into T, a binary snapshot of the result is written next to it (or to `snapshot`) and
+// reused for as long as the file and the layout of T stay the same, so later launches skip toml parsing entirely.
+// T must not hold string views, they would point into the snapshot which does not outlive this call
+template <typename T>
+    requires TomlDeserializable<T> && BinaryReflectable<T> && std::default_initializable<T>
+auto load_config(const std::filesystem::path &path, std::filesystem::path snapshot = {}) -> std::expected<T, ConfigError> {
+    if (snapshot.empty()) {
+        snapshot = internal::snapshot_path(path);
+    }
+
+    auto source = fs::read_file_binary(path);
+    if (!source) {
+        return std::unexpected(ConfigError::FileReadFailure);
+    }
+
+    auto key = internal::snapshot_key(*source, internal::layout_signature<T>());
+    if (key) {
+        if (auto cached = internal::read_snapshot(snapshot, *key)) {
+            if (auto value = from_binary<T>(cached->payload())) {
+                return std::move(*value);
+            }
+        }
+    }
+
+    auto table = internal::parse_toml(*source, path);
+    if (!table) {
+        return std::unexpected(table.error());
+    }
+
+    auto value = deserialize<toml::table, T, TomlDeserializeError>(*table);
+    if (!value) {
+        return std::unexpected(ConfigError::DeserializeFailure);
+    }
+
+    if (key) {
+        internal::write_snapshot(snapshot, *key, to_binary(*value));
+    }
+    return std::move(*value);
+}
+
+} // namespace muon::serde
@@ -0,0 +1,91 @@
+#include "muon/serde/json.hpp"
+
+#include "nlohmann/json.hpp"
+
+#include <vector>
+
+namespace muon::serde::internal {
+
+namespace {
+
+// the parser hands each token over once, only the stack of containers being filled is kept between events
+class JsonSink {
+public:
+    using Json = nlohmann::json;
+
+    explicit JsonSink(JsonFrame root) { frames_.push_back(root); }
+
+    auto null() -> bool { return scalar(nullptr); }
+    auto boolean(bool value) -> bool { return scalar(value); }
+    auto number_integer(Json::number_integer_t value) -> bool { return scalar(static_cast<int64_t>(value)); }
+    auto number_unsigned(Json::number_unsigned_t value) -> bool { return scalar(static_cast<uint64_t>(value)); }
+    auto number_float(Json::number_float_t value, const Json::string_t &) -> bool { return scalar(static_cast<double>(value)); }
+    auto string(Json::string_t &value) -> bool { return scalar(std::string_view{value}); }
+    auto binary(Json::binary_t &) -> bool { return mismatch(); }
+
+    auto start_object(size_t) -> bool { return open(true); }
+    auto end_object() -> bool { return close(); }
+    auto start_array(size_t) -> bool { return open(false); }
+    auto end_array() -> bool { return close(); }
+
+    auto key(Json::string_t &key) -> bool {
+        auto &frame = frames_.back();
+        return frame.ops->key(frame, key) || mismatch();
+    }
+
+    auto parse_error(size_t, const std::string &, const nlohmann::detail::exception &) -> bool {
+        error_ = JsonDeserializeError::ParseFailure;
+        return false;
+    }
+
+    auto error() const -> JsonDeserializeError { return error_; }
+
+private:
+    auto scalar(const JsonScalar &value) -> bool {
+        auto &frame = frames_.back();
+        return frame.ops->scalar(frame, value) || mismatch();
+    }
+
+    auto open(bool object) -> bool {
+        JsonFrame child{nullptr, nullptr, 0};
+        if (!frames_.back().ops->open(frames_.back(), object, child)) {
+            return mismatch();
+        }
+        frames_.push_back(child);
+        return true;
+    }
+
+    auto close() -> bool {
+        frames_.pop_back();
+        return true;
+    }
+
+    auto mismatch() -> bool {
+        error_ = JsonDeserializeError::TypeMismatch;
+        return false;
+    }
+
+    std::vector<JsonFrame> frames_;
+    JsonDeserializeError error_{JsonDeserializeError::ParseFailure};
+};
+
+template <typename Input>
+auto parse(Input &&input, JsonFrame root) -> std::expected<void, JsonDeserializeError> {
+    JsonSink sink{root};
+    if (!nlohmann::json::sax_parse(std::forward<Input>(input), &sink)) {
+        return std::unexpected(sink.error());
+    }
+    return {};
+}
+
+} // namespace
+
+auto stream_json(std::istream &input, JsonFrame root) -> std::expected<void, JsonDeserializeError> {
+    return parse(input, root);
+}
+
+auto stream_json(std::string_view text, JsonFrame root) -> std::expected<void, JsonDeserializeError> {
+    return parse(text, root);
+}
+
+} // namespace muon::serde::internal
@@ -0,0 +1,338 @@
+#pragma once
+
+#include "magic_enum/magic_enum.hpp"
+#include "muon/serde/reflect.hpp"
+#include "muon/serde/serde.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace muon::serde {
+
+// a json document on disk, streamed rather than loaded
+struct JsonFile {
+    std::filesystem::path path;
+};
+
+enum class JsonDeserializeError {
+    FileOpenFailure,
+    ParseFailure,
+    TypeMismatch,
+};
+
+template <typename To>
+concept JsonDeserializable = Deserializable<JsonFile, To, JsonDeserializeError>;
+
+namespace internal {
+
+using JsonScalar = std::variant<std::nullptr_t, bool, int64_t, uint64_t, double, std::string_view>;
+
+struct JsonFrame;
+
+// how a container being filled reacts to each parser event, the slot is the field index of an object, the element
+// index of a fixed size array and unused otherwise
+struct JsonFrameOps {
+    auto (*key)(JsonFrame &frame, std::string_view key) -> bool;
+    auto (*scalar)(JsonFrame &frame, const JsonScalar &value) -> bool;
+    auto (*open)(JsonFrame &frame, bool object, JsonFrame &child) -> bool;
+};
+
+struct JsonFrame {
+    void *target;
+    const JsonFrameOps *ops;
+    size_t slot;
+};
+
+constexpr size_t SKIPPED_SLOT = std::numeric_limits<size_t>::max();
+
+template <typename T>
+concept JsonNamed = Reflected<T> && requires {
+    { std::string_view{T::JSON_FIELDS[0]} };
+    requires std::size(T::JSON_FIELDS) == count_fields<T>();
+};
+
+template <typename T>
+consteval auto json_supported() -> bool;
+
+template <typename... Fields>
+consteval auto json_fields_supported(TypeList<Fields...>) -> bool {
+    return (json_supported<Fields>() && ...);
+}
+
+template <typename T>
+consteval auto json_supported() -> bool {
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T> || std::same_as<T, std::string>) {
+        return true;
+    } else if constexpr (IsVector<T>::value) {
+        return !std::same_as<typename T::value_type, bool> && json_supported<typename T::value_type>();
+    } else if constexpr (IsArray<T>::value || IsOptional<T>::value) {
+        return json_supported<typename T::value_type>();
+    } else if constexpr (JsonNamed<T>) {
+        return json_fields_supported(FieldTypes<T>{});
+    } else {
+        return false;
+    }
+}
+
+template <std::integral T>
+constexpr auto fits_integer(int64_t value) -> bool {
+    if (value < 0) {
+        return std::is_signed_v<T> && value >= static_cast<int64_t>(std::numeric_limits<T>::min());
+    }
+    return static_cast<uint64_t>(value) <= static_cast<uint64_t>(std::numeric_limits<T>::max());
+}
+
+template <typename T>
+auto assign_number(T &target, const JsonScalar &value) -> bool {
+    if (const auto *integer = std::get_if<int64_t>(&value)) {
+        if constexpr (std::is_integral_v<T>) {
+            if (!fits_integer<T>(*integer)) {
+                return false;
+            }
+        }
+        target = static_cast<T>(*integer);
+        return true;
+    }
+    if (const auto *integer = std::get_if<uint64_t>(&value)) {
+        if constexpr (std::is_integral_v<T>) {
+            if (*integer > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+                return false;
+            }
+        }
+        target = static_cast<T>(*integer);
+        return true;
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        if (const auto *number = std::get_if<double>(&value)) {
+            target = static_cast<T>(*number);
+            return true;
+        }
+    }
+    return false;
+}
+
+// stores a scalar into a value of type T
+template <typename T>
+auto assign(T &target, const JsonScalar &value) -> bool {
+    if constexpr (std::same_as<T, bool>) {
+        const auto *boolean = std::get_if<bool>(&value);
+        if (boolean) {
+            target = *boolean;
+        }
+        return boolean != nullptr;
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        return assign_number(target, value);
+    } else if constexpr (std::is_enum_v<T>) {
+        if (const auto *name = std::get_if<std::string_view>(&value)) {
+            auto enumerator = magic_enum::enum_cast<T>(*name);
+            if (enumerator) {
+                target = *enumerator;
+            }
+            return enumerator.has_value();
+        }
+        std::underlying_type_t<T> underlying{};
+        if (!assign_number(underlying, value)) {
+            return false;
+        }
+        target = static_cast<T>(underlying);
+        return true;
+    } else if constexpr (std::same_as<T, std::string>) {
+        const auto *text = std::get_if<std::string_view>(&value);
+        if (text) {
+            target.assign(*text);
+        }
+        return text != nullptr;
+    } else if constexpr (IsOptional<T>::value) {
+        if (std::holds_alternative<std::nullptr_t>(value)) {
+            target.reset();
+            return true;
+        }
+        return assign(target.emplace(), value);
+    } else {
+        return false;
+    }
+}
+
+template <typename T>
+auto open(T &target, bool object, JsonFrame &child) -> bool;
+
+template <typename T>
+auto with_field(T &object, size_t index, auto &&fn) -> bool {
+    return visit_fields(object, [index, &fn](auto &...fields) {
+        size_t current = 0;
+        bool result = false;
+        ((current++ == index ? (result = fn(fields), true) : false) || ...);
+        return result;
+    });
+}
+
+// unknown keys and everything below them are read and dropped
+inline const JsonFrameOps SKIP_OPS{
+    .key = [](JsonFrame &, std::string_view) { return true; },
+    .scalar = [](JsonFrame &, const JsonScalar &) { return true; },
+    .open = [](JsonFrame &, bool, JsonFrame &child) {
+        child = {nullptr, &SKIP_OPS, 0};
+        return true;
+    },
+};
+
+template <typename T>
+struct ObjectOps {
+    static auto key(JsonFrame &frame, std::string_view key) -> bool {
+        frame.slot = SKIPPED_SLOT;
+        for (size_t i = 0; i < std::size(T::JSON_FIELDS); i++) {
+            if (std::string_view{T::JSON_FIELDS[i]} == key) {
+                frame.slot = i;
+                break;
+            }
+        }
+        return true;
+    }
+
+    static auto scalar(JsonFrame &frame, const JsonScalar &value) -> bool {
+        if (frame.slot == SKIPPED_SLOT) {
+            return true;
+        }
+        return with_field(*static_cast<T *>(frame.target), frame.slot, [&value](auto &field) { return assign(field, value); });
+    }
+
+    static auto open(JsonFrame &frame, bool object, JsonFrame &child) -> bool {
+        if (frame.slot == SKIPPED_SLOT) {
+            return SKIP_OPS.open(frame, object, child);
+        }
+        return with_field(*static_cast<T *>(frame.target), frame.slot, [object, &child](auto &field) {
+            return internal::open(field, object, child);
+        });
+    }
+
+    static constexpr JsonFrameOps OPS{.key = key, .scalar = scalar, .open = open};
+};
+
+template <typename T>
+struct VectorOps {
+    static auto key(JsonFrame &, std::string_view) -> bool { return false; }
+
+    // elements are appended one at a time, nothing below this frame is open while the vector grows
+    static auto scalar(JsonFrame &frame, const JsonScalar &value) -> bool {
+        return assign(static_cast<T *>(frame.target)->emplace_back(), value);
+    }
+
+    static auto open(JsonFrame &frame, bool object, JsonFrame &child) -> bool {
+        return internal::open(static_cast<T *>(frame.target)->emplace_back(), object, child);
+    }
+
+    static constexpr JsonFrameOps OPS{.key = key, .scalar = scalar, .open = open};
+};
+
+template <typename T>
+struct ArrayOps {
+    static auto key(JsonFrame &, std::string_view) -> bool { return false; }
+
+    static auto scalar(JsonFrame &frame, const JsonScalar &value) -> bool {
+        auto &array = *static_cast<T *>(frame.target);
+        return frame.slot < array.size() && assign(array[frame.slot++], value);
+    }
+
+    static auto open(JsonFrame &frame, bool object, JsonFrame &child) -> bool {
+        auto &array = *static_cast<T *>(frame.target);
+        return frame.slot < array.size() && internal::open(array[frame.slot++], object, child);
+    }
+
+    static constexpr JsonFrameOps OPS{.key = key, .scalar = scalar, .open = open};
+};
+
+// the document itself is a single slot holding T
+template <typename T>
+struct RootOps {
+    static auto key(JsonFrame &, std::string_view) -> bool { return false; }
+
+    static auto scalar(JsonFrame &frame, const JsonScalar &value) -> bool {
+        return assign(*static_cast<T *>(frame.target), value);
+    }
+
+    static auto open(JsonFrame &frame, bool object, JsonFrame &child) -> bool {
+        return internal::open(*static_cast<T *>(frame.target), object, child);
+    }
+
+    static constexpr JsonFrameOps OPS{.key = key, .scalar = scalar, .open = open};
+};
+
+template <typename T>
+auto open(T &target, bool object, JsonFrame &child) -> bool {
+    if constexpr (IsVector<T>::value) {
+        target.clear();
+        child = {&target, &VectorOps<T>::OPS, 0};
+        return !object;
+    } else if constexpr (IsArray<T>::value) {
+        child = {&target, &ArrayOps<T>::OPS, 0};
+        return !object;
+    } else if constexpr (IsOptional<T>::value) {
+        return open(target.emplace(), object, child);
+    } else if constexpr (JsonNamed<T>) {
+        child = {&target, &ObjectOps<T>::OPS, SKIPPED_SLOT};
+        return object;
+    } else {
+        return false;
+    }
+}
+
+auto stream_json(std::istream &input, JsonFrame root) -> std::expected<void, JsonDeserializeError>;
+auto stream_json(std::string_view text, JsonFrame root) -> std::expected<void, JsonDeserializeError>;
+
+} // namespace internal
+
+// numbers, booleans, strings, enums (by name or value), vectors, arrays, optionals and aggregates are supported,
+// aggregates name their fields in declaration order through a static JSON_FIELDS array
+template <typename T>
+concept JsonStreamable = internal::json_supported<T>();
+
+// feeds parser events straight into T without building a document, missing fields keep their default value and
+// unknown fields are skipped
+template <JsonStreamable T>
+    requires std::default_initializable<T>
+auto stream_json(std::istream &input) -> std::expected<T, JsonDeserializeError> {
+    T value{};
+    auto result = internal::stream_json(input, {&value, &internal::RootOps<T>::OPS, 0});
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+    return value;
+}
+
+template <JsonStreamable T>
+    requires std::default_initializable<T>
+auto stream_json(std::string_view text) -> std::expected<T, JsonDeserializeError> {
+    T value{};
+    auto result = internal::stream_json(text, {&value, &internal::RootOps<T>::OPS, 0});
+    if (!result) {
+        return std::unexpected(result.error());
+    }
+    return value;
+}
+
+template <typename From, typename To, typename Error>
+    requires std::same_as<From, JsonFile> && std::same_as<Error, JsonDeserializeError> && JsonStreamable<To>
+auto deserialize(const From &from) -> std::expected<To, Error> {
+    std::ifstream file{from.path, std::ios::binary};
+    if (!file) {
+        return std::unexpected(JsonDeserializeError::FileOpenFailure);
+    }
+    return stream_json<To>(file);
+}
+
+} // namespace muon::serde
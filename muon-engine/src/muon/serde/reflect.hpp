@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace muon::serde::internal {
+
+constexpr size_t MAX_FIELDS = 16;
+
+template <typename T>
+struct IsArray : std::false_type {};
+template <typename T, size_t N>
+struct IsArray<std::array<T, N>> : std::true_type {};
+
+template <typename T>
+struct IsVector : std::false_type {};
+template <typename T, typename Allocator>
+struct IsVector<std::vector<T, Allocator>> : std::true_type {};
+
+template <typename T>
+struct IsOptional : std::false_type {};
+template <typename T>
+struct IsOptional<std::optional<T>> : std::true_type {};
+
+template <typename... Fields>
+struct TypeList {};
+
+template <typename T>
+concept Reflected = std::is_aggregate_v<T> && std::is_class_v<T> && !IsArray<T>::value;
+
+// converts to any field type, optionals are left to their converting constructor which would otherwise be ambiguous, C
+// arrays are not supported as brace elision spreads them over several fields
+struct AnyField {
+    template <typename T>
+        requires(!IsOptional<T>::value)
+    operator T &() const noexcept;
+};
+
+template <typename T, typename... Fields>
+consteval auto count_fields() -> size_t {
+    if constexpr (sizeof...(Fields) <= MAX_FIELDS && requires { T{Fields{}..., AnyField{}}; }) {
+        return count_fields<T, Fields..., AnyField>();
+    } else {
+        return sizeof...(Fields);
+    }
+}
+
+template <typename T, typename Fn>
+constexpr auto visit_fields(T &value, Fn &&fn) -> decltype(auto) {
+    constexpr auto COUNT = count_fields<std::remove_cv_t<T>>();
+    static_assert(COUNT <= MAX_FIELDS, "aggregate has too many fields to reflect");
+
+    if constexpr (COUNT == 0) {
+        return fn();
+    } else if constexpr (COUNT == 1) {
+        auto &[f0] = value;
+        return fn(f0);
+    } else if constexpr (COUNT == 2) {
+        auto &[f0, f1] = value;
+        return fn(f0, f1);
+    } else if constexpr (COUNT == 3) {
+        auto &[f0, f1, f2] = value;
+        return fn(f0, f1, f2);
+    } else if constexpr (COUNT == 4) {
+        auto &[f0, f1, f2, f3] = value;
+        return fn(f0, f1, f2, f3);
+    } else if constexpr (COUNT == 5) {
+        auto &[f0, f1, f2, f3, f4] = value;
+        return fn(f0, f1, f2, f3, f4);
+    } else if constexpr (COUNT == 6) {
+        auto &[f0, f1, f2, f3, f4, f5] = value;
+        return fn(f0, f1, f2, f3, f4, f5);
+    } else if constexpr (COUNT == 7) {
+        auto &[f0, f1, f2, f3, f4, f5, f6] = value;
+        return fn(f0, f1, f2, f3, f4, f5, f6);
+    } else if constexpr (COUNT == 8) {
+        auto &[f0, f1, f2, f3, f4, f5, f6, f7] = value;
+        return fn(f0, f1, f2, f3, f4, f5, f6, f7);
+    } else if constexpr (COUNT == 9) {
+        auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8] = value;
+        return fn(f0, f1, f2, f3, f4, f5, f6, f7, f8);
+    } else if constexpr (COUNT == 10) {
+        auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9] = value;
+        return fn(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9);
+    } else if constexpr (COUNT == 11) {
+        auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = value;
+        return fn(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+    } else if constexpr (COUNT == 12) {
+        auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = value;
+        return fn(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+    } else if constexpr (COUNT == 13) {
+        auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12] = value;
+        return fn(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12);
+    } else if constexpr (COUNT == 14) {
+        auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13] = value;
+        return fn(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13);
+    } else if constexpr (COUNT == 15) {
+        auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14] = value;
+        return fn(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14);
+    } else if constexpr (COUNT == 16) {
+        auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15] = value;
+        return fn(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15);
+    }
+}
+
+struct FieldTypeList {
+    template <typename... Fields>
+    auto operator()(Fields &...) const -> TypeList<std::remove_cv_t<Fields>...>;
+};
+
+template <typename T>
+using FieldTypes = decltype(visit_fields(std::declval<T &>(), FieldTypeList{}));
+
+} // namespace muon::serde::internal
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <expected>
 #include <filesystem>
+#include <span>
+#include <string>
 #include <string_view>
 
 namespace muon::utils {
@@ -25,6 +28,26 @@ enum class Signal {
 
 void invoke_signal(Signal signal);
 
+// writes straight to the standard error stream without buffering or allocating, safe to call from a signal handler
+void write_error_output(std::string_view text) noexcept;
+
 auto has_elevated_privileges() -> bool;
 
+auto demangle(const char *name) -> std::string;
+
+enum class MapError {
+    FileOpenFailure,
+    FileResizeFailure,
+    MapFailure,
+    UnmapFailure,
+};
+
+// maps `size` bytes of the file read/write and shared, creating or resizing it as needed
+auto map_file(const std::filesystem::path &path, size_t size) -> std::expected<std::span<std::byte>, MapError>;
+auto unmap_file(std::span<std::byte> mapping) -> std::expected<void, MapError>;
+
+// maps the whole of an existing file read only
+auto map_file_read(const std::filesystem::path &path) -> std::expected<std::span<const std::byte>, MapError>;
+auto unmap_file(std::span<const std::byte> mapping) -> std::expected<void, MapError>;
+
 } // namespace muon
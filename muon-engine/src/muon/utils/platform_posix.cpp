@@ -3,7 +3,12 @@
 #include "muon/core/log.hpp"
 
 #include <csignal>
+#include <cstdlib>
+#include <cxxabi.h>
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 namespace muon::utils {
@@ -46,6 +51,87 @@ void invoke_signal(Signal signal) {
     }
 }
 
+void write_error_output(std::string_view text) noexcept {
+    while (!text.empty()) {
+        auto written = write(STDERR_FILENO, text.data(), text.size());
+        if (written <= 0) {
+            return;
+        }
+        text.remove_prefix(static_cast<size_t>(written));
+    }
+}
+
 auto has_elevated_privileges() -> bool { return geteuid() == 0; }
 
+auto demangle(const char *name) -> std::string {
+    int32_t status = 0;
+    char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status != 0 || !demangled) {
+        return name;
+    }
+
+    std::string result = demangled;
+    std::free(demangled);
+    return result;
+}
+
+auto map_file(const std::filesystem::path &path, size_t size) -> std::expected<std::span<std::byte>, MapError> {
+    int32_t descriptor = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (descriptor < 0) {
+        return std::unexpected(MapError::FileOpenFailure);
+    }
+
+    if (ftruncate(descriptor, static_cast<off_t>(size)) != 0) {
+        close(descriptor);
+        return std::unexpected(MapError::FileResizeFailure);
+    }
+
+    // the mapping keeps the file alive, the descriptor is no longer needed
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (data == MAP_FAILED) {
+        return std::unexpected(MapError::MapFailure);
+    }
+
+    return std::span{static_cast<std::byte *>(data), size};
+}
+
+auto unmap_file(std::span<std::byte> mapping) -> std::expected<void, MapError> {
+    if (munmap(mapping.data(), mapping.size()) != 0) {
+        return std::unexpected(MapError::UnmapFailure);
+    }
+
+    return {};
+}
+
+auto map_file_read(const std::filesystem::path &path) -> std::expected<std::span<const std::byte>, MapError> {
+    int32_t descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        return std::unexpected(MapError::FileOpenFailure);
+    }
+
+    struct stat status{};
+    if (fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+        close(descriptor);
+        return std::unexpected(MapError::MapFailure);
+    }
+
+    auto size = static_cast<size_t>(status.st_size);
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (data == MAP_FAILED) {
+        return std::unexpected(MapError::MapFailure);
+    }
+
+    return std::span{static_cast<const std::byte *>(data), size};
+}
+
+auto unmap_file(std::span<const std::byte> mapping) -> std::expected<void, MapError> {
+    if (munmap(const_cast<std::byte *>(mapping.data()), mapping.size()) != 0) {
+        return std::unexpected(MapError::UnmapFailure);
+    }
+
+    return {};
+}
+
 } // namespace muon
@@ -63,6 +63,11 @@ void invoke_signal(Signal signal) {
     }
 }
 
+void write_error_output(std::string_view text) noexcept {
+    DWORD written = 0;
+    WriteFile(GetStdHandle(STD_ERROR_HANDLE), text.data(), static_cast<DWORD>(text.size()), &written, nullptr);
+}
+
 auto has_elevated_privileges() -> bool {
     BOOL isAdmin = FALSE;
     PSID administratorsGroup = nullptr;
@@ -80,4 +85,99 @@ auto has_elevated_privileges() -> bool {
     return static_cast<bool>(isAdmin);
 }
 
+auto demangle(const char *name) -> std::string {
+    // MSVC type names are already human readable, only drop the class/struct prefix
+    std::string_view view = name;
+    for (std::string_view prefix : {"class ", "struct ", "enum "}) {
+        if (view.starts_with(prefix)) {
+            view.remove_prefix(prefix.size());
+            break;
+        }
+    }
+    return std::string{view};
+}
+
+auto map_file(const std::filesystem::path &path, size_t size) -> std::expected<std::span<std::byte>, MapError> {
+    HANDLE file = CreateFileW(
+        path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        print_error(GetLastError());
+        return std::unexpected(MapError::FileOpenFailure);
+    }
+
+    LARGE_INTEGER length;
+    length.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(file, length, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+        print_error(GetLastError());
+        CloseHandle(file);
+        return std::unexpected(MapError::FileResizeFailure);
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, length.HighPart, length.LowPart, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        print_error(GetLastError());
+        return std::unexpected(MapError::MapFailure);
+    }
+
+    // the view keeps the mapping and file alive once both handles are closed
+    void *data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    CloseHandle(mapping);
+    if (!data) {
+        print_error(GetLastError());
+        return std::unexpected(MapError::MapFailure);
+    }
+
+    return std::span{static_cast<std::byte *>(data), size};
+}
+
+auto unmap_file(std::span<std::byte> mapping) -> std::expected<void, MapError> {
+    if (!UnmapViewOfFile(mapping.data())) {
+        print_error(GetLastError());
+        return std::unexpected(MapError::UnmapFailure);
+    }
+
+    return {};
+}
+
+auto map_file_read(const std::filesystem::path &path) -> std::expected<std::span<const std::byte>, MapError> {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        print_error(GetLastError());
+        return std::unexpected(MapError::FileOpenFailure);
+    }
+
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(file, &length) || length.QuadPart <= 0) {
+        CloseHandle(file);
+        return std::unexpected(MapError::MapFailure);
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        print_error(GetLastError());
+        return std::unexpected(MapError::MapFailure);
+    }
+
+    void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data) {
+        print_error(GetLastError());
+        return std::unexpected(MapError::MapFailure);
+    }
+
+    return std::span{static_cast<const std::byte *>(data), static_cast<size_t>(length.QuadPart)};
+}
+
+auto unmap_file(std::span<const std::byte> mapping) -> std::expected<void, MapError> {
+    if (!UnmapViewOfFile(mapping.data())) {
+        print_error(GetLastError());
+        return std::unexpected(MapError::UnmapFailure);
+    }
+
+    return {};
+}
+
 } // namespace muon
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "muon/utils/no_copy.hpp"
+#include "muon/utils/no_move.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace muon::utils {
+
+// lock-free queue for exactly one producer thread and one consumer thread
+template <typename T>
+class RingBuffer : NoCopy, NoMove {
+public:
+    using ValueType = T;
+    using SizeType = size_t;
+
+    explicit RingBuffer(SizeType capacity) : slots_(std::bit_ceil(capacity)), mask_{slots_.size() - 1} {}
+
+    template <typename U>
+    auto push(U &&value) noexcept -> bool {
+        const SizeType tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == slots_.size()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == slots_.size()) {
+                return false;
+            }
+        }
+
+        slots_[tail & mask_] = std::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    auto pop() noexcept -> std::optional<T> {
+        const SizeType head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return std::nullopt;
+            }
+        }
+
+        std::optional<T> value{std::move(slots_[head & mask_])};
+        head_.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    auto size() const noexcept -> SizeType {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    auto capacity() const noexcept -> SizeType { return slots_.size(); }
+
+private:
+    static constexpr SizeType CACHE_LINE = 64;
+
+    std::vector<T> slots_;
+    SizeType mask_;
+
+    alignas(CACHE_LINE) std::atomic<SizeType> head_{0};
+    SizeType cached_tail_{0};
+
+    alignas(CACHE_LINE) std::atomic<SizeType> tail_{0};
+    SizeType cached_head_{0};
+};
+
+} // namespace muon::utils
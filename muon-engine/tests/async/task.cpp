@@ -0,0 +1,94 @@
+#include "muon/async/task.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "muon/async/frame_pool.hpp"
+#include "muon/async/scheduler.hpp"
+#include "muon/job/system.hpp"
+
+#include <cstdint>
+#include <thread>
+
+namespace muon {
+
+namespace {
+
+auto forty_two() -> async::Task<uint32_t> { co_return 42; }
+
+auto add_one(uint32_t &counter) -> async::Task<uint32_t> {
+    uint32_t value = co_await forty_two();
+    counter = value + 1;
+    co_return counter;
+}
+
+auto count_frames(async::Scheduler &scheduler, uint32_t &frames) -> async::Task<> {
+    for (uint32_t i = 0; i < 3; i++) {
+        co_await scheduler.next_frame();
+        frames += 1;
+    }
+}
+
+auto square_on_job(async::Scheduler &scheduler, uint32_t &output, std::thread::id &resumed_on) -> async::Task<> {
+    output = co_await scheduler.run_job([] { return 7u * 7u; });
+    resumed_on = std::this_thread::get_id();
+}
+
+} // namespace
+
+TEST_CASE("task does not start until awaited", "[task]") {
+    uint32_t counter = 0;
+    auto task = add_one(counter);
+    REQUIRE(counter == 0);
+    REQUIRE(!task.done());
+
+    task.resume();
+    REQUIRE(task.done());
+    REQUIRE(task.result() == 43);
+    REQUIRE(counter == 43);
+}
+
+TEST_CASE("next frame resumes once per tick", "[task]") {
+    job::System jobs{1};
+    async::Scheduler scheduler{jobs};
+
+    uint32_t frames = 0;
+    scheduler.spawn(count_frames(scheduler, frames));
+    REQUIRE(scheduler.pending() == 1);
+
+    scheduler.tick();
+    REQUIRE(frames == 0);
+
+    for (uint32_t i = 1; i <= 3; i++) {
+        scheduler.tick();
+        REQUIRE(frames == i);
+    }
+
+    REQUIRE(scheduler.pending() == 0);
+}
+
+TEST_CASE("job results resume on the ticking thread", "[task]") {
+    job::System jobs{2};
+    async::Scheduler scheduler{jobs};
+
+    uint32_t output = 0;
+    std::thread::id resumed_on{};
+    scheduler.spawn(square_on_job(scheduler, output, resumed_on));
+
+    while (scheduler.pending() > 0) {
+        scheduler.tick();
+        std::this_thread::yield();
+    }
+
+    REQUIRE(output == 49);
+    REQUIRE(resumed_on == std::this_thread::get_id());
+}
+
+TEST_CASE("frame pool reuses freed blocks", "[task]") {
+    void *first = async::FramePool::allocate(200);
+    async::FramePool::deallocate(first, 200);
+
+    void *second = async::FramePool::allocate(180);
+    REQUIRE(first == second);
+    async::FramePool::deallocate(second, 180);
+}
+
+} // namespace muon
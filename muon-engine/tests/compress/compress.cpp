@@ -0,0 +1,161 @@
+#include "muon/compress/compress.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace muon::compress {
+
+namespace {
+
+auto sample_text(size_t lines) -> std::string {
+    std::string text;
+    for (size_t i = 0; i < lines; i++) {
+        text += fmt::format("[{:06}] entity {} moved to ({}, {}, {})\n", i, i % 97, i * 0.5, i % 13, -static_cast<double>(i));
+    }
+    return text;
+}
+
+auto collect(std::vector<uint8_t> &output) -> Sink {
+    return [&output](BufferView chunk) { output.insert(output.end(), chunk.begin(), chunk.end()); };
+}
+
+} // namespace
+
+TEST_CASE("one shot compression round trips", "[compress]") {
+    Buffer source{sample_text(4096)};
+
+    auto zlib = Options{.codec = Codec::Zlib, .level = DEFAULT_ZLIB_LEVEL};
+    auto threaded = Options{.level = 1, .workers = 2};
+
+    for (auto options : {Options{}, zlib, threaded}) {
+        auto compressed = compress(source, options);
+        REQUIRE(compressed.has_value());
+        REQUIRE(compressed->size() < source.size() / 4);
+
+        auto decompressed = decompress(*compressed, options.codec);
+        REQUIRE(decompressed.has_value());
+        REQUIRE(*decompressed == source);
+    }
+
+    REQUIRE(compress(source, {.level = 100}).error() == CompressError::InvalidOptions);
+    REQUIRE(compress(source, {.codec = Codec::Zlib, .level = 6, .workers = 2}).error() == CompressError::InvalidOptions);
+}
+
+TEST_CASE("frame headers claiming huge sizes are not trusted", "[compress]") {
+    // a frame declaring a terabyte of content that holds a single five byte raw block
+    std::vector<uint8_t> frame{0x28, 0xb5, 0x2f, 0xfd, 0xc0, 0x00, 0, 0, 0, 0, 0, 0x01, 0, 0, 0x29, 0, 0, 'h', 'e', 'l', 'l', 'o'};
+    REQUIRE(decompress(BufferView{frame.data(), frame.size()}).error() == CompressError::CorruptData);
+
+    // the same frame with an honest size still decodes in one go
+    frame[11] = 0;
+    frame[6] = 5;
+    auto decompressed = decompress(BufferView{frame.data(), frame.size()});
+    REQUIRE(decompressed.has_value());
+    REQUIRE(*decompressed == Buffer{"hello"});
+}
+
+TEST_CASE("decompression writes into caller buffers", "[compress]") {
+    Buffer source{sample_text(512)};
+
+    for (auto codec : {Codec::Zstd, Codec::Zlib}) {
+        Options options{.codec = codec, .level = 3};
+        std::vector<uint8_t> compressed(compress_bound(source.size(), codec));
+        auto written = compress_into(source, compressed, options);
+        REQUIRE(written.has_value());
+
+        std::vector<uint8_t> output(source.size());
+        auto size = decompress_into({compressed.data(), *written}, output, codec);
+        REQUIRE(size == source.size());
+        REQUIRE(BufferView{output.data(), output.size()} == BufferView{source});
+
+        std::vector<uint8_t> small(source.size() / 2);
+        REQUIRE(decompress_into({compressed.data(), *written}, small, codec).error() == CompressError::DestinationTooSmall);
+
+        std::vector<uint8_t> tiny(8);
+        REQUIRE(compress_into(source, tiny, options).error() == CompressError::DestinationTooSmall);
+    }
+
+    Buffer garbage{std::string_view{"definitely not compressed"}};
+    REQUIRE_FALSE(decompress(garbage).has_value());
+    REQUIRE_FALSE(decompress(garbage, Codec::Zlib).has_value());
+}
+
+TEST_CASE("streaming compression round trips", "[compress]") {
+    auto text = sample_text(8192);
+
+    for (auto codec : {Codec::Zstd, Codec::Zlib}) {
+        std::vector<uint8_t> compressed;
+        Compressor compressor{{.codec = codec, .level = 3}};
+        for (size_t offset = 0; offset < text.size(); offset += 1000) {
+            auto length = std::min<size_t>(1000, text.size() - offset);
+            REQUIRE(compressor.write({reinterpret_cast<const uint8_t *>(text.data() + offset), length}, collect(compressed)));
+        }
+        REQUIRE(compressor.finish(collect(compressed)));
+
+        // streamed frames carry no size up front
+        auto whole = decompress({compressed.data(), compressed.size()}, codec);
+        REQUIRE(whole.has_value());
+        REQUIRE(std::string_view{reinterpret_cast<const char *>(whole->data()), whole->size()} == text);
+
+        std::vector<uint8_t> output;
+        Decompressor decompressor{codec};
+        for (size_t offset = 0; offset < compressed.size(); offset += 7) {
+            REQUIRE_FALSE(decompressor.finished());
+            auto length = std::min<size_t>(7, compressed.size() - offset);
+            REQUIRE(decompressor.write({compressed.data() + offset, length}, collect(output)));
+        }
+        REQUIRE(decompressor.finished());
+        REQUIRE(std::string_view{reinterpret_cast<const char *>(output.data()), output.size()} == text);
+
+        auto truncated = decompress({compressed.data(), compressed.size() / 2}, codec);
+        REQUIRE(truncated.error() == CompressError::Truncated);
+    }
+}
+
+TEST_CASE("dictionaries shrink small payloads", "[compress]") {
+    std::vector<Buffer> payloads;
+    for (size_t i = 0; i < 256; i++) {
+        payloads.emplace_back(fmt::format(
+            R"({{"id": {}, "material": "materials/surface_{}.mat", "shader": "shaders/lit.spv", "flags": ["cast_shadows", )"
+            R"("receive_shadows"], "tint": [{}, 1.0, 1.0, 1.0]}})",
+            i, i % 17, i * 0.01
+        ));
+    }
+    std::vector<BufferView> samples(payloads.begin(), payloads.end());
+
+    auto dictionary = Dictionary::train(samples, 4096);
+    REQUIRE(dictionary.has_value());
+    REQUIRE(dictionary->id() != 0);
+
+    size_t plain = 0;
+    size_t trained = 0;
+    for (const auto &payload : payloads) {
+        plain += compress(payload)->size();
+
+        auto compressed = compress(payload, *dictionary);
+        REQUIRE(compressed.has_value());
+        trained += compressed->size();
+        REQUIRE(decompress(*compressed, *dictionary) == payload);
+    }
+    REQUIRE(trained * 2 < plain);
+
+    auto compressed = compress(payloads[0], *dictionary);
+    REQUIRE(decompress(*compressed).error() == CompressError::DictionaryMismatch);
+
+    std::vector<uint8_t> streamed;
+    Compressor compressor{*dictionary};
+    REQUIRE(compressor.write(payloads[1], collect(streamed)));
+    REQUIRE(compressor.finish(collect(streamed)));
+    REQUIRE(decompress({streamed.data(), streamed.size()}, *dictionary) == payloads[1]);
+
+    REQUIRE(Dictionary::train(std::span<const BufferView>{samples}.first(2)).error() == CompressError::TrainingFailure);
+}
+
+} // namespace muon::compress
@@ -0,0 +1,110 @@
+#include "muon/compress/seekable.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "fmt/format.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace muon::compress {
+
+namespace {
+
+auto sample_text(size_t lines) -> std::string {
+    std::string text;
+    for (size_t i = 0; i < lines; i++) {
+        text += fmt::format("frame {:08} input {} state {}\n", i, i % 7, i * 31);
+    }
+    return text;
+}
+
+auto as_text(BufferView view) -> std::string_view {
+    return {reinterpret_cast<const char *>(view.data()), view.size()};
+}
+
+} // namespace
+
+TEST_CASE("seekable archives read arbitrary ranges", "[compress][seekable]") {
+    auto text = sample_text(20000);
+    Buffer source{text};
+    job::System jobs{3};
+
+    auto archive = compress_seekable(source, {.level = 3, .frame_size = 4096}, &jobs);
+    REQUIRE(archive.has_value());
+
+    // plain zstd skips the jump table
+    REQUIRE(as_text(*decompress(*archive)) == text);
+
+    auto reader = SeekableReader::open(*archive);
+    REQUIRE(reader.has_value());
+    REQUIRE(reader->size() == text.size());
+    REQUIRE(reader->frame_count() == (text.size() + 4095) / 4096);
+
+    auto ranges = {std::pair<size_t, size_t>{0, 10}, {4090, 12}, {4096, 4096}, {1000, 50000}, {text.size() - 5, 5}};
+    for (auto [offset, size] : ranges) {
+        auto serial = reader->read(offset, size);
+        REQUIRE(serial.has_value());
+        REQUIRE(as_text(*serial) == text.substr(offset, size));
+
+        auto parallel = reader->read(offset, size, &jobs);
+        REQUIRE(parallel == serial);
+    }
+
+    REQUIRE(reader->read(0, text.size() * 2, &jobs).value().size() == text.size());
+    REQUIRE(reader->read(text.size(), 10)->size() == 0);
+    REQUIRE(reader->read(text.size() + 1, 10).error() == CompressError::OutOfRange);
+}
+
+TEST_CASE("seekable writer streams frames", "[compress][seekable]") {
+    auto text = sample_text(5000);
+
+    std::vector<uint8_t> archive;
+    auto sink = [&archive](BufferView chunk) { archive.insert(archive.end(), chunk.begin(), chunk.end()); };
+    SeekableWriter writer{{.level = 1, .frame_size = 1000}};
+    for (size_t offset = 0; offset < text.size(); offset += 333) {
+        auto line = std::string_view{text}.substr(offset, 333);
+        REQUIRE(writer.write({reinterpret_cast<const uint8_t *>(line.data()), line.size()}, sink));
+    }
+    REQUIRE(writer.finish(sink));
+
+    auto reader = SeekableReader::open({archive.data(), archive.size()});
+    REQUIRE(reader.has_value());
+    REQUIRE(reader->frame_count() == (text.size() + 999) / 1000);
+    REQUIRE(as_text(*reader->read(2500, 3000)) == text.substr(2500, 3000));
+}
+
+TEST_CASE("seekable archives reject damaged tables", "[compress][seekable]") {
+    Buffer source{sample_text(1000)};
+    auto archive = compress_seekable(source, {.frame_size = 1024});
+    REQUIRE(archive.has_value());
+
+    REQUIRE(SeekableReader::open(BufferView{archive->data(), 4}).error() == CompressError::InvalidSeekTable);
+    REQUIRE(SeekableReader::open(BufferView{archive->data(), archive->size() - 1}).error() == CompressError::InvalidSeekTable);
+
+    auto damaged = *archive;
+    damaged.data()[damaged.size() - 9] ^= 1;
+    REQUIRE(SeekableReader::open(damaged).error() == CompressError::InvalidSeekTable);
+
+    auto corrupt = *archive;
+    corrupt.data()[6] ^= 0xff;
+    auto reader = SeekableReader::open(corrupt);
+    REQUIRE(reader.has_value());
+    REQUIRE_FALSE(reader->read(0, 100).has_value());
+
+    REQUIRE(compress_seekable(source, {.frame_size = 0}).error() == CompressError::InvalidOptions);
+
+    // a table claiming a huge frame is never trusted for an allocation, the frame itself gives it away
+    auto inflated = *archive;
+    size_t entry_size = (inflated.data()[inflated.size() - 5] & 0x80) ? 12 : 8;
+    auto *first_entry = inflated.data() + inflated.size() - SEEK_TABLE_FOOTER_SIZE - reader->frame_count() * entry_size;
+    std::memset(first_entry + 4, 0xff, 4);
+    auto inflated_reader = SeekableReader::open(inflated);
+    REQUIRE(inflated_reader.has_value());
+    REQUIRE(inflated_reader->read(10, 100).error() == CompressError::CorruptData);
+}
+
+} // namespace muon::compress
@@ -0,0 +1,189 @@
+#include "muon/core/async_sink.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "fmt/format.h"
+#include "spdlog/logger.h"
+#include "spdlog/sinks/base_sink.h"
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace muon::log {
+
+namespace {
+
+class CollectingSink final : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    auto lines() -> std::vector<std::string> {
+        std::lock_guard lock{mutex_};
+        return lines_;
+    }
+
+    auto flushed_lines() -> size_t {
+        std::lock_guard lock{mutex_};
+        return flushed_;
+    }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg &message) override {
+        lines_.emplace_back(message.payload.data(), message.payload.size());
+    }
+
+    void flush_() override { flushed_ = lines_.size(); }
+
+private:
+    std::vector<std::string> lines_;
+    size_t flushed_{0};
+};
+
+auto make_sink(std::shared_ptr<CollectingSink> &collected, size_t slots, OverflowPolicy overflow) -> std::shared_ptr<AsyncSink> {
+    collected = std::make_shared<CollectingSink>();
+    return std::make_shared<AsyncSink>(std::vector<spdlog::sink_ptr>{collected}, slots, overflow, std::chrono::hours{1});
+}
+
+} // namespace
+
+TEST_CASE("async sink keeps records in order across threads", "[async_sink]") {
+    constexpr uint32_t THREADS = 4;
+    constexpr uint32_t COUNT = 5000;
+
+    std::shared_ptr<CollectingSink> collected;
+    auto sink = make_sink(collected, 64, OverflowPolicy::Block);
+    sink->start();
+    spdlog::logger logger{"TEST", sink};
+
+    {
+        std::vector<std::jthread> producers;
+        for (uint32_t thread = 0; thread < THREADS; thread++) {
+            producers.emplace_back([&, thread] {
+                for (uint32_t i = 0; i < COUNT; i++) {
+                    // some records span several slots and wrap around the end of the ring
+                    logger.info("{} {} {}", thread, i, std::string(i % 300, 'x'));
+                }
+            });
+        }
+    }
+    sink->stop();
+
+    auto lines = collected->lines();
+    REQUIRE(lines.size() == THREADS * COUNT);
+
+    std::array<uint32_t, THREADS> next{};
+    for (const auto &line : lines) {
+        uint32_t thread = 0;
+        uint32_t index = 0;
+        auto parsed = std::from_chars(line.data(), line.data() + line.size(), thread);
+        std::from_chars(parsed.ptr + 1, line.data() + line.size(), index);
+        REQUIRE(index == next[thread]);
+        REQUIRE(line == fmt::format("{} {} {}", thread, index, std::string(index % 300, 'x')));
+        next[thread] += 1;
+    }
+}
+
+TEST_CASE("async sink blocks until the writer makes room", "[async_sink]") {
+    std::shared_ptr<CollectingSink> collected;
+    auto sink = make_sink(collected, 16, OverflowPolicy::Block);
+    spdlog::logger logger{"TEST", sink};
+
+    // short records take one slot each, the writer isn't running yet so the ring fills up
+    for (int32_t i = 0; i < 16; i++) {
+        logger.info("{}", i);
+    }
+
+    std::atomic<bool> finished{false};
+    std::jthread producer{[&] {
+        for (int32_t i = 16; i < 100; i++) {
+            logger.info("{}", i);
+        }
+        finished.store(true);
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    REQUIRE_FALSE(finished.load());
+
+    sink->start();
+    producer.join();
+    sink->stop();
+
+    auto lines = collected->lines();
+    REQUIRE(lines.size() == 100);
+    for (int32_t i = 0; i < 100; i++) {
+        REQUIRE(lines[i] == std::to_string(i));
+    }
+}
+
+TEST_CASE("async sink drops new records when full", "[async_sink]") {
+    std::shared_ptr<CollectingSink> collected;
+    auto sink = make_sink(collected, 16, OverflowPolicy::Drop);
+    spdlog::logger logger{"TEST", sink};
+
+    for (int32_t i = 0; i < 20; i++) {
+        logger.info("{}", i);
+    }
+    // a record bigger than the whole ring never fits
+    logger.info("{}", std::string(16 * AsyncSink::SLOT_SIZE, 'x'));
+    sink->start();
+    sink->stop();
+
+    auto lines = collected->lines();
+    REQUIRE(lines.size() == 17);
+    for (int32_t i = 0; i < 16; i++) {
+        REQUIRE(lines[i] == std::to_string(i));
+    }
+    REQUIRE(lines[16] == "async log dropped 5 records, the queue was full");
+}
+
+TEST_CASE("async sink overwrites the oldest records when full", "[async_sink]") {
+    std::shared_ptr<CollectingSink> collected;
+    auto sink = make_sink(collected, 16, OverflowPolicy::Overwrite);
+    spdlog::logger logger{"TEST", sink};
+
+    for (int32_t i = 0; i < 20; i++) {
+        logger.info("{}", i);
+    }
+    // takes two slots, so the two oldest go
+    logger.info("{}", std::string(AsyncSink::SLOT_SIZE, 'x'));
+    sink->start();
+    sink->stop();
+
+    auto lines = collected->lines();
+    REQUIRE(lines.size() == 16);
+    for (int32_t i = 0; i < 14; i++) {
+        REQUIRE(lines[i] == std::to_string(i + 6));
+    }
+    REQUIRE(lines[14] == std::string(AsyncSink::SLOT_SIZE, 'x'));
+    REQUIRE(lines[15] == "async log overwrote the 6 oldest records, the queue was full");
+}
+
+TEST_CASE("async sink writes and flushes everything on stop and drain", "[async_sink]") {
+    std::shared_ptr<CollectingSink> collected;
+    auto sink = make_sink(collected, 256, OverflowPolicy::Block);
+    spdlog::logger logger{"TEST", sink};
+    sink->start();
+
+    // the flush interval is an hour, so only the drain gets these out
+    for (int32_t i = 0; i < 100; i++) {
+        logger.info("{}", i);
+    }
+    REQUIRE(sink->drain(std::chrono::seconds{5}));
+    REQUIRE(collected->flushed_lines() == 100);
+
+    for (int32_t i = 100; i < 1000; i++) {
+        logger.info("{}", i);
+    }
+    sink->stop();
+    REQUIRE(collected->flushed_lines() == 1000);
+
+    // once stopped records go straight through
+    logger.info("after");
+    REQUIRE(collected->lines().back() == "after");
+}
+
+} // namespace muon::log
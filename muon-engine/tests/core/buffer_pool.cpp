@@ -0,0 +1,69 @@
+#include "muon/core/buffer_pool.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <utility>
+
+namespace muon {
+
+TEST_CASE("buffer pool sizes fall into classes", "[core][buffer_pool]") {
+    REQUIRE(BufferPool::size_class(1) == 64);
+    REQUIRE(BufferPool::size_class(64) == 64);
+    REQUIRE(BufferPool::size_class(65) == 128);
+    REQUIRE(BufferPool::size_class(1000) == 1024);
+    REQUIRE(BufferPool::size_class(4096) == 4096);
+    REQUIRE(BufferPool::size_class(4097) == 4608);
+
+    for (size_t size : {100uz, 5000uz, 1000000uz, 4000000uz}) {
+        auto size_class = BufferPool::size_class(size);
+        REQUIRE(size_class >= size);
+        REQUIRE(size_class - size <= size / 8 + 64);
+        REQUIRE(BufferPool::size_class(size_class) == size_class);
+    }
+}
+
+TEST_CASE("buffer pool hands out aligned buffers and reuses them", "[core][buffer_pool]") {
+    BufferPool pool{256};
+
+    auto buffer = pool.acquire(3000);
+    REQUIRE(buffer.size() == BufferPool::size_class(3000));
+    REQUIRE(buffer.alignment() == 256);
+    REQUIRE(reinterpret_cast<uintptr_t>(buffer.data()) % 256 == 0);
+
+    auto *data = buffer.data();
+    pool.release(std::move(buffer));
+    REQUIRE(pool.cached_bytes() == BufferPool::size_class(3000));
+
+    // anything in the same class gets the same memory back
+    auto reused = pool.acquire(2900);
+    REQUIRE(reused.data() == data);
+    REQUIRE(pool.cached_bytes() == 0);
+
+    // copies keep the alignment so they can go back to the pool too
+    Buffer copy = reused;
+    REQUIRE(copy.alignment() == 256);
+    REQUIRE(reinterpret_cast<uintptr_t>(copy.data()) % 256 == 0);
+    pool.release(std::move(copy));
+    pool.release(std::move(reused));
+    REQUIRE(pool.cached_bytes() == 2 * BufferPool::size_class(3000));
+
+    pool.clear();
+    REQUIRE(pool.cached_bytes() == 0);
+}
+
+TEST_CASE("buffer pool only keeps what fits", "[core][buffer_pool]") {
+    BufferPool pool{64, 4096};
+
+    // not a class size, or not aligned enough for the pool
+    pool.release(Buffer{100});
+    pool.release(Buffer{4096, std::align_val_t{16}});
+    REQUIRE(pool.cached_bytes() == 0);
+
+    pool.release(pool.acquire(4096));
+    REQUIRE(pool.cached_bytes() == 4096);
+    pool.release(pool.acquire(64));
+    REQUIRE(pool.cached_bytes() == 4096);
+}
+
+} // namespace muon
@@ -0,0 +1,182 @@
+#include "muon/core/deferred_log.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace muon::log {
+
+namespace {
+
+enum class Colour : uint8_t { Red = 3 };
+
+template <typename... Args>
+auto round_trip(const char *text, const Args &...args) -> std::string {
+    Format format;
+    format.format = text;
+    format.args.assign(internal::ARG_TYPES<Args...>.begin(), internal::ARG_TYPES<Args...>.end());
+
+    std::vector<std::byte> payload((size_t{0} + ... + internal::encoded_size(args)));
+    auto *out = payload.data();
+    (internal::encode(out, args), ...);
+    REQUIRE(out == payload.data() + payload.size());
+
+    return format_record(format, payload);
+}
+
+// records a single u32 so that the order can be checked on the way out
+auto write_record(internal::ThreadBuffer &buffer, uint32_t value) -> bool {
+    auto *out = buffer.reserve(internal::record_size(sizeof(value)));
+    if (!out) {
+        return false;
+    }
+    internal::RecordHeader header{.format = 1, .size = sizeof(value), .time = 0};
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + sizeof(header), &value, sizeof(value));
+    buffer.commit();
+    return true;
+}
+
+auto read_records(internal::ThreadBuffer &buffer) -> std::vector<uint32_t> {
+    std::vector<uint32_t> values;
+    buffer.consume([&](const internal::RecordHeader &header, std::span<const std::byte> payload) {
+        REQUIRE(header.size == sizeof(uint32_t));
+        std::memcpy(&values.emplace_back(), payload.data(), sizeof(uint32_t));
+    });
+    return values;
+}
+
+} // namespace
+
+TEST_CASE("deferred records format like the call site", "[deferred_log]") {
+    std::string name{"muon"};
+    REQUIRE(round_trip("no arguments") == "no arguments");
+    REQUIRE(round_trip("{} {} {}", int8_t{-4}, uint16_t{9}, int64_t{-1} << 40) == "-4 9 -1099511627776");
+    REQUIRE(round_trip("{:.2f} {}", 1.5f, 0.25) == "1.50 0.25");
+    REQUIRE(round_trip("{} {} {}", true, 'x', Colour::Red) == "true x 3");
+    REQUIRE(round_trip("{} {} {}", "literal", name, std::string_view{"view"}) == "literal muon view");
+}
+
+TEST_CASE("deferred records encode argument types", "[deferred_log]") {
+    REQUIRE(internal::arg_type<int16_t>() == ArgType::I32);
+    REQUIRE(internal::arg_type<uint64_t>() == ArgType::U64);
+    REQUIRE(internal::arg_type<const char *>() == ArgType::String);
+    REQUIRE(internal::arg_type<const int *>() == ArgType::Pointer);
+    REQUIRE(internal::encoded_size(std::string_view{"abc"}) == sizeof(uint32_t) + 3);
+}
+
+TEST_CASE("truncated deferred records are reported", "[deferred_log]") {
+    Format format;
+    format.format = "{} {}";
+    format.args = {ArgType::U64, ArgType::U64};
+    std::vector<std::byte> payload(12);
+    REQUIRE(format_record(format, payload) == "{} {} [truncated record]");
+}
+
+TEST_CASE("thread buffers skip the tail end when a record would wrap", "[deferred_log]") {
+    // 24 byte records in 128 bytes, once four have been read the fifth still fits before the end and the sixth has to
+    // start over at the front
+    internal::ThreadBuffer buffer{0, 128};
+    REQUIRE(internal::record_size(sizeof(uint32_t)) == 24);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        REQUIRE(write_record(buffer, i));
+    }
+    REQUIRE(read_records(buffer) == std::vector<uint32_t>{0, 1, 2, 3});
+
+    for (uint32_t i = 4; i < 9; i++) {
+        REQUIRE(write_record(buffer, i));
+    }
+    REQUIRE(read_records(buffer) == std::vector<uint32_t>{4, 5, 6, 7, 8});
+    REQUIRE(buffer.take_dropped() == 0);
+}
+
+TEST_CASE("full thread buffers drop and count records", "[deferred_log]") {
+    internal::ThreadBuffer buffer{0, 128};
+    for (uint32_t i = 0; i < 5; i++) {
+        REQUIRE(write_record(buffer, i));
+    }
+    REQUIRE_FALSE(write_record(buffer, 5));
+    REQUIRE_FALSE(write_record(buffer, 6));
+    REQUIRE(buffer.reserve(256) == nullptr);
+    REQUIRE(buffer.take_dropped() == 3);
+    REQUIRE(buffer.take_dropped() == 0);
+
+    // nothing already written is lost, and space comes back once the writer catches up
+    REQUIRE(read_records(buffer) == std::vector<uint32_t>{0, 1, 2, 3, 4});
+    REQUIRE(write_record(buffer, 7));
+    REQUIRE(read_records(buffer) == std::vector<uint32_t>{7});
+}
+
+TEST_CASE("the writer thread drains records into a binary log", "[deferred_log]") {
+    constexpr uint32_t BURSTS = 100;
+    constexpr uint32_t BURST = 100;
+    constexpr uint32_t COUNT = BURSTS * BURST + 5000;
+    auto path = std::filesystem::temp_directory_path() / "muon_deferred_test.mulog";
+
+    Config config;
+    config.deferred = DeferredOutput::Binary;
+    config.binary_path = path;
+    // room for a little over a burst, so the buffer wraps many times and the last long run overflows it
+    config.thread_buffer_size = 4096;
+    internal::start_deferred(config);
+    REQUIRE(internal::deferred_enabled());
+
+    // a fresh thread gets a buffer of the configured size
+    std::jthread{[] {
+        uint32_t i = 0;
+        for (uint32_t burst = 0; burst < BURSTS; burst++) {
+            for (uint32_t end = i + BURST; i < end; i++) {
+                MU_WARN_DEFERRED("record {} from {}", i, "the test");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{2});
+        }
+        for (; i < COUNT; i++) {
+            MU_WARN_DEFERRED("record {} from {}", i, "the test");
+        }
+    }}.join();
+    internal::stop_deferred();
+    REQUIRE_FALSE(internal::deferred_enabled());
+
+    auto log = read_binary_log(path);
+    REQUIRE(log.has_value());
+    REQUIRE_FALSE(log->truncated);
+    REQUIRE(log->records.size() + log->dropped == COUNT);
+    // more came through than the buffer holds at once, so it wrapped
+    auto record_size = internal::record_size(internal::encoded_size(uint32_t{0}) + internal::encoded_size("the test"));
+    REQUIRE(log->records.size() > config.thread_buffer_size / record_size);
+
+    uint32_t previous = 0;
+    for (size_t i = 0; i < log->records.size(); i++) {
+        const auto &record = log->records[i];
+        REQUIRE(record.level == spdlog::level::warn);
+        REQUIRE(record.file.ends_with("deferred_log.cpp"));
+        REQUIRE(record.text.starts_with("record "));
+        REQUIRE(record.text.ends_with(" from the test"));
+        auto value = static_cast<uint32_t>(std::stoul(record.text.substr(7)));
+        REQUIRE((i == 0 || value > previous));
+        previous = value;
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("binary logs that aren't are rejected", "[deferred_log]") {
+    auto path = std::filesystem::temp_directory_path() / "muon_deferred_garbage.mulog";
+    {
+        std::ofstream file{path, std::ios::binary};
+        file << "definitely not a log";
+    }
+    REQUIRE(read_binary_log(path).error() == BinaryLogError::InvalidFormat);
+    std::filesystem::remove(path);
+    REQUIRE(read_binary_log(path).error() == BinaryLogError::FileOpenFailure);
+}
+
+} // namespace muon::log
@@ -0,0 +1,97 @@
+#include "muon/core/flight_recorder.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+namespace muon::log {
+
+TEST_CASE("flight recorder reads back records in order", "[flight_recorder]") {
+    auto path = std::filesystem::temp_directory_path() / "muon-flight-recorder-test";
+    REQUIRE(open_flight_recorder(path, 8));
+
+    record_log(spdlog::level::warn, "MUON", "first");
+    record_event("muon::event::WindowQuit");
+    record_frame(7, std::chrono::milliseconds{16});
+
+    auto dump = read_flight_recorder(path);
+    REQUIRE(dump);
+    REQUIRE_FALSE(dump->clean_exit);
+    REQUIRE(dump->records.size() == 3);
+
+    REQUIRE(dump->records[0].kind == FlightRecordKind::Log);
+    REQUIRE(dump->records[0].level == spdlog::level::warn);
+    REQUIRE(dump->records[0].source == "MUON");
+    REQUIRE(dump->records[0].text == "first");
+    REQUIRE(dump->records[1].kind == FlightRecordKind::Event);
+    REQUIRE(dump->records[1].text == "muon::event::WindowQuit");
+    REQUIRE(dump->records[2].kind == FlightRecordKind::Frame);
+    REQUIRE(dump->records[2].text == "frame 7 took 16.000 ms");
+
+    // the frame calibrated the tick rate, so timestamps come back as wall time
+    auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch());
+    for (const auto &record : dump->records) {
+        REQUIRE(std::chrono::abs(now - std::chrono::nanoseconds{record.time}) < std::chrono::seconds{10});
+    }
+
+    close_flight_recorder();
+    REQUIRE(read_flight_recorder(path)->clean_exit);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(std::filesystem::path{path} += ".prev");
+}
+
+TEST_CASE("flight recorder keeps the most recent records", "[flight_recorder]") {
+    auto path = std::filesystem::temp_directory_path() / "muon-flight-recorder-wrap-test";
+    REQUIRE(open_flight_recorder(path, 8));
+
+    for (int32_t i = 0; i < 20; i++) {
+        record_log(spdlog::level::info, "APP", std::to_string(i));
+    }
+    record_log(spdlog::level::info, "APP", std::string(200, 'x'));
+    close_flight_recorder();
+
+    auto dump = read_flight_recorder(path);
+    REQUIRE(dump);
+    REQUIRE(dump->records.size() == 8);
+    REQUIRE(dump->lost == 13);
+    REQUIRE(dump->records.front().text == "13");
+    REQUIRE(dump->records.back().text == std::string(FLIGHT_TEXT_SIZE, 'x'));
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(std::filesystem::path{path} += ".prev");
+}
+
+TEST_CASE("flight recorder can be reopened on another file", "[flight_recorder]") {
+    auto first = std::filesystem::temp_directory_path() / "muon-flight-recorder-first-test";
+    auto second = std::filesystem::temp_directory_path() / "muon-flight-recorder-second-test";
+
+    REQUIRE(open_flight_recorder(first, 8));
+    record_log(spdlog::level::info, "APP", "first");
+    REQUIRE(open_flight_recorder(second, 8));
+    record_log(spdlog::level::info, "APP", "second");
+    close_flight_recorder();
+
+    // nothing is recorded once closed
+    record_log(spdlog::level::info, "APP", "ignored");
+
+    auto first_dump = read_flight_recorder(first);
+    REQUIRE(first_dump);
+    REQUIRE(first_dump->clean_exit);
+    REQUIRE(first_dump->records.size() == 1);
+    REQUIRE(first_dump->records[0].text == "first");
+
+    auto second_dump = read_flight_recorder(second);
+    REQUIRE(second_dump);
+    REQUIRE(second_dump->records.size() == 1);
+    REQUIRE(second_dump->records[0].text == "second");
+
+    for (const auto &path : {first, second}) {
+        std::filesystem::remove(path);
+        std::filesystem::remove(std::filesystem::path{path} += ".prev");
+    }
+}
+
+} // namespace muon::log
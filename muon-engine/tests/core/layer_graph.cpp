@@ -0,0 +1,162 @@
+#include "muon/core/layer_graph.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "muon/core/layer.hpp"
+#include "muon/core/layer_stack.hpp"
+#include "muon/job/system.hpp"
+
+#include <atomic>
+#include <stdexcept>
+
+namespace muon {
+
+struct Transforms {};
+struct Physics {};
+
+class AccessLayer final : public Layer {
+public:
+    template <typename Fn>
+    AccessLayer(Fn &&declare) { declare(*this); }
+
+    void on_attach() override {}
+    void on_detach() override {}
+    void on_update() override {
+        updates += 1;
+        if (throws) {
+            throw std::runtime_error{"layer failed"};
+        }
+    }
+
+    template <typename Resource>
+    void declare_reads() { reads<Resource>(); }
+
+    template <typename Resource>
+    void declare_writes() { writes<Resource>(); }
+
+    void declare_after(const Layer *layer) { runs_after(layer); }
+
+    std::atomic<uint32_t> updates{0};
+    bool throws{false};
+};
+
+TEST_CASE("undeclared layers run one per level", "[layer_graph]") {
+    LayerStack stack;
+    stack.push_layer(new AccessLayer{[](auto &) {}});
+    stack.push_layer(new AccessLayer{[](auto &) {}});
+
+    LayerGraph graph;
+    graph.build(stack);
+
+    REQUIRE(graph.levels().size() == 2);
+}
+
+TEST_CASE("independent readers share a level", "[layer_graph]") {
+    LayerStack stack;
+    stack.push_layer(new AccessLayer{[](auto &layer) { layer.template declare_reads<Transforms>(); }});
+    stack.push_layer(new AccessLayer{[](auto &layer) { layer.template declare_reads<Transforms>(); }});
+    stack.push_layer(new AccessLayer{[](auto &layer) { layer.template declare_writes<Physics>(); }});
+
+    LayerGraph graph;
+    graph.build(stack);
+
+    REQUIRE(graph.levels().size() == 1);
+    REQUIRE(graph.levels().front().size() == 3);
+}
+
+TEST_CASE("writer orders after earlier reader", "[layer_graph]") {
+    LayerStack stack;
+    stack.push_layer(new AccessLayer{[](auto &layer) { layer.template declare_writes<Transforms>(); }});
+    stack.push_layer(new AccessLayer{[](auto &layer) { layer.template declare_reads<Transforms>(); }});
+    stack.push_layer(new AccessLayer{[](auto &layer) { layer.template declare_reads<Physics>(); }});
+
+    LayerGraph graph;
+    graph.build(stack);
+
+    REQUIRE(graph.levels().size() == 2);
+    REQUIRE(graph.levels()[0].size() == 2);
+    REQUIRE(graph.levels()[1].size() == 1);
+}
+
+TEST_CASE("explicit dependency orders layers", "[layer_graph]") {
+    LayerStack stack;
+    auto *first = new AccessLayer{[](auto &layer) { layer.template declare_reads<Physics>(); }};
+    auto *second = new AccessLayer{[&](auto &layer) { layer.declare_after(first); }};
+    stack.push_layer(first);
+    stack.push_layer(second);
+
+    LayerGraph graph;
+    graph.build(stack);
+
+    REQUIRE(graph.levels().size() == 2);
+    REQUIRE(graph.levels()[0].front() == first);
+    REQUIRE(graph.levels()[1].front() == second);
+}
+
+TEST_CASE("dependency cycle falls back to serial order", "[layer_graph]") {
+    LayerStack stack;
+    auto *first = new AccessLayer{[](auto &layer) { layer.template declare_reads<Physics>(); }};
+    auto *second = new AccessLayer{[&](auto &layer) { layer.declare_after(first); }};
+    first->declare_after(second);
+    stack.push_layer(first);
+    stack.push_layer(second);
+
+    LayerGraph graph;
+    graph.build(stack);
+
+    REQUIRE(graph.levels().size() == 2);
+}
+
+TEST_CASE("every layer updates once per execution", "[layer_graph]") {
+    LayerStack stack;
+    std::vector<AccessLayer *> layers;
+    for (size_t i = 0; i < 8; i++) {
+        auto *layer = new AccessLayer{[](auto &layer) { layer.template declare_reads<Transforms>(); }};
+        layers.emplace_back(layer);
+        stack.push_layer(layer);
+    }
+
+    job::System jobs{4};
+    LayerGraph graph;
+    graph.build(stack);
+    graph.execute(jobs);
+    graph.execute(jobs);
+
+    for (auto *layer : layers) {
+        REQUIRE(layer->updates == 2);
+    }
+}
+
+TEST_CASE("a throwing layer fails the execution without hanging it", "[layer_graph]") {
+    LayerStack stack;
+    std::vector<AccessLayer *> layers;
+    for (size_t i = 0; i < 4; i++) {
+        auto *layer = new AccessLayer{[](auto &layer) { layer.template declare_reads<Transforms>(); }};
+        layers.emplace_back(layer);
+        stack.push_layer(layer);
+    }
+
+    job::System jobs{2};
+    LayerGraph graph;
+    graph.build(stack);
+
+    SECTION("on a worker") { layers[2]->throws = true; }
+    SECTION("on the calling thread") { layers[0]->throws = true; }
+    SECTION("on both") {
+        layers[0]->throws = true;
+        layers[3]->throws = true;
+    }
+
+    REQUIRE_THROWS_AS(graph.execute(jobs), std::runtime_error);
+    for (auto *layer : layers) {
+        REQUIRE(layer->updates == 1);
+        layer->throws = false;
+    }
+
+    // the failure doesn't stick to the next execution
+    graph.execute(jobs);
+    for (auto *layer : layers) {
+        REQUIRE(layer->updates == 2);
+    }
+}
+
+} // namespace muon
@@ -0,0 +1,92 @@
+#include "muon/core/log.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <latch>
+#include <thread>
+#include <vector>
+
+namespace muon::log {
+
+TEST_CASE("category levels gate messages", "[log]") {
+    auto previous = level(Category::Fs);
+
+    set_level(Category::Fs, spdlog::level::warn);
+    REQUIRE_FALSE(should_log(Category::Fs, spdlog::level::info));
+    REQUIRE(should_log(Category::Fs, spdlog::level::err));
+
+    bool evaluated = false;
+    auto argument = [&] {
+        evaluated = true;
+        return 0;
+    };
+    MU_LOG_DEBUG(Fs, "{}", argument());
+    REQUIRE_FALSE(evaluated);
+
+    set_level(Category::Fs, previous);
+}
+
+TEST_CASE("category levels parse from a list", "[log]") {
+    auto previous_fs = level(Category::Fs);
+    auto previous_window = level(Category::Window);
+
+    REQUIRE(apply_levels("fs=error,window=trace"));
+    REQUIRE(level(Category::Fs) == spdlog::level::err);
+    REQUIRE(level(Category::Window) == spdlog::level::trace);
+
+    REQUIRE_FALSE(apply_levels("fs=loud,nothing=info,window"));
+    REQUIRE(level(Category::Fs) == spdlog::level::err);
+
+    set_level(Category::Fs, previous_fs);
+    set_level(Category::Window, previous_window);
+}
+
+TEST_CASE("rate limiter allows a fixed number of messages per second", "[log]") {
+    RateLimiter limiter{2};
+    auto start = std::chrono::steady_clock::time_point{std::chrono::seconds{100}};
+
+    REQUIRE(limiter.allow(start));
+    REQUIRE(limiter.allow(start + std::chrono::milliseconds{10}));
+    REQUIRE_FALSE(limiter.allow(start + std::chrono::milliseconds{20}));
+    REQUIRE(limiter.suppressed() == 1);
+
+    REQUIRE(limiter.allow(start + std::chrono::seconds{1}));
+}
+
+TEST_CASE("rate limiter holds its limit across threads at a second boundary", "[log]") {
+    constexpr uint32_t PER_SECOND = 50;
+    RateLimiter limiter{PER_SECOND};
+    auto start = std::chrono::steady_clock::time_point{std::chrono::seconds{100}};
+
+    for (auto now : {start, start + std::chrono::seconds{1}, start + std::chrono::seconds{2}}) {
+        std::atomic<uint32_t> allowed{0};
+        std::latch ready{8};
+        std::vector<std::jthread> threads;
+        for (int32_t t = 0; t < 8; t++) {
+            threads.emplace_back([&] {
+                ready.arrive_and_wait();
+                for (int32_t i = 0; i < 1000; i++) {
+                    allowed += limiter.allow(now) ? 1 : 0;
+                }
+            });
+        }
+        threads.clear();
+        REQUIRE(allowed == PER_SECOND);
+    }
+
+    // a late caller still on the previous second doesn't reopen it
+    REQUIRE_FALSE(limiter.allow(start + std::chrono::seconds{1}));
+}
+
+TEST_CASE("every n logs the first of every n calls", "[log]") {
+    uint32_t logged = 0;
+    auto count = [&] { return ++logged; };
+    for (int32_t i = 0; i < 10; i++) {
+        MU_LOG_EVERY_N(Core, spdlog::level::critical, 4, "{}", count());
+    }
+    REQUIRE(logged == 3);
+}
+
+} // namespace muon::log
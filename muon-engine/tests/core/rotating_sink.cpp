@@ -0,0 +1,79 @@
+#include "muon/core/rotating_sink.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "spdlog/logger.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace muon::log {
+
+namespace {
+
+auto archives(const std::filesystem::path &directory) -> std::vector<std::filesystem::path> {
+    std::vector<std::filesystem::path> paths;
+    for (const auto &entry : std::filesystem::directory_iterator{directory}) {
+        paths.push_back(entry.path());
+    }
+    return paths;
+}
+
+} // namespace
+
+TEST_CASE("rotating sink compresses rotated segments", "[rotating_sink]") {
+    auto directory = std::filesystem::temp_directory_path() / "muon-rotating-sink";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    RotationOptions options{.max_size = 4096, .disk_budget = 0, .archive_directory = directory / "archive"};
+    {
+        auto sink = std::make_shared<RotatingSink>(directory / "test.log", options);
+        spdlog::logger logger{"rotating", sink};
+        logger.set_pattern("%v");
+        for (int32_t i = 0; i < 1000; i++) {
+            logger.info("line {} of a log that will not fit in one segment", i);
+        }
+    }
+
+    auto rotated = archives(options.archive_directory);
+    REQUIRE(rotated.size() > 1);
+    for (const auto &path : rotated) {
+        REQUIRE(path.extension() == ".zst");
+        REQUIRE(std::filesystem::file_size(path) < options.max_size);
+    }
+    REQUIRE(std::filesystem::file_size(directory / "test.log") <= options.max_size);
+
+    // the next run archives the previous file instead of truncating it
+    { RotatingSink sink{directory / "test.log", options}; }
+    REQUIRE(archives(options.archive_directory).size() == rotated.size() + 1);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("rotating sink keeps archives within the disk budget", "[rotating_sink]") {
+    auto directory = std::filesystem::temp_directory_path() / "muon-rotating-sink-budget";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    RotationOptions options{.max_size = 4096, .disk_budget = 6000, .archive_directory = directory / "archive"};
+    {
+        auto sink = std::make_shared<RotatingSink>(directory / "test.log", options);
+        spdlog::logger logger{"rotating", sink};
+        logger.set_pattern("%v");
+        for (int32_t i = 0; i < 5000; i++) {
+            logger.info("{:08x} {:08x} {:08x}", i * 2654435761u, i * 40503u, i * 97u);
+        }
+    }
+
+    uint64_t total = 0;
+    for (const auto &path : archives(options.archive_directory)) {
+        total += std::filesystem::file_size(path);
+    }
+    REQUIRE(total <= options.disk_budget);
+
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace muon::log
@@ -0,0 +1,50 @@
+#include "muon/core/synthetic_event_source.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "muon/event/dispatcher.hpp"
+#include "muon/event/event.hpp"
+
+#include <cstdint>
+
+namespace muon {
+
+TEST_CASE("scheduled events dispatch on their frame", "[synthetic_event_source]") {
+    event::Dispatcher dispatcher;
+    SyntheticEventSource source{dispatcher, std::nullopt};
+
+    std::vector<uint64_t> focus_frames;
+    auto handle = dispatcher.subscribe<event::WindowFocus>([&](const auto &) { focus_frames.emplace_back(source.frame()); });
+
+    source.schedule(1, event::WindowFocus{true});
+    source.schedule(3, event::WindowFocus{false});
+    source.schedule(3, event::WindowFocus{true});
+
+    for (uint32_t i = 0; i < 5; i++) {
+        source.poll_events();
+    }
+
+    REQUIRE(focus_frames == std::vector<uint64_t>{1, 3, 3});
+    REQUIRE(dispatcher.unsubscribe<event::WindowFocus>(handle));
+}
+
+TEST_CASE("frame limit dispatches quit on the last frame", "[synthetic_event_source]") {
+    event::Dispatcher dispatcher;
+    SyntheticEventSource source{dispatcher, 3};
+
+    uint64_t quit_frame = 0;
+    uint32_t quit_count = 0;
+    auto handle = dispatcher.subscribe<event::WindowQuit>([&](const auto &) {
+        quit_frame = source.frame();
+        quit_count += 1;
+    });
+
+    for (uint32_t i = 0; i < 3; i++) {
+        source.poll_events();
+    }
+
+    REQUIRE(quit_count == 1);
+    REQUIRE(quit_frame == 2);
+    REQUIRE(dispatcher.unsubscribe<event::WindowQuit>(handle));
+}
+
+} // namespace muon
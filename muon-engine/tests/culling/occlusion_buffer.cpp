@@ -0,0 +1,167 @@
+#include "muon/culling/occlusion_buffer.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace muon::culling {
+
+namespace {
+
+auto camera() -> glm::mat4 {
+    auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+    auto view = glm::lookAt(glm::vec3{0.0f}, glm::vec3{0.0f, 0.0f, -1.0f}, glm::vec3{0.0f, 1.0f, 0.0f});
+    return projection * view;
+}
+
+auto quad(float size) -> std::array<glm::vec3, 4> {
+    return {glm::vec3{-size, -size, 0.0f}, glm::vec3{size, -size, 0.0f}, glm::vec3{size, size, 0.0f}, glm::vec3{-size, size, 0.0f}};
+}
+
+constexpr std::array<uint32_t, 6> QUAD_INDICES{0, 1, 2, 0, 2, 3};
+
+auto cube(const glm::vec3 &center, float extent) -> maths::Aabb {
+    return maths::Aabb::from_center(center, glm::vec3{extent});
+}
+
+// normalised device depth in [0, 1] for a depth in clip space
+auto device_depth(float z) -> float {
+#if defined(GLM_FORCE_DEPTH_ZERO_TO_ONE)
+    return z;
+#else
+    return z * 0.5f + 0.5f;
+#endif
+}
+
+} // namespace
+
+TEST_CASE("a wall hides what is behind it", "[culling][occlusion]") {
+    OcclusionBuffer buffer;
+    REQUIRE(buffer.width() == 256);
+    REQUIRE(buffer.height() == 144);
+
+    buffer.clear(camera());
+    auto wall = quad(3.0f);
+    buffer.render(glm::translate(glm::mat4{1.0f}, glm::vec3{0.0f, 0.0f, -10.0f}), wall, QUAD_INDICES);
+
+    REQUIRE(!buffer.is_visible(cube({0.0f, 0.0f, -20.0f}, 1.0f)));
+    REQUIRE(!buffer.is_visible(cube({1.5f, -1.5f, -40.0f}, 2.0f)));
+    REQUIRE(buffer.is_visible(cube({0.0f, 0.0f, -5.0f}, 1.0f)));
+    // in front of the wall at its far edge, and peeking out from behind it
+    REQUIRE(buffer.is_visible(cube({0.0f, 0.0f, -10.5f}, 1.0f)));
+    REQUIRE(buffer.is_visible(cube({8.0f, 0.0f, -20.0f}, 1.0f)));
+    // nothing behind the camera can be ruled out, nothing outside the screen is visible
+    REQUIRE(buffer.is_visible(cube({0.0f, 0.0f, 0.0f}, 1.0f)));
+    REQUIRE(!buffer.is_visible(cube({0.0f, 500.0f, -20.0f}, 1.0f)));
+
+    // the winding doesn't matter
+    buffer.clear(camera());
+    std::array<uint32_t, 6> reversed{0, 2, 1, 0, 3, 2};
+    buffer.render(glm::translate(glm::mat4{1.0f}, glm::vec3{0.0f, 0.0f, -10.0f}), wall, reversed);
+    REQUIRE(!buffer.is_visible(cube({0.0f, 0.0f, -20.0f}, 1.0f)));
+
+    buffer.clear(camera());
+    REQUIRE(buffer.is_visible(cube({0.0f, 0.0f, -20.0f}, 1.0f)));
+}
+
+TEST_CASE("occluders crossing the near plane are clipped", "[culling][occlusion]") {
+    OcclusionBuffer buffer;
+    buffer.clear(camera());
+
+    // a floor running from behind the camera into the distance
+    std::array<glm::vec3, 4> floor{
+        glm::vec3{-100.0f, -1.0f, 10.0f}, glm::vec3{100.0f, -1.0f, 10.0f}, glm::vec3{100.0f, -1.0f, -150.0f},
+        glm::vec3{-100.0f, -1.0f, -150.0f}
+    };
+    buffer.render(glm::mat4{1.0f}, floor, QUAD_INDICES);
+
+    REQUIRE(!buffer.is_visible(cube({0.0f, -6.0f, -30.0f}, 1.0f)));
+    REQUIRE(!buffer.is_visible(cube({-10.0f, -5.0f, -40.0f}, 1.5f)));
+    REQUIRE(buffer.is_visible(cube({0.0f, 1.0f, -30.0f}, 1.0f)));
+    // resting on the floor
+    REQUIRE(buffer.is_visible(cube({0.0f, 0.0f, -30.0f}, 1.0f)));
+}
+
+TEST_CASE("culling keeps the visible indices in order", "[culling][occlusion]") {
+    OcclusionBuffer buffer;
+    buffer.clear(camera());
+    auto wall = quad(3.0f);
+    buffer.render(glm::translate(glm::mat4{1.0f}, glm::vec3{0.0f, 0.0f, -10.0f}), wall, QUAD_INDICES);
+
+    std::vector<maths::Aabb> boxes{
+        cube({0.0f, 0.0f, -20.0f}, 1.0f), cube({8.0f, 0.0f, -20.0f}, 1.0f), cube({0.0f, 0.0f, -5.0f}, 1.0f),
+        cube({-1.0f, 1.0f, -30.0f}, 1.0f), cube({-8.0f, 0.0f, -20.0f}, 1.0f)
+    };
+    std::array<std::vector<float>, 6> columns;
+    for (const auto &box : boxes) {
+        for (int axis = 0; axis < 3; axis++) {
+            columns[axis].push_back(box.min[axis]);
+            columns[axis + 3].push_back(box.max[axis]);
+        }
+    }
+    maths::AabbSoa<const float> soa{{columns[0], columns[1], columns[2]}, {columns[3], columns[4], columns[5]}};
+
+    std::vector<uint32_t> visible{0, 1, 2, 3, 4};
+    buffer.cull(soa, visible);
+    REQUIRE(visible == std::vector<uint32_t>{1, 2, 4});
+}
+
+TEST_CASE("resolved depth never lies in front of an occluder", "[culling][occlusion]") {
+    // clip space vertices straight through, so pixel centres can be checked against the triangles directly
+    OcclusionBuffer buffer{64, 48};
+    buffer.clear(glm::mat4{1.0f});
+
+    std::mt19937 random{5};
+    std::uniform_real_distribution<float> position{-1.2f, 1.2f};
+    std::uniform_real_distribution<float> depth{0.0f, 1.0f};
+    std::vector<glm::vec3> vertices;
+    for (int i = 0; i < 40 * 3; i++) {
+        vertices.push_back({position(random), position(random), depth(random)});
+    }
+    std::vector<uint32_t> indices(vertices.size());
+    for (uint32_t i = 0; i < indices.size(); i++) {
+        indices[i] = i;
+    }
+    buffer.render(glm::mat4{1.0f}, vertices, indices);
+
+    auto resolved = buffer.resolve();
+    REQUIRE(resolved.size() == 64 * 48);
+
+    size_t covered = 0;
+    for (uint32_t y = 0; y < buffer.height(); y++) {
+        for (uint32_t x = 0; x < buffer.width(); x++) {
+            float px = (static_cast<float>(x) + 0.5f) / 32.0f - 1.0f;
+            float py = (static_cast<float>(y) + 0.5f) / 24.0f - 1.0f;
+
+            // the nearest triangle over the pixel centre
+            auto nearest = std::numeric_limits<float>::infinity();
+            for (size_t i = 0; i < vertices.size(); i += 3) {
+                auto a = vertices[i];
+                auto b = vertices[i + 1];
+                auto c = vertices[i + 2];
+                auto area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+                auto u = ((b.x - px) * (c.y - py) - (b.y - py) * (c.x - px)) / area;
+                auto v = ((c.x - px) * (a.y - py) - (c.y - py) * (a.x - px)) / area;
+                auto w = 1.0f - u - v;
+                if (u >= 0.0f && v >= 0.0f && w >= 0.0f) {
+                    nearest = std::min(nearest, device_depth(u * a.z + v * b.z + w * c.z));
+                }
+            }
+
+            auto known = resolved[y * buffer.width() + x];
+            REQUIRE(known >= nearest - 1e-4f);
+            covered += known < std::numeric_limits<float>::infinity() ? 1 : 0;
+        }
+    }
+    // and the buffer actually learnt something
+    REQUIRE(covered > resolved.size() / 2);
+}
+
+} // namespace muon::culling
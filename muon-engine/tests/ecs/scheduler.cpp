@@ -0,0 +1,236 @@
+#include "muon/ecs/scheduler.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "muon/ecs/query.hpp"
+#include "muon/ecs/system.hpp"
+#include "muon/ecs/system_layer.hpp"
+#include "muon/ecs/world.hpp"
+#include "muon/job/system.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace muon::ecs {
+
+namespace {
+
+struct Position {
+    float x{0.0f};
+};
+
+struct Velocity {
+    float x{0.0f};
+};
+
+struct Spawned {};
+
+class AccessSystem final : public System {
+public:
+    template <typename Fn>
+    AccessSystem(Fn &&declare) {
+        declare(*this);
+    }
+
+    void on_update(SystemContext &) override {
+        updates += 1;
+        if (throws) {
+            throw std::runtime_error{"system failed"};
+        }
+    }
+
+    template <typename... Ts>
+    void declare_queries() {
+        queries<Ts...>();
+    }
+
+    void declare_after(const System *system) { runs_after(system); }
+
+    std::atomic<uint32_t> updates{0};
+    bool throws{false};
+};
+
+class Movement final : public System {
+public:
+    explicit Movement(World &world) : query_{world} { queries<Position, const Velocity>(); }
+
+    void on_update(SystemContext &context) override {
+        query_.each(context.jobs, [](Position &position, const Velocity &velocity) { position.x += velocity.x; });
+    }
+
+private:
+    Query<Position, const Velocity> query_;
+};
+
+class Spawner final : public System {
+public:
+    explicit Spawner(World &world) : query_{world} { queries<const Position>(); }
+
+    void on_update(SystemContext &context) override {
+        query_.each([&](Entity entity, const Position &position) {
+            if (position.x >= 2.0f && !context.world.has<Spawned>(entity)) {
+                context.commands.add(entity, Spawned{});
+                context.commands.create(Position{-1.0f});
+            }
+        });
+    }
+
+private:
+    Query<const Position> query_;
+};
+
+} // namespace
+
+TEST_CASE("systems that only read share a level", "[ecs][scheduler]") {
+    World world;
+    Scheduler scheduler{world};
+    scheduler.emplace<AccessSystem>([](auto &system) { system.template declare_queries<const Position>(); });
+    scheduler.emplace<AccessSystem>([](auto &system) { system.template declare_queries<const Position, Velocity>(); });
+    scheduler.emplace<AccessSystem>([](auto &system) { system.template declare_queries<Spawned>(); });
+
+    REQUIRE(scheduler.levels().size() == 1);
+    REQUIRE(scheduler.levels().front().size() == 3);
+}
+
+TEST_CASE("conflicting systems keep their order", "[ecs][scheduler]") {
+    World world;
+    Scheduler scheduler{world};
+    auto &writer = scheduler.emplace<AccessSystem>([](auto &system) { system.template declare_queries<Position>(); });
+    auto &reader = scheduler.emplace<AccessSystem>([](auto &system) { system.template declare_queries<const Position>(); });
+    auto &other = scheduler.emplace<AccessSystem>([](auto &system) { system.template declare_queries<Velocity>(); });
+    auto &last = scheduler.emplace<AccessSystem>([&](auto &system) {
+        system.template declare_queries<const Velocity>();
+        system.declare_after(&reader);
+    });
+
+    const auto &levels = scheduler.levels();
+    REQUIRE(levels.size() == 3);
+    REQUIRE(levels[0] == Scheduler::Level{&writer, &other});
+    REQUIRE(levels[1] == Scheduler::Level{&reader});
+    REQUIRE(levels[2] == Scheduler::Level{&last});
+}
+
+TEST_CASE("undeclared systems run alone", "[ecs][scheduler]") {
+    World world;
+    Scheduler scheduler{world};
+    scheduler.emplace<AccessSystem>([](auto &system) { system.template declare_queries<const Position>(); });
+    scheduler.emplace<AccessSystem>([](auto &) {});
+    scheduler.emplace<AccessSystem>([](auto &system) { system.template declare_queries<const Position>(); });
+
+    REQUIRE(scheduler.levels().size() == 3);
+}
+
+TEST_CASE("cyclic dependencies fall back to serial order", "[ecs][scheduler]") {
+    World world;
+    Scheduler scheduler{world};
+    auto &first = scheduler.emplace<AccessSystem>([](auto &system) { system.template declare_queries<const Position>(); });
+    auto &second = scheduler.emplace<AccessSystem>([](auto &system) { system.template declare_queries<const Position>(); });
+    first.declare_after(&second);
+    second.declare_after(&first);
+
+    REQUIRE(scheduler.levels().size() == 2);
+    REQUIRE(scheduler.levels()[0] == Scheduler::Level{&first});
+}
+
+TEST_CASE("a throwing system fails the run without hanging it", "[ecs][scheduler]") {
+    World world;
+    job::System jobs{2};
+    Scheduler scheduler{world};
+    std::vector<AccessSystem *> systems;
+    for (size_t i = 0; i < 4; i++) {
+        auto &system = scheduler.emplace<AccessSystem>([](auto &system) { system.template declare_queries<const Position>(); });
+        systems.emplace_back(&system);
+    }
+    REQUIRE(scheduler.levels().size() == 1);
+
+    SECTION("on a worker") { systems[3]->throws = true; }
+    SECTION("on the calling thread") { systems[0]->throws = true; }
+
+    REQUIRE_THROWS_AS(scheduler.run(jobs), std::runtime_error);
+    for (auto *system : systems) {
+        REQUIRE(system->updates == 1);
+        system->throws = false;
+    }
+
+    scheduler.run(jobs);
+    for (auto *system : systems) {
+        REQUIRE(system->updates == 2);
+    }
+}
+
+TEST_CASE("scheduled systems update the world", "[ecs][scheduler]") {
+    World world;
+    for (int i = 0; i < 5000; i++) {
+        world.create(Position{0.0f}, Velocity{1.0f});
+    }
+    world.create(Position{0.0f});
+
+    job::System jobs{2};
+    Scheduler scheduler{world, 16};
+    auto &movement = scheduler.emplace<Movement>(world);
+    auto &spawner = scheduler.emplace<Spawner>(world);
+    REQUIRE(scheduler.levels().size() == 2);
+
+    for (int frame = 0; frame < 3; frame++) {
+        scheduler.run(jobs);
+    }
+
+    size_t moved = 0;
+    Query<const Position, const Velocity> moving{world};
+    moving.each([&](const Position &position, const Velocity &) { moved += position.x == 3.0f ? 1 : 0; });
+    REQUIRE(moved == 5000);
+
+    // the spawner's commands were applied after the second and third frame
+    Query<const Spawned> spawned{world};
+    REQUIRE(spawned.size() == 5000);
+    REQUIRE(world.size() == 5001 + 5000);
+
+    REQUIRE(scheduler.timings(movement).percentiles().count == 3);
+    REQUIRE(scheduler.timings(spawner).percentiles().count == 3);
+    REQUIRE(scheduler.name(movement).find("Movement") != std::string_view::npos);
+}
+
+TEST_CASE("parallel queries visit every chunk once", "[ecs][query]") {
+    World world;
+    for (int i = 0; i < 20000; i++) {
+        world.create(Position{0.0f}, Velocity{1.0f});
+        if (i % 3 == 0) {
+            world.create(Position{0.0f}, Velocity{1.0f}, Spawned{});
+        }
+    }
+
+    job::System jobs{3};
+    Query<Position, const Velocity> query{world};
+    std::atomic<size_t> count{0};
+    query.each_chunk(jobs, [&](std::span<const Entity> entities, std::span<Position> positions, std::span<const Velocity>) {
+        for (auto &position : positions) {
+            position.x += 1.0f;
+        }
+        count += entities.size();
+    });
+    REQUIRE(count == query.size());
+
+    size_t once = 0;
+    query.each([&](const Position &position, const Velocity &) { once += position.x == 1.0f ? 1 : 0; });
+    REQUIRE(once == count);
+}
+
+TEST_CASE("system layers run their scheduler", "[ecs][system_layer]") {
+    job::System jobs{1};
+    SystemLayer layer{jobs};
+    REQUIRE(layer.access().declared);
+    REQUIRE(layer.access().writes == std::vector<std::type_index>{typeid(World)});
+
+    auto entity = layer.world().create(Position{0.0f}, Velocity{2.0f});
+    layer.scheduler().emplace<Movement>(layer.world());
+    layer.on_update();
+    layer.on_update();
+    REQUIRE(layer.world().get<Position>(entity).x == 4.0f);
+}
+
+} // namespace muon::ecs
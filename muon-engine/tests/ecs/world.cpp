@@ -0,0 +1,245 @@
+#include "muon/ecs/world.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "muon/ecs/archetype.hpp"
+#include "muon/ecs/command_buffer.hpp"
+#include "muon/ecs/query.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace muon::ecs {
+
+namespace {
+
+struct Position {
+    float x{0.0f};
+    float y{0.0f};
+};
+
+struct Velocity {
+    float x{0.0f};
+    float y{0.0f};
+};
+
+struct Name {
+    std::string value;
+};
+
+struct Owned {
+    std::unique_ptr<int> value;
+};
+
+struct alignas(64) Wide {
+    float values[16]{};
+};
+
+} // namespace
+
+TEST_CASE("entities hold components", "[ecs][world]") {
+    World world;
+    auto a = world.create(Position{1.0f, 2.0f}, Velocity{3.0f, 4.0f});
+    auto b = world.create(Position{5.0f, 6.0f});
+
+    REQUIRE(world.size() == 2);
+    REQUIRE(world.alive(a));
+    REQUIRE(world.get<Position>(a).x == 1.0f);
+    REQUIRE(world.get<Velocity>(a).y == 4.0f);
+    REQUIRE(world.has<Position>(b));
+    REQUIRE(!world.has<Velocity>(b));
+    REQUIRE(world.try_get<Velocity>(b) == nullptr);
+
+    world.add<Velocity>(b, 7.0f, 8.0f);
+    REQUIRE(world.get<Velocity>(b).x == 7.0f);
+    REQUIRE(world.get<Position>(b).y == 6.0f);
+
+    // adding again replaces the value instead of moving the entity
+    world.add<Velocity>(b, 9.0f, 10.0f);
+    REQUIRE(world.get<Velocity>(b).x == 9.0f);
+
+    REQUIRE(world.remove<Position>(a));
+    REQUIRE(!world.remove<Position>(a));
+    REQUIRE(!world.has<Position>(a));
+    REQUIRE(world.get<Velocity>(a).x == 3.0f);
+    REQUIRE(world.get<Position>(b).x == 5.0f);
+}
+
+TEST_CASE("destroyed entities go stale", "[ecs][world]") {
+    World world;
+    auto a = world.create(Position{1.0f, 0.0f});
+    auto b = world.create(Position{2.0f, 0.0f});
+    auto uuid = world.uuid(a);
+
+    world.destroy(a);
+    REQUIRE(!world.alive(a));
+    REQUIRE(world.size() == 1);
+    REQUIRE(!world.find(uuid));
+
+    // b filled the hole a left in the archetype
+    REQUIRE(world.get<Position>(b).x == 2.0f);
+
+    // the index is reused under a new generation
+    auto c = world.create(Position{3.0f, 0.0f});
+    REQUIRE(c.index == a.index);
+    REQUIRE(c.generation != a.generation);
+    REQUIRE(!world.alive(a));
+    REQUIRE(world.get<Position>(c).x == 3.0f);
+}
+
+TEST_CASE("entities are found by uuid", "[ecs][world]") {
+    World world;
+    auto a = world.create(Name{"a"});
+    auto uuid = world.uuid(a);
+    REQUIRE(!uuid.is_nil());
+    REQUIRE(world.find(uuid) == a);
+
+    world.destroy(a);
+    auto restored = world.restore(uuid, Name{"restored"});
+    REQUIRE(world.find(uuid) == restored);
+    REQUIRE(world.uuid(restored) == uuid);
+    REQUIRE(world.get<Name>(restored).value == "restored");
+}
+
+TEST_CASE("components survive moving between archetypes", "[ecs][world]") {
+    World world;
+    std::vector<Entity> entities;
+    for (int i = 0; i < 100; i++) {
+        entities.push_back(world.create(Name{std::string(32, static_cast<char>('a' + i % 26))}, Owned{std::make_unique<int>(i)}));
+    }
+
+    for (int i = 0; i < 100; i += 2) {
+        world.add<Position>(entities[i], static_cast<float>(i), 0.0f);
+    }
+    for (int i = 0; i < 100; i += 3) {
+        world.remove<Name>(entities[i]);
+    }
+    for (int i = 0; i < 100; i += 5) {
+        world.destroy(entities[i]);
+    }
+
+    for (int i = 0; i < 100; i++) {
+        if (i % 5 == 0) {
+            REQUIRE(!world.alive(entities[i]));
+            continue;
+        }
+        REQUIRE(*world.get<Owned>(entities[i]).value == i);
+        REQUIRE(world.has<Position>(entities[i]) == (i % 2 == 0));
+        if (i % 3 == 0) {
+            REQUIRE(!world.has<Name>(entities[i]));
+        } else {
+            REQUIRE(world.get<Name>(entities[i]).value == std::string(32, static_cast<char>('a' + i % 26)));
+        }
+    }
+}
+
+TEST_CASE("queries visit every matching entity", "[ecs][query]") {
+    World world;
+    Query<Position, const Velocity> moving{world};
+    REQUIRE(moving.size() == 0);
+
+    auto a = world.create(Position{}, Velocity{1.0f, 2.0f});
+    auto b = world.create(Position{}, Velocity{3.0f, 4.0f}, Name{"b"});
+    auto c = world.create(Position{});
+    REQUIRE(moving.size() == 2);
+
+    moving.each([](Position &position, const Velocity &velocity) {
+        position.x += velocity.x;
+        position.y += velocity.y;
+    });
+    REQUIRE(world.get<Position>(a).x == 1.0f);
+    REQUIRE(world.get<Position>(b).y == 4.0f);
+    REQUIRE(world.get<Position>(c).x == 0.0f);
+
+    // archetypes created after the query ran are picked up
+    auto d = world.create(Velocity{5.0f, 6.0f}, Owned{}, Position{});
+    std::set<uint32_t> seen;
+    moving.each([&seen](Entity entity, Position &, const Velocity &) { seen.insert(entity.index); });
+    REQUIRE(seen == std::set<uint32_t>{a.index, b.index, d.index});
+
+    world.remove<Velocity>(a);
+    REQUIRE(moving.size() == 2);
+}
+
+TEST_CASE("queries iterate whole chunks", "[ecs][query]") {
+    World world;
+    std::vector<Entity> entities;
+    for (int i = 0; i < 10000; i++) {
+        entities.push_back(world.create(Position{static_cast<float>(i), 0.0f}, Velocity{1.0f, 0.0f}));
+    }
+
+    Query<Position, const Velocity> query{world};
+    size_t chunks = 0;
+    size_t count = 0;
+    query.each_chunk([&](std::span<const Entity> chunk, std::span<Position> positions, std::span<const Velocity> velocities) {
+        REQUIRE(chunk.size() == positions.size());
+        REQUIRE(chunk.size() == velocities.size());
+        for (size_t i = 0; i < positions.size(); i++) {
+            positions[i].x += velocities[i].x;
+        }
+        chunks++;
+        count += chunk.size();
+    });
+    REQUIRE(count == entities.size());
+    REQUIRE(chunks > 1);
+
+    for (int i = 0; i < 10000; i++) {
+        REQUIRE(world.get<Position>(entities[i]).x == static_cast<float>(i + 1));
+    }
+}
+
+TEST_CASE("chunk columns are cache line aligned", "[ecs][archetype]") {
+    World world;
+    for (int i = 0; i < 1000; i++) {
+        world.create(Position{}, Wide{}, Name{});
+    }
+
+    Query<Position, Wide, Name> query{world};
+    query.each_chunk([](std::span<const Entity>, std::span<Position> positions, std::span<Wide> wide, std::span<Name> names) {
+        REQUIRE(reinterpret_cast<uintptr_t>(positions.data()) % CHUNK_ALIGNMENT == 0);
+        REQUIRE(reinterpret_cast<uintptr_t>(wide.data()) % CHUNK_ALIGNMENT == 0);
+        REQUIRE(reinterpret_cast<uintptr_t>(names.data()) % CHUNK_ALIGNMENT == 0);
+        REQUIRE(reinterpret_cast<const std::byte *>(names.data() + names.size()) -
+                    reinterpret_cast<const std::byte *>(positions.data()) <=
+                static_cast<ptrdiff_t>(CHUNK_SIZE));
+    });
+}
+
+TEST_CASE("command buffers defer structural changes", "[ecs][command_buffer]") {
+    World world;
+    auto a = world.create(Position{}, Velocity{1.0f, 0.0f});
+    auto b = world.create(Position{}, Velocity{-1.0f, 0.0f});
+
+    CommandBuffer commands;
+    Query<Position, Velocity> query{world};
+    Uuid spawned;
+    query.each([&](Entity entity, Position &, Velocity &velocity) {
+        if (velocity.x < 0.0f) {
+            commands.destroy(entity);
+            commands.add(entity, Name{"ignored"});
+            spawned = commands.create(Position{2.0f, 0.0f}, Name{"spawned"});
+        } else {
+            commands.remove<Velocity>(entity);
+            commands.add(entity, Name{"kept"});
+        }
+    });
+    REQUIRE(commands.size() == 5);
+    REQUIRE(world.size() == 2);
+
+    commands.apply(world);
+    REQUIRE(commands.empty());
+    REQUIRE(world.size() == 2);
+    REQUIRE(!world.alive(b));
+    REQUIRE(!world.has<Velocity>(a));
+    REQUIRE(world.get<Name>(a).value == "kept");
+
+    auto created = world.find(spawned);
+    REQUIRE(created);
+    REQUIRE(world.get<Name>(*created).value == "spawned");
+    REQUIRE(world.get<Position>(*created).x == 2.0f);
+}
+
+} // namespace muon::ecs
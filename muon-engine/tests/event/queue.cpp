@@ -0,0 +1,119 @@
+#include "muon/event/queue.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <thread>
+#include <variant>
+
+namespace muon::event {
+
+namespace {
+
+auto key(uint32_t index) -> Queued {
+    return Queued{
+        .timestamp = index,
+        .event = Keyboard{static_cast<input::Scancode>(index % 100), true, false, input::Modifier{0}},
+    };
+}
+
+auto motion(uint64_t timestamp, float x, float y) -> Queued { return Queued{.timestamp = timestamp, .event = MouseMotion{x, y}}; }
+
+} // namespace
+
+TEST_CASE("motion merges while the queue is backed up", "[event][queue]") {
+    Queue queue{16};
+
+    // fill up to the slots kept back for events that can't be merged
+    for (uint32_t i = 0; i < 14; i++) {
+        REQUIRE(queue.push(key(i)));
+    }
+    for (uint32_t i = 0; i < 5; i++) {
+        REQUIRE(queue.push(motion(100 + i, 1.0f, -2.0f)));
+    }
+    REQUIRE(queue.size() == 14);
+
+    // the merged motion takes a single slot once there's room, in front of whatever comes after it
+    for (uint32_t i = 0; i < 4; i++) {
+        REQUIRE(queue.pop().has_value());
+    }
+    REQUIRE(queue.push(key(200)));
+    REQUIRE(queue.size() == 12);
+
+    for (uint32_t i = 4; i < 14; i++) {
+        REQUIRE(queue.pop()->timestamp == i);
+    }
+    auto merged = queue.pop();
+    REQUIRE(merged.has_value());
+    REQUIRE(merged->timestamp == 104);
+    REQUIRE(std::get<MouseMotion>(merged->event).x == 5.0f);
+    REQUIRE(std::get<MouseMotion>(merged->event).y == -10.0f);
+    REQUIRE(queue.pop()->timestamp == 200);
+    REQUIRE_FALSE(queue.pop().has_value());
+}
+
+TEST_CASE("merged motion goes out on flush", "[event][queue]") {
+    Queue queue{8};
+    for (uint32_t i = 0; i < 7; i++) {
+        REQUIRE(queue.push(key(i)));
+    }
+    REQUIRE(queue.push(motion(10, 1.0f, 1.0f)));
+    REQUIRE(queue.push(motion(11, 1.0f, 1.0f)));
+    REQUIRE(queue.size() == 7);
+
+    while (queue.pop()) {
+    }
+    queue.flush();
+    auto merged = queue.pop();
+    REQUIRE(merged.has_value());
+    REQUIRE(merged->timestamp == 11);
+    REQUIRE(std::get<MouseMotion>(merged->event).x == 2.0f);
+}
+
+TEST_CASE("a quit survives a full queue", "[event][queue]") {
+    Queue queue{8};
+    for (uint32_t i = 0; i < 8; i++) {
+        REQUIRE(queue.push(key(i)));
+    }
+    REQUIRE_FALSE(queue.push(key(8)));
+    REQUIRE(queue.push(Queued{.timestamp = 50, .event = WindowQuit{}}));
+    REQUIRE_FALSE(queue.push(key(9)));
+
+    for (uint32_t i = 0; i < 8; i++) {
+        auto queued = queue.pop();
+        REQUIRE(queued.has_value());
+        REQUIRE(std::holds_alternative<Keyboard>(queued->event));
+    }
+    auto quit = queue.pop();
+    REQUIRE(quit.has_value());
+    REQUIRE(std::holds_alternative<WindowQuit>(quit->event));
+    REQUIRE(quit->timestamp == 50);
+
+    // delivered once
+    REQUIRE_FALSE(queue.pop().has_value());
+}
+
+TEST_CASE("events keep their order across the ring wrapping", "[event][queue]") {
+    constexpr uint32_t COUNT = 10000;
+    Queue queue{8};
+
+    std::jthread producer{[&] {
+        for (uint32_t i = 0; i < COUNT; i++) {
+            while (!queue.push(key(i))) {
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    uint32_t expected = 0;
+    while (expected < COUNT) {
+        if (auto queued = queue.pop()) {
+            REQUIRE(queued->timestamp == expected);
+            REQUIRE(std::get<Keyboard>(queued->event).scancode == static_cast<input::Scancode>(expected % 100));
+            expected += 1;
+        }
+    }
+    REQUIRE_FALSE(queue.pop().has_value());
+}
+
+} // namespace muon::event
@@ -0,0 +1,232 @@
+#include "muon/image/png.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "muon/compress/compress.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace muon::image {
+
+namespace {
+
+struct Pixels {
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    std::vector<uint8_t> data;
+};
+
+auto pattern(uint32_t width, uint32_t height, uint32_t channels) -> Pixels {
+    Pixels pixels{width, height, channels, {}};
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            for (uint32_t c = 0; c < channels; c++) {
+                pixels.data.push_back(static_cast<uint8_t>(x * 37 + y * 11 + c * 101));
+            }
+        }
+    }
+    return pixels;
+}
+
+auto crc32(std::span<const uint8_t> bytes) -> uint32_t {
+    uint32_t crc = 0xffffffff;
+    for (auto byte : bytes) {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+void put_u32(std::vector<uint8_t> &out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void put_chunk(std::vector<uint8_t> &out, std::string_view type, std::span<const uint8_t> data) {
+    put_u32(out, static_cast<uint32_t>(data.size()));
+    auto start = out.size();
+    out.insert(out.end(), type.begin(), type.end());
+    out.insert(out.end(), data.begin(), data.end());
+    put_u32(out, crc32(std::span{out}.subspan(start)));
+}
+
+// unfiltered 8 bit grey, rgb or rgba, optionally split into the seven adam7 passes
+auto encode_png(const Pixels &pixels, bool interlaced) -> std::vector<uint8_t> {
+    constexpr std::array<uint32_t, 7> START_X{0, 4, 0, 2, 0, 1, 0};
+    constexpr std::array<uint32_t, 7> START_Y{0, 0, 4, 0, 2, 0, 1};
+    constexpr std::array<uint32_t, 7> STEP_X{8, 8, 4, 4, 2, 2, 1};
+    constexpr std::array<uint32_t, 7> STEP_Y{8, 8, 8, 4, 4, 2, 2};
+
+    std::vector<uint8_t> scanlines;
+    for (size_t pass = 0; pass < (interlaced ? 7 : 1); pass++) {
+        uint32_t start_x = interlaced ? START_X[pass] : 0;
+        uint32_t start_y = interlaced ? START_Y[pass] : 0;
+        uint32_t step_x = interlaced ? STEP_X[pass] : 1;
+        uint32_t step_y = interlaced ? STEP_Y[pass] : 1;
+        if (start_x >= pixels.width) {
+            continue;
+        }
+        for (uint32_t y = start_y; y < pixels.height; y += step_y) {
+            scanlines.push_back(0);
+            for (uint32_t x = start_x; x < pixels.width; x += step_x) {
+                auto *pixel = &pixels.data[(y * pixels.width + x) * pixels.channels];
+                scanlines.insert(scanlines.end(), pixel, pixel + pixels.channels);
+            }
+        }
+    }
+    auto compressed = compress::compress(BufferView{scanlines.data(), scanlines.size()}, {.codec = compress::Codec::Zlib, .level = 6});
+
+    std::vector<uint8_t> png{137, 80, 78, 71, 13, 10, 26, 10};
+    std::vector<uint8_t> header;
+    put_u32(header, pixels.width);
+    put_u32(header, pixels.height);
+    uint8_t colour_type = pixels.channels == 1 ? 0 : pixels.channels == 3 ? 2 : 6;
+    header.insert(header.end(), {8, colour_type, 0, 0, static_cast<uint8_t>(interlaced ? 1 : 0)});
+    put_chunk(png, "IHDR", header);
+    put_chunk(png, "IDAT", std::span<const uint8_t>{compressed->data(), compressed->size()});
+    put_chunk(png, "IEND", {});
+    return png;
+}
+
+auto view(const std::vector<uint8_t> &bytes) -> BufferView { return {bytes.data(), bytes.size()}; }
+
+// what every format should hold for a source pixel, alpha is opaque when the png has none
+auto expected_pixel(std::span<const uint8_t> source, PixelFormat format) -> std::vector<uint8_t> {
+    std::array<uint8_t, 4> rgba{};
+    if (source.size() == 1) {
+        rgba = {source[0], source[0], source[0], 255};
+    } else {
+        rgba = {source[0], source[1], source[2], static_cast<uint8_t>(source.size() == 4 ? source[3] : 255)};
+    }
+
+    switch (format) {
+        case PixelFormat::R8:
+            return {rgba[0]};
+        case PixelFormat::Rgb8:
+            return {rgba[0], rgba[1], rgba[2]};
+        case PixelFormat::Rgba8:
+            return {rgba.begin(), rgba.end()};
+        case PixelFormat::Bgra8:
+            return {rgba[2], rgba[1], rgba[0], rgba[3]};
+        case PixelFormat::Rgba16:
+            break;
+    }
+    std::vector<uint8_t> wide(8);
+    for (size_t c = 0; c < 4; c++) {
+        uint16_t channel = rgba[c] * 257;
+        std::memcpy(&wide[c * 2], &channel, sizeof(channel));
+    }
+    return wide;
+}
+
+void require_pixels(const Image &image, const Pixels &source, PixelFormat format) {
+    REQUIRE(image.width() == source.width);
+    REQUIRE(image.height() == source.height);
+    REQUIRE(image.format() == format);
+
+    auto size = bytes_per_pixel(format);
+    for (uint32_t y = 0; y < source.height; y++) {
+        auto row = image.row(y);
+        for (uint32_t x = 0; x < source.width; x++) {
+            auto pixel = std::span{source.data}.subspan((y * source.width + x) * source.channels, source.channels);
+            auto decoded = row.subspan(x * size, size);
+            REQUIRE(std::vector<uint8_t>(decoded.begin(), decoded.end()) == expected_pixel(pixel, format));
+        }
+    }
+}
+
+constexpr std::array FORMATS{PixelFormat::R8, PixelFormat::Rgb8, PixelFormat::Rgba8, PixelFormat::Bgra8, PixelFormat::Rgba16};
+
+} // namespace
+
+TEST_CASE("pngs decode into every pixel format", "[image][png]") {
+    BufferPool pool;
+
+    for (uint32_t channels : {1u, 3u, 4u}) {
+        auto source = pattern(37, 21, channels);
+        auto png = encode_png(source, false);
+
+        for (auto format : FORMATS) {
+            auto image = decode_png(view(png), format, pool);
+            REQUIRE(image.has_value());
+            require_pixels(*image, source, format);
+            REQUIRE(reinterpret_cast<uintptr_t>(image->pixels().data()) % BufferPool::DEFAULT_ALIGNMENT == 0);
+            pool.release(std::move(*image).release());
+        }
+    }
+}
+
+TEST_CASE("interlaced pngs decode the same as plain ones", "[image][png]") {
+    BufferPool pool;
+
+    // sizes that leave some adam7 passes short or empty
+    for (auto [width, height] : {std::pair{1u, 1u}, std::pair{3u, 2u}, std::pair{13u, 11u}, std::pair{64u, 9u}}) {
+        auto source = pattern(width, height, 4);
+        auto png = encode_png(source, true);
+
+        for (auto format : FORMATS) {
+            auto image = decode_png(view(png), format, pool);
+            REQUIRE(image.has_value());
+            require_pixels(*image, source, format);
+            pool.release(std::move(*image).release());
+        }
+    }
+}
+
+TEST_CASE("broken pngs are rejected", "[image][png]") {
+    BufferPool pool;
+
+    std::vector<uint8_t> garbage(64, 0x42);
+    REQUIRE(decode_png(view(garbage), PixelFormat::Rgba8, pool).error() == ImageError::InvalidPng);
+
+    auto too_large = encode_png(pattern(MAX_PNG_DIMENSION + 1, 1, 4), false);
+    REQUIRE(decode_png(view(too_large), PixelFormat::Rgba8, pool).error() == ImageError::TooLarge);
+
+    // the image data stops partway through
+    auto source = pattern(32, 32, 4);
+    auto png = encode_png(source, false);
+    auto data_size = static_cast<size_t>(png[33]) << 24 | png[34] << 16 | png[35] << 8 | png[36];
+    std::vector<uint8_t> truncated(png.begin(), png.begin() + 33);
+    std::vector<uint8_t> partial(png.begin() + 41, png.begin() + 41 + data_size / 2);
+    put_chunk(truncated, "IDAT", partial);
+    put_chunk(truncated, "IEND", {});
+    REQUIRE(decode_png(view(truncated), PixelFormat::Rgba8, pool).error() == ImageError::CorruptData);
+}
+
+TEST_CASE("batches of pngs decode across jobs in order", "[image][png]") {
+    BufferPool pool;
+    job::System jobs{3};
+
+    std::vector<Pixels> sources;
+    std::vector<std::vector<uint8_t>> pngs;
+    for (uint32_t i = 0; i < 12; i++) {
+        sources.push_back(pattern(16 + i * 3, 8 + i, i % 2 == 0 ? 4 : 3));
+        pngs.push_back(encode_png(sources.back(), i % 3 == 0));
+    }
+    std::vector<uint8_t> garbage(64, 0x42);
+    pngs.push_back(garbage);
+
+    std::vector<BufferView> views;
+    for (const auto &png : pngs) {
+        views.push_back(view(png));
+    }
+
+    auto images = decode_png(views, PixelFormat::Bgra8, pool, jobs);
+    REQUIRE(images.size() == pngs.size());
+    for (size_t i = 0; i < sources.size(); i++) {
+        REQUIRE(images[i].has_value());
+        require_pixels(*images[i], sources[i], PixelFormat::Bgra8);
+    }
+    REQUIRE(images.back().error() == ImageError::InvalidPng);
+}
+
+} // namespace muon::image
@@ -2,6 +2,11 @@
 
 #include "catch2/catch_test_macros.hpp"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
 namespace muon {
 
 TEST_CASE("align 0 by 8", "[alignment]") {
@@ -81,4 +86,106 @@ TEST_CASE("align 3 by 7", "[alignment]") {
     REQUIRE(result == 7);
 }
 
+TEST_CASE("align matches division for every small value and alignment", "[alignment]") {
+    for (uint64_t alignment = 1; alignment <= 64; alignment++) {
+        for (uint64_t value = 0; value <= 512; value++) {
+            uint64_t up = (value + alignment - 1) / alignment * alignment;
+            uint64_t down = value / alignment * alignment;
+            REQUIRE(maths::align(value, alignment) == up);
+            REQUIRE(maths::align_down(value, alignment) == down);
+            REQUIRE(maths::is_aligned(value, alignment) == (value % alignment == 0));
+        }
+    }
+}
+
+TEST_CASE("compile time alignment matches runtime alignment", "[alignment]") {
+    for (uint64_t value = 0; value <= 512; value++) {
+        REQUIRE(maths::align<1>(value) == maths::align(value, 1));
+        REQUIRE(maths::align<8>(value) == maths::align(value, 8));
+        REQUIRE(maths::align<64>(value) == maths::align(value, 64));
+        REQUIRE(maths::align_down<16>(value) == maths::align_down(value, 16));
+        REQUIRE(maths::is_aligned<4>(value) == maths::is_aligned(value, 4));
+        REQUIRE(maths::is_aligned<256>(value) == maths::is_aligned(value, 256));
+    }
+}
+
+TEST_CASE("alignment is usable in constant expressions", "[alignment]") {
+    STATIC_REQUIRE(maths::align(13, 8) == 16);
+    STATIC_REQUIRE(maths::align(13, 6) == 18);
+    STATIC_REQUIRE(maths::align<4096>(4097) == 8192);
+    STATIC_REQUIRE(maths::align_down(13, 8) == 8);
+    STATIC_REQUIRE(maths::align_down<4096>(8191) == 4096);
+    STATIC_REQUIRE(maths::is_aligned<16>(48));
+    STATIC_REQUIRE(!maths::is_aligned(10, 4));
+    STATIC_REQUIRE(maths::next_pow2(33) == 64);
+    STATIC_REQUIRE(maths::log2(64) == 6);
+}
+
+TEST_CASE("alignment near the top of the range", "[alignment]") {
+    constexpr uint64_t TOP = uint64_t{1} << 63;
+    REQUIRE(maths::align(TOP - 1, TOP) == TOP);
+    REQUIRE(maths::align<4096>(TOP - 1) == TOP);
+    REQUIRE(maths::align_down(std::numeric_limits<uint64_t>::max(), TOP) == TOP);
+    REQUIRE(maths::align_down<8>(std::numeric_limits<uint64_t>::max()) == std::numeric_limits<uint64_t>::max() - 7);
+    REQUIRE(maths::is_aligned(TOP, TOP));
+}
+
+TEST_CASE("align pointers", "[alignment]") {
+    alignas(64) std::array<std::byte, 256> storage{};
+
+    for (size_t offset = 0; offset < 128; offset++) {
+        auto *pointer = storage.data() + offset;
+        auto *up = maths::align(pointer, 16);
+        auto *down = maths::align_down(pointer, 16);
+
+        REQUIRE(maths::is_aligned(up, 16));
+        REQUIRE(maths::is_aligned(down, 16));
+        REQUIRE(up >= pointer);
+        REQUIRE(up - pointer < 16);
+        REQUIRE(down <= pointer);
+        REQUIRE(pointer - down < 16);
+        REQUIRE(maths::is_aligned(pointer, 16) == (up == pointer));
+    }
+
+    const auto *first = storage.data();
+    REQUIRE(maths::align(first, 64) == first);
+    REQUIRE(maths::align(first + 1, 64) == first + 64);
+    REQUIRE(reinterpret_cast<uintptr_t>(maths::align(first + 1, 3)) % 3 == 0);
+}
+
+TEST_CASE("next power of two", "[alignment]") {
+    REQUIRE(maths::next_pow2(0) == 1);
+    REQUIRE(maths::next_pow2(1) == 1);
+    REQUIRE(maths::next_pow2(2) == 2);
+    REQUIRE(maths::next_pow2(3) == 4);
+    REQUIRE(maths::next_pow2(uint64_t{1} << 63) == uint64_t{1} << 63);
+
+    for (uint32_t shift = 1; shift < 63; shift++) {
+        uint64_t power = uint64_t{1} << shift;
+        REQUIRE(maths::is_pow2(power));
+        REQUIRE(!maths::is_pow2(power + 1));
+        REQUIRE(maths::next_pow2(power) == power);
+        REQUIRE(maths::next_pow2(power - 1) == (shift == 1 ? 1 : power));
+        REQUIRE(maths::next_pow2(power + 1) == power << 1);
+    }
+    REQUIRE(!maths::is_pow2(0));
+}
+
+TEST_CASE("integer logarithms", "[alignment]") {
+    REQUIRE(maths::log2(1) == 0);
+    REQUIRE(maths::log2_ceil(0) == 0);
+    REQUIRE(maths::log2_ceil(1) == 0);
+    REQUIRE(maths::log2(std::numeric_limits<uint64_t>::max()) == 63);
+    REQUIRE(maths::log2_ceil(std::numeric_limits<uint64_t>::max()) == 64);
+
+    for (uint32_t shift = 1; shift < 64; shift++) {
+        uint64_t power = uint64_t{1} << shift;
+        REQUIRE(maths::log2(power) == shift);
+        REQUIRE(maths::log2(power - 1) == shift - 1);
+        REQUIRE(maths::log2_ceil(power) == shift);
+        REQUIRE(maths::log2_ceil(power + 1) == shift + 1);
+        REQUIRE(maths::log2_ceil(power - 1) == (shift == 1 ? 0 : shift));
+    }
+}
+
 } // namespace muon
@@ -0,0 +1,258 @@
+#include "muon/maths/batch.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace muon::maths {
+
+namespace {
+
+// covers a full avx-512 vector and a remainder for every width
+constexpr size_t COUNT = 37;
+
+struct Columns {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> w;
+
+    explicit Columns(size_t count) : x(count), y(count), z(count), w(count) {}
+
+    auto vec3() -> Vec3Soa<float> { return {x, y, z}; }
+    auto vec4() -> Vec4Soa<float> { return {x, y, z, w}; }
+};
+
+auto close(float value, float expected, float tolerance = 1e-5f) -> bool {
+    return std::abs(value - expected) <= tolerance * (1.0f + std::abs(expected));
+}
+
+auto make_matrix() -> glm::mat4 {
+    float c = std::cos(0.7f);
+    float s = std::sin(0.7f);
+    glm::mat4 matrix{1.0f};
+    matrix[0] = glm::vec4{c * 2.0f, s * 2.0f, 0.0f, 0.0f};
+    matrix[1] = glm::vec4{-s, c, 0.5f, 0.0f};
+    matrix[2] = glm::vec4{0.0f, -0.25f, 1.5f, 0.0f};
+    matrix[3] = glm::vec4{10.0f, -4.0f, 2.5f, 1.0f};
+    return matrix;
+}
+
+auto make_columns(size_t seed) -> Columns {
+    Columns columns{COUNT};
+    uint32_t state = static_cast<uint32_t>(seed) * 2654435761u + 1;
+    auto next = [&state] {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / static_cast<float>(1 << 24) * 2.0f - 1.0f;
+    };
+    for (size_t i = 0; i < COUNT; i++) {
+        columns.x[i] = next() * 50.0f;
+        columns.y[i] = next() * 50.0f;
+        columns.z[i] = next() * 50.0f;
+        columns.w[i] = next() * 50.0f;
+    }
+    return columns;
+}
+
+auto quat_at(Columns &columns, size_t i) -> glm::quat { return {columns.w[i], columns.x[i], columns.y[i], columns.z[i]}; }
+
+// runs the check at every level the cpu supports, then restores the default
+template <typename Fn>
+void for_each_level(Fn &&fn) {
+    for (auto level : {SimdLevel::Scalar, SimdLevel::Sse4, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (set_simd_level(level) == level) {
+            fn();
+        }
+    }
+    set_simd_level(supported_simd_level());
+}
+
+} // namespace
+
+TEST_CASE("batch transforms match glm", "[maths][batch]") {
+    auto matrix = make_matrix();
+    auto input = make_columns(1);
+
+    for_each_level([&] {
+        Columns points{COUNT};
+        transform_points(matrix, input.vec3(), points.vec3());
+        Columns vectors{COUNT};
+        transform_vectors(matrix, input.vec3(), vectors.vec3());
+        Columns full{COUNT};
+        transform(matrix, input.vec4(), full.vec4());
+
+        for (size_t i = 0; i < COUNT; i++) {
+            glm::vec4 point = matrix * glm::vec4{input.x[i], input.y[i], input.z[i], 1.0f};
+            REQUIRE(close(points.x[i], point.x));
+            REQUIRE(close(points.y[i], point.y));
+            REQUIRE(close(points.z[i], point.z));
+
+            glm::vec4 vector = matrix * glm::vec4{input.x[i], input.y[i], input.z[i], 0.0f};
+            REQUIRE(close(vectors.x[i], vector.x));
+            REQUIRE(close(vectors.z[i], vector.z));
+
+            glm::vec4 value = matrix * glm::vec4{input.x[i], input.y[i], input.z[i], input.w[i]};
+            REQUIRE(close(full.y[i], value.y));
+            REQUIRE(close(full.w[i], value.w));
+        }
+    });
+}
+
+TEST_CASE("batch transforms accept a matrix per point", "[maths][batch]") {
+    auto input = make_columns(2);
+    std::vector<glm::mat4> matrices(COUNT, make_matrix());
+    for (size_t i = 0; i < COUNT; i++) {
+        matrices[i][3] = glm::vec4{static_cast<float>(i), -static_cast<float>(i), 0.5f, 1.0f};
+    }
+
+    for_each_level([&] {
+        // in place
+        auto points = input;
+        transform_points(matrices, points.vec3(), points.vec3());
+        for (size_t i = 0; i < COUNT; i++) {
+            glm::vec4 point = matrices[i] * glm::vec4{input.x[i], input.y[i], input.z[i], 1.0f};
+            REQUIRE(close(points.x[i], point.x));
+            REQUIRE(close(points.y[i], point.y));
+            REQUIRE(close(points.z[i], point.z));
+        }
+    });
+}
+
+TEST_CASE("batch quaternions match glm", "[maths][batch]") {
+    auto from = make_columns(3);
+    auto to = make_columns(4);
+    std::vector<float> t(COUNT);
+    for (size_t i = 0; i < COUNT; i++) {
+        t[i] = static_cast<float>(i) / static_cast<float>(COUNT - 1);
+    }
+
+    for_each_level([&] {
+        Columns a{COUNT};
+        Columns b{COUNT};
+        normalize(from.vec4(), a.vec4());
+        normalize(to.vec4(), b.vec4());
+        for (size_t i = 0; i < COUNT; i++) {
+            auto expected = glm::normalize(quat_at(from, i));
+            REQUIRE(close(a.x[i], expected.x));
+            REQUIRE(close(a.w[i], expected.w));
+        }
+
+        Columns result{COUNT};
+        slerp(a.vec4(), b.vec4(), t, result.vec4());
+        for (size_t i = 0; i < COUNT; i++) {
+            auto expected = glm::slerp(quat_at(a, i), quat_at(b, i), t[i]);
+            REQUIRE(close(result.x[i], expected.x, 1e-4f));
+            REQUIRE(close(result.y[i], expected.y, 1e-4f));
+            REQUIRE(close(result.z[i], expected.z, 1e-4f));
+            REQUIRE(close(result.w[i], expected.w, 1e-4f));
+        }
+    });
+}
+
+TEST_CASE("batch bounding boxes contain their transformed corners", "[maths][batch]") {
+    auto matrix = make_matrix();
+    auto a = make_columns(5);
+    auto b = make_columns(6);
+    Columns min{COUNT};
+    Columns max{COUNT};
+    for (size_t i = 0; i < COUNT; i++) {
+        min.x[i] = std::min(a.x[i], b.x[i]);
+        min.y[i] = std::min(a.y[i], b.y[i]);
+        min.z[i] = std::min(a.z[i], b.z[i]);
+        max.x[i] = std::max(a.x[i], b.x[i]);
+        max.y[i] = std::max(a.y[i], b.y[i]);
+        max.z[i] = std::max(a.z[i], b.z[i]);
+    }
+
+    for_each_level([&] {
+        Columns out_min{COUNT};
+        Columns out_max{COUNT};
+        transform_aabbs(matrix, {min.vec3(), max.vec3()}, {out_min.vec3(), out_max.vec3()});
+
+        for (size_t i = 0; i < COUNT; i++) {
+            constexpr float LARGEST = std::numeric_limits<float>::max();
+            glm::vec3 low{LARGEST, LARGEST, LARGEST};
+            glm::vec3 high{-LARGEST, -LARGEST, -LARGEST};
+            for (uint32_t corner = 0; corner < 8; corner++) {
+                glm::vec4 point = matrix * glm::vec4{
+                    corner & 1 ? max.x[i] : min.x[i], corner & 2 ? max.y[i] : min.y[i], corner & 4 ? max.z[i] : min.z[i], 1.0f
+                };
+                for (int axis = 0; axis < 3; axis++) {
+                    low[axis] = std::min(low[axis], point[axis]);
+                    high[axis] = std::max(high[axis], point[axis]);
+                }
+            }
+
+            // the box around the transformed corners is exactly what arvo's method produces
+            REQUIRE(close(out_min.x[i], low.x));
+            REQUIRE(close(out_min.y[i], low.y));
+            REQUIRE(close(out_min.z[i], low.z));
+            REQUIRE(close(out_max.x[i], high.x));
+            REQUIRE(close(out_max.y[i], high.y));
+            REQUIRE(close(out_max.z[i], high.z));
+        }
+    });
+}
+
+TEST_CASE("frustum culling matches the scalar tests", "[maths][batch]") {
+    auto projection = glm::perspective(glm::radians(60.0f), 1.5f, 0.5f, 40.0f);
+    auto view = glm::lookAt(glm::vec3{0.0f}, glm::vec3{1.0f, 0.3f, -0.5f}, glm::vec3{0.0f, 1.0f, 0.0f});
+    auto frustum = Frustum::from_matrix(projection * view);
+
+    auto centres = make_columns(7);
+    auto extents = make_columns(8);
+    Columns min{COUNT};
+    Columns max{COUNT};
+    std::vector<uint32_t> expected_spheres;
+    std::vector<uint32_t> expected_boxes;
+    for (size_t i = 0; i < COUNT; i++) {
+        extents.w[i] = std::abs(extents.w[i]) * 0.2f;
+        glm::vec3 centre{centres.x[i], centres.y[i], centres.z[i]};
+        glm::vec3 extent = glm::abs(glm::vec3{extents.x[i], extents.y[i], extents.z[i]}) * 0.2f;
+        min.x[i] = centre.x - extent.x;
+        min.y[i] = centre.y - extent.y;
+        min.z[i] = centre.z - extent.z;
+        max.x[i] = centre.x + extent.x;
+        max.y[i] = centre.y + extent.y;
+        max.z[i] = centre.z + extent.z;
+        if (frustum.overlaps(Sphere{centre, extents.w[i]})) {
+            expected_spheres.push_back(static_cast<uint32_t>(i));
+        }
+        if (frustum.overlaps(Aabb{centre - extent, centre + extent})) {
+            expected_boxes.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    REQUIRE(!expected_spheres.empty());
+    REQUIRE(expected_spheres.size() < COUNT);
+    REQUIRE(!expected_boxes.empty());
+    REQUIRE(expected_boxes.size() < COUNT);
+
+    for_each_level([&] {
+        // results are appended to whatever the list already holds
+        std::vector<uint32_t> visible{99};
+        frustum_cull(frustum, SphereSoa<const float>{centres.vec3(), extents.w}, visible);
+        REQUIRE(visible.front() == 99);
+        REQUIRE(std::vector<uint32_t>{visible.begin() + 1, visible.end()} == expected_spheres);
+
+        visible.clear();
+        frustum_cull(frustum, AabbSoa<const float>{min.vec3(), max.vec3()}, visible);
+        REQUIRE(visible == expected_boxes);
+    });
+}
+
+TEST_CASE("simd level is clamped to the cpu", "[maths][batch]") {
+    REQUIRE(set_simd_level(SimdLevel::Avx512) == supported_simd_level());
+    REQUIRE(simd_level() == supported_simd_level());
+    REQUIRE(set_simd_level(SimdLevel::Scalar) == SimdLevel::Scalar);
+    set_simd_level(supported_simd_level());
+}
+
+} // namespace muon::maths
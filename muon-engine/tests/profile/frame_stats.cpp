@@ -0,0 +1,60 @@
+#include "muon/profile/frame_stats.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+namespace muon {
+
+using namespace std::chrono_literals;
+
+TEST_CASE("empty histogram reports zeros", "[frame_stats]") {
+    profile::RollingHistogram histogram{16};
+    auto stats = histogram.percentiles();
+    REQUIRE(stats.count == 0);
+    REQUIRE(stats.p99 == 0ns);
+    REQUIRE(stats.max == 0ns);
+}
+
+TEST_CASE("percentiles land within bucket precision", "[frame_stats]") {
+    profile::RollingHistogram histogram{1000};
+    for (uint32_t i = 1; i <= 1000; i++) {
+        histogram.record(std::chrono::microseconds{i});
+    }
+
+    auto stats = histogram.percentiles();
+    REQUIRE(stats.count == 1000);
+    REQUIRE(stats.max == 1000us);
+
+    auto within = [](profile::Duration actual, profile::Duration expected) {
+        auto error = actual > expected ? actual - expected : expected - actual;
+        return error.count() <= expected.count() / 25;
+    };
+    REQUIRE(within(stats.p50, 500us));
+    REQUIRE(within(stats.p95, 950us));
+    REQUIRE(within(stats.p99, 990us));
+}
+
+TEST_CASE("old samples fall out of the window", "[frame_stats]") {
+    profile::RollingHistogram histogram{4};
+    for (uint32_t i = 0; i < 4; i++) {
+        histogram.record(100ms);
+    }
+    for (uint32_t i = 0; i < 4; i++) {
+        histogram.record(1ms);
+    }
+
+    auto stats = histogram.percentiles();
+    REQUIRE(stats.count == 4);
+    REQUIRE(stats.max == 1ms);
+    REQUIRE(stats.p99 <= 1ms);
+}
+
+TEST_CASE("small values are exact", "[frame_stats]") {
+    profile::RollingHistogram histogram{8};
+    histogram.record(7ns);
+    REQUIRE(histogram.percentile(1.0) == 7ns);
+}
+
+} // namespace muon
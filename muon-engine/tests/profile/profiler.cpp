@@ -0,0 +1,69 @@
+#include "muon/profile/profiler.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "nlohmann/json.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+
+namespace muon::profile {
+
+TEST_CASE("captures write zones from every thread as a chrome trace", "[profile]") {
+    auto path = std::filesystem::temp_directory_path() / "muon-profiler-test.json";
+
+    { ScopedZone ignored{"before capture"}; }
+
+    capture(2, path);
+    REQUIRE(is_capturing());
+
+    {
+        ScopedZone outer{"outer"};
+        { ScopedZone inner{"inner"}; }
+    }
+    std::thread worker{[] { ScopedZone zone{"worker"}; }};
+    worker.join();
+    mark_frame();
+    REQUIRE(is_capturing());
+
+    { ScopedZone zone{intern("second frame")}; }
+    mark_frame();
+    REQUIRE_FALSE(is_capturing());
+
+    { ScopedZone ignored{"after capture"}; }
+
+    std::ifstream file{path};
+    REQUIRE(file);
+    auto trace = nlohmann::json::parse(file);
+    REQUIRE(trace["displayTimeUnit"] == "ms");
+
+    std::map<std::string, nlohmann::json> zones;
+    for (const auto &event : trace["traceEvents"]) {
+        REQUIRE(event["ph"] == "X");
+        REQUIRE(event["ts"].get<double>() >= 0.0);
+        REQUIRE(event["dur"].get<double>() >= 0.0);
+        zones[event["name"].get<std::string>()] = event;
+    }
+    REQUIRE(zones.size() == 4);
+    REQUIRE(zones.contains("outer"));
+    REQUIRE(zones.contains("inner"));
+    REQUIRE(zones.contains("worker"));
+    REQUIRE(zones.contains("second frame"));
+
+    // nested zones sit inside their parent on the same thread, other threads get their own track
+    auto begin = [&](const char *name) { return zones[name]["ts"].get<double>(); };
+    auto end = [&](const char *name) { return begin(name) + zones[name]["dur"].get<double>(); };
+    REQUIRE(begin("inner") >= begin("outer"));
+    REQUIRE(end("inner") <= end("outer"));
+    REQUIRE(begin("second frame") >= end("worker"));
+
+    REQUIRE(zones["inner"]["tid"] == zones["outer"]["tid"]);
+    REQUIRE(zones["second frame"]["tid"] == zones["outer"]["tid"]);
+    REQUIRE(zones["worker"]["tid"] != zones["outer"]["tid"]);
+
+    std::filesystem::remove(path);
+}
+
+} // namespace muon::profile
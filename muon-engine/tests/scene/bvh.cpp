@@ -0,0 +1,214 @@
+#include "muon/scene/bvh.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "muon/job/system.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace muon::scene {
+
+namespace {
+
+auto random_box(std::mt19937 &random, float world = 100.0f) -> maths::Aabb {
+    std::uniform_real_distribution<float> position{-world, world};
+    std::uniform_real_distribution<float> size{0.1f, 2.0f};
+    glm::vec3 center{position(random), position(random), position(random)};
+    return maths::Aabb::from_center(center, glm::vec3{size(random), size(random), size(random)});
+}
+
+template <typename Overlaps>
+auto brute_force(const Bvh &bvh, const std::vector<ProxyId> &proxies, Overlaps &&overlaps) -> std::vector<ProxyId> {
+    std::vector<ProxyId> found;
+    for (auto proxy : proxies) {
+        if (bvh.contains(proxy) && overlaps(bvh.bounds(proxy))) {
+            found.push_back(proxy);
+        }
+    }
+    std::ranges::sort(found);
+    return found;
+}
+
+auto sorted(std::vector<ProxyId> proxies) -> std::vector<ProxyId> {
+    std::ranges::sort(proxies);
+    return proxies;
+}
+
+// every kind of query against a brute force pass over the enlarged boxes
+void check_queries(const Bvh &bvh, const std::vector<ProxyId> &proxies, std::mt19937 &random) {
+    for (int i = 0; i < 20; i++) {
+        auto box = random_box(random);
+        box = maths::Aabb::from_center(box.center(), glm::vec3{15.0f});
+        std::vector<ProxyId> found;
+        bvh.query(box, found);
+        REQUIRE(sorted(found) == brute_force(bvh, proxies, [&](const maths::Aabb &other) { return box.overlaps(other); }));
+
+        maths::Sphere sphere{box.center(), 12.0f};
+        found.clear();
+        bvh.query(sphere, found);
+        REQUIRE(sorted(found) == brute_force(bvh, proxies, [&](const maths::Aabb &other) {
+                    auto delta = glm::max(other.min - sphere.center, glm::vec3{0.0f}) +
+                                 glm::max(sphere.center - other.max, glm::vec3{0.0f});
+                    return glm::dot(delta, delta) <= sphere.radius * sphere.radius;
+                }));
+    }
+
+    auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 80.0f);
+    auto view = glm::lookAt(glm::vec3{0.0f, 0.0f, 0.0f}, glm::vec3{1.0f, 0.2f, -0.5f}, glm::vec3{0.0f, 1.0f, 0.0f});
+    auto frustum = maths::Frustum::from_matrix(projection * view);
+    std::vector<ProxyId> visible;
+    bvh.query(frustum, visible);
+    REQUIRE(sorted(visible) == brute_force(bvh, proxies, [&](const maths::Aabb &other) { return frustum.overlaps(other); }));
+
+    for (int i = 0; i < 20; i++) {
+        maths::Ray ray{random_box(random).center(), glm::normalize(random_box(random).center())};
+        auto hit = bvh.raycast(ray);
+
+        auto closest = std::numeric_limits<float>::infinity();
+        for (auto proxy : proxies) {
+            if (bvh.contains(proxy)) {
+                closest = std::min(closest, maths::intersect(ray, bvh.bounds(proxy)));
+            }
+        }
+        if (closest == std::numeric_limits<float>::infinity()) {
+            REQUIRE(!hit);
+        } else {
+            REQUIRE(hit);
+            REQUIRE(std::abs(hit->distance - closest) < 1e-3f);
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("incremental inserts answer queries like brute force", "[scene][bvh]") {
+    std::mt19937 random{7};
+    Bvh bvh;
+    std::vector<ProxyId> proxies;
+    for (uint64_t i = 0; i < 2000; i++) {
+        proxies.push_back(bvh.create(random_box(random), i));
+    }
+
+    REQUIRE(bvh.size() == 2000);
+    REQUIRE(bvh.user_data(proxies[42]) == 42);
+    REQUIRE(bvh.height() < 40);
+    check_queries(bvh, proxies, random);
+}
+
+TEST_CASE("moving and destroying keeps the tree valid", "[scene][bvh]") {
+    std::mt19937 random{11};
+    Bvh bvh;
+    std::vector<ProxyId> proxies;
+    for (int i = 0; i < 1000; i++) {
+        proxies.push_back(bvh.create(random_box(random)));
+    }
+
+    // small moves stay inside the margin, large ones reinsert
+    auto small = bvh.bounds(proxies[0]);
+    REQUIRE(!bvh.move(proxies[0], {small.min + glm::vec3{0.15f}, small.max - glm::vec3{0.15f}}));
+    REQUIRE(bvh.move(proxies[0], random_box(random)));
+
+    std::vector<maths::Aabb> boxes;
+    for (size_t i = 0; i < proxies.size(); i += 2) {
+        boxes.push_back(random_box(random));
+    }
+    std::vector<ProxyId> moving;
+    for (size_t i = 0; i < proxies.size(); i += 2) {
+        moving.push_back(proxies[i]);
+    }
+    REQUIRE(bvh.move(moving, boxes) > 0);
+
+    for (size_t i = 0; i < proxies.size(); i += 3) {
+        bvh.destroy(proxies[i]);
+    }
+    REQUIRE(!bvh.contains(proxies[0]));
+    check_queries(bvh, proxies, random);
+
+    // freed proxies are reused
+    auto reused = bvh.create(random_box(random));
+    REQUIRE(std::ranges::find(proxies, reused) != proxies.end());
+    proxies.push_back(reused);
+    check_queries(bvh, proxies, random);
+}
+
+TEST_CASE("bulk builds use the job system", "[scene][bvh]") {
+    std::mt19937 random{13};
+    std::vector<maths::Aabb> boxes;
+    std::vector<uint64_t> user_data;
+    for (uint64_t i = 0; i < 20000; i++) {
+        boxes.push_back(random_box(random, 500.0f));
+        user_data.push_back(i * 3);
+    }
+
+    job::System jobs{3};
+    Bvh bvh{0.0f};
+    std::vector<ProxyId> proxies(boxes.size());
+    bvh.create(boxes, user_data, proxies, &jobs);
+    REQUIRE(bvh.size() == boxes.size());
+    REQUIRE(bvh.user_data(proxies[100]) == 300);
+    REQUIRE(bvh.bounds(proxies[100]) == boxes[100]);
+    check_queries(bvh, proxies, random);
+
+    // inserting one by one gives a worse tree than the sah build, but not by much thanks to the rotations
+    Bvh incremental{0.0f};
+    for (const auto &box : boxes) {
+        incremental.create(box);
+    }
+    REQUIRE(bvh.cost() <= incremental.cost() * 1.2f);
+
+    // a small batch is inserted into the existing tree
+    std::vector<ProxyId> more(100);
+    bvh.create(std::span{boxes}.first(100), {}, more);
+    proxies.insert(proxies.end(), more.begin(), more.end());
+    check_queries(bvh, proxies, random);
+
+    // removing most of the tree rebuilds the rest
+    bvh.destroy(std::span{proxies}.first(15000), &jobs);
+    REQUIRE(bvh.size() == 5100);
+    check_queries(bvh, proxies, random);
+}
+
+TEST_CASE("refitting follows boxes changed in place", "[scene][bvh]") {
+    std::mt19937 random{17};
+    Bvh bvh{0.0f};
+    std::vector<ProxyId> proxies;
+    for (int i = 0; i < 1000; i++) {
+        proxies.push_back(bvh.create(random_box(random)));
+    }
+
+    for (size_t i = 0; i < proxies.size(); i += 4) {
+        auto box = bvh.bounds(proxies[i]);
+        bvh.set_bounds(proxies[i], {box.min + glm::vec3{1.0f}, box.max + glm::vec3{1.5f}});
+    }
+    bvh.refit();
+    check_queries(bvh, proxies, random);
+}
+
+TEST_CASE("ray filters narrow hits down to the shape", "[scene][bvh]") {
+    Bvh bvh{0.0f};
+    auto front = bvh.create(maths::Aabb{glm::vec3{-1.0f, -1.0f, -6.0f}, glm::vec3{1.0f, 1.0f, -4.0f}});
+    auto back = bvh.create(maths::Aabb{glm::vec3{-1.0f, -1.0f, -11.0f}, glm::vec3{1.0f, 1.0f, -9.0f}});
+
+    maths::Ray ray{glm::vec3{0.0f}, glm::vec3{0.0f, 0.0f, -1.0f}};
+    auto hit = bvh.raycast(ray);
+    REQUIRE(hit);
+    REQUIRE(hit->proxy == front);
+    REQUIRE(hit->distance == 4.0f);
+
+    REQUIRE(!bvh.raycast(ray, 3.0f));
+
+    // the front proxy's shape turns out to be hollow
+    hit = bvh.raycast(ray, 100.0f, [&](ProxyId proxy, float distance) {
+        return proxy == front ? std::numeric_limits<float>::infinity() : distance + 0.5f;
+    });
+    REQUIRE(hit);
+    REQUIRE(hit->proxy == back);
+    REQUIRE(hit->distance == 9.5f);
+}
+
+} // namespace muon::scene
@@ -0,0 +1,185 @@
+#include "muon/scene/transform.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "muon/job/system.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace muon::scene {
+
+namespace {
+
+auto matrix_of(const Transform &local) -> glm::mat4 {
+    return glm::translate(glm::mat4{1.0f}, local.translation) * glm::mat4_cast(local.rotation) *
+           glm::scale(glm::mat4{1.0f}, local.scale);
+}
+
+auto close(const glm::mat4 &a, const glm::mat4 &b) -> bool {
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            if (std::abs(a[column][row] - b[column][row]) > 1e-4f) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+auto make_transform(float seed) -> Transform {
+    return {
+        glm::vec3{seed, -seed * 0.5f, 2.0f},
+        glm::angleAxis(seed * 0.3f, glm::normalize(glm::vec3{1.0f, seed, 0.5f})),
+        glm::vec3{1.0f + seed * 0.1f, 1.0f, 0.5f},
+    };
+}
+
+} // namespace
+
+TEST_CASE("world matrices compose down the hierarchy", "[scene][transform]") {
+    TransformHierarchy hierarchy;
+    auto a = make_transform(1.0f);
+    auto b = make_transform(2.0f);
+    auto c = make_transform(3.0f);
+
+    auto root = hierarchy.create(a);
+    auto child = hierarchy.create(root, b);
+    auto grandchild = hierarchy.create(child, c);
+    auto sibling = hierarchy.create(root, c);
+    REQUIRE(hierarchy.update() == 4);
+
+    REQUIRE(close(hierarchy.world(root), matrix_of(a)));
+    REQUIRE(close(hierarchy.world(child), matrix_of(a) * matrix_of(b)));
+    REQUIRE(close(hierarchy.world(grandchild), matrix_of(a) * matrix_of(b) * matrix_of(c)));
+    REQUIRE(close(hierarchy.world(sibling), matrix_of(a) * matrix_of(c)));
+    REQUIRE(hierarchy.parent(grandchild) == child);
+    REQUIRE(!hierarchy.parent(root));
+}
+
+TEST_CASE("updates only recompute changed subtrees", "[scene][transform]") {
+    TransformHierarchy hierarchy;
+    auto root = hierarchy.create();
+    auto branch = hierarchy.create(root);
+    std::vector<Node> leaves;
+    for (size_t i = 0; i < 10; i++) {
+        leaves.push_back(hierarchy.create(branch, make_transform(static_cast<float>(i))));
+    }
+    auto other = hierarchy.create(root);
+    REQUIRE(hierarchy.size() == 13);
+    REQUIRE(hierarchy.update() == 13);
+    REQUIRE(hierarchy.update() == 0);
+
+    hierarchy.set_translation(leaves[3], glm::vec3{0.0f, 1.0f, 0.0f});
+    REQUIRE(hierarchy.update() == 1);
+
+    hierarchy.set_scale(branch, glm::vec3{2.0f});
+    REQUIRE(hierarchy.update() == 11);
+    REQUIRE(hierarchy.local(leaves[3]).translation == glm::vec3{0.0f, 1.0f, 0.0f});
+    REQUIRE(close(hierarchy.world(leaves[3]), matrix_of({.scale = glm::vec3{2.0f}}) * matrix_of(hierarchy.local(leaves[3]))));
+
+    hierarchy.set_rotation(other, glm::angleAxis(1.0f, glm::vec3{0.0f, 0.0f, 1.0f}));
+    hierarchy.set_translation(leaves[0], glm::vec3{1.0f});
+    REQUIRE(hierarchy.update() == 2);
+
+    hierarchy.set_translation(root, glm::vec3{5.0f, 0.0f, 0.0f});
+    REQUIRE(hierarchy.update() == 13);
+    REQUIRE(hierarchy.update() == 0);
+}
+
+TEST_CASE("reparenting keeps the local transform", "[scene][transform]") {
+    TransformHierarchy hierarchy;
+    auto a = make_transform(1.0f);
+    auto b = make_transform(2.0f);
+    auto c = make_transform(3.0f);
+
+    auto first = hierarchy.create(a);
+    auto second = hierarchy.create(b);
+    auto node = hierarchy.create(first, c);
+    auto below = hierarchy.create(node, a);
+    hierarchy.update();
+
+    hierarchy.set_parent(node, second);
+    REQUIRE(hierarchy.parent(node) == second);
+    REQUIRE(hierarchy.update() == 2);
+    REQUIRE(close(hierarchy.world(node), matrix_of(b) * matrix_of(c)));
+    REQUIRE(close(hierarchy.world(below), matrix_of(b) * matrix_of(c) * matrix_of(a)));
+
+    // moving second below below's old grandparent makes it deeper, which still has to update in order
+    hierarchy.set_parent(second, first);
+    hierarchy.update();
+    REQUIRE(close(hierarchy.world(below), matrix_of(a) * matrix_of(b) * matrix_of(c) * matrix_of(a)));
+
+    hierarchy.set_parent(node, std::nullopt);
+    REQUIRE(!hierarchy.parent(node));
+    hierarchy.update();
+    REQUIRE(close(hierarchy.world(below), matrix_of(c) * matrix_of(a)));
+    REQUIRE(hierarchy.local(below).translation == a.translation);
+}
+
+TEST_CASE("destroying a node takes its subtree with it", "[scene][transform]") {
+    TransformHierarchy hierarchy;
+    auto root = hierarchy.create(make_transform(1.0f));
+    auto node = hierarchy.create(root);
+    auto child = hierarchy.create(node);
+    auto grandchild = hierarchy.create(child);
+    auto kept = hierarchy.create(root, make_transform(2.0f));
+    hierarchy.update();
+
+    hierarchy.destroy(node);
+    REQUIRE(hierarchy.size() == 2);
+    REQUIRE(!hierarchy.contains(node));
+    REQUIRE(!hierarchy.contains(child));
+    REQUIRE(!hierarchy.contains(grandchild));
+    REQUIRE(hierarchy.contains(kept));
+
+    // slots are reused under a new generation
+    auto reused = hierarchy.create(kept, make_transform(3.0f));
+    REQUIRE(!hierarchy.contains(node));
+    REQUIRE(!hierarchy.contains(child));
+    REQUIRE(!hierarchy.contains(grandchild));
+    REQUIRE(hierarchy.contains(reused));
+
+    REQUIRE(hierarchy.update() == 1);
+    REQUIRE(close(hierarchy.world(kept), matrix_of(make_transform(1.0f)) * matrix_of(make_transform(2.0f))));
+    REQUIRE(close(
+        hierarchy.world(reused),
+        matrix_of(make_transform(1.0f)) * matrix_of(make_transform(2.0f)) * matrix_of(make_transform(3.0f))
+    ));
+}
+
+TEST_CASE("parallel updates match serial ones", "[scene][transform]") {
+    constexpr size_t WIDTH = 10000;
+    job::System jobs{2};
+    TransformHierarchy serial;
+    TransformHierarchy parallel;
+
+    auto serial_root = serial.create(make_transform(0.5f));
+    auto parallel_root = parallel.create(make_transform(0.5f));
+    std::vector<Node> serial_nodes;
+    std::vector<Node> parallel_nodes;
+    for (size_t i = 0; i < WIDTH; i++) {
+        auto local = make_transform(static_cast<float>(i % 17));
+        auto serial_parent = serial.create(serial_root, local);
+        auto parallel_parent = parallel.create(parallel_root, local);
+        serial_nodes.push_back(serial.create(serial_parent, local));
+        parallel_nodes.push_back(parallel.create(parallel_parent, local));
+    }
+
+    REQUIRE(serial.update() == WIDTH * 2 + 1);
+    REQUIRE(parallel.update(&jobs) == WIDTH * 2 + 1);
+
+    serial.set_translation(serial_root, glm::vec3{1.0f, 2.0f, 3.0f});
+    parallel.set_translation(parallel_root, glm::vec3{1.0f, 2.0f, 3.0f});
+    REQUIRE(serial.update() == WIDTH * 2 + 1);
+    REQUIRE(parallel.update(&jobs) == WIDTH * 2 + 1);
+    REQUIRE(parallel.update(&jobs) == 0);
+
+    for (size_t i = 0; i < WIDTH; i += 97) {
+        REQUIRE(close(serial.world(serial_nodes[i]), parallel.world(parallel_nodes[i])));
+    }
+}
+
+} // namespace muon::scene
@@ -0,0 +1,142 @@
+#include "muon/serde/binary.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace muon::serde {
+
+namespace {
+
+enum class Shape : uint8_t {
+    Box,
+    Sphere,
+    Capsule,
+};
+
+enum class Layer : int32_t {
+    Background = -1,
+    World = 0,
+    Overlay = 1000,
+};
+
+struct Vertex {
+    std::array<float, 3> position;
+    std::array<float, 2> uv;
+};
+
+struct Mesh {
+    Uuid id;
+    std::string name;
+    Shape shape;
+    Layer layer;
+    bool visible;
+    int64_t offset;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::optional<double> scale;
+};
+
+struct Tagged {
+    std::string_view tag;
+    crypto::Hash hash;
+};
+
+} // namespace
+
+TEST_CASE("aggregates are reflected", "[serde][binary]") {
+    STATIC_REQUIRE(internal::count_fields<Vertex>() == 2);
+    STATIC_REQUIRE(internal::count_fields<Mesh>() == 9);
+    STATIC_REQUIRE(internal::is_blittable<Vertex>());
+    STATIC_REQUIRE_FALSE(internal::is_blittable<Mesh>());
+    STATIC_REQUIRE(BinaryReflectable<Mesh>);
+    STATIC_REQUIRE(BinarySerializable<Mesh>);
+    STATIC_REQUIRE(Binarydeserializable<Mesh>);
+}
+
+TEST_CASE("aggregates round trip", "[serde][binary]") {
+    Mesh mesh;
+    mesh.id = Uuid::uuid4();
+    mesh.name = "crate";
+    mesh.shape = Shape::Capsule;
+    mesh.layer = Layer::Background;
+    mesh.visible = true;
+    mesh.offset = -123456789012;
+    mesh.vertices = {{{0.0f, 1.0f, 2.0f}, {0.5f, 0.5f}}, {{-1.0f, 0.0f, 4.0f}, {0.0f, 1.0f}}};
+    mesh.indices = {0, 1, 300, 70000};
+    mesh.scale = 2.5;
+
+    auto buffer = serialize<Mesh, Buffer>(mesh);
+    REQUIRE(buffer.size() == binary_size(mesh));
+
+    auto decoded = deserialize<BufferView, Mesh, BinaryDeserializeError>(buffer);
+    REQUIRE(decoded.has_value());
+    REQUIRE(std::ranges::equal(decoded->id, mesh.id));
+    REQUIRE(decoded->name == mesh.name);
+    REQUIRE(decoded->shape == mesh.shape);
+    REQUIRE(decoded->layer == mesh.layer);
+    REQUIRE(decoded->visible);
+    REQUIRE(decoded->offset == mesh.offset);
+    REQUIRE(decoded->vertices.size() == 2);
+    REQUIRE(decoded->vertices[1].position == mesh.vertices[1].position);
+    REQUIRE(decoded->vertices[1].uv == mesh.vertices[1].uv);
+    REQUIRE(decoded->indices == mesh.indices);
+    REQUIRE(decoded->scale == mesh.scale);
+}
+
+TEST_CASE("integers are varint encoded", "[serde][binary]") {
+    REQUIRE(binary_size(uint32_t{1}) == 1);
+    REQUIRE(binary_size(uint32_t{300}) == 2);
+    REQUIRE(binary_size(int64_t{-1}) == 1);
+    REQUIRE(binary_size(UINT64_MAX) == 10);
+    REQUIRE(binary_size(std::vector<uint16_t>{1, 2, 3}) == 4);
+    REQUIRE(binary_size(std::vector<float>{1.0f, 2.0f, 3.0f}) == 1 + 3 * sizeof(float));
+
+    for (int64_t value : {INT64_MIN, int64_t{-300}, int64_t{-1}, int64_t{0}, int64_t{64}, INT64_MAX}) {
+        auto decoded = from_binary<int64_t>(to_binary(value));
+        REQUIRE(decoded == value);
+    }
+}
+
+TEST_CASE("string views borrow from the buffer", "[serde][binary]") {
+    Tagged tagged{.tag = "player", .hash = crypto::Hash{}};
+    tagged.hash.data()[0] = 0xab;
+
+    auto buffer = to_binary(tagged);
+    auto decoded = from_binary<Tagged>(buffer);
+    REQUIRE(decoded.has_value());
+    REQUIRE(decoded->tag == "player");
+    REQUIRE(reinterpret_cast<const uint8_t *>(decoded->tag.data()) > buffer.data());
+    REQUIRE(reinterpret_cast<const uint8_t *>(decoded->tag.data()) < buffer.end());
+    REQUIRE(decoded->hash == tagged.hash);
+}
+
+TEST_CASE("malformed input is rejected", "[serde][binary]") {
+    auto buffer = to_binary(std::vector<std::string>{"first", "second"});
+
+    REQUIRE(from_binary<std::vector<std::string>>(BufferView{buffer.data(), buffer.size() - 1}).error() ==
+            BinaryDeserializeError::UnexpectedEnd);
+    REQUIRE(from_binary<std::string>(buffer).error() == BinaryDeserializeError::TrailingData);
+
+    std::array<uint8_t, 11> overlong{0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01};
+    REQUIRE(from_binary<uint64_t>(BufferView{overlong.data(), overlong.size()}).error() == BinaryDeserializeError::InvalidVarint);
+
+    std::array<uint8_t, 3> wide{0x80, 0x80, 0x04};
+    REQUIRE(from_binary<uint16_t>(BufferView{wide.data(), wide.size()}).error() == BinaryDeserializeError::InvalidVarint);
+
+    std::array<uint8_t, 1> flag{2};
+    REQUIRE(from_binary<bool>(BufferView{flag.data(), flag.size()}).error() == BinaryDeserializeError::InvalidValue);
+
+    // a count larger than the input fails before allocating
+    std::array<uint8_t, 5> count{0xff, 0xff, 0xff, 0xff, 0x0f};
+    REQUIRE(from_binary<std::vector<Vertex>>(BufferView{count.data(), count.size()}).error() ==
+            BinaryDeserializeError::UnexpectedEnd);
+}
+
+} // namespace muon::serde
@@ -0,0 +1,139 @@
+#include "muon/serde/blob.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+namespace muon::serde {
+
+namespace {
+
+constexpr uint32_t SCHEMA = 3;
+
+struct MeshInfo {
+    RelString name;
+    uint32_t vertex_count;
+    std::array<float, 6> bounds;
+};
+
+struct SceneInfo {
+    uint64_t id;
+    RelString name;
+    RelVector<MeshInfo> meshes;
+    RelPtr<MeshInfo> selected;
+};
+
+auto build_scene() -> std::pair<Buffer, BlobRef<SceneInfo>> {
+    BlobBuilder builder{SCHEMA};
+    auto scene = builder.add<SceneInfo>();
+    builder.get(scene).id = 42;
+    builder.link(scene, &SceneInfo::name, builder.add_string("level one"));
+
+    std::vector<MeshInfo> infos(3);
+    for (uint32_t i = 0; i < infos.size(); i++) {
+        infos[i].vertex_count = 100 * (i + 1);
+        infos[i].bounds = {0.0f, 0.0f, 0.0f, 1.0f, 2.0f, static_cast<float>(i)};
+    }
+    auto meshes = builder.add_vector<MeshInfo>(infos);
+    builder.link(scene, &SceneInfo::meshes, meshes);
+    builder.link(meshes.at(0), &MeshInfo::name, builder.add_string("floor"));
+    builder.link(meshes.at(1), &MeshInfo::name, builder.add_string("wall"));
+    builder.link(meshes.at(2), &MeshInfo::name, builder.add_string("roof"));
+    builder.link(scene, &SceneInfo::selected, meshes.at(1));
+
+    return {builder.finish(scene), scene};
+}
+
+} // namespace
+
+TEST_CASE("blobs are read in place", "[serde][blob]") {
+    auto [buffer, ref] = build_scene();
+    REQUIRE(buffer.alignment() >= BLOB_ALIGNMENT);
+    REQUIRE(reinterpret_cast<uintptr_t>(buffer.data()) % BLOB_ALIGNMENT == 0);
+
+    auto scene = blob_root<SceneInfo>(buffer, SCHEMA);
+    REQUIRE(scene.has_value());
+    REQUIRE((*scene)->id == 42);
+    REQUIRE((*scene)->name.view() == "level one");
+    REQUIRE((*scene)->meshes.size() == 3);
+    REQUIRE((*scene)->meshes[2].name.view() == "roof");
+    REQUIRE((*scene)->meshes[2].vertex_count == 300);
+    REQUIRE((*scene)->meshes[2].bounds[5] == 2.0f);
+    REQUIRE((*scene)->selected->name.view() == "wall");
+
+    // nothing was copied out of the buffer
+    auto *begin = reinterpret_cast<const std::byte *>(buffer.data());
+    auto *name = reinterpret_cast<const std::byte *>((*scene)->meshes[0].name.c_str());
+    REQUIRE(name > begin);
+    REQUIRE(name < begin + buffer.size());
+}
+
+TEST_CASE("blobs are read from mapped files", "[serde][blob]") {
+    auto path = std::filesystem::temp_directory_path() / "muon-scene.blob";
+    {
+        auto [buffer, ref] = build_scene();
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    }
+
+    {
+        auto blob = MappedBlob::open(path);
+        REQUIRE(blob.has_value());
+        auto scene = blob->root<SceneInfo>(SCHEMA);
+        REQUIRE(scene.has_value());
+        REQUIRE((*scene)->meshes[1].name.view() == "wall");
+        REQUIRE(blob->root<SceneInfo>(SCHEMA + 1).error() == BlobError::SchemaMismatch);
+    }
+
+    std::filesystem::remove(path);
+    REQUIRE(MappedBlob::open(path).error() == BlobError::FileOpenFailure);
+}
+
+TEST_CASE("corrupt blobs are rejected", "[serde][blob]") {
+    auto [buffer, ref] = build_scene();
+    auto *scene = reinterpret_cast<SceneInfo *>(buffer.data() + ref.position);
+
+    SECTION("truncated") {
+        REQUIRE(blob_root<SceneInfo>(BufferView{buffer.data(), buffer.size() - 1}, SCHEMA).error() ==
+                BlobError::InvalidHeader);
+    }
+
+    SECTION("offset outside the blob") {
+        int32_t offset = static_cast<int32_t>(buffer.size());
+        std::memcpy(static_cast<void *>(&scene->name), &offset, sizeof(offset));
+        REQUIRE(blob_root<SceneInfo>(buffer, SCHEMA).error() == BlobError::OutOfBounds);
+    }
+
+    SECTION("offset into the header") {
+        int32_t offset = 8 - static_cast<int32_t>(ref.position + offsetof(SceneInfo, selected));
+        std::memcpy(static_cast<void *>(&scene->selected), &offset, sizeof(offset));
+        REQUIRE(blob_root<SceneInfo>(buffer, SCHEMA).error() == BlobError::OutOfBounds);
+    }
+
+    SECTION("misaligned object") {
+        int32_t offset = scene->selected.offset() + 1;
+        std::memcpy(static_cast<void *>(&scene->selected), &offset, sizeof(offset));
+        REQUIRE(blob_root<SceneInfo>(buffer, SCHEMA).error() == BlobError::Misaligned);
+    }
+
+    SECTION("vector larger than the blob") {
+        uint32_t size = UINT32_MAX;
+        std::memcpy(reinterpret_cast<std::byte *>(&scene->meshes) + sizeof(int32_t), &size, sizeof(size));
+        REQUIRE(blob_root<SceneInfo>(buffer, SCHEMA).error() == BlobError::OutOfBounds);
+    }
+
+    SECTION("unterminated string") {
+        auto *name = const_cast<char *>(scene->name.c_str());
+        name[scene->name.size()] = '!';
+        REQUIRE(blob_root<SceneInfo>(buffer, SCHEMA).error() == BlobError::Unterminated);
+    }
+}
+
+} // namespace muon::serde
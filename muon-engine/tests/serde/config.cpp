@@ -0,0 +1,113 @@
+#include "muon/serde/config.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace muon::serde {
+
+namespace {
+
+struct WindowConfig {
+    uint32_t width;
+    uint32_t height;
+    bool vsync;
+};
+
+struct ProjectConfig {
+    std::string name;
+    WindowConfig window;
+    std::vector<std::string> plugins;
+};
+
+uint32_t parse_count = 0;
+
+void write_text(const std::filesystem::path &path, std::string_view text) {
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+} // namespace
+
+template <>
+auto deserialize<toml::table, ProjectConfig, TomlDeserializeError>(const toml::table &table)
+    -> std::expected<ProjectConfig, TomlDeserializeError> {
+    parse_count++;
+
+    auto name = table["name"].value<std::string>();
+    auto width = table["window"]["width"].value<uint32_t>();
+    auto height = table["window"]["height"].value<uint32_t>();
+    auto vsync = table["window"]["vsync"].value<bool>();
+    const auto *plugins = table["plugins"].as_array();
+    if (!name || !width || !height || !vsync || !plugins) {
+        return std::unexpected(TomlDeserializeError::FieldNotPresent);
+    }
+
+    ProjectConfig config{.name = *name, .window = {*width, *height, *vsync}, .plugins = {}};
+    for (const auto &plugin : *plugins) {
+        if (auto value = plugin.value<std::string>()) {
+            config.plugins.push_back(*value);
+        }
+    }
+    return config;
+}
+
+TEST_CASE("config snapshots are reused until the file changes", "[serde][config]") {
+    auto directory = std::filesystem::temp_directory_path() / "muon-config";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    auto path = directory / "project.toml";
+
+    write_text(path, "name = \"sandbox\"\nplugins = [\"audio\", \"physics\"]\n\n[window]\nwidth = 1280\nheight = 720\nvsync = true\n");
+    parse_count = 0;
+
+    auto first = load_config<ProjectConfig>(path);
+    REQUIRE(first.has_value());
+    REQUIRE(first->name == "sandbox");
+    REQUIRE(first->window.width == 1280);
+    REQUIRE(first->plugins == std::vector<std::string>{"audio", "physics"});
+    REQUIRE(parse_count == 1);
+    REQUIRE(std::filesystem::exists(internal::snapshot_path(path)));
+
+    auto second = load_config<ProjectConfig>(path);
+    REQUIRE(second.has_value());
+    REQUIRE(second->plugins == first->plugins);
+    REQUIRE(second->window.vsync);
+    REQUIRE(parse_count == 1);
+
+    write_text(path, "name = \"sandbox\"\nplugins = []\n\n[window]\nwidth = 640\nheight = 480\nvsync = false\n");
+    auto third = load_config<ProjectConfig>(path);
+    REQUIRE(third.has_value());
+    REQUIRE(third->window.width == 640);
+    REQUIRE(third->plugins.empty());
+    REQUIRE(parse_count == 2);
+
+    // a damaged snapshot falls back to parsing
+    write_text(internal::snapshot_path(path), "not a snapshot");
+    REQUIRE(load_config<ProjectConfig>(path)->window.height == 480);
+    REQUIRE(parse_count == 3);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("config errors are reported", "[serde][config]") {
+    auto directory = std::filesystem::temp_directory_path() / "muon-config-errors";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    auto path = directory / "project.toml";
+
+    REQUIRE(load_config<ProjectConfig>(path).error() == ConfigError::FileReadFailure);
+
+    write_text(path, "name = \"sandbox\"\n");
+    REQUIRE(load_config<ProjectConfig>(path).error() == ConfigError::DeserializeFailure);
+    REQUIRE_FALSE(std::filesystem::exists(internal::snapshot_path(path)));
+
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace muon::serde
@@ -0,0 +1,99 @@
+#include "muon/serde/json.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace muon::serde {
+
+namespace {
+
+enum class Kind : uint8_t {
+    Empty,
+    Mesh,
+    Light,
+};
+
+struct Node {
+    static constexpr std::array JSON_FIELDS{"name", "kind", "position", "children", "parent"};
+
+    std::string name;
+    Kind kind;
+    std::array<float, 3> position;
+    std::vector<uint32_t> children;
+    std::optional<uint32_t> parent;
+};
+
+struct Scene {
+    static constexpr std::array JSON_FIELDS{"version", "nodes"};
+
+    uint32_t version;
+    std::vector<Node> nodes;
+};
+
+constexpr std::string_view SCENE = R"({
+    "version": 2,
+    "exporter": {"name": "tool", "flags": [1, 2, {"deep": null}]},
+    "nodes": [
+        {"name": "root", "kind": "Empty", "position": [0, 0, 0], "children": [1, 2], "parent": null},
+        {"name": "crate", "kind": 1, "position": [1.5, -2, 3.25], "children": [], "parent": 0},
+        {"name": "sun", "kind": "Light", "position": [0, 100, 0], "unknown": "skipped", "parent": 0}
+    ]
+})";
+
+} // namespace
+
+TEST_CASE("json streams into typed targets", "[serde][json]") {
+    STATIC_REQUIRE(JsonStreamable<Scene>);
+    STATIC_REQUIRE(JsonDeserializable<Scene>);
+
+    auto scene = stream_json<Scene>(SCENE);
+    REQUIRE(scene.has_value());
+    REQUIRE(scene->version == 2);
+    REQUIRE(scene->nodes.size() == 3);
+
+    REQUIRE(scene->nodes[0].name == "root");
+    REQUIRE(scene->nodes[0].kind == Kind::Empty);
+    REQUIRE(scene->nodes[0].children == std::vector<uint32_t>{1, 2});
+    REQUIRE_FALSE(scene->nodes[0].parent.has_value());
+
+    REQUIRE(scene->nodes[1].kind == Kind::Mesh);
+    REQUIRE(scene->nodes[1].position == std::array{1.5f, -2.0f, 3.25f});
+    REQUIRE(scene->nodes[1].parent == 0u);
+
+    REQUIRE(scene->nodes[2].kind == Kind::Light);
+    REQUIRE(scene->nodes[2].children.empty());
+}
+
+TEST_CASE("json files deserialize through serde", "[serde][json]") {
+    auto path = std::filesystem::temp_directory_path() / "muon-scene.json";
+    {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        file << SCENE;
+    }
+
+    auto scene = deserialize<JsonFile, Scene, JsonDeserializeError>(JsonFile{path});
+    REQUIRE(scene.has_value());
+    REQUIRE(scene->nodes[2].name == "sun");
+
+    std::filesystem::remove(path);
+    REQUIRE(deserialize<JsonFile, Scene, JsonDeserializeError>(JsonFile{path}).error() == JsonDeserializeError::FileOpenFailure);
+}
+
+TEST_CASE("json errors are reported", "[serde][json]") {
+    REQUIRE(stream_json<Scene>(R"({"version": 2, "nodes": [)").error() == JsonDeserializeError::ParseFailure);
+    REQUIRE(stream_json<Scene>(R"({"version": "two"})").error() == JsonDeserializeError::TypeMismatch);
+    REQUIRE(stream_json<Scene>(R"({"version": -1})").error() == JsonDeserializeError::TypeMismatch);
+    REQUIRE(stream_json<Scene>(R"({"nodes": {}})").error() == JsonDeserializeError::TypeMismatch);
+    REQUIRE(stream_json<Scene>(R"({"nodes": [{"kind": "Camera"}]})").error() == JsonDeserializeError::TypeMismatch);
+    REQUIRE(stream_json<Scene>(R"({"nodes": [{"position": [1, 2, 3, 4]}]})").error() == JsonDeserializeError::TypeMismatch);
+}
+
+} // namespace muon::serde
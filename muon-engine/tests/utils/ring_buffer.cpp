@@ -0,0 +1,65 @@
+#include "muon/utils/ring_buffer.hpp"
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <thread>
+
+namespace muon {
+
+TEST_CASE("capacity rounds up to a power of two", "[ring_buffer]") {
+    utils::RingBuffer<uint32_t> buffer{5};
+    REQUIRE(buffer.capacity() == 8);
+}
+
+TEST_CASE("pop from empty buffer fails", "[ring_buffer]") {
+    utils::RingBuffer<uint32_t> buffer{4};
+    REQUIRE(!buffer.pop().has_value());
+}
+
+TEST_CASE("push to full buffer fails", "[ring_buffer]") {
+    utils::RingBuffer<uint32_t> buffer{4};
+    for (uint32_t i = 0; i < 4; i++) {
+        REQUIRE(buffer.push(i));
+    }
+    REQUIRE(!buffer.push(4u));
+    REQUIRE(buffer.size() == 4);
+}
+
+TEST_CASE("values pop in push order", "[ring_buffer]") {
+    utils::RingBuffer<uint32_t> buffer{4};
+    for (uint32_t round = 0; round < 3; round++) {
+        for (uint32_t i = 0; i < 3; i++) {
+            REQUIRE(buffer.push(round * 3 + i));
+        }
+        for (uint32_t i = 0; i < 3; i++) {
+            REQUIRE(buffer.pop() == round * 3 + i);
+        }
+    }
+}
+
+TEST_CASE("producer and consumer threads agree on order", "[ring_buffer]") {
+    constexpr uint32_t count = 100000;
+    utils::RingBuffer<uint32_t> buffer{64};
+
+    std::jthread producer{[&] {
+        for (uint32_t i = 0; i < count; i++) {
+            while (!buffer.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < count) {
+        if (auto value = buffer.pop()) {
+            ordered = ordered && *value == expected;
+            expected += 1;
+        }
+    }
+
+    REQUIRE(ordered);
+}
+
+} // namespace muon
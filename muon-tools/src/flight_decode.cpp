@@ -0,0 +1,59 @@
+#include "fmt/chrono.h"
+#include "fmt/format.h"
+#include "muon/core/flight_recorder.hpp"
+#include "spdlog/common.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+namespace {
+
+auto kind_name(const muon::log::FlightRecord &record) -> std::string_view {
+    switch (record.kind) {
+        case muon::log::FlightRecordKind::Log: {
+            auto level = spdlog::level::to_string_view(record.level);
+            return {level.data(), level.size()};
+        }
+        case muon::log::FlightRecordKind::Event:
+            return "event";
+        case muon::log::FlightRecordKind::Frame:
+            return "frame";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+auto main(int32_t count, char **arguments) -> int32_t {
+    if (count != 2) {
+        fmt::println(stderr, "usage: {} <file.flight>", arguments[0]);
+        return 1;
+    }
+
+    auto dump = muon::log::read_flight_recorder(arguments[1]);
+    if (!dump) {
+        if (dump.error() == muon::log::FlightRecorderError::FileOpenFailure) {
+            fmt::println(stderr, "failed to open {}", arguments[1]);
+        } else {
+            fmt::println(stderr, "{} is not a muon flight recorder", arguments[1]);
+        }
+        return 1;
+    }
+
+    for (const auto &record : dump->records) {
+        auto timestamp = std::chrono::sys_time<std::chrono::nanoseconds>{std::chrono::nanoseconds{record.time}};
+        std::string_view source{record.source};
+        fmt::println(
+            "{:%T} [{:>3}] [{:>8}] {}{}{}", timestamp, record.thread, kind_name(record), source, source.empty() ? "" : ": ",
+            record.text
+        );
+    }
+
+    fmt::println(
+        "-- {} records, {} overwritten or torn, {} --", dump->records.size(), dump->lost,
+        dump->clean_exit ? "clean exit" : "process did not shut down cleanly"
+    );
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "fmt/chrono.h"
+#include "fmt/format.h"
+#include "muon/core/deferred_log.hpp"
+#include "spdlog/common.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+auto main(int32_t count, char **arguments) -> int32_t {
+    if (count != 2) {
+        fmt::println(stderr, "usage: {} <file.mulog>", arguments[0]);
+        return 1;
+    }
+
+    auto log = muon::log::read_binary_log(arguments[1]);
+    if (!log) {
+        switch (log.error()) {
+            case muon::log::BinaryLogError::FileOpenFailure:
+                fmt::println(stderr, "failed to open {}", arguments[1]);
+                break;
+            case muon::log::BinaryLogError::InvalidFormat:
+                fmt::println(stderr, "{} is not a valid muon binary log", arguments[1]);
+                break;
+            case muon::log::BinaryLogError::UnsupportedVersion:
+                fmt::println(stderr, "{} was written by an unsupported version", arguments[1]);
+                break;
+        }
+        return 1;
+    }
+
+    for (const auto &record : log->records) {
+        auto timestamp = std::chrono::sys_time<std::chrono::nanoseconds>{std::chrono::nanoseconds{record.time}};
+        auto level = spdlog::level::to_string_view(record.level);
+        fmt::println(
+            "{:%T} [{:>3}] [{:>5}] {}:{}: {}", timestamp, record.thread, fmt::string_view{level.data(), level.size()},
+            record.file, record.line, record.text
+        );
+    }
+
+    if (log->dropped > 0) {
+        fmt::println("-- {} records dropped --", log->dropped);
+    }
+    if (log->truncated) {
+        fmt::println(stderr, "the log ends partway through an entry");
+    }
+    return 0;
+}